@@ -53,6 +53,24 @@ extern "C" {
 #define MSX_SETPOINT   2
 #define MSX_FLOWPACED  3
 
+#define MSX_PROF_STEP        0         // WQ time step (MSXstep)
+#define MSX_PROF_GETHYDVARS  1         //   Retrieval of hydraulic results
+#define MSX_PROF_SORTNODES   2         //   Topological sorting of nodes
+#define MSX_PROF_SAVEOUTPUT  3         //   Writing of results to output file
+#define MSX_PROF_TRANSPORT   4         //   Transport of species
+#define MSX_PROF_REACT       5         //     Reactions in pipes & tanks
+#define MSX_PROF_ADVECT      6         //     Advection of pipe segments
+#define MSX_PROF_MIX         7         //     Mixing & routing at nodes
+#define MSX_PROF_DISPERSION  8         //     Longitudinal dispersion
+
+#define MSX_MEM_NETWORK      0         // Network objects, species & ID tables
+#define MSX_MEM_QUALITY      1         // Water quality system arrays
+#define MSX_MEM_SEGMENTS     2         // Memory pool of pipe segments
+#define MSX_MEM_WORKSPACE    3         // Per-thread ODE & dispersion workspaces
+#define MSX_MEM_OUTPUT       4         // Output statistics buffers
+#define MSX_MEM_PROFILING    5         // Trace buffer
+#define MSX_MEM_FILES        6         // Disk space of hydraulics & output files
+
 // --- declare MSX functions
 
 int  MSXDLLEXPORT MSXENopen(const char *inpFile, const char *rptFile,
@@ -84,6 +102,13 @@ int  MSXDLLEXPORT MSXgetpatternvalue(int pat, int period, double *value);
 int  MSXDLLEXPORT MSXgetinitqual(int type, int index, int species, double *value);
 int  MSXDLLEXPORT MSXgetqual(int type, int index, int species, double *value);
 int  MSXDLLEXPORT MSXgeterror(int code, char *msg, int len);
+int  MSXDLLEXPORT MSXsetprofiling(int enabled);
+int  MSXDLLEXPORT MSXgetprofile(int phase, double *seconds, int *calls);
+int  MSXDLLEXPORT MSXsettracing(int size);
+int  MSXDLLEXPORT MSXgettrace(int maxEvents, int *phases, double *starts,
+                  double *durations, int *count, int *dropped);
+int  MSXDLLEXPORT MSXgetmemoryusage(int category, double *bytes);
+int  MSXDLLEXPORT MSXsetfullsort(int fullsort);
 
 int  MSXDLLEXPORT MSXsetconstant(int index, double value);
 int  MSXDLLEXPORT MSXsetparameter(int type, int index, int param, double value);
@@ -12,6 +12,7 @@
 **  AllocReset()    - reset the current pool
 **  AllocSetPool()  - set the current pool
 **  AllocFree()     - free the memory used by the current pool.
+**  AllocSize()     - size of the memory held by a pool.
 **
 */
 
@@ -202,3 +203,25 @@ void  AllocFreePool()
     free((char *) root);
     root = NULL;
 }
+
+
+/*
+**  AllocSize()
+**
+**  Return the number of bytes held by a pool (incl. its headers).
+*/
+
+double  AllocSize(alloc_handle_t *pool)
+{
+    alloc_root_t *pool_root = (alloc_root_t *) pool;
+    alloc_hdr_t  *hdr;
+    double        size;
+
+    if (pool_root == NULL) return(0.0);
+    size = sizeof(alloc_root_t);
+    for (hdr = pool_root->first; hdr != NULL; hdr = hdr->next)
+    {
+        size += sizeof(alloc_hdr_t) + ALLOC_BLOCK_SIZE;
+    }
+    return(size);
+}
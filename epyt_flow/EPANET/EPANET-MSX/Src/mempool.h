@@ -20,5 +20,6 @@ char           *Alloc(long);
 alloc_handle_t *AllocSetPool(alloc_handle_t *);
 void            AllocReset(void);
 void            AllocFreePool(void);
+double          AllocSize(alloc_handle_t *);
 
 #endif
\ No newline at end of file
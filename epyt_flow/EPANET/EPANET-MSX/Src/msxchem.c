@@ -67,6 +67,7 @@ int    MSXchem_react(double dt);
 int    MSXchem_equil(int zone, int k, double *c);
 char*  MSXchem_getVariableStr(int i, char *s);                                 
 void   MSXchem_close(void);
+double MSXchem_getWorkspaceSize(void);
 
 // Imported functions
 //-------------------
@@ -254,6 +255,48 @@ void MSXchem_close()
 
 //=============================================================================
 
+double MSXchem_getWorkspaceSize()
+/*
+**  Purpose:
+**    computes the memory held by the chemistry system of a single thread.
+**
+**  Input:
+**    none.
+**
+**  Returns:
+**    number of bytes of the thread's concentration arrays and the
+**    workspaces of its ODE and algebraic eqn. solvers.
+**
+**  Notes:
+**    only valid while the chemistry system is open.
+*/
+{
+    double m = NumSpecies + 1;
+    double n = MAX(NumPipeEquilSpecies, NumTankEquilSpecies) + 1;
+    double bytes;
+
+// --- Yrate, Yequil, F & ChemC1 arrays
+
+    bytes = 4.0 * m * sizeof(double);
+
+// --- ODE solver workspace
+
+    if ( MSX.Solver == RK5 ) bytes += 7.0 * m * sizeof(double);
+    if ( MSX.Solver == ROS2 )
+    {
+        bytes += 3.0 * m * sizeof(double) + m * sizeof(int);
+        bytes += m * sizeof(double *) + m * m * sizeof(double);
+    }
+
+// --- Newton solver workspace
+
+    bytes += 2.0 * n * sizeof(double) + n * sizeof(int);
+    bytes += n * sizeof(double *) + n * n * sizeof(double);
+    return bytes;
+}
+
+//=============================================================================
+
 int MSXchem_react(double dt)
 /*
 **  Purpose:
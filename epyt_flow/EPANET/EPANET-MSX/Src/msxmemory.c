@@ -0,0 +1,270 @@
+/******************************************************************************
+**  MODULE:        MSXMEMORY.C
+**  PROJECT:       EPANET-MSX
+**  DESCRIPTION:   Accounting of the memory allocated by the EPANET
+**                 Multi-Species Extension toolkit.
+**  AUTHORS:       see AUTHORS
+**  Copyright:     see AUTHORS
+**  License:       see LICENSE
+**  VERSION:       2.0.00
+**  LAST UPDATE:   10/18/2026
+******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "msxtypes.h"
+#include "epanetmsx.h"
+
+//  External variables
+//--------------------
+extern MSXproject  MSX;                // MSX project data
+
+//  Imported functions
+//--------------------
+double MSXchem_getWorkspaceSize(void);
+double MSXproj_getHashSize(void);
+
+//  Exported functions
+//--------------------
+int    MSXmem_getUsage(int category, double *bytes);
+
+//  Local functions
+//-----------------
+static double getNetworkSize(void);
+static double getQualitySize(void);
+static double getWorkspaceSize(void);
+static double getFileSize(TFile *file);
+
+// Size of a 1-based array of n items of a given type
+#define ARRAYSIZE(n, type) ((double)((n) + 1) * sizeof(type))
+
+//=============================================================================
+
+int MSXmem_getUsage(int category, double *bytes)
+/*
+**  Purpose:
+**    computes the amount of memory the project currently holds.
+**
+**  Input:
+**    category = a memory category (see MSX_MEM_* constants).
+**
+**  Output:
+**    *bytes = number of bytes.
+**
+**  Returns:
+**    an error code (or 0 for no error).
+*/
+{
+    int m;
+
+    *bytes = 0.0;
+    switch ( category )
+    {
+    case MSX_MEM_NETWORK:
+        *bytes = getNetworkSize();
+        break;
+
+    case MSX_MEM_QUALITY:
+        *bytes = getQualitySize();
+        break;
+
+    case MSX_MEM_SEGMENTS:
+        if ( MSX.QualityOpened ) *bytes = AllocSize(MSX.QualPool);
+        break;
+
+    case MSX_MEM_WORKSPACE:
+        *bytes = getWorkspaceSize();
+        break;
+
+    case MSX_MEM_OUTPUT:
+    // --- buffers used when computing reporting statistics
+        if ( MSX.OutFile.file == NULL ) break;
+        m = MAX(MSX.Nobjects[NODE], MSX.Nobjects[LINK]);
+        *bytes = ARRAYSIZE(m, REAL4) + 2.0 * ARRAYSIZE(m, double);
+        break;
+
+    case MSX_MEM_PROFILING:
+        if ( MSX.Profile.trace )
+            *bytes = (double)MSX.Profile.traceSize * sizeof(StraceEvent);
+        break;
+
+    case MSX_MEM_FILES:
+        *bytes = getFileSize(&MSX.HydFile) + getFileSize(&MSX.OutFile);
+        if ( MSX.TmpOutFile.file != MSX.OutFile.file )
+            *bytes += getFileSize(&MSX.TmpOutFile);
+        break;
+
+    default:
+        return ERR_INVALID_OBJECT_PARAMS;
+    }
+    return 0;
+}
+
+//=============================================================================
+
+double getNetworkSize()
+/*
+**  Purpose:
+**    computes the memory held by the network's objects, the species,
+**    terms, parameters, constants, patterns, sources, ID hash tables
+**    and node adjacency lists.
+**
+**  Input:
+**    none.
+**
+**  Returns:
+**    number of bytes.
+*/
+{
+    int i;
+    int ns = MSX.Nobjects[SPECIES];
+    int np = MSX.Nobjects[PARAMETER];
+    double bytes = 0.0;
+    Psource source;
+    SnumList *mult;
+    Padjlist alink;
+
+    bytes += ARRAYSIZE(MSX.Nobjects[NODE], Snode);
+    bytes += ARRAYSIZE(MSX.Nobjects[LINK], Slink);
+    bytes += ARRAYSIZE(MSX.Nobjects[TANK], Stank);
+    bytes += ARRAYSIZE(ns, Sspecies);
+    bytes += ARRAYSIZE(MSX.Nobjects[TERM], Sterm);
+    bytes += ARRAYSIZE(np, Sparam);
+    bytes += ARRAYSIZE(MSX.Nobjects[CONSTANT], Sconst);
+    bytes += ARRAYSIZE(MSX.Nobjects[PATTERN], Spattern);
+    bytes += ARRAYSIZE(MSX.Nobjects[CONSTANT], double);
+    bytes += 3.0 * ARRAYSIZE(ns, double);
+
+// --- hydraulic variables
+
+    bytes += 2.0 * ARRAYSIZE(MSX.Nobjects[NODE], float);
+    bytes += 2.0 * ARRAYSIZE(MSX.Nobjects[LINK], float);
+
+// --- concentrations & parameters of nodes, links & tanks
+
+    bytes += 2.0 * MSX.Nobjects[NODE] * ARRAYSIZE(ns, double);
+    bytes += MSX.Nobjects[LINK] * (2.0 * ARRAYSIZE(ns, double) + ARRAYSIZE(np, double));
+    bytes += MSX.Nobjects[TANK] * (2.0 * ARRAYSIZE(ns, double) + ARRAYSIZE(np, double));
+
+    for (i = 1; i <= MSX.Nobjects[NODE]; i++)
+    {
+        for (source = MSX.Node[i].sources; source != NULL; source = source->next)
+            bytes += sizeof(struct Ssource);
+    }
+    for (i = 1; i <= MSX.Nobjects[PATTERN]; i++)
+    {
+        for (mult = MSX.Pattern[i].first; mult != NULL; mult = mult->next)
+            bytes += sizeof(SnumList);
+    }
+
+// --- dispersion coefficients
+
+    if ( MSX.DispersionFlag && MSX.Dispersion.pipeDispersionCoeff )
+        bytes += ARRAYSIZE(MSX.Nobjects[LINK], double);
+
+    bytes += MSXproj_getHashSize();
+
+    if ( MSX.Adjlist )
+    {
+        bytes += ARRAYSIZE(MSX.Nobjects[NODE], Padjlist);
+        for (i = 0; i <= MSX.Nobjects[NODE]; i++)
+        {
+            for (alink = MSX.Adjlist[i]; alink != NULL; alink = alink->next)
+                bytes += sizeof(struct Sadjlist);
+        }
+    }
+    return bytes;
+}
+
+//=============================================================================
+
+double getQualitySize()
+/*
+**  Purpose:
+**    computes the memory held by the water quality system's arrays
+**    (without the pipe segments).
+**
+**  Input:
+**    none.
+**
+**  Returns:
+**    number of bytes.
+*/
+{
+    int ns = MSX.Nobjects[SPECIES];
+    int n = MSX.Nobjects[LINK] + MSX.Nobjects[TANK];
+    double bytes = 0.0;
+
+    if ( !MSX.QualityOpened ) return 0.0;
+
+// --- species concentrations, mass balance & source inflows
+
+    bytes += 10.0 * ARRAYSIZE(ns, double);
+
+// --- first, last & new segments and flow direction of each link
+
+    bytes += 3.0 * ARRAYSIZE(n, Pseg);
+    bytes += ARRAYSIZE(n, FlowDirection);
+    bytes += ARRAYSIZE(MSX.Nobjects[NODE], int);
+
+// --- work space for re-sorting nodes after flow reversals
+
+    bytes += 5.0 * ARRAYSIZE(MSX.Nobjects[NODE], int);
+    bytes += ARRAYSIZE(MSX.Nobjects[LINK], int);
+    return bytes;
+}
+
+//=============================================================================
+
+double getWorkspaceSize()
+/*
+**  Purpose:
+**    computes the memory held by the thread-private workspaces of the
+**    chemistry system and the dispersion solver.
+**
+**  Input:
+**    none.
+**
+**  Returns:
+**    number of bytes of all threads.
+*/
+{
+    int nthreads = 1;
+    double bytes = 0.0;
+
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+
+    if ( MSX.QualityOpened ) bytes += MSXchem_getWorkspaceSize();
+    if ( MSX.DispersionFlag ) bytes += 6.0 * (MSX.MaxSegments + 2) * sizeof(double);
+    return nthreads * bytes;
+}
+
+//=============================================================================
+
+double getFileSize(TFile *file)
+/*
+**  Purpose:
+**    computes the size of an opened file.
+**
+**  Input:
+**    file = a project's file.
+**
+**  Returns:
+**    the file's size in bytes (0 if the file is not opened).
+*/
+{
+    struct stat info;
+
+    if ( file->file == NULL || strlen(file->name) == 0 ) return 0.0;
+    if ( stat(file->name, &info) != 0 ) return 0.0;
+    return (double)info.st_size;
+}
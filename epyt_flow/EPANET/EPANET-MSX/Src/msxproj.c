@@ -73,6 +73,7 @@ int    MSXproj_addObject(int type, char *id, int n);
 int    MSXproj_findObject(int type, char *id);
 char * MSXproj_findID(int type, char *id);
 char * MSXproj_getErrmsg(int errcode);
+double MSXproj_getHashSize(void);
 
 //  Local functions
 //-----------------
@@ -323,6 +324,7 @@ void setDefaults()
     MSX.Solver = EUL;
     MSX.Coupling = NO_COUPLING;
     MSX.Compiler = NO_COMPILER;                                                
+    MSX.FullSort = 0;
     MSX.ErrCode = 0;
     MSX.AreaUnits = FT2;
     MSX.RateUnits = DAYS;
@@ -700,6 +702,34 @@ void deleteHashTables()
     }
 }
 
+//=============================================================================
+
+double MSXproj_getHashSize()
+/*
+**  Purpose:
+**    computes the memory held by the object ID hash tables.
+**
+**  Input:
+**    none.
+**
+**  Returns:
+**    number of bytes of the hash tables, their entries and the
+**    memory pool storing the object ID's.
+*/
+{
+    int j;
+    double bytes = 0.0;
+
+    for (j = 0; j < MAX_OBJECTS; j++)
+    {
+        if ( Htable[j] == NULL ) continue;
+        bytes += HTMAXSIZE * sizeof(HTtable);
+        bytes += MSX.Nobjects[j] * sizeof(struct HTentry);
+    }
+    if ( HashPool ) bytes += AllocSize(HashPool);
+    return bytes;
+}
+
 // New function added (LR-11/20/07, to fix bug 08)
 int openRptFile()
 {
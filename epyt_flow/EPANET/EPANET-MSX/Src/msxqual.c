@@ -18,6 +18,7 @@
 //#include "mempool.h"
 #include "msxutils.h"
 #include "dispersion.h"
+#include "epanetmsx.h"
 
 // Macros to identify upstream & downstream nodes of a link
 // under the current flow and to compute link volume
@@ -80,6 +81,7 @@ void   MSXqual_removeSeg(Pseg seg);
 Pseg   MSXqual_getFreeSeg(double v, double c[]);
 void   MSXqual_addSeg(int k, Pseg seg);
 void   MSXqual_reversesegs(int k);
+void   MSXqual_profStop(int phase, double t0);
 
 //  Local functions
 //-----------------
@@ -102,6 +104,11 @@ static void evalnodeinflow(int, double, double*, double*);
 static void evalnodeoutflow(int k, double* upnodequal, double tstep);
 static int sortNodes();
 static int selectnonstacknode(int numsorted, int* indegree);
+static int sortAllNodes();
+static int updateSort();
+static int reorderNodes(int u, int v);
+static int searchOrder(int n, int lb, int ub, int dir, int target, int* delta);
+static int cmpInt(const void* a, const void* b);
 static void findstoredmass(double* mass);
 
 static void   evalHydVariables(int k);
@@ -181,6 +188,15 @@ int  MSXqual_open()
 
     MSX.SortedNodes = (int*)calloc(n, sizeof(int));
 
+// --- allocate work space for re-sorting nodes after flow reversals
+
+    MSX.Sort.Pos = (int*)calloc(n, sizeof(int));
+    MSX.Sort.Mark = (int*)calloc(n, sizeof(int));
+    MSX.Sort.Stack = (int*)calloc(n, sizeof(int));
+    MSX.Sort.Delta = (int*)calloc(n, sizeof(int));
+    MSX.Sort.Nodes = (int*)calloc(n, sizeof(int));
+    MSX.Sort.Changed = (int*)calloc(MSX.Nobjects[LINK] + 1, sizeof(int));
+
 // --- check for successful memory allocation
 
     CALL(errcode, MEMCHECK(MSX.C1));
@@ -191,6 +207,12 @@ int  MSXqual_open()
     CALL(errcode, MEMCHECK(MSX.MassIn));
     CALL(errcode, MEMCHECK(MSX.SourceIn));
     CALL(errcode, MEMCHECK(MSX.SortedNodes));
+    CALL(errcode, MEMCHECK(MSX.Sort.Pos));
+    CALL(errcode, MEMCHECK(MSX.Sort.Mark));
+    CALL(errcode, MEMCHECK(MSX.Sort.Stack));
+    CALL(errcode, MEMCHECK(MSX.Sort.Delta));
+    CALL(errcode, MEMCHECK(MSX.Sort.Nodes));
+    CALL(errcode, MEMCHECK(MSX.Sort.Changed));
     CALL(errcode, MEMCHECK(MSX.MassBalance.initial));
     CALL(errcode, MEMCHECK(MSX.MassBalance.inflow));
     CALL(errcode, MEMCHECK(MSX.MassBalance.indisperse));
@@ -338,7 +360,10 @@ int MSXqual_step(double *t, double *tleft)
     int m;
     double smassin, smassout, sreacted;
     int64_t  hstep, tstep, dt;
-    
+    double t0 = 0.0, t1 = 0.0;
+
+    PROF_START(t0);
+
 // --- set the shared memory pool to the water quality pool
 //     and the overall time step to nominal WQ time step
 
@@ -369,6 +394,7 @@ int MSXqual_step(double *t, double *tleft)
         // --- retrieve new hydraulic solution
             if (MSX.Qtime == MSX.Htime)
             {
+                PROF_START(t1);
                 CALL(errcode, getHydVars());
 
                 for (int kl = 1; kl <= MSX.Nobjects[LINK]; kl++)
@@ -381,6 +407,7 @@ int MSXqual_step(double *t, double *tleft)
 
                     evalHydVariables(kl);
                 }
+                PROF_STOP(MSX_PROF_GETHYDVARS, t1);
 
                 if (MSX.Qtime < MSX.Dur)
                 {
@@ -396,7 +423,9 @@ int MSXqual_step(double *t, double *tleft)
 
                     if (flowchanged)
                     {
+                        PROF_START(t1);
                         CALL(errcode, sortNodes());
+                        PROF_STOP(MSX_PROF_SORTNODES, t1);
                     }
                 }
             }
@@ -404,7 +433,9 @@ int MSXqual_step(double *t, double *tleft)
         // --- report results if its time to do so
             if (MSX.Saveflag && MSX.Qtime == MSX.Rtime)
             {
+                PROF_START(t1);
                 CALL(errcode, MSXout_saveResults());
+                PROF_STOP(MSX_PROF_SAVEOUTPUT, t1);
                 MSX.Rtime += MSX.Rstep * 1000;
                 MSX.Nperiods++;
             }
@@ -457,6 +488,7 @@ int MSXqual_step(double *t, double *tleft)
         }
         CALL(errcode, MSXout_saveFinalResults());
     }
+    PROF_STOP(MSX_PROF_STEP, t0);
     return errcode;
 }
 
@@ -553,12 +585,19 @@ int MSXqual_close()
     FREE(MSX.NewSeg);
     FREE(MSX.FlowDir);
     FREE(MSX.SortedNodes);
+    FREE(MSX.Sort.Pos);
+    FREE(MSX.Sort.Mark);
+    FREE(MSX.Sort.Stack);
+    FREE(MSX.Sort.Delta);
+    FREE(MSX.Sort.Nodes);
+    FREE(MSX.Sort.Changed);
     FREE(MSX.MassIn);
     FREE(MSX.SourceIn);
     if ( MSX.QualPool)
     {
         AllocSetPool(MSX.QualPool);
         AllocFreePool();
+        MSX.QualPool = NULL;
     }
     FREE(MSX.MassBalance.initial);
     FREE(MSX.MassBalance.inflow);
@@ -673,6 +712,40 @@ int  getHydVars()
 
 //=============================================================================
 
+void MSXqual_profStop(int phase, double t0)
+/*
+**  Purpose:
+**    adds the time elapsed since t0 to a phase's total and/or records
+**    it in the trace ring buffer.
+**
+**  Input:
+**    phase = simulation phase (see MSX_PROF_* constants)
+**    t0 = time at which the phase was entered (sec).
+**
+**  Returns:
+**    none.
+*/
+{
+    StraceEvent *event;
+    double t1 = MSXutils_clock();
+
+    if (MSX.Profile.enabled)
+    {
+        MSX.Profile.time[phase] += t1 - t0;
+        MSX.Profile.calls[phase]++;
+    }
+    if (MSX.Profile.tracing)
+    {
+        event = &MSX.Profile.trace[MSX.Profile.traceCount % MSX.Profile.traceSize];
+        event->phase = phase;
+        event->start = t0;
+        event->duration = t1 - t0;
+        MSX.Profile.traceCount++;
+    }
+}
+
+//=============================================================================
+
 int  transport(int64_t tstep)
 /*
 **  Purpose:
@@ -688,8 +761,11 @@ int  transport(int64_t tstep)
 {
     int64_t qtime, dt64;
     double dt;
+    double t0 = 0.0, t1 = 0.0;
     int  errcode = 0;
 
+    PROF_START(t0);
+
 // --- repeat until time step is exhausted
 
     MSXerr_clearMathError();                // clear math error flag           
@@ -702,9 +778,17 @@ int  transport(int64_t tstep)
         qtime += dt64;                      // update amount of input tstep taken
         dt = dt64 / 1000.;                  // time step as fractional seconds
         
+        PROF_START(t1);
         errcode = MSXchem_react(dt);        // react species in each pipe & tank
-        if ( errcode ) return errcode;
+        PROF_STOP(MSX_PROF_REACT, t1);
+        if ( errcode )
+        {
+            PROF_STOP(MSX_PROF_TRANSPORT, t0);
+            return errcode;
+        }
+        PROF_START(t1);
         advectSegs(dt);                     // advect segments in each pipe
+        PROF_STOP(MSX_PROF_ADVECT, t1);
         
         topological_transport(dt);          //replace accumulate, updateNodes, sourceInput and release
 
@@ -714,6 +798,7 @@ int  transport(int64_t tstep)
 			errcode = ERR_ILLEGAL_MATH;
 		}
    }
+   PROF_STOP(MSX_PROF_TRANSPORT, t0);
    return errcode;
 }
 
@@ -731,6 +816,10 @@ void  initSegs()
     int     j, k, m;
     double  v;
 
+// --- nodes are fully sorted once the flow directions are established
+
+    MSX.Sort.Valid = 0;
+
 // --- examine each link
 
     for (k=1; k<=MSX.Nobjects[LINK]; k++)
@@ -835,6 +924,7 @@ int  flowdirchanged()
 
 // --- examine each link
 
+    MSX.Sort.Nchanged = 0;
     for (k=1; k<=MSX.Nobjects[LINK]; k++)
     {
     // --- find new flow direction
@@ -855,6 +945,12 @@ int  flowdirchanged()
         {
             flowchanged = 1;            
         }
+
+    // --- links with a new non-negligible flow direction are the
+    //     only ones that can violate the current node order
+
+        if (newdir != MSX.FlowDir[k] && newdir != ZERO_FLOW)
+            MSX.Sort.Changed[MSX.Sort.Nchanged++] = k;
         MSX.FlowDir[k] = newdir;
     }
     return flowchanged;
@@ -1255,8 +1351,10 @@ void topological_transport(double dt)
 {
     int j, n, k, m;
     double volin, volout;
+    double t0 = 0.0;
     Padjlist  alink;
 
+    PROF_START(t0);
 
     // Analyze each node in topological order
     for (j = 1; j <= MSX.Nobjects[NODE]; j++)
@@ -1316,6 +1414,9 @@ void topological_transport(double dt)
         }
 
     }
+    PROF_STOP(MSX_PROF_MIX, t0);
+    PROF_START(t0);
+
     /*Advection-Reaction Done, Dispersion Starts*/
     //1. Linear relationship for each pipe
     //2. Compose the nodal equations
@@ -1330,6 +1431,7 @@ void topological_transport(double dt)
             segqual_update(m, dt);
         }
     }
+    PROF_STOP(MSX_PROF_DISPERSION, t0);
 }
 
 
@@ -1573,7 +1675,24 @@ int sortNodes()
 **--------------------------------------------------------------
 **   Input:   none
 **   Output:  returns an error code
-**   Purpose: topologically sorts nodes from upstream to downstream.
+**   Purpose: topologically sorts nodes from upstream to downstream
+**            after the flow direction of any link has changed.
+**   Note:    if the current order has no cycles then only the
+**            nodes affected by the changed links are re-ordered
+**            (unless a full sort is forced with MSXsetfullsort).
+**--------------------------------------------------------------
+*/
+{
+    if (MSX.Sort.Valid && !MSX.FullSort && updateSort()) return 0;
+    return sortAllNodes();
+}
+
+int sortAllNodes()
+/*
+**--------------------------------------------------------------
+**   Input:   none
+**   Output:  returns an error code
+**   Purpose: topologically sorts all nodes from upstream to downstream.
 **   Note:    links with negligible flow are ignored since they can
 **            create spurious cycles that cause the sort to fail.
 **--------------------------------------------------------------
@@ -1585,6 +1704,7 @@ int sortNodes()
     int* stack = NULL;
     int stacksize = 0;
     int numsorted = 0;
+    int cyclic = 0;
     int errcode = 0;
     FlowDirection dir;
     Padjlist  alink;
@@ -1624,6 +1744,7 @@ int sortNodes()
                 //  ... add a non-sorted node connected to a sorted one to stack
                 j = selectnonstacknode(numsorted, indegree);
                 if (j == 0) break;  // This shouldn't happen.
+                cyclic = 1;
                 indegree[j] = 0;
                 stacksize++;
                 stack[stacksize] = j;
@@ -1669,9 +1790,150 @@ int sortNodes()
     if (numsorted < MSX.Nobjects[NODE]) errcode = 120;
     FREE(indegree);
     FREE(stack);
+
+    // Save the position of each node for later incremental updates
+    // (which are only possible if the sorted order has no cycles)
+    if (!errcode)
+    {
+        for (i = 1; i <= MSX.Nobjects[NODE]; i++) MSX.Sort.Pos[MSX.SortedNodes[i]] = i;
+    }
+    MSX.Sort.Valid = !errcode && !cyclic;
     return errcode;
 }
 
+int updateSort()
+/*
+**--------------------------------------------------------------
+**   Input:   none
+**   Output:  returns 1 if the sorted nodes were updated or
+**            0 if a full sort is required
+**   Purpose: restores the topological order of the sorted nodes
+**            after flow reversals by re-ordering only the nodes
+**            between the end nodes of each link that now flows
+**            against the order (Pearce-Kelly algorithm).
+**   Note:    a full sort is required if the new flow directions
+**            contain a cycle or if re-ordering would visit more
+**            nodes than a full sort.
+**--------------------------------------------------------------
+*/
+{
+    int i, k;
+
+    // Re-ordering visits each node at a higher cost than a full sort
+    MSX.Sort.Budget = MSX.Nobjects[NODE] / 4;
+
+    // Links whose flow became negligible can not violate the order and
+    // a re-ordering never violates a link that already follows it
+    for (i = 0; i < MSX.Sort.Nchanged; i++)
+    {
+        k = MSX.Sort.Changed[i];
+        if (MSX.Sort.Pos[UP_NODE(k)] < MSX.Sort.Pos[DOWN_NODE(k)]) continue;
+        if (!reorderNodes(UP_NODE(k), DOWN_NODE(k)))
+        {
+            memset(MSX.Sort.Mark, 0, (MSX.Nobjects[NODE] + 1) * sizeof(int));
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int reorderNodes(int u, int v)
+/*
+**--------------------------------------------------------------
+**   Input:   u = upstream node of a link
+**            v = downstream node of the link (sorted before u)
+**   Output:  returns 0 if the link closes a cycle or if the
+**            search exceeds its budget
+**   Purpose: moves the nodes upstream of u in front of the nodes
+**            downstream of v, considering only the nodes sorted
+**            between v and u.
+**--------------------------------------------------------------
+*/
+{
+    int i, nf, nb;
+    int lb = MSX.Sort.Pos[v];
+    int ub = MSX.Sort.Pos[u];
+    int* delta = MSX.Sort.Delta;
+
+    // Find the positions of the nodes downstream of v and upstream of u
+    nf = searchOrder(v, lb, ub, 1, u, delta);
+    if (nf < 0) return 0;
+    nb = searchOrder(u, lb, ub, -1, 0, &delta[nf]);
+    if (nb < 0) return 0;
+
+    // Upstream nodes keep their relative order followed by the
+    // downstream nodes, both placed into the freed positions
+    qsort(delta, nf, sizeof(int), cmpInt);
+    qsort(&delta[nf], nb, sizeof(int), cmpInt);
+    for (i = 0; i < nb; i++) MSX.Sort.Nodes[i] = MSX.SortedNodes[delta[nf + i]];
+    for (i = 0; i < nf; i++) MSX.Sort.Nodes[nb + i] = MSX.SortedNodes[delta[i]];
+    qsort(delta, nb + nf, sizeof(int), cmpInt);
+    for (i = 0; i < nb + nf; i++)
+    {
+        MSX.SortedNodes[delta[i]] = MSX.Sort.Nodes[i];
+        MSX.Sort.Pos[MSX.Sort.Nodes[i]] = delta[i];
+        MSX.Sort.Mark[MSX.Sort.Nodes[i]] = 0;
+    }
+    return 1;
+}
+
+int searchOrder(int n, int lb, int ub, int dir, int target, int* delta)
+/*
+**--------------------------------------------------------------
+**   Input:   n = start node
+**            lb, ub = positions bounding the search
+**            dir = 1 to search downstream or -1 to search upstream
+**            target = node that closes a cycle if it is reached
+**   Output:  delta = positions of the nodes found;
+**            returns number of nodes found or -1 if target is reached
+**            or if more nodes are found than the remaining budget
+**   Purpose: finds all nodes connected to node n by links with flow
+**            in the search direction that are sorted between lb and ub.
+**--------------------------------------------------------------
+*/
+{
+    int i, k, m;
+    int count = 0;
+    int stacksize = 0;
+    Padjlist alink;
+
+    MSX.Sort.Mark[n] = 1;
+    MSX.Sort.Stack[++stacksize] = n;
+    while (stacksize > 0)
+    {
+        i = MSX.Sort.Stack[stacksize--];
+        delta[count++] = MSX.Sort.Pos[i];
+        if (--MSX.Sort.Budget < 0) return -1;
+        for (alink = MSX.Adjlist[i]; alink != NULL; alink = alink->next)
+        {
+            // ... skip links with negligible flow or flow against the search
+            k = alink->link;
+            m = alink->node;
+            if (MSX.FlowDir[k] == ZERO_FLOW) continue;
+            if ((dir > 0) != (DOWN_NODE(k) == m)) continue;
+
+            // ... add node m to the search if it lies between the bounds
+            if (m == target) return -1;
+            if (MSX.Sort.Mark[m] || MSX.Sort.Pos[m] <= lb || MSX.Sort.Pos[m] >= ub) continue;
+            MSX.Sort.Mark[m] = 1;
+            MSX.Sort.Stack[++stacksize] = m;
+        }
+    }
+    return count;
+}
+
+int cmpInt(const void* a, const void* b)
+/*
+**--------------------------------------------------------------
+**   Input:   a, b = pointers to integers
+**   Output:  returns the sign of *a - *b
+**   Purpose: compares two integers for qsort.
+**--------------------------------------------------------------
+*/
+{
+    return (*(const int*)a > *(const int*)b) - (*(const int*)a < *(const int*)b);
+}
+
 int selectnonstacknode(int numsorted, int* indegree)
 /*
 **--------------------------------------------------------------
@@ -49,6 +49,7 @@ double MSXqual_getNodeQual(int j, int m);
 double MSXqual_getLinkQual(int k, int m);
 int    MSXrpt_write(void);
 int    MSXfile_save(FILE *f);
+int    MSXmem_getUsage(int category, double *bytes);
 
 //=============================================================================
 
@@ -803,6 +804,58 @@ int  MSXDLLEXPORT  MSXgeterror(int code, char *msg, int len)
 
 //=============================================================================
 
+int  MSXDLLEXPORT  MSXsetprofiling(int enabled)
+/*
+**  Purpose:
+**    turns the timing of simulation phases on or off -- enabling it
+**    clears all previously collected data.
+**
+**  Input:
+**    enabled = 1 to enable profiling, 0 to disable it.
+**
+**  Returns:
+**    an error code (or 0 for no error).
+*/
+{
+    if ( enabled )
+    {
+        memset(MSX.Profile.time, 0, sizeof(MSX.Profile.time));
+        memset(MSX.Profile.calls, 0, sizeof(MSX.Profile.calls));
+        MSX.Profile.enabled = 1;
+    }
+    else MSX.Profile.enabled = 0;
+    return 0;
+}
+
+//=============================================================================
+
+int  MSXDLLEXPORT  MSXgetprofile(int phase, double *seconds, int *calls)
+/*
+**  Purpose:
+**    retrieves the profiling data collected for a simulation phase.
+**
+**  Input:
+**    phase = simulation phase (see MSX_PROF_* constants).
+**
+**  Output:
+**    *seconds = accumulated wall clock time spent in the phase;
+**    *calls = number of times the phase was entered.
+**
+**  Returns:
+**    an error code (or 0 for no error).
+*/
+{
+    *seconds = 0.0;
+    *calls = 0;
+    if ( phase < MSX_PROF_STEP || phase > MSX_PROF_DISPERSION )
+        return ERR_INVALID_OBJECT_PARAMS;
+    *seconds = MSX.Profile.time[phase];
+    *calls = (int)MSX.Profile.calls[phase];
+    return 0;
+}
+
+//=============================================================================
+
 int  MSXDLLEXPORT  MSXsetconstant(int index, double value)
 /*
 **  Purpose:
@@ -1162,3 +1215,139 @@ int  MSXDLLEXPORT MSXsavemsxfile(char *fname)
     fclose(f);
     return errcode;
 }
+
+//=============================================================================
+
+int  MSXDLLEXPORT  MSXsettracing(int size)
+/*
+**  Purpose:
+**    turns the recording of a timeline of simulation phases on or off --
+**    once the ring buffer is full the oldest events are overwritten.
+**
+**  Input:
+**    size = capacity (in events) of the trace ring buffer, 0 disables tracing.
+**
+**  Returns:
+**    an error code (or 0 for no error).
+*/
+{
+    MSX.Profile.tracing = 0;
+    free(MSX.Profile.trace);
+    MSX.Profile.trace = NULL;
+    MSX.Profile.traceSize = 0;
+    MSX.Profile.traceHead = 0;
+    MSX.Profile.traceCount = 0;
+    MSX.Profile.traceDropped = 0;
+    if ( size <= 0 ) return 0;
+
+    MSX.Profile.trace = (StraceEvent *) calloc(size, sizeof(StraceEvent));
+    if ( MSX.Profile.trace == NULL ) return ERR_MEMORY;
+    MSX.Profile.traceSize = size;
+    MSX.Profile.tracing = 1;
+    return 0;
+}
+
+//=============================================================================
+
+int  MSXDLLEXPORT  MSXgettrace(int maxEvents, int *phases, double *starts,
+                               double *durations, int *count, int *dropped)
+/*
+**  Purpose:
+**    retrieves (and removes) the oldest events from the trace ring buffer.
+**
+**  Input:
+**    maxEvents = size of the output arrays.
+**
+**  Output:
+**    phases = simulation phase of each event (see MSX_PROF_* constants);
+**    starts = time at which each phase was entered (sec);
+**    durations = time spent in each phase (sec);
+**    *count = number of events retrieved;
+**    *dropped = number of events lost due to buffer overflow since last call.
+**
+**  Returns:
+**    an error code (or 0 for no error).
+**
+**  Notes:
+**    time stamps refer to the same clock as the ones of EN_gettrace.
+*/
+{
+    long n;
+    StraceEvent *event;
+    Sprofile *prof = &MSX.Profile;
+
+    *count = 0;
+    *dropped = 0;
+    if ( prof->trace == NULL ) return 0;
+
+// --- skip events that have been overwritten
+
+    if ( prof->traceCount - prof->traceHead > prof->traceSize )
+    {
+        prof->traceDropped += prof->traceCount - prof->traceHead - prof->traceSize;
+        prof->traceHead = prof->traceCount - prof->traceSize;
+    }
+
+    for (n = 0; n < maxEvents && prof->traceHead < prof->traceCount; n++)
+    {
+        event = &prof->trace[prof->traceHead % prof->traceSize];
+        phases[n] = event->phase;
+        starts[n] = event->start;
+        durations[n] = event->duration;
+        prof->traceHead++;
+    }
+    *count = (int)n;
+    *dropped = (int)prof->traceDropped;
+    prof->traceDropped = 0;
+    return 0;
+}
+
+//=============================================================================
+
+int  MSXDLLEXPORT  MSXgetmemoryusage(int category, double *bytes)
+/*
+**  Purpose:
+**    retrieves the amount of memory the project currently holds.
+**
+**  Input:
+**    category = a memory category (see MSX_MEM_* constants).
+**
+**  Output:
+**    *bytes = number of bytes (disk space in case of MSX_MEM_FILES).
+**
+**  Returns:
+**    an error code (or 0 for no error).
+**
+**  Notes:
+**    the thread-private workspaces are counted once per OpenMP thread.
+*/
+{
+    *bytes = 0.0;
+    if ( !MSX.ProjectOpened ) return ERR_MSX_NOT_OPENED;
+    return MSXmem_getUsage(category, bytes);
+}
+
+//=============================================================================
+
+int  MSXDLLEXPORT  MSXsetfullsort(int fullsort)
+/*
+**  Purpose:
+**    selects whether all nodes are re-sorted whenever the flow direction
+**    of a link changes or only the nodes affected by the changed links
+**    are re-ordered (default).
+**
+**  Input:
+**    fullsort = 1 to always re-sort all nodes, 0 otherwise.
+**
+**  Returns:
+**    an error code (or 0 for no error).
+**
+**  Notes:
+**    both settings give the same results -- a full sort is slower and
+**    mainly serves as a reference for checking the incremental update.
+*/
+{
+    if ( !MSX.ProjectOpened ) return ERR_MSX_NOT_OPENED;
+    MSX.FullSort = (fullsort != 0);
+    return 0;
+}
@@ -51,6 +51,17 @@ typedef  float REAL4;
 //-----------------------------------------------------------------------------
 #define CALL(err, f) (err = ( (err>100) ? (err) : (f) ))
 
+//-----------------------------------------------------------------------------
+//  Macros to time a simulation phase if profiling or tracing is enabled
+//  (t is a local double holding the phase's start time)
+//-----------------------------------------------------------------------------
+#define PROF_START(t) \
+    do { if (MSX.Profile.enabled || MSX.Profile.tracing) \
+             (t) = MSXutils_clock(); } while(0)
+#define PROF_STOP(phase, t) \
+    do { if (MSX.Profile.enabled || MSX.Profile.tracing) \
+             MSXqual_profStop((phase), (t)); } while(0)
+
 
 //-----------------------------------------------------------------------------
 //  Defined Constants
@@ -58,6 +69,7 @@ typedef  float REAL4;
 #define   MAGICNUMBER  516114521
 #define   VERSION      200000
 #define   MAXMSG       1024            // Max. # characters in message text
+#define   MAXPROFPHASES 16             // Max. # of profiled simulation phases
 #define   MAXLINE      1024            // Max. # characters in input line
 #define   TRUE         1
 #define   FALSE        0
@@ -432,6 +444,19 @@ typedef struct                 // Mass Balance Components
     double   * ratio;           // ratio of mass added to mass lost
 } SmassBalance;
 
+typedef struct                 // Incremental Topological Sort
+{
+    int    Valid;              // 1 if sorted nodes have no cycles
+    int    Budget;             // nodes left to visit before a full sort
+    int*   Pos;                // position of each node in SortedNodes
+    int*   Mark;               // search mark of each node
+    int*   Stack;              // depth-first search stack
+    int*   Delta;              // positions of the re-ordered nodes
+    int*   Nodes;              // re-ordered nodes
+    int    Nchanged;           // number of links with a new flow direction
+    int*   Changed;            // links with a new (non-negligible) flow direction
+} Ssort;
+
 
 typedef struct
 {
@@ -465,6 +490,28 @@ typedef struct
 } Sdispersion;
 
 
+typedef struct                         // TRACE EVENT
+{
+   int    phase;                       // simulation phase
+   double start;                       // time at which phase was entered (sec)
+   double duration;                    // time spent in phase (sec)
+}  StraceEvent;
+
+
+typedef struct                         // PERFORMANCE PROFILING DATA
+{
+   int    enabled;                     // profiling enabled flag
+   double time[MAXPROFPHASES];         // accumulated wall clock time (sec)
+   long   calls[MAXPROFPHASES];        // number of times a phase was entered
+   int    tracing;                     // tracing enabled flag
+   int    traceSize;                   // capacity of trace ring buffer
+   long   traceHead;                   // # of trace events already retrieved
+   long   traceCount;                  // # of trace events recorded
+   long   traceDropped;                // # of trace events overwritten
+   StraceEvent *trace;                 // ring buffer of trace events
+}  Sprofile;
+
+
 typedef struct                         // MSX PROJECT VARIABLES
 {
    TFile  HydFile,                     // EPANET hydraulics file
@@ -543,9 +590,13 @@ typedef struct                         // MSX PROJECT VARIABLES
    double* MassIn;        // mass inflow of each species to each node
    double* SourceIn;      // external mass inflow of each species from WQ source;
    int* SortedNodes;
+   Ssort Sort;                         // Incremental node sorting work space
+   int FullSort;                       // 1 if all nodes are always re-sorted
   
    Sdispersion Dispersion;
 
+   Sprofile Profile;                   // Performance profiling data
+
 } MSXproject;
 
 #endif
@@ -15,6 +15,7 @@
 #include <string.h>
 #include <math.h>
 #include <float.h>
+#include <time.h>
 
 #include "msxutils.h"
 // --- define WINDOWS
@@ -27,6 +28,10 @@
   #define WINDOWS
 #endif
 
+#ifdef WINDOWS
+#include <windows.h>
+#endif
+
 #define UCHAR(x) (((x) >= 'a' && (x) <= 'z') ? ((x)&~32) : (x))
 #define TINY1 1.0e-20
 
@@ -76,6 +81,35 @@ char * MSXutils_getTempName(char *s)
 
 //=============================================================================
 
+double MSXutils_clock(void)
+/*
+**  Purpose:
+**    reads a high resolution monotonic clock.
+**
+**  Input:
+**    none
+**
+**  Returns:
+**    the current clock time in seconds.
+*/
+{
+#ifdef WINDOWS
+    static LARGE_INTEGER freq = {0};
+    LARGE_INTEGER count;
+
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+//=============================================================================
+
 int  MSXutils_strcomp(char *s1, char *s2)
 /*
 **  Purpose:
@@ -16,6 +16,9 @@
 // Gets the name of a temporary file                                           
 char * MSXutils_getTempName(char *s);
 
+// Reads a monotonic wall clock (in seconds) for profiling
+double MSXutils_clock(void);
+
 // Case insentive comparison of two strings
 int MSXutils_strcomp(char *s1, char *s2);
 
@@ -0,0 +1,684 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       adjoint.c
+ Description:  computes the backward (adjoint) transport of water from sensor
+               nodes to all upstream nodes using the hydraulic periods stored
+               in the hydraulics file
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "types.h"
+#include "funcs.h"
+
+// Flows below this value (cfs) are treated as zero
+#define  AZERO  1.e-6
+
+// Stored hydraulic periods
+typedef struct {
+    int     Count;              // Number of periods
+    int     Capacity;           // Allocated number of periods
+    long    *Time;              // Start time of each period (sec)
+    REAL4   *Flow;              // Link flows (Count x Nlinks)
+    char    *Open;              // Link open flags (Count x Nlinks)
+    REAL4   *Inflow;            // External node inflows (Count x Nnodes)
+    REAL4   *Volume;            // Tank volumes (Count x Ntanks)
+} AdjPeriods;
+
+// Weight of the water that passed a node during a time bin
+typedef struct {
+    int     Node;               // Node index
+    int     Bin;                // Time bin index
+    int     Slot;               // Position in hash table
+    int     Next;               // Next cell of the same time bin
+    int     Queued;             // Cell waits for being processed
+    double  W;                  // Total weight
+    double  Wt;                 // Total weight x time
+    double  Pw;                 // Pending weight
+    double  Pwt;                // Pending weight x time
+} AdjCell;
+
+// Work space of the backward pass
+typedef struct {
+    Project     *pr;
+    AdjPeriods  per;
+    int         *adjStart;      // Links incident to each node (CSR)
+    int         *adjLink;
+    int         *tankOf;        // Tank index of each node (0 = none)
+    double      binSize;        // Length of a time bin (sec)
+    double      floor;          // Smallest weight that is propagated
+    int         curBin;         // Time bin being processed
+    int         *head;          // First cell of each time bin
+    AdjCell     *cells;         // Cells of the current pass
+    int         ncells, maxcells;
+    int         *table;         // Hash table of cells
+    int         tablesize;      // (a power of 2)
+    int         *stack;         // Cells of the current time bin
+    int         nstack, maxstack;
+} AdjWork;
+
+// Local functions
+static int   readperiods(AdjWork *, double);
+static int   buildincidence(AdjWork *);
+static void  freework(AdjWork *);
+static int   findperiod(AdjPeriods *, double);
+static int   findcell(AdjWork *, int, int);
+static int   growtable(AdjWork *);
+static int   push(AdjWork *, int);
+static int   addweight(AdjWork *, int, double, double);
+static int   propagate(AdjWork *, int, double, double);
+static double entrytime(AdjWork *, int, int, double, double, int *);
+static void  resetcells(AdjWork *);
+
+
+int backwardinfluence(Project *pr, int nsensors, const int *sensors,
+                      int ntimes, const double *times, long binsize,
+                      double minweight, int capacity, int *count, int *rows,
+                      int *nodes, double *injtimes, double *weights)
+/*
+**--------------------------------------------------------------
+**  Input:   nsensors = number of sensor nodes
+**           sensors = index of each sensor node
+**           ntimes = number of sample times
+**           times = sample times (sec)
+**           binsize = length of a time bin (sec)
+**           minweight = smallest weight that is reported
+**           capacity = length of the output arrays
+**  Output:  count = number of (node, time bin) entries found
+**           rows = sample of each entry (sensor x ntimes + time)
+**           nodes = node index of each entry
+**           injtimes = mean time at which the water passed the node
+**           weights = fraction of the sampled water that passed
+**                     the node during the entry's time bin
+**  Returns: error code
+**  Purpose: routes the water sampled at each sensor node at each
+**           sample time backwards through the network (i.e. against
+**           the flow direction of the stored hydraulic periods)
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+
+    AdjWork w;
+    int i, k, s, c, errcode = 0;
+    double tmax = 0.0, weight, tbar;
+    int nbins;
+    AdjCell *cell;
+
+    // Results of the hydraulic solver that are overwritten by reading
+    // the hydraulics file
+    double *demand = NULL, *head = NULL, *flow = NULL, *setting = NULL;
+    StatusType *status = NULL;
+
+    *count = 0;
+    for (i = 0; i < ntimes; i++) tmax = MAX(tmax, times[i]);
+
+    memset(&w, 0, sizeof(AdjWork));
+    w.pr = pr;
+    w.binSize = (double)binsize;
+    w.floor = MAX(1.e-3 * minweight, 1.e-12);
+    nbins = (int)(tmax / w.binSize) + 1;
+
+    demand = (double *)calloc(net->Nnodes + 1, sizeof(double));
+    head = (double *)calloc(net->Nnodes + 1, sizeof(double));
+    flow = (double *)calloc(net->Nlinks + 1, sizeof(double));
+    setting = (double *)calloc(net->Nlinks + 1, sizeof(double));
+    status = (StatusType *)calloc(net->Nlinks + 1, sizeof(StatusType));
+    w.head = (int *)calloc(nbins, sizeof(int));
+    w.tablesize = 1024;
+    w.table = (int *)malloc(w.tablesize * sizeof(int));
+    if (!demand || !head || !flow || !setting || !status || !w.head ||
+        !w.table) errcode = 101;
+    else
+    {
+        memcpy(demand, hyd->NodeDemand, (net->Nnodes + 1) * sizeof(double));
+        memcpy(head, hyd->NodeHead, (net->Nnodes + 1) * sizeof(double));
+        memcpy(flow, hyd->LinkFlow, (net->Nlinks + 1) * sizeof(double));
+        memcpy(setting, hyd->LinkSetting, (net->Nlinks + 1) * sizeof(double));
+        memcpy(status, hyd->LinkStatus, (net->Nlinks + 1) * sizeof(StatusType));
+        for (i = 0; i < w.tablesize; i++) w.table[i] = -1;
+
+        ERRCODE(readperiods(&w, tmax));
+        ERRCODE(buildincidence(&w));
+    }
+
+    // One backward pass per sample
+    for (s = 0; s < nsensors && !errcode; s++)
+    {
+        for (k = 0; k < ntimes && !errcode; k++)
+        {
+            if (times[k] < 0.0) continue;
+            for (i = 0; i < nbins; i++) w.head[i] = -1;
+            w.curBin = nbins;
+            errcode = addweight(&w, sensors[s], times[k], 1.0);
+
+            // Process all time bins backwards -- water can only be routed
+            // to the current or earlier time bins
+            for (w.curBin = nbins - 1; w.curBin >= 0 && !errcode; w.curBin--)
+            {
+                for (c = w.head[w.curBin]; c >= 0 && !errcode; c = w.cells[c].Next)
+                {
+                    errcode = push(&w, c);
+                }
+                while (w.nstack > 0 && !errcode)
+                {
+                    cell = &w.cells[w.stack[--w.nstack]];
+                    cell->Queued = FALSE;
+                    if (cell->Pw <= w.floor) continue;
+
+                    weight = cell->Pw;
+                    tbar = cell->Pwt / cell->Pw;
+                    cell->W += cell->Pw;
+                    cell->Wt += cell->Pwt;
+                    cell->Pw = 0.0;
+                    cell->Pwt = 0.0;
+                    errcode = propagate(&w, cell->Node, tbar, weight);
+                }
+            }
+
+            // Report all cells that carry enough of the sampled water
+            for (c = 0; c < w.ncells && !errcode; c++)
+            {
+                cell = &w.cells[c];
+                if (cell->W < minweight || cell->W <= 0.0) continue;
+                if (*count < capacity)
+                {
+                    rows[*count] = s * ntimes + k;
+                    nodes[*count] = cell->Node;
+                    injtimes[*count] = cell->Wt / cell->W;
+                    weights[*count] = cell->W;
+                }
+                (*count)++;
+            }
+            resetcells(&w);
+        }
+    }
+
+    // Restore the results of the hydraulic solver
+    if (demand && head && flow && setting && status)
+    {
+        memcpy(hyd->NodeDemand, demand, (net->Nnodes + 1) * sizeof(double));
+        memcpy(hyd->NodeHead, head, (net->Nnodes + 1) * sizeof(double));
+        memcpy(hyd->LinkFlow, flow, (net->Nlinks + 1) * sizeof(double));
+        memcpy(hyd->LinkSetting, setting, (net->Nlinks + 1) * sizeof(double));
+        memcpy(hyd->LinkStatus, status, (net->Nlinks + 1) * sizeof(StatusType));
+    }
+    FREE(demand);
+    FREE(head);
+    FREE(flow);
+    FREE(setting);
+    FREE(status);
+    freework(&w);
+    return errcode;
+}
+
+
+int readperiods(AdjWork *w, double tmax)
+/*
+**--------------------------------------------------------------
+**  Input:   tmax = latest sample time (sec)
+**  Output:  returns error code
+**  Purpose: reads all hydraulic periods that start before tmax
+**           from the hydraulics file
+**--------------------------------------------------------------
+*/
+{
+    Project *pr = w->pr;
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    AdjPeriods *per = &w->per;
+
+    int i, k, n;
+    long htime, hstep;
+    void *p1, *p2, *p3, *p4, *p5;
+
+    fseek(pr->outfile.HydFile, pr->outfile.HydOffset, SEEK_SET);
+    do
+    {
+        if (!readhyd(pr, &htime)) return 307;
+        if (!readhydstep(pr, &hstep)) return 307;
+
+        // Expand the storage of the periods
+        if (per->Count == per->Capacity)
+        {
+            n = MAX(16, 2 * per->Capacity);
+            p1 = realloc(per->Time, n * sizeof(long));
+            if (p1) per->Time = (long *)p1;
+            p2 = realloc(per->Flow, (size_t)n * net->Nlinks * sizeof(REAL4));
+            if (p2) per->Flow = (REAL4 *)p2;
+            p3 = realloc(per->Open, (size_t)n * net->Nlinks * sizeof(char));
+            if (p3) per->Open = (char *)p3;
+            p4 = realloc(per->Inflow, (size_t)n * net->Nnodes * sizeof(REAL4));
+            if (p4) per->Inflow = (REAL4 *)p4;
+            p5 = realloc(per->Volume, (size_t)n * MAX(net->Ntanks, 1) * sizeof(REAL4));
+            if (p5) per->Volume = (REAL4 *)p5;
+            if (!p1 || !p2 || !p3 || !p4 || !p5) return 101;
+            per->Capacity = n;
+        }
+
+        // Store the flows, external inflows, and tank volumes of the period
+        k = per->Count++;
+        per->Time[k] = htime;
+        for (i = 1; i <= net->Nlinks; i++)
+        {
+            per->Flow[(size_t)k * net->Nlinks + i - 1] = (REAL4)hyd->LinkFlow[i];
+            per->Open[(size_t)k * net->Nlinks + i - 1] = hyd->LinkStatus[i] > CLOSED;
+        }
+        // (the net inflow of a tank is carried by its links)
+        for (i = 1; i <= net->Nnodes; i++)
+        {
+            per->Inflow[(size_t)k * net->Nnodes + i - 1] = (i > net->Njuncs) ? 0.0f :
+                (REAL4)MAX(0.0, -hyd->NodeDemand[i]);
+        }
+        for (i = 1; i <= net->Ntanks; i++)
+        {
+            per->Volume[(size_t)k * net->Ntanks + i - 1] = (REAL4)
+                (net->Tank[i].A == 0.0 ? 0.0 :
+                 tankvolume(pr, i, hyd->NodeHead[net->Tank[i].Node]));
+        }
+    } while (hstep > 0 && htime + hstep <= tmax);
+    return 0;
+}
+
+
+int buildincidence(AdjWork *w)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns error code
+**  Purpose: builds the lists of links incident to each node and
+**           the node-to-tank map
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &w->pr->network;
+
+    int i, n1, n2;
+    int *pos;
+
+    w->adjStart = (int *)calloc(net->Nnodes + 2, sizeof(int));
+    w->adjLink = (int *)calloc(2 * net->Nlinks + 1, sizeof(int));
+    w->tankOf = (int *)calloc(net->Nnodes + 1, sizeof(int));
+    pos = (int *)calloc(net->Nnodes + 2, sizeof(int));
+    if (!w->adjStart || !w->adjLink || !w->tankOf || !pos)
+    {
+        FREE(pos);
+        return 101;
+    }
+
+    for (i = 1; i <= net->Nlinks; i++)
+    {
+        w->adjStart[net->Link[i].N1 + 1]++;
+        w->adjStart[net->Link[i].N2 + 1]++;
+    }
+    for (i = 1; i <= net->Nnodes + 1; i++) w->adjStart[i] += w->adjStart[i - 1];
+    memcpy(pos, w->adjStart, (net->Nnodes + 2) * sizeof(int));
+    for (i = 1; i <= net->Nlinks; i++)
+    {
+        n1 = net->Link[i].N1;
+        n2 = net->Link[i].N2;
+        w->adjLink[pos[n1]++] = i;
+        w->adjLink[pos[n2]++] = i;
+    }
+    for (i = 1; i <= net->Ntanks; i++) w->tankOf[net->Tank[i].Node] = i;
+    free(pos);
+    return 0;
+}
+
+
+void freework(AdjWork *w)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: frees the work space of the backward pass
+**--------------------------------------------------------------
+*/
+{
+    FREE(w->per.Time);
+    FREE(w->per.Flow);
+    FREE(w->per.Open);
+    FREE(w->per.Inflow);
+    FREE(w->per.Volume);
+    FREE(w->adjStart);
+    FREE(w->adjLink);
+    FREE(w->tankOf);
+    FREE(w->head);
+    FREE(w->cells);
+    FREE(w->table);
+    FREE(w->stack);
+}
+
+
+int findperiod(AdjPeriods *per, double t)
+/*
+**--------------------------------------------------------------
+**  Input:   t = time (sec)
+**  Output:  returns index of the hydraulic period containing t
+**  Purpose: finds the hydraulic period of a given time
+**
+**  Notes:   Water that passes a node at the start of a period
+**           arrived during the previous period, so the start time
+**           is assigned to the previous period.
+**--------------------------------------------------------------
+*/
+{
+    int lo = 0, hi = per->Count - 1, mid;
+
+    while (lo < hi)
+    {
+        mid = (lo + hi + 1) / 2;
+        if ((double)per->Time[mid] < t) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+
+int findcell(AdjWork *w, int node, int bin)
+/*
+**--------------------------------------------------------------
+**  Input:   node = node index
+**           bin = time bin index
+**  Output:  returns index of the cell (or -1 if out of memory)
+**  Purpose: finds (or creates) the cell of a node and a time bin
+**--------------------------------------------------------------
+*/
+{
+    unsigned int h;
+    int c, n;
+    AdjCell *cell;
+
+    h = ((unsigned int)node * 2654435761u) ^ ((unsigned int)bin * 40503u);
+    h &= (unsigned int)(w->tablesize - 1);
+    while ((c = w->table[h]) >= 0)
+    {
+        if (w->cells[c].Node == node && w->cells[c].Bin == bin) return c;
+        h = (h + 1) & (unsigned int)(w->tablesize - 1);
+    }
+
+    // Create a new cell
+    if (w->ncells == w->maxcells)
+    {
+        n = MAX(1024, 2 * w->maxcells);
+        cell = (AdjCell *)realloc(w->cells, n * sizeof(AdjCell));
+        if (cell == NULL) return -1;
+        w->cells = cell;
+        w->maxcells = n;
+    }
+    c = w->ncells++;
+    cell = &w->cells[c];
+    memset(cell, 0, sizeof(AdjCell));
+    cell->Node = node;
+    cell->Bin = bin;
+    cell->Slot = (int)h;
+    w->table[h] = c;
+
+    // Add the cell to its time bin (the current bin is processed via the stack)
+    cell->Next = -1;
+    if (bin < w->curBin)
+    {
+        cell->Next = w->head[bin];
+        w->head[bin] = c;
+    }
+
+    // Keep the hash table at most half full
+    if (2 * w->ncells > w->tablesize && growtable(w)) return -1;
+    return c;
+}
+
+
+int growtable(AdjWork *w)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns 1 if out of memory, 0 otherwise
+**  Purpose: doubles the size of the hash table of cells
+**--------------------------------------------------------------
+*/
+{
+    int c, n = 2 * w->tablesize;
+    unsigned int h;
+    int *table = (int *)malloc(n * sizeof(int));
+
+    if (table == NULL) return 1;
+    for (c = 0; c < n; c++) table[c] = -1;
+    for (c = 0; c < w->ncells; c++)
+    {
+        h = ((unsigned int)w->cells[c].Node * 2654435761u) ^
+            ((unsigned int)w->cells[c].Bin * 40503u);
+        h &= (unsigned int)(n - 1);
+        while (table[h] >= 0) h = (h + 1) & (unsigned int)(n - 1);
+        table[h] = c;
+        w->cells[c].Slot = (int)h;
+    }
+    free(w->table);
+    w->table = table;
+    w->tablesize = n;
+    return 0;
+}
+
+
+int push(AdjWork *w, int c)
+/*
+**--------------------------------------------------------------
+**  Input:   c = cell index
+**  Output:  returns error code
+**  Purpose: queues a cell of the current time bin for processing
+**--------------------------------------------------------------
+*/
+{
+    int n, *stack;
+
+    if (w->cells[c].Queued) return 0;
+    if (w->nstack == w->maxstack)
+    {
+        n = MAX(256, 2 * w->maxstack);
+        stack = (int *)realloc(w->stack, n * sizeof(int));
+        if (stack == NULL) return 101;
+        w->stack = stack;
+        w->maxstack = n;
+    }
+    w->stack[w->nstack++] = c;
+    w->cells[c].Queued = TRUE;
+    return 0;
+}
+
+
+int addweight(AdjWork *w, int node, double t, double weight)
+/*
+**--------------------------------------------------------------
+**  Input:   node = node index
+**           t = time (sec)
+**           weight = fraction of the sampled water
+**  Output:  returns error code
+**  Purpose: adds sampled water that passed a node at a given time
+**--------------------------------------------------------------
+*/
+{
+    int c, bin;
+
+    // Water that was already in the network at time zero is not traced
+    if (t < 0.0 || weight <= w->floor) return 0;
+
+    bin = (int)(t / w->binSize);
+    if (bin > w->curBin) bin = w->curBin;
+    c = findcell(w, node, bin);
+    if (c < 0) return 101;
+    w->cells[c].Pw += weight;
+    w->cells[c].Pwt += weight * t;
+    if (bin == w->curBin) return push(w, c);
+    return 0;
+}
+
+
+int propagate(AdjWork *w, int node, double t, double weight)
+/*
+**--------------------------------------------------------------
+**  Input:   node = node index
+**           t = time (sec) at which the water passed the node
+**           weight = fraction of the sampled water
+**  Output:  returns error code
+**  Purpose: routes water that passed a node to the upstream nodes
+**           (or to an earlier time at the same node)
+**--------------------------------------------------------------
+*/
+{
+    Project *pr = w->pr;
+    Network *net = &pr->network;
+    AdjPeriods *per = &w->per;
+
+    int i, k, m, up, back, tank, errcode = 0;
+    double q, qin, f, t0, v;
+    Slink *link;
+    REAL4 *flow;
+    char *open;
+
+    k = findperiod(per, t);
+    flow = &per->Flow[(size_t)k * net->Nlinks - 1];
+    open = &per->Open[(size_t)k * net->Nlinks - 1];
+
+    // Total inflow into the node
+    qin = per->Inflow[(size_t)k * net->Nnodes + node - 1];
+    for (i = w->adjStart[node]; i < w->adjStart[node + 1]; i++)
+    {
+        m = w->adjLink[i];
+        if (!open[m]) continue;
+        if (net->Link[m].N2 == node && flow[m] > AZERO) qin += flow[m];
+        else if (net->Link[m].N1 == node && flow[m] < -AZERO) qin -= flow[m];
+    }
+
+    // Water of a reservoir does not come from anywhere else
+    tank = w->tankOf[node];
+    f = 1.0;
+    if (tank > 0)
+    {
+        if (net->Tank[tank].A == 0.0) return 0;
+
+        // Water of a (completely mixed) tank entered it during the last
+        // time bin or was already in it before
+        v = per->Volume[(size_t)k * net->Ntanks + tank - 1];
+        if (k + 1 < per->Count)
+        {
+            v += (per->Volume[(size_t)(k + 1) * net->Ntanks + tank - 1] - v) *
+                 (t - per->Time[k]) / (per->Time[k + 1] - per->Time[k]);
+        }
+        f = (v > 0.0) ? MIN(1.0, qin * w->binSize / v) : 1.0;
+        if (f < 1.0)
+        {
+            errcode = addweight(w, node, t - w->binSize, weight * (1.0 - f));
+        }
+    }
+
+    // Stagnant water stays at the node
+    if (qin <= AZERO)
+    {
+        if (tank == 0) errcode = addweight(w, node, t - w->binSize, weight);
+        return errcode;
+    }
+
+    // Split the water among the links that flow into the node --
+    // the share of external inflows is not traced any further
+    for (i = w->adjStart[node]; i < w->adjStart[node + 1] && !errcode; i++)
+    {
+        m = w->adjLink[i];
+        if (!open[m]) continue;
+        link = &net->Link[m];
+        q = flow[m];
+        if (link->N2 == node && q > AZERO) up = link->N1;
+        else if (link->N1 == node && q < -AZERO)
+        {
+            up = link->N2;
+            q = -q;
+        }
+        else continue;
+
+        // Time at which the water entered a pipe (pumps & valves have
+        // no travel time) -- water that entered it while the flow was
+        // reversed came from this node
+        t0 = t;
+        back = FALSE;
+        if (link->Type <= PIPE)
+        {
+            t0 = entrytime(w, m, k, t, (up == link->N1) ? 1.0 : -1.0, &back);
+        }
+        errcode = addweight(w, back ? node : up, t0, weight * f * q / qin);
+    }
+    return errcode;
+}
+
+
+double entrytime(AdjWork *w, int m, int k, double t, double dir, int *back)
+/*
+**--------------------------------------------------------------
+**  Input:   m = pipe index
+**           k = hydraulic period containing t
+**           t = time (sec) at which the water left the pipe
+**           dir = 1 if the water flowed from the pipe's start to its
+**                 end node, -1 if in the opposite direction
+**  Output:  back = TRUE if the water entered the pipe through the
+**                  node it left it by (i.e. while the flow was
+**                  reversed), FALSE if through the other node
+**           returns time (sec) at which the water entered the pipe
+**           (negative if it was already in the pipe at time zero)
+**  Purpose: finds the entry time of the water leaving a pipe by
+**           following it backwards through the flows of the
+**           hydraulic periods
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &w->pr->network;
+    AdjPeriods *per = &w->per;
+    Slink *link = &net->Link[m];
+
+    double q, tstart;
+    double v = link->Len * PI * SQR(link->Diam) / 4.0;
+    double x = 0.0;     // Volume between the water and the exit node
+
+    *back = FALSE;
+    for (; k >= 0; k--)
+    {
+        tstart = (double)per->Time[k];
+        q = dir * per->Flow[(size_t)k * net->Nlinks + m - 1];
+        if (!per->Open[(size_t)k * net->Nlinks + m - 1] || ABS(q) <= AZERO)
+        {
+            q = 0.0;
+        }
+        if (q > 0.0 && x + q * (t - tstart) >= v) return t - (v - x) / q;
+        if (q < 0.0 && x + q * (t - tstart) <= 0.0)
+        {
+            *back = TRUE;
+            return t + x / q;
+        }
+        x += q * (t - tstart);
+        t = tstart;
+    }
+    return -1.0;
+}
+
+
+void resetcells(AdjWork *w)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: removes all cells of the last backward pass
+**--------------------------------------------------------------
+*/
+{
+    int c;
+
+    for (c = 0; c < w->ncells; c++) w->table[w->cells[c].Slot] = -1;
+    w->ncells = 0;
+    w->nstack = 0;
+}
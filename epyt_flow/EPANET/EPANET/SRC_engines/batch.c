@@ -0,0 +1,434 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       batch.c
+ Description:  simulates a batch of scenarios (variants of a network that
+               differ in their time parameters and in timed changes of
+               node & link properties) on a pool of threads
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define NULLDEVICE "NUL"
+#else
+#include <pthread.h>
+#define NULLDEVICE "/dev/null"
+#endif
+
+#include "epanet2_2.h"
+#include "types.h"
+#include "funcs.h"
+
+// Batch of scenarios shared by all threads
+typedef struct {
+    const char   *inpfile;       // Input file of the network
+    int      nscenarios;         // Number of scenarios
+    const long   *params;        // Duration, hyd. & report step of each scenario
+    const int    *evstart;       // First event of each scenario
+    const long   *evtimes;       // Time of each event
+    const int    *evtargets;     // Object type, index & property of each event
+    const double *evvalues;      // New property value of each event
+    int      nsensors;           // Number of sensors
+    const int    *sensors;       // Object type, index & property of each sensor
+    int      nperiods;           // Number of reporting periods
+    double   *values;            // Sensor readings (scenarios x periods x sensors)
+    int      *errcodes;          // Error code of each scenario
+    int      next;               // Next scenario to be simulated
+#ifdef _WIN32
+    CRITICAL_SECTION lock;       // Lock of the next scenario
+#else
+    pthread_mutex_t  lock;
+#endif
+} BatchJob;
+
+// Work space of a thread -- a private copy of the network that
+// simulates one scenario after the other
+typedef struct {
+    BatchJob *job;               // Batch of scenarios
+    Project  *pr;                // Private copy of the network
+    Times    times;              // Original time parameters
+    double   *saved;             // Original values of the event targets
+    int      maxevents;          // Max. number of events of a scenario
+    int      errcode;            // Error code
+} BatchWorker;
+
+// Local functions
+static int   nextscenario(BatchJob *);
+static int   getvalue(Project *, const int *, double *);
+static int   setvalue(Project *, const int *, double);
+static int   runscenario(BatchWorker *, int);
+static void  runscenarios(BatchWorker *);
+
+#ifdef _WIN32
+static DWORD WINAPI workerthread(LPVOID);
+#else
+static void *workerthread(void *);
+#endif
+
+
+int runbatch(Project *pr, int nscenarios, const long *params, const int *evstart,
+             const long *evtimes, const int *evtargets, const double *evvalues,
+             int nsensors, const int *sensors, int nperiods, int nthreads,
+             double *values, int *errcodes)
+/*
+**--------------------------------------------------------------
+**  Input:   nscenarios = number of scenarios
+**           params = duration, hydraulic & reporting time step of
+**                    each scenario (values <= 0 keep the network's)
+**           evstart = index of the first event of each scenario
+**                     (nscenarios + 1 entries)
+**           evtimes = time of each event (sorted per scenario)
+**           evtargets = object type (EN_NODE or EN_LINK), index and
+**                       property of each event
+**           evvalues = new property value of each event
+**           nsensors = number of sensors
+**           sensors = object type, index and property of each sensor
+**           nperiods = number of reporting periods
+**           nthreads = number of threads
+**  Output:  values = sensor readings of each scenario and reporting
+**                    period (nscenarios x nperiods x nsensors)
+**           errcodes = error code of each scenario
+**  Returns: error code
+**  Purpose: simulates a batch of variants of the project's network
+**
+**  Notes:   The network is written to a temporary input file that
+**           is read by each thread into its own project. A thread
+**           simulates one scenario after the other -- time parameters
+**           and the properties changed by events are restored before
+**           the next scenario. Readings of periods that are not
+**           simulated are left unchanged.
+**--------------------------------------------------------------
+*/
+{
+    int i, errcode = 0;
+    char inpfile[MAXFNAME + 1];
+    BatchJob job;
+    BatchWorker *workers;
+
+    // Write the network to a temporary input file
+    getTmpName(inpfile);
+    if (strlen(inpfile) == 0) return 303;
+    errcode = saveinpfile(pr, inpfile);
+    if (errcode)
+    {
+        remove(inpfile);
+        return errcode;
+    }
+
+    job.inpfile = inpfile;
+    job.nscenarios = nscenarios;
+    job.params = params;
+    job.evstart = evstart;
+    job.evtimes = evtimes;
+    job.evtargets = evtargets;
+    job.evvalues = evvalues;
+    job.nsensors = nsensors;
+    job.sensors = sensors;
+    job.nperiods = nperiods;
+    job.values = values;
+    job.errcodes = errcodes;
+    job.next = 0;
+#ifdef _WIN32
+    InitializeCriticalSection(&job.lock);
+#else
+    pthread_mutex_init(&job.lock, NULL);
+#endif
+
+    nthreads = MAX(1, MIN(nthreads, nscenarios));
+    workers = (BatchWorker *)calloc(nthreads, sizeof(BatchWorker));
+    if (workers == NULL) errcode = 101;
+    else
+    {
+        for (i = 0; i < nthreads; i++) workers[i].job = &job;
+
+        // Simulate all scenarios
+        if (nthreads == 1) runscenarios(&workers[0]);
+        else
+        {
+#ifdef _WIN32
+            HANDLE *threads = (HANDLE *)calloc(nthreads, sizeof(HANDLE));
+            if (threads == NULL) errcode = 101;
+            else
+            {
+                for (i = 0; i < nthreads; i++)
+                {
+                    threads[i] = CreateThread(NULL, 0, workerthread, &workers[i], 0, NULL);
+                    if (threads[i] == NULL) runscenarios(&workers[i]);
+                }
+                for (i = 0; i < nthreads; i++)
+                {
+                    if (threads[i] == NULL) continue;
+                    WaitForSingleObject(threads[i], INFINITE);
+                    CloseHandle(threads[i]);
+                }
+                free(threads);
+            }
+#else
+            pthread_t *threads = (pthread_t *)calloc(nthreads, sizeof(pthread_t));
+            int *started = (int *)calloc(nthreads, sizeof(int));
+            if (threads == NULL || started == NULL) errcode = 101;
+            else
+            {
+                for (i = 0; i < nthreads; i++)
+                {
+                    started[i] = pthread_create(&threads[i], NULL, workerthread,
+                                                &workers[i]) == 0;
+                    if (!started[i]) runscenarios(&workers[i]);
+                }
+                for (i = 0; i < nthreads; i++)
+                {
+                    if (started[i]) pthread_join(threads[i], NULL);
+                }
+            }
+            free(threads);
+            free(started);
+#endif
+        }
+
+        for (i = 0; i < nthreads; i++)
+        {
+            if (!errcode) errcode = workers[i].errcode;
+        }
+        free(workers);
+    }
+
+#ifdef _WIN32
+    DeleteCriticalSection(&job.lock);
+#else
+    pthread_mutex_destroy(&job.lock);
+#endif
+    remove(inpfile);
+    return errcode;
+}
+
+
+int nextscenario(BatchJob *job)
+/*
+**--------------------------------------------------------------
+**  Input:   job = batch of scenarios
+**  Output:  returns index of the next scenario to be simulated
+**           or -1 if all scenarios have been taken
+**  Purpose: hands out the scenarios of a batch to the threads
+**--------------------------------------------------------------
+*/
+{
+    int s = -1;
+
+#ifdef _WIN32
+    EnterCriticalSection(&job->lock);
+#else
+    pthread_mutex_lock(&job->lock);
+#endif
+    if (job->next < job->nscenarios) s = job->next++;
+#ifdef _WIN32
+    LeaveCriticalSection(&job->lock);
+#else
+    pthread_mutex_unlock(&job->lock);
+#endif
+    return s;
+}
+
+
+int getvalue(Project *pr, const int *target, double *value)
+/*
+**--------------------------------------------------------------
+**  Input:   target = object type, index and property
+**  Output:  value = property value
+**  Returns: error code
+**  Purpose: reads a node or link property
+**--------------------------------------------------------------
+*/
+{
+    if (target[0] == EN_NODE) return EN_getnodevalue(pr, target[1], target[2], value);
+    if (target[0] == EN_LINK) return EN_getlinkvalue(pr, target[1], target[2], value);
+    return 251;
+}
+
+
+int setvalue(Project *pr, const int *target, double value)
+/*
+**--------------------------------------------------------------
+**  Input:   target = object type, index and property
+**           value = new property value
+**  Output:  none
+**  Returns: error code
+**  Purpose: changes a node or link property
+**--------------------------------------------------------------
+*/
+{
+    if (target[0] == EN_NODE) return EN_setnodevalue(pr, target[1], target[2], value);
+    if (target[0] == EN_LINK) return EN_setlinkvalue(pr, target[1], target[2], value);
+    return 251;
+}
+
+
+void runscenarios(BatchWorker *w)
+/*
+**--------------------------------------------------------------
+**  Input:   w = thread work space
+**  Output:  none
+**  Purpose: loads a private copy of the network and simulates
+**           scenarios until all scenarios of the batch are taken
+**--------------------------------------------------------------
+*/
+{
+    BatchJob *job = w->job;
+    int s, errcode;
+
+    // Load the network -- nothing is reported
+    errcode = EN_createproject(&w->pr);
+    if (!errcode)
+    {
+        errcode = EN_open(w->pr, job->inpfile, NULLDEVICE, "");
+        w->pr->report.Messageflag = FALSE;
+    }
+
+    // Work space for restoring the properties changed by events
+    if (!errcode)
+    {
+        w->times = w->pr->times;
+        for (s = 0; s < job->nscenarios; s++)
+        {
+            w->maxevents = MAX(w->maxevents, job->evstart[s + 1] - job->evstart[s]);
+        }
+        w->saved = (double *)calloc(MAX(1, w->maxevents), sizeof(double));
+        if (w->saved == NULL) errcode = 101;
+    }
+
+    // Simulate one scenario after the other
+    if (errcode) w->errcode = errcode;
+    while ((s = nextscenario(job)) >= 0)
+    {
+        job->errcodes[s] = errcode ? errcode : runscenario(w, s);
+    }
+
+    FREE(w->saved);
+    if (w->pr)
+    {
+        EN_close(w->pr);
+        EN_deleteproject(w->pr);
+        w->pr = NULL;
+    }
+}
+
+
+int runscenario(BatchWorker *w, int s)
+/*
+**--------------------------------------------------------------
+**  Input:   w = thread work space
+**           s = scenario index
+**  Output:  returns error code (or the largest warning code)
+**  Purpose: simulates a single scenario
+**--------------------------------------------------------------
+*/
+{
+    BatchJob *job = w->job;
+    Project  *pr = w->pr;
+    Times    *time = &pr->times;
+
+    int i, j, k, period, err, errcode = 0;
+    int first = job->evstart[s];
+    int nevents = job->evstart[s + 1] - first;
+    int qual = pr->quality.Qualflag != NONE;
+    const long *params = &job->params[3 * s];
+    long t = 0, tstep = 0, qstep, hstep;
+    double *values;
+
+    // Time parameters of the scenario
+    *time = w->times;
+    if (params[2] > 0) errcode = EN_settimeparam(pr, EN_REPORTSTEP, params[2]);
+    if (params[1] > 0 && !errcode) errcode = EN_settimeparam(pr, EN_HYDSTEP, params[1]);
+    if (params[0] > 0 && !errcode) errcode = EN_settimeparam(pr, EN_DURATION, params[0]);
+    if (errcode) return errcode;
+    hstep = time->Hstep;
+
+    // Hydraulics are passed to the quality solver in memory
+    errcode = EN_openH(pr);
+    if (!errcode && qual) errcode = EN_openQ(pr);
+    if (!errcode) errcode = EN_initH(pr, EN_NOSAVE);
+    if (!errcode && qual) errcode = EN_initQ(pr, EN_NOSAVE);
+
+    // Save the original values of all properties changed by events
+    for (i = 0; i < nevents && errcode <= 100; i++)
+    {
+        errcode = MAX(errcode, getvalue(pr, &job->evtargets[3 * (first + i)], &w->saved[i]));
+    }
+
+    k = 0;
+    while (errcode <= 100)
+    {
+        // Apply all events up to the current time
+        for (; k < nevents && job->evtimes[first + k] <= t && errcode <= 100; k++)
+        {
+            i = first + k;
+            errcode = MAX(errcode, setvalue(pr, &job->evtargets[3 * i], job->evvalues[i]));
+        }
+        if (errcode > 100) break;
+
+        // Solve the current time step
+        err = EN_runH(pr, &t);
+        if (err <= 100 && qual) err = MAX(err, EN_runQ(pr, &qstep));
+        errcode = MAX(errcode, err);
+        if (errcode > 100) break;
+
+        // Read the sensors at reporting times
+        if (t >= time->Rstart && (t - time->Rstart) % time->Rstep == 0)
+        {
+            period = (int)((t - time->Rstart) / time->Rstep);
+            if (period < job->nperiods)
+            {
+                values = &job->values[((size_t)s * job->nperiods + period) * job->nsensors];
+                for (j = 0; j < job->nsensors; j++)
+                {
+                    errcode = MAX(errcode, getvalue(pr, &job->sensors[3 * j], &values[j]));
+                }
+            }
+        }
+
+        // Advance to the next time step -- which must not pass the next event
+        if (k < nevents && job->evtimes[first + k] > t)
+        {
+            time->Hstep = MIN(hstep, job->evtimes[first + k] - t);
+        }
+        err = EN_nextH(pr, &tstep);
+        time->Hstep = hstep;
+        if (err <= 100 && qual) err = MAX(err, EN_nextQ(pr, &qstep));
+        errcode = MAX(errcode, err);
+        if (tstep <= 0) break;
+        t += tstep;
+    }
+
+    // Restore the changed properties (in reverse order)
+    for (i = MIN(k, nevents) - 1; i >= 0; i--)
+    {
+        setvalue(pr, &job->evtargets[3 * (first + i)], w->saved[i]);
+    }
+    if (qual) EN_closeQ(pr);
+    EN_closeH(pr);
+    return errcode;
+}
+
+
+#ifdef _WIN32
+DWORD WINAPI workerthread(LPVOID arg)
+{
+    runscenarios((BatchWorker *)arg);
+    return 0;
+}
+#else
+void *workerthread(void *arg)
+{
+    runscenarios((BatchWorker *)arg);
+    return NULL;
+}
+#endif
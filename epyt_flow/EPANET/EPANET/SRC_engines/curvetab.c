@@ -0,0 +1,363 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       curvetab.c
+ Description:  lookup tables that locate the segment of a data curve in
+               constant time while the hydraulic solver is open
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "funcs.h"
+
+// Curves with fewer points are scanned directly
+#define MINTABPTS  4
+
+// Number of bins per curve segment
+#define BINSPERSEG 2
+
+// Local functions
+static int   buildtab(Scurvetab *, Scurve *);
+static void  freetab(Scurvetab *);
+static int   issorted(int, double *);
+static int   *buildbins(int, double *, int *, double *);
+static int   findpoint(int, double *, int, double, int *, double);
+static Scurvetab *gettab(Project *, int);
+
+
+int  opencurvetabs(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns error code
+**  Purpose: builds the lookup tables of all curves
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+
+    int i, errcode = 0;
+
+    hyd->CurveTab = (Scurvetab *)calloc(net->Ncurves + 1, sizeof(Scurvetab));
+    if (hyd->CurveTab == NULL) return 101;
+    hyd->Ncurvetabs = net->Ncurves;
+    for (i = 1; i <= net->Ncurves && !errcode; i++)
+    {
+        errcode = buildtab(&hyd->CurveTab[i], &net->Curve[i]);
+    }
+    return errcode;
+}
+
+
+void  closecurvetabs(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: frees the lookup tables of all curves
+**--------------------------------------------------------------
+*/
+{
+    Hydraul *hyd = &pr->hydraul;
+
+    int i;
+
+    if (hyd->CurveTab == NULL) return;
+    for (i = 1; i <= hyd->Ncurvetabs; i++) freetab(&hyd->CurveTab[i]);
+    FREE(hyd->CurveTab);
+    hyd->Ncurvetabs = 0;
+}
+
+
+int  updatecurvetab(Project *pr, int i)
+/*
+**--------------------------------------------------------------
+**  Input:   i = curve index
+**  Output:  returns error code
+**  Purpose: rebuilds the lookup table of a curve whose data
+**           points have changed
+**--------------------------------------------------------------
+*/
+{
+    Scurvetab *tab = gettab(pr, i);
+
+    if (tab == NULL) return 0;
+    freetab(tab);
+    return buildtab(tab, &pr->network.Curve[i]);
+}
+
+
+int  buildtab(Scurvetab *tab, Scurve *curve)
+/*
+**--------------------------------------------------------------
+**  Input:   curve = data curve
+**  Output:  tab = lookup table of the curve
+**           returns error code
+**  Purpose: builds the lookup table of a curve
+**--------------------------------------------------------------
+*/
+{
+    int k, n = curve->Npts;
+    double *x = curve->X,
+           *y = curve->Y;
+
+    memset(tab, 0, sizeof(Scurvetab));
+    if (n < MINTABPTS) return 0;
+
+    // Intercept & slope of each segment (k-1, k) -- exactly as
+    // they are computed from the curve's points
+    tab->H0 = (double *)calloc(n, sizeof(double));
+    tab->R = (double *)calloc(n, sizeof(double));
+    if (tab->H0 == NULL || tab->R == NULL)
+    {
+        freetab(tab);
+        return 101;
+    }
+    for (k = 1; k < n; k++)
+    {
+        tab->R[k] = (y[k] - y[k - 1]) / (x[k] - x[k - 1]);
+        tab->H0[k] = y[k - 1] - tab->R[k] * x[k - 1];
+    }
+
+    // Bins of the x-values and, for inverse lookups (e.g. of
+    // volume curves), of the y-values
+    tab->Xbin = buildbins(n, x, &tab->Nxbins, &tab->Xscale);
+    tab->Ybin = buildbins(n, y, &tab->Nybins, &tab->Yscale);
+    if ((tab->Nxbins > 0 && tab->Xbin == NULL) ||
+        (tab->Nybins > 0 && tab->Ybin == NULL))
+    {
+        freetab(tab);
+        return 101;
+    }
+    tab->Npts = n;
+    return 0;
+}
+
+
+void  freetab(Scurvetab *tab)
+/*
+**--------------------------------------------------------------
+**  Input:   tab = lookup table of a curve
+**  Output:  none
+**  Purpose: frees the lookup table of a curve
+**--------------------------------------------------------------
+*/
+{
+    FREE(tab->Xbin);
+    FREE(tab->Ybin);
+    FREE(tab->H0);
+    FREE(tab->R);
+    memset(tab, 0, sizeof(Scurvetab));
+}
+
+
+int  *buildbins(int n, double *x, int *nbins, double *scale)
+/*
+**--------------------------------------------------------------
+**  Input:   n = number of values
+**           x = values
+**  Output:  nbins = number of bins (0 if values are not sorted)
+**           scale = bins per unit of x
+**           returns the first value at or above the lower bound
+**           of each bin
+**  Purpose: divides the range of sorted values into bins of
+**           equal width
+**--------------------------------------------------------------
+*/
+{
+    int b, k, *bin;
+    double width;
+
+    *nbins = 0;
+    *scale = 0.0;
+    if (!issorted(n, x)) return NULL;
+
+    *nbins = BINSPERSEG * (n - 1);
+    bin = (int *)calloc(*nbins, sizeof(int));
+    if (bin == NULL) return NULL;
+    width = (x[n - 1] - x[0]) / *nbins;
+    *scale = 1.0 / width;
+    for (b = 0, k = 0; b < *nbins; b++)
+    {
+        while (k < n - 1 && x[k] < x[0] + b * width) k++;
+        bin[b] = k;
+    }
+    return bin;
+}
+
+
+int  issorted(int n, double *x)
+/*
+**--------------------------------------------------------------
+**  Input:   n = number of values
+**           x = values
+**  Output:  returns TRUE if the values are non-decreasing and
+**           span a range of non-zero width
+**--------------------------------------------------------------
+*/
+{
+    int k;
+
+    for (k = 1; k < n; k++)
+    {
+        if (!(x[k] >= x[k - 1])) return FALSE;
+    }
+    return x[n - 1] > x[0];
+}
+
+
+double  curvetabsize(Scurve *curve)
+/*
+**--------------------------------------------------------------
+**  Input:   curve = data curve
+**  Output:  returns number of bytes
+**  Purpose: computes the size of the lookup table that is built
+**           for a curve when the hydraulic solver is opened
+**--------------------------------------------------------------
+*/
+{
+    int n = curve->Npts;
+    double bytes;
+
+    if (n < MINTABPTS) return 0.0;
+    bytes = 2.0 * n * sizeof(double);
+    if (issorted(n, curve->X)) bytes += (double)BINSPERSEG * (n - 1) * sizeof(int);
+    if (issorted(n, curve->Y)) bytes += (double)BINSPERSEG * (n - 1) * sizeof(int);
+    return bytes;
+}
+
+
+int  findpoint(int n, double *x, int nbins, double scale, int *bin, double xx)
+/*
+**--------------------------------------------------------------
+**  Input:   n = number of values
+**           x = values
+**           nbins = number of bins (0 if none)
+**           scale = bins per unit of x
+**           bin = first value at or above each bin
+**           xx = value to be located
+**  Output:  returns index of the first value at or above xx
+**           (or n if there is none)
+**  Purpose: locates a value in a sorted array
+**
+**  Note:    the bin gives a starting point that is at most a few
+**           values off -- the result is always the same as that
+**           of a linear scan.
+**--------------------------------------------------------------
+*/
+{
+    int b, k;
+
+    if (nbins == 0)
+    {
+        for (k = 0; k < n && x[k] < xx; k++);
+        return k;
+    }
+    if (!(xx > x[0])) return 0;
+    if (xx > x[n - 1]) return n;
+    b = (int)((xx - x[0]) * scale);
+    if (b >= nbins) b = nbins - 1;
+    k = bin[b];
+    while (k > 0 && x[k - 1] >= xx) k--;
+    while (x[k] < xx) k++;
+    return k;
+}
+
+
+Scurvetab *gettab(Project *pr, int i)
+/*
+**--------------------------------------------------------------
+**  Input:   i = curve index
+**  Output:  returns lookup table of curve i (NULL if none)
+**  Purpose: finds the lookup table of a curve
+**--------------------------------------------------------------
+*/
+{
+    Hydraul *hyd = &pr->hydraul;
+
+    if (hyd->CurveTab == NULL || i > hyd->Ncurvetabs) return NULL;
+    return &hyd->CurveTab[i];
+}
+
+
+void  curvesegment(Project *pr, int i, double x, double *h0, double *r)
+/*
+**--------------------------------------------------------------
+**  Input:   i = curve index
+**           x = x-value (in curve units)
+**  Output:  h0 = intercept of the curve segment containing x
+**           r = slope of the curve segment containing x
+**  Purpose: finds the linear segment of a curve that brackets
+**           a given x-value (the first or last segment if x is
+**           off the curve)
+**--------------------------------------------------------------
+*/
+{
+    Scurve *curve = &pr->network.Curve[i];
+    Scurvetab *tab = gettab(pr, i);
+
+    int k1, k2, npts = curve->Npts;
+    double *xs = curve->X,
+           *ys = curve->Y;
+
+    if (tab != NULL && tab->Npts > 0)
+    {
+        k2 = findpoint(npts, xs, tab->Nxbins, tab->Xscale, tab->Xbin, x);
+        if (k2 == 0) k2++;
+        else if (k2 == npts) k2--;
+        *r = tab->R[k2];
+        *h0 = tab->H0[k2];
+        return;
+    }
+
+    k2 = findpoint(npts, xs, 0, 0.0, NULL, x);
+    if (k2 == 0) k2++;
+    else if (k2 == npts)  k2--;
+    k1 = k2 - 1;
+    *r = (ys[k2] - ys[k1]) / (xs[k2] - xs[k1]);
+    *h0 = ys[k1] - (*r) * xs[k1];
+}
+
+
+double  curvevalue(Project *pr, int i, int inverse, double xx)
+/*
+**--------------------------------------------------------------
+**  Input:   i = curve index
+**           inverse = TRUE if the curve is interpolated
+**                     from its y-values to its x-values
+**           xx = specified x-value (or y-value if inverse)
+**  Output:  returns y-value (or x-value if inverse) on the
+**           curve at xx
+**  Purpose: interpolates a curve like interp() does, but locates
+**           the segment containing xx by the curve's lookup table
+**--------------------------------------------------------------
+*/
+{
+    Scurve *curve = &pr->network.Curve[i];
+    Scurvetab *tab = gettab(pr, i);
+
+    int k, m = curve->Npts - 1;
+    double dx, dy;
+    double *x = inverse ? curve->Y : curve->X,
+           *y = inverse ? curve->X : curve->Y;
+
+    if (tab == NULL || tab->Npts == 0) return interp(curve->Npts, x, y, xx);
+
+    if (xx <= x[0]) return y[0];
+    if (inverse) k = findpoint(m + 1, x, tab->Nybins, tab->Yscale, tab->Ybin, xx);
+    else         k = findpoint(m + 1, x, tab->Nxbins, tab->Xscale, tab->Xbin, xx);
+    if (k == 0 || k > m) return y[m];
+    dx = x[k] - x[k - 1];
+    dy = y[k] - y[k - 1];
+    if (ABS(dx) < TINY) return y[k];
+    return y[k] - (x[k] - xx) * dy / dx;
+}
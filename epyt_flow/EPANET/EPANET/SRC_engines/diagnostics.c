@@ -0,0 +1,171 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       diagnostics.c
+ Description:  recording of per time step hydraulic solver diagnostics
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "funcs.h"
+
+
+int diagenable(Project *pr, int enabled)
+/*
+**--------------------------------------------------------------
+**  Input:   enabled = TRUE to start recording, FALSE to stop it
+**  Output:  returns error code
+**  Purpose: turns the recording of hydraulic step diagnostics
+**           on or off; both discard all previous records
+**--------------------------------------------------------------
+*/
+{
+    Diagnostics *diag = &pr->diagnostics;
+
+    diag->Enabled = FALSE;
+    diag->Count = 0;
+    diag->Capacity = 0;
+    diag->StatusSize = 0;
+    free(diag->Steps);
+    free(diag->StartStatus);
+    diag->Steps = NULL;
+    diag->StartStatus = NULL;
+    if (!enabled) return 0;
+
+    diag->Capacity = 256;
+    diag->Steps = (SHydDiag *)calloc(diag->Capacity, sizeof(SHydDiag));
+    if (diag->Steps == NULL)
+    {
+        diag->Capacity = 0;
+        return 101;
+    }
+    diag->Enabled = TRUE;
+    return 0;
+}
+
+
+int diagstart(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns error code
+**  Purpose: remembers the state of the network at the start of
+**           a hydraulic time step
+**--------------------------------------------------------------
+*/
+{
+    Diagnostics *diag = &pr->diagnostics;
+    StatusType *status;
+
+    // Links might have been added since the last step
+    if (diag->StatusSize != pr->network.Nlinks + 1)
+    {
+        status = (StatusType *)realloc(diag->StartStatus,
+                                       (pr->network.Nlinks + 1) * sizeof(StatusType));
+        if (status == NULL) return 101;
+        diag->StartStatus = status;
+        diag->StatusSize = pr->network.Nlinks + 1;
+    }
+
+    memcpy(diag->StartStatus, pr->hydraul.LinkStatus,
+           (pr->network.Nlinks + 1) * sizeof(StatusType));
+    diag->BadValves = 0;
+    diag->Flags = EN_DIAGFLAG_REUSEDORDER;
+    return 0;
+}
+
+
+int diagrecord(Project *pr, long t, int iter, double relerr)
+/*
+**--------------------------------------------------------------
+**  Input:   t = current hydraulic time (sec)
+**           iter = number of hydraulic trials taken
+**           relerr = convergence error of the solution
+**  Output:  returns error code
+**  Purpose: appends the diagnostics of the hydraulic time step
+**           just solved to the diagnostics stream
+**--------------------------------------------------------------
+*/
+{
+    Diagnostics *diag = &pr->diagnostics;
+    Hydraul *hyd = &pr->hydraul;
+    SHydDiag *step, *steps;
+    int i;
+
+    // Grow the stream if needed
+    if (diag->Count == diag->Capacity)
+    {
+        steps = (SHydDiag *)realloc(diag->Steps,
+                                    2 * diag->Capacity * sizeof(SHydDiag));
+        if (steps == NULL) return 101;
+        diag->Steps = steps;
+        diag->Capacity *= 2;
+    }
+
+    step = &diag->Steps[diag->Count++];
+    step->Time = t;
+    step->Iterations = iter;
+    step->RelativeError = relerr;
+    step->MaxHeadError = hyd->MaxHeadError;
+    step->MaxFlowChange = hyd->MaxFlowChange;
+    step->StatusChanges = 0;
+    for (i = 1; i <= pr->network.Nlinks; i++)
+    {
+        if (hyd->LinkStatus[i] != diag->StartStatus[i]) step->StatusChanges++;
+    }
+    step->BadValves = diag->BadValves;
+    step->DeficientNodes = hyd->DeficientNodes;
+    step->DemandReduction = hyd->DemandReduction;
+    step->Flags = diag->Flags;
+    return 0;
+}
+
+
+int diaggetfield(Project *pr, int field, int count, double *values)
+/*
+**--------------------------------------------------------------
+**  Input:   field = a diagnostics field (see EN_DiagnosticField)
+**           count = size of values
+**  Output:  values = field of the first count recorded steps
+**  Returns: error code
+**  Purpose: retrieves one field of the diagnostics stream
+**--------------------------------------------------------------
+*/
+{
+    Diagnostics *diag = &pr->diagnostics;
+    SHydDiag *step;
+    int i;
+
+    if (field < EN_DIAG_TIME || field > EN_DIAG_FLAGS) return 251;
+    if (count > diag->Count) count = diag->Count;
+    for (i = 0; i < count; i++)
+    {
+        step = &diag->Steps[i];
+        switch (field)
+        {
+        case EN_DIAG_TIME:            values[i] = (double)step->Time; break;
+        case EN_DIAG_ITERATIONS:      values[i] = step->Iterations; break;
+        case EN_DIAG_RELERROR:        values[i] = step->RelativeError; break;
+        case EN_DIAG_MAXHEADERROR:
+            values[i] = step->MaxHeadError * pr->Ucf[HEAD];
+            break;
+        case EN_DIAG_MAXFLOWCHANGE:
+            values[i] = step->MaxFlowChange * pr->Ucf[FLOW];
+            break;
+        case EN_DIAG_STATUSCHANGES:   values[i] = step->StatusChanges; break;
+        case EN_DIAG_BADVALVES:       values[i] = step->BadValves; break;
+        case EN_DIAG_DEFICIENTNODES:  values[i] = step->DeficientNodes; break;
+        case EN_DIAG_DEMANDREDUCTION: values[i] = step->DemandReduction; break;
+        case EN_DIAG_FLAGS:           values[i] = step->Flags; break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,600 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       edit.c
+ Description:  network edit transactions that batch the addition and
+               deletion of network objects
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+
+/*
+  While an edit transaction is active:
+  - the arrays of nodes, links, tanks, pumps, valves, patterns and
+    controls grow geometrically instead of by one item per addition,
+  - adding a junction only renumbers the links connected to tanks and
+    reservoirs instead of scanning all links,
+  - deleted nodes and links are only removed from the ID hash tables
+    (a deleted node's links are deleted along with it). They keep
+    their index until the transaction is committed, at which point all
+    of them are removed in a single pass over the network.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "funcs.h"
+#include "hash.h"
+
+// Local functions
+static void  *resize(void *, int, size_t, int *);
+static char  *resizeflags(char *, int, int, int *);
+static int   compactnetwork(Project *);
+
+
+int beginedit(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns error code
+**  Purpose: starts a network edit transaction
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Quality *qual = &pr->quality;
+    Editor  *ed = &pr->editor;
+    int k, errcode = 0;
+
+    if (ed->Active) return 263;
+
+    // Bring all arrays to a known capacity
+    net->Node = resize(net->Node, net->Nnodes, sizeof(Snode), &errcode);
+    hyd->NodeDemand = resize(hyd->NodeDemand, net->Nnodes, sizeof(double), &errcode);
+    hyd->NodeHead = resize(hyd->NodeHead, net->Nnodes, sizeof(double), &errcode);
+    qual->NodeQual = resize(qual->NodeQual, net->Nnodes, sizeof(double), &errcode);
+    net->Link = resize(net->Link, net->Nlinks, sizeof(Slink), &errcode);
+    hyd->LinkFlow = resize(hyd->LinkFlow, net->Nlinks, sizeof(double), &errcode);
+    hyd->LinkSetting = resize(hyd->LinkSetting, net->Nlinks, sizeof(double), &errcode);
+    hyd->LinkStatus = resize(hyd->LinkStatus, net->Nlinks, sizeof(StatusType), &errcode);
+    net->Tank = resize(net->Tank, net->Ntanks, sizeof(Stank), &errcode);
+    net->Pump = resize(net->Pump, net->Npumps, sizeof(Spump), &errcode);
+    net->Valve = resize(net->Valve, net->Nvalves, sizeof(Svalve), &errcode);
+    net->Pattern = resize(net->Pattern, net->Npats, sizeof(Spattern), &errcode);
+    net->Control = resize(net->Control, net->Ncontrols, sizeof(Scontrol), &errcode);
+    if (errcode) return errcode;
+    ed->NodeCapacity = net->Nnodes;
+    ed->LinkCapacity = net->Nlinks;
+    ed->TankCapacity = net->Ntanks;
+    ed->PumpCapacity = net->Npumps;
+    ed->ValveCapacity = net->Nvalves;
+    ed->PatCapacity = net->Npats;
+    ed->ControlCapacity = net->Ncontrols;
+
+    // Allocate the transaction's bookkeeping arrays
+    ed->NodeDeleted = (char *)calloc(net->Nnodes + 1, sizeof(char));
+    ed->LinkDeleted = (char *)calloc(net->Nlinks + 1, sizeof(char));
+    ed->IsTankLink = (char *)calloc(net->Nlinks + 1, sizeof(char));
+    ed->TankLinks = (int *)calloc(net->Nlinks + 1, sizeof(int));
+    ERRCODE(MEMCHECK(ed->NodeDeleted));
+    ERRCODE(MEMCHECK(ed->LinkDeleted));
+    ERRCODE(MEMCHECK(ed->IsTankLink));
+    ERRCODE(MEMCHECK(ed->TankLinks));
+    if (errcode)
+    {
+        freeedit(pr);
+        return errcode;
+    }
+
+    // Collect the links connected to tanks & reservoirs
+    ed->Ndeleted = 0;
+    ed->NtankLinks = 0;
+    for (k = 1; k <= net->Nlinks; k++) editaddlink(pr, k);
+    ed->Active = TRUE;
+    return 0;
+}
+
+
+int commitedit(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns error code
+**  Purpose: ends a network edit transaction by removing all
+**           deleted objects and trimming the network's arrays
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Quality *qual = &pr->quality;
+    Parser  *parser = &pr->parser;
+    int errcode = 0;
+
+    if (!pr->editor.Active) return 0;
+
+    // Remove all deleted nodes & links at once
+    if (pr->editor.Ndeleted > 0) errcode = compactnetwork(pr);
+
+    // Trim arrays to the size of the edited network
+    if (!errcode)
+    {
+        net->Node = resize(net->Node, net->Nnodes, sizeof(Snode), &errcode);
+        hyd->NodeDemand = resize(hyd->NodeDemand, net->Nnodes, sizeof(double), &errcode);
+        hyd->NodeHead = resize(hyd->NodeHead, net->Nnodes, sizeof(double), &errcode);
+        qual->NodeQual = resize(qual->NodeQual, net->Nnodes, sizeof(double), &errcode);
+        net->Link = resize(net->Link, net->Nlinks, sizeof(Slink), &errcode);
+        hyd->LinkFlow = resize(hyd->LinkFlow, net->Nlinks, sizeof(double), &errcode);
+        hyd->LinkSetting = resize(hyd->LinkSetting, net->Nlinks, sizeof(double), &errcode);
+        hyd->LinkStatus = resize(hyd->LinkStatus, net->Nlinks, sizeof(StatusType), &errcode);
+        net->Tank = resize(net->Tank, net->Ntanks, sizeof(Stank), &errcode);
+        net->Pump = resize(net->Pump, net->Npumps, sizeof(Spump), &errcode);
+        net->Valve = resize(net->Valve, net->Nvalves, sizeof(Svalve), &errcode);
+        net->Pattern = resize(net->Pattern, net->Npats, sizeof(Spattern), &errcode);
+        net->Control = resize(net->Control, net->Ncontrols, sizeof(Scontrol), &errcode);
+    }
+    parser->MaxNodes = net->Nnodes;
+    parser->MaxLinks = net->Nlinks;
+    parser->MaxPats = net->Npats;
+    parser->MaxControls = net->Ncontrols;
+
+    // The adjacency lists are rebuilt by the next solver that is opened
+    freeadjlists(net);
+    freeedit(pr);
+    return errcode;
+}
+
+
+void freeedit(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: frees the memory used by a network edit transaction
+**--------------------------------------------------------------
+*/
+{
+    Editor *ed = &pr->editor;
+
+    free(ed->NodeDeleted);
+    free(ed->LinkDeleted);
+    free(ed->IsTankLink);
+    free(ed->TankLinks);
+    memset(ed, 0, sizeof(Editor));
+}
+
+
+int editreservenode(Project *pr, int nodeType)
+/*
+**--------------------------------------------------------------
+**  Input:   nodeType = type of the node to be added
+**  Output:  returns error code
+**  Purpose: makes room for one more node in the node arrays
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Quality *qual = &pr->quality;
+    Editor  *ed = &pr->editor;
+    int cap, errcode = 0;
+
+    if (net->Nnodes + 1 > ed->NodeCapacity)
+    {
+        cap = MAX(net->Nnodes + 1, 2 * ed->NodeCapacity);
+        net->Node = resize(net->Node, cap, sizeof(Snode), &errcode);
+        hyd->NodeDemand = resize(hyd->NodeDemand, cap, sizeof(double), &errcode);
+        hyd->NodeHead = resize(hyd->NodeHead, cap, sizeof(double), &errcode);
+        qual->NodeQual = resize(qual->NodeQual, cap, sizeof(double), &errcode);
+        ed->NodeDeleted = resizeflags(ed->NodeDeleted, ed->NodeCapacity, cap, &errcode);
+        if (errcode) return errcode;
+        ed->NodeCapacity = cap;
+    }
+    if (nodeType != EN_JUNCTION && net->Ntanks + 1 > ed->TankCapacity)
+    {
+        cap = MAX(net->Ntanks + 1, 2 * ed->TankCapacity);
+        net->Tank = resize(net->Tank, cap, sizeof(Stank), &errcode);
+        if (errcode) return errcode;
+        ed->TankCapacity = cap;
+    }
+    return 0;
+}
+
+
+int editreservelink(Project *pr, int linkType)
+/*
+**--------------------------------------------------------------
+**  Input:   linkType = type of the link to be added
+**  Output:  returns error code
+**  Purpose: makes room for one more link in the link arrays
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Editor  *ed = &pr->editor;
+    int cap, errcode = 0;
+
+    if (net->Nlinks + 1 > ed->LinkCapacity)
+    {
+        cap = MAX(net->Nlinks + 1, 2 * ed->LinkCapacity);
+        net->Link = resize(net->Link, cap, sizeof(Slink), &errcode);
+        hyd->LinkFlow = resize(hyd->LinkFlow, cap, sizeof(double), &errcode);
+        hyd->LinkSetting = resize(hyd->LinkSetting, cap, sizeof(double), &errcode);
+        hyd->LinkStatus = resize(hyd->LinkStatus, cap, sizeof(StatusType), &errcode);
+        ed->TankLinks = resize(ed->TankLinks, cap, sizeof(int), &errcode);
+        ed->LinkDeleted = resizeflags(ed->LinkDeleted, ed->LinkCapacity, cap, &errcode);
+        ed->IsTankLink = resizeflags(ed->IsTankLink, ed->LinkCapacity, cap, &errcode);
+        if (errcode) return errcode;
+        ed->LinkCapacity = cap;
+    }
+    if (linkType == PUMP && net->Npumps + 1 > ed->PumpCapacity)
+    {
+        cap = MAX(net->Npumps + 1, 2 * ed->PumpCapacity);
+        net->Pump = resize(net->Pump, cap, sizeof(Spump), &errcode);
+        if (errcode) return errcode;
+        ed->PumpCapacity = cap;
+    }
+    if (linkType > PUMP && net->Nvalves + 1 > ed->ValveCapacity)
+    {
+        cap = MAX(net->Nvalves + 1, 2 * ed->ValveCapacity);
+        net->Valve = resize(net->Valve, cap, sizeof(Svalve), &errcode);
+        if (errcode) return errcode;
+        ed->ValveCapacity = cap;
+    }
+    return 0;
+}
+
+
+int editreservepattern(Project *pr, int n)
+/*
+**--------------------------------------------------------------
+**  Input:   n = number of time patterns to be added
+**  Output:  returns error code
+**  Purpose: makes room for n more time patterns
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Editor  *ed = &pr->editor;
+    int cap, errcode = 0;
+
+    if (net->Npats + n > ed->PatCapacity)
+    {
+        cap = MAX(net->Npats + n, 2 * ed->PatCapacity);
+        net->Pattern = resize(net->Pattern, cap, sizeof(Spattern), &errcode);
+        if (errcode) return errcode;
+        ed->PatCapacity = cap;
+    }
+    return 0;
+}
+
+
+int editreservecontrol(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns error code
+**  Purpose: makes room for one more simple control
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Editor  *ed = &pr->editor;
+    int cap, errcode = 0;
+
+    if (net->Ncontrols + 1 > ed->ControlCapacity)
+    {
+        cap = MAX(net->Ncontrols + 1, 2 * ed->ControlCapacity);
+        net->Control = resize(net->Control, cap, sizeof(Scontrol), &errcode);
+        if (errcode) return errcode;
+        ed->ControlCapacity = cap;
+    }
+    return 0;
+}
+
+
+void editinsertjunc(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: renumbers the tanks & reservoirs referred to by the
+**           transaction and by links after a new junction was
+**           inserted at position Njuncs of the Node array
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Editor  *ed = &pr->editor;
+    int i, k;
+    Slink *link;
+
+    for (i = net->Nnodes; i >= net->Njuncs; i--)
+    {
+        ed->NodeDeleted[i + 1] = ed->NodeDeleted[i];
+    }
+    ed->NodeDeleted[net->Njuncs] = FALSE;
+
+    // Only links connected to a tank or reservoir refer to a
+    // node index beyond the new junction
+    for (k = 0; k < ed->NtankLinks; k++)
+    {
+        link = &net->Link[ed->TankLinks[k]];
+        if (link->N1 >= net->Njuncs) link->N1 += 1;
+        if (link->N2 >= net->Njuncs) link->N2 += 1;
+    }
+}
+
+
+void editaddlink(Project *pr, int index)
+/*
+**--------------------------------------------------------------
+**  Input:   index = link index
+**  Output:  none
+**  Purpose: registers a link whose end nodes have changed if it
+**           is connected to a tank or reservoir
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Editor  *ed = &pr->editor;
+    Slink *link = &net->Link[index];
+
+    if (ed->IsTankLink[index]) return;
+    if (link->N1 > net->Njuncs || link->N2 > net->Njuncs)
+    {
+        ed->IsTankLink[index] = TRUE;
+        ed->TankLinks[ed->NtankLinks] = index;
+        ed->NtankLinks++;
+    }
+}
+
+
+int editdeletenode(Project *pr, int index)
+/*
+**--------------------------------------------------------------
+**  Input:   index = node index
+**  Output:  returns error code
+**  Purpose: marks a node (and the links connected to it) for
+**           deletion when the transaction is committed
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Editor  *ed = &pr->editor;
+    int k;
+    Slink *link;
+
+    if (ed->NodeDeleted[index]) return 203;
+    hashtable_delete(net->NodeHashTable, net->Node[index].ID);
+    ed->NodeDeleted[index] = TRUE;
+    ed->Ndeleted++;
+
+    // The node's links are deleted right away so that they can no
+    // longer be found or referred to during the transaction
+    for (k = 1; k <= net->Nlinks; k++)
+    {
+        link = &net->Link[k];
+        if (!ed->LinkDeleted[k] && (link->N1 == index || link->N2 == index))
+        {
+            editdeletelink(pr, k);
+        }
+    }
+    return 0;
+}
+
+
+int editdeletelink(Project *pr, int index)
+/*
+**--------------------------------------------------------------
+**  Input:   index = link index
+**  Output:  returns error code
+**  Purpose: marks a link for deletion when the transaction is
+**           committed
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Editor  *ed = &pr->editor;
+
+    if (ed->LinkDeleted[index]) return 204;
+    hashtable_delete(net->LinkHashTable, net->Link[index].ID);
+    ed->LinkDeleted[index] = TRUE;
+    ed->Ndeleted++;
+    return 0;
+}
+
+
+int compactnetwork(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns error code
+**  Purpose: removes all nodes & links marked for deletion and
+**           renumbers the remaining objects in a single pass
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Quality *qual = &pr->quality;
+    Editor  *ed = &pr->editor;
+
+    int i, k, n, njuncs;
+    int *nodemap, *linkmap;
+    Snode *node;
+    Slink *link;
+    Scontrol *control;
+
+    // New index of each node & link (0 if deleted)
+    nodemap = (int *)calloc(net->Nnodes + 1, sizeof(int));
+    linkmap = (int *)calloc(net->Nlinks + 1, sizeof(int));
+    if (nodemap == NULL || linkmap == NULL)
+    {
+        free(nodemap);
+        free(linkmap);
+        return 101;
+    }
+
+    // Compact the Node array
+    n = 0;
+    njuncs = 0;
+    for (i = 1; i <= net->Nnodes; i++)
+    {
+        node = &net->Node[i];
+        if (ed->NodeDeleted[i])
+        {
+            freedemands(node);
+            free(node->S);
+            free(node->Comment);
+            continue;
+        }
+        n++;
+        if (i <= net->Njuncs) njuncs++;
+        nodemap[i] = n;
+        if (n < i)
+        {
+            net->Node[n] = *node;
+            hashtable_update(net->NodeHashTable, net->Node[n].ID, n);
+        }
+    }
+    net->Nnodes = n;
+    net->Njuncs = njuncs;
+
+    // Compact the Tank array
+    n = 0;
+    for (i = 1; i <= net->Ntanks; i++)
+    {
+        k = nodemap[net->Tank[i].Node];
+        if (k == 0) continue;
+        n++;
+        net->Tank[n] = net->Tank[i];
+        net->Tank[n].Node = k;
+    }
+    net->Ntanks = n;
+
+    // Compact the Link array
+    n = 0;
+    for (k = 1; k <= net->Nlinks; k++)
+    {
+        link = &net->Link[k];
+        if (ed->LinkDeleted[k])
+        {
+            if (link->Type <= PIPE) net->Npipes--;
+            free(link->Comment);
+            freelinkvertices(link);
+            continue;
+        }
+        n++;
+        linkmap[k] = n;
+        if (n < k)
+        {
+            net->Link[n] = *link;
+            hashtable_update(net->LinkHashTable, net->Link[n].ID, n);
+        }
+        net->Link[n].N1 = nodemap[net->Link[n].N1];
+        net->Link[n].N2 = nodemap[net->Link[n].N2];
+    }
+    net->Nlinks = n;
+
+    // Compact the Pump & Valve arrays
+    n = 0;
+    for (i = 1; i <= net->Npumps; i++)
+    {
+        k = linkmap[net->Pump[i].Link];
+        if (k == 0) continue;
+        n++;
+        net->Pump[n] = net->Pump[i];
+        net->Pump[n].Link = k;
+    }
+    net->Npumps = n;
+    n = 0;
+    for (i = 1; i <= net->Nvalves; i++)
+    {
+        k = linkmap[net->Valve[i].Link];
+        if (k == 0) continue;
+        n++;
+        net->Valve[n] = net->Valve[i];
+        net->Valve[n].Link = k;
+    }
+    net->Nvalves = n;
+
+    // Delete controls containing a deleted node or link
+    n = 0;
+    for (i = 1; i <= net->Ncontrols; i++)
+    {
+        control = &net->Control[i];
+        if (control->Link > 0 && linkmap[control->Link] == 0) continue;
+        if (control->Node > 0 && nodemap[control->Node] == 0) continue;
+        n++;
+        net->Control[n] = *control;
+        net->Control[n].Link = linkmap[net->Control[n].Link];
+        net->Control[n].Node = nodemap[net->Control[n].Node];
+    }
+    net->Ncontrols = n;
+
+    // Make the same adjustments to rule-based controls (see RULES.C)
+    remaprules(pr, nodemap, linkmap);
+
+    // A trace node can not be deleted
+    qual->TraceNode = nodemap[qual->TraceNode];
+
+    free(nodemap);
+    free(linkmap);
+    return 0;
+}
+
+
+void *resize(void *a, int n, size_t size, int *errcode)
+/*
+**--------------------------------------------------------------
+**  Input:   a = a 1-based array
+**           n = number of items the array must hold
+**           size = size of a single item
+**  Output:  errcode = set to 101 if out of memory
+**  Returns: the reallocated array (or the original one if an
+**           error occurred)
+**--------------------------------------------------------------
+*/
+{
+    void *b;
+
+    if (*errcode) return a;
+    b = realloc(a, (n + 1) * size);
+    if (b == NULL)
+    {
+        *errcode = 101;
+        return a;
+    }
+    return b;
+}
+
+
+char *resizeflags(char *a, int oldn, int n, int *errcode)
+/*
+**--------------------------------------------------------------
+**  Input:   a = a 1-based array of flags holding oldn items
+**           n = number of items the array must hold
+**  Output:  errcode = set to 101 if out of memory
+**  Returns: the reallocated array with all new flags cleared
+**--------------------------------------------------------------
+*/
+{
+    char *b;
+
+    if (*errcode) return a;
+    b = (char *)realloc(a, (n + 1) * sizeof(char));
+    if (b == NULL)
+    {
+        *errcode = 101;
+        return a;
+    }
+    if (n > oldn) memset(b + oldn + 1, 0, n - oldn);
+    return b;
+}
@@ -67,6 +67,9 @@ int DLLEXPORT EN_deleteproject(EN_Project p)
     remove(p->TmpHydFname);
     remove(p->TmpOutFname);
     remove(p->TmpStatFname);
+    proftrace(&p->profile, 0);
+    diagenable(p, FALSE);
+    warmstartenable(p, FALSE);
     free(p);
     return 0;
 }
@@ -344,6 +347,7 @@ int DLLEXPORT EN_saveinpfile(EN_Project p, const char *filename)
  */
 {
   if (!p->Openflag) return 102;
+  if (p->editor.Active) return 263;
   return saveinpfile(p, filename);
 }
 
@@ -359,6 +363,8 @@ int DLLEXPORT EN_close(EN_Project p)
     // Free all project data
     if (p->Openflag) writetime(p, FMT105);
     freedata(p);
+    warmstartclear(p);
+    observeclear(p);
 
     // Close output file
     closeoutfile(p);
@@ -487,6 +493,7 @@ int DLLEXPORT EN_openH(EN_Project p)
     p->hydraul.OpenHflag = FALSE;
     p->outfile.SaveHflag = FALSE;
     if (!p->Openflag) return 102;
+    if (p->editor.Active) return 263;
 
     // Check that previously saved hydraulics file not in use
     if (p->outfile.Hydflag == USE) return 107;
@@ -655,6 +662,163 @@ int DLLEXPORT EN_usehydfile(EN_Project p, const char *filename)
     return errcode;
 }
 
+int DLLEXPORT EN_getleaksignatures(EN_Project p, int nCandidates, const int *nodes,
+                                   const double *emitterCoeffs, int nSensors,
+                                   const int *sensors, int nThreads, double *pressureDrops)
+/*----------------------------------------------------------------
+**  Input:   nCandidates = number of candidate leaks
+**           nodes = junction index of each candidate leak
+**           emitterCoeffs = emitter coeff. of each candidate leak
+**                           (flow units / (pressure units)^N)
+**           nSensors = number of sensor nodes
+**           sensors = index of each sensor node
+**           nThreads = number of threads
+**  Output:  pressureDrops = pressure drop at each sensor node caused
+**                           by each candidate leak (nSensors x
+**                           nCandidates, row-major)
+**  Returns: error code (or warning 1 if some candidates did not
+**           converge)
+**  Purpose: computes the pressure signatures of candidate leaks
+**           relative to the current hydraulic solution
+**----------------------------------------------------------------
+*/
+{
+    Network *net = &p->network;
+    Hydraul *hyd = &p->hydraul;
+
+    int i, errcode;
+    double *ke;
+
+    if (!p->Openflag) return 102;
+    if (!hyd->OpenHflag) return 103;
+    if (nCandidates <= 0 || nSensors <= 0 || nThreads <= 0) return 202;
+    for (i = 0; i < nCandidates; i++)
+    {
+        if (nodes[i] <= 0 || nodes[i] > net->Njuncs) return 203;
+        if (emitterCoeffs[i] <= 0.0) return 202;
+    }
+    for (i = 0; i < nSensors; i++)
+    {
+        if (sensors[i] <= 0 || sensors[i] > net->Nnodes) return 203;
+    }
+
+    // Convert emitter coeffs. to internal head loss coeffs.
+    ke = (double *)calloc(nCandidates, sizeof(double));
+    if (ke == NULL) return 101;
+    for (i = 0; i < nCandidates; i++)
+    {
+        ke[i] = pow((p->Ucf[FLOW] / emitterCoeffs[i]), hyd->Qexp) / p->Ucf[PRESSURE];
+    }
+
+    errcode = leaksignatures(p, nCandidates, nodes, ke, nSensors, sensors,
+                             nThreads, pressureDrops);
+    free(ke);
+    return errcode;
+}
+
+int DLLEXPORT EN_getbackwardinfluence(EN_Project p, int nSensors, const int *sensors,
+                                      int nTimes, const double *times, long binSize,
+                                      double minWeight, int capacity, int *count,
+                                      int *rows, int *nodes, double *injTimes,
+                                      double *weights)
+/*----------------------------------------------------------------
+**  Input:   nSensors = number of sensor nodes
+**           sensors = index of each sensor node
+**           nTimes = number of sample times
+**           times = sample times (sec)
+**           binSize = length of a time bin (sec)
+**           minWeight = smallest weight that is reported
+**           capacity = length of the output arrays
+**  Output:  count = number of entries of the influence matrix
+**           rows = sample of each entry (sensor x nTimes + time)
+**           nodes = node index of each entry
+**           injTimes = mean time (sec) at which the sampled water
+**                      passed the node
+**           weights = fraction of the sampled water that passed
+**                     the node
+**  Returns: error code
+**  Purpose: computes the influence of all upstream nodes on the
+**           water sampled at sensor nodes by a backward pass over
+**           the saved hydraulic results
+**----------------------------------------------------------------
+*/
+{
+    Network *net = &p->network;
+
+    int i;
+
+    if (!p->Openflag) return 102;
+    if (p->editor.Active) return 263;
+    if (p->hydraul.OpenHflag || p->quality.OpenQflag) return 108;
+    if (p->outfile.HydFile == NULL || !p->outfile.SaveHflag) return 104;
+    if (nSensors <= 0 || nTimes <= 0 || binSize <= 0 || minWeight < 0.0 ||
+        capacity < 0) return 202;
+    for (i = 0; i < nSensors; i++)
+    {
+        if (sensors[i] <= 0 || sensors[i] > net->Nnodes) return 203;
+    }
+
+    return backwardinfluence(p, nSensors, sensors, nTimes, times, binSize,
+                             minWeight, capacity, count, rows, nodes, injTimes,
+                             weights);
+}
+
+int DLLEXPORT EN_runbatch(EN_Project p, int nScenarios, const long *params,
+                          const int *eventStart, const long *eventTimes,
+                          const int *eventTargets, const double *eventValues,
+                          int nSensors, const int *sensors, int nPeriods,
+                          int nThreads, double *values, int *errcodes)
+/*----------------------------------------------------------------
+**  Input:   nScenarios = number of scenarios
+**           params = duration, hydraulic & reporting time step (sec)
+**                    of each scenario (values <= 0 keep the network's)
+**           eventStart = index of the first event of each scenario
+**                        (nScenarios + 1 entries)
+**           eventTimes = time (sec) of each event
+**           eventTargets = object type (EN_NODE or EN_LINK), index and
+**                          property code of each event
+**           eventValues = new property value of each event
+**           nSensors = number of sensors
+**           sensors = object type, index and property code of each
+**                     sensor
+**           nPeriods = number of reporting periods
+**           nThreads = number of threads
+**  Output:  values = sensor readings (nScenarios x nPeriods x nSensors)
+**           errcodes = error code of each scenario
+**  Returns: error code
+**  Purpose: simulates a batch of variants of the project's network
+**           on a pool of threads
+**----------------------------------------------------------------
+*/
+{
+    Network *net = &p->network;
+
+    int i, n, nevents;
+    const int *target;
+
+    if (!p->Openflag) return 102;
+    if (p->hydraul.OpenHflag || p->quality.OpenQflag) return 108;
+    if (nScenarios <= 0 || nSensors < 0 || nPeriods < 0 || nThreads <= 0) return 202;
+    if (eventStart[0] != 0) return 202;
+    for (i = 0; i < nScenarios; i++)
+    {
+        if (eventStart[i + 1] < eventStart[i]) return 202;
+    }
+    nevents = eventStart[nScenarios];
+    for (i = 0; i < nevents + nSensors; i++)
+    {
+        target = (i < nevents) ? &eventTargets[3 * i] : &sensors[3 * (i - nevents)];
+        if (target[0] == EN_NODE) n = net->Nnodes;
+        else if (target[0] == EN_LINK) n = net->Nlinks;
+        else return 251;
+        if (target[1] <= 0 || target[1] > n) return 203;
+    }
+
+    return runbatch(p, nScenarios, params, eventStart, eventTimes, eventTargets,
+                    eventValues, nSensors, sensors, nPeriods, nThreads, values,
+                    errcodes);
+}
+
 /********************************************************************
 
     Water Quality Analysis Functions
@@ -721,6 +885,7 @@ int DLLEXPORT EN_openQ(EN_Project p)
     p->quality.OpenQflag = FALSE;
     p->outfile.SaveQflag = FALSE;
     if (!p->Openflag) return 102;
+    if (p->editor.Active) return 263;
     if (!p->hydraul.OpenHflag && !p->outfile.SaveHflag) return 104;
 
     // Open water quality solver
@@ -1093,6 +1258,325 @@ int DLLEXPORT EN_getresultindex(EN_Project p, int type, int index, int *value)
     return 0;
 }
 
+int DLLEXPORT EN_setprofiling(EN_Project p, int enabled)
+/*----------------------------------------------------------------
+**  Input:   enabled = 1 to enable profiling, 0 to disable it
+**  Output:  none
+**  Returns: error code
+**  Purpose: turns the timing of simulation phases on or off;
+**           enabling it clears all previously collected data
+**----------------------------------------------------------------
+*/
+{
+    if (enabled)
+    {
+        profreset(&p->profile);
+        p->profile.Enabled = TRUE;
+    }
+    else p->profile.Enabled = FALSE;
+    return 0;
+}
+
+int DLLEXPORT EN_getprofile(EN_Project p, int phase, double *seconds,
+                            int *calls, int *iterations)
+/*----------------------------------------------------------------
+**  Input:   phase = a simulation phase (see EN_ProfilePhase)
+**  Output:  seconds = accumulated wall clock time spent in the phase
+**           calls = number of times the phase was entered
+**           iterations = total hydraulic trials (EN_PROF_HYDSOLVE
+**                        only, 0 otherwise)
+**  Returns: error code
+**  Purpose: retrieves the profiling data collected for a phase
+**----------------------------------------------------------------
+*/
+{
+    Profile *prof = &p->profile;
+
+    *seconds = 0.0;
+    *calls = 0;
+    *iterations = 0;
+    if (phase < EN_PROF_RUNHYD || phase > EN_PROF_MIX) return 251;
+    *seconds = prof->Time[phase];
+    *calls = (int)prof->Calls[phase];
+    if (phase == EN_PROF_HYDSOLVE) *iterations = (int)prof->Iterations;
+    return 0;
+}
+
+int DLLEXPORT EN_settracing(EN_Project p, int size)
+/*----------------------------------------------------------------
+**  Input:   size = capacity (in events) of the trace ring buffer,
+**                  0 to disable tracing
+**  Output:  none
+**  Returns: error code
+**  Purpose: turns the recording of a timeline of simulation
+**           phases on or off; once the buffer is full the oldest
+**           events are overwritten
+**----------------------------------------------------------------
+*/
+{
+    return proftrace(&p->profile, size);
+}
+
+int DLLEXPORT EN_gettrace(EN_Project p, int maxEvents, int *phases,
+                          double *starts, double *durations, int *count,
+                          int *dropped)
+/*----------------------------------------------------------------
+**  Input:   maxEvents = size of the output arrays
+**  Output:  phases = simulation phase of each event (see EN_ProfilePhase)
+**           starts = time at which each phase was entered (sec)
+**           durations = time spent in each phase (sec)
+**           count = number of events retrieved
+**           dropped = number of events lost due to buffer overflow
+**  Returns: error code
+**  Purpose: retrieves (and removes) the oldest recorded trace events
+**----------------------------------------------------------------
+*/
+{
+    if (maxEvents < 0) return 202;
+    return profgettrace(&p->profile, maxEvents, phases, starts, durations,
+                        count, dropped);
+}
+
+int DLLEXPORT EN_gettraceclock(EN_Project p, double *seconds)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  seconds = current time of the clock used for tracing
+**  Returns: error code
+**  Purpose: reads the clock used to time stamp trace events
+**----------------------------------------------------------------
+*/
+{
+    if (!p->Openflag) return 102;
+    *seconds = profclock();
+    return 0;
+}
+
+int DLLEXPORT EN_setdiagnostics(EN_Project p, int enabled)
+/*----------------------------------------------------------------
+**  Input:   enabled = 1 to record hydraulic step diagnostics, 0 not to
+**  Output:  none
+**  Returns: error code
+**  Purpose: turns the recording of per time step convergence
+**           diagnostics on or off; both discard all previous records
+**----------------------------------------------------------------
+*/
+{
+    return diagenable(p, enabled);
+}
+
+int DLLEXPORT EN_getdiagnosticscount(EN_Project p, int *count)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  count = number of recorded hydraulic steps
+**  Returns: error code
+**  Purpose: retrieves the number of hydraulic steps recorded since
+**           the hydraulic solver was last initialized
+**----------------------------------------------------------------
+*/
+{
+    *count = p->diagnostics.Count;
+    return 0;
+}
+
+int DLLEXPORT EN_getdiagnostics(EN_Project p, int field, int count,
+                                double *values)
+/*----------------------------------------------------------------
+**  Input:   field = a diagnostics field (see EN_DiagnosticField)
+**           count = size of values
+**  Output:  values = the field's value for each recorded step
+**  Returns: error code
+**  Purpose: retrieves one field of the hydraulic step diagnostics
+**----------------------------------------------------------------
+*/
+{
+    if (count < 0) return 202;
+    return diaggetfield(p, field, count, values);
+}
+
+int DLLEXPORT EN_getmemoryusage(EN_Project p, int category, double *bytes)
+/*----------------------------------------------------------------
+**  Input:   category = a memory category (see EN_MemoryCategory)
+**  Output:  bytes = number of bytes currently held by the project
+**  Returns: error code
+**  Purpose: retrieves the amount of memory allocated by a project
+**           for one category of data
+**----------------------------------------------------------------
+*/
+{
+    *bytes = 0.0;
+    if (!p->Openflag) return 102;
+    return memusage(p, category, bytes);
+}
+
+int DLLEXPORT EN_getsolvermemory(EN_Project p, double *bytes)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  bytes = number of bytes that opening the solvers adds
+**  Returns: error code
+**  Purpose: estimates the memory the hydraulic and water quality
+**           solvers allocate when they are opened, without
+**           opening them
+**----------------------------------------------------------------
+*/
+{
+    *bytes = 0.0;
+    if (!p->Openflag) return 102;
+    return solvermemory(p, bytes);
+}
+
+int DLLEXPORT EN_setwarmstart(EN_Project p, int enabled)
+/*----------------------------------------------------------------
+**  Input:   enabled = 1 to warm start re-runs of the hydraulic
+**                     analysis, 0 not to
+**  Output:  none
+**  Returns: error code
+**  Purpose: turns warm starts on or off; both discard all recorded
+**           solutions and the cached sparse matrix structure
+**----------------------------------------------------------------
+*/
+{
+    if (p->hydraul.OpenHflag) return 262;
+    return warmstartenable(p, enabled);
+}
+
+int DLLEXPORT EN_setwarmstarttol(EN_Project p, double tolerance)
+/*----------------------------------------------------------------
+**  Input:   tolerance = largest flow change (in flow units) of the
+**                       first trial for which a warm started time
+**                       step is accepted (0 to always solve to full
+**                       accuracy)
+**  Output:  none
+**  Returns: error code
+**  Purpose: sets the tolerance of warm started time steps
+**----------------------------------------------------------------
+*/
+{
+    if (tolerance < 0.0) return 213;
+    p->warmstart.Tolerance = tolerance;
+    return 0;
+}
+
+int DLLEXPORT EN_getwarmstart(EN_Project p, int *steps, int *warmStarted,
+                              int *accepted, int *reused)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  steps = number of time steps solved since the hydraulic
+**                   solver was last initialized
+**           warmStarted = number of those steps that started from
+**                         the previous run's solution
+**           accepted = number of warm started steps that were
+**                      accepted within the tolerance
+**           reused = 1 if the sparse matrix structure of the
+**                    previous run was re-used, 0 if not
+**  Returns: error code
+**  Purpose: retrieves statistics of the current warm started run
+**----------------------------------------------------------------
+*/
+{
+    Warmstart *ws = &p->warmstart;
+
+    *steps = ws->Curr.Count;
+    *warmStarted = ws->Hits;
+    *accepted = ws->Accepted;
+    *reused = ws->Reused;
+    return 0;
+}
+
+int DLLEXPORT EN_setobservations(EN_Project p, int nSensors, const int *objects,
+                                 const int *indices, const int *properties,
+                                 const double *scales, int nTimes, const double *times,
+                                 const double *values)
+/*----------------------------------------------------------------
+**  Input:   nSensors = number of sensors
+**           objects = object type of each sensor (EN_NODE or EN_LINK)
+**           indices = node or link index of each sensor
+**           properties = measured property of each sensor
+**                        (see EN_NodeProperty and EN_LinkProperty)
+**           scales = scaling factor of each sensor's residuals
+**           nTimes = number of observed time points
+**           times = observed time points (sec, ascending)
+**           values = observed readings (nTimes x nSensors, NaN if
+**                    missing)
+**  Output:  none
+**  Returns: error code
+**  Purpose: sets the sensor readings the residuals of the hydraulic
+**           analysis are computed of (0 sensors to discard them)
+**----------------------------------------------------------------
+*/
+{
+    if (!p->Openflag) return 102;
+    if (p->hydraul.OpenHflag) return 262;
+    return observeset(p, nSensors, objects, indices, properties, scales, nTimes,
+                      times, values);
+}
+
+int DLLEXPORT EN_getresidual(EN_Project p, double *sum, int *count)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  sum = sum of the squared (scaled) residuals
+**           count = number of residuals
+**  Returns: error code
+**  Purpose: retrieves the residuals of the observed sensor readings
+**           since the hydraulic solver was last initialized
+**----------------------------------------------------------------
+*/
+{
+    *sum = p->observations.Sum;
+    *count = p->observations.Count;
+    return 0;
+}
+
+int DLLEXPORT EN_setqualrouting(EN_Project p, int mode)
+/*----------------------------------------------------------------
+**  Input:   mode = water quality routing method (see EN_QualRouting)
+**  Output:  none
+**  Returns: error code
+**  Purpose: selects how constituents are transported through pipes;
+**           reactive constituents (incl. water age) always use
+**           fixed quality time steps
+**----------------------------------------------------------------
+*/
+{
+    if (!p->Openflag) return 102;
+    if (p->quality.OpenQflag) return 262;
+    if (mode < EN_ROUTE_STEPS || mode > EN_ROUTE_EVENTS) return 202;
+    p->quality.RouteMode = mode;
+    return 0;
+}
+
+int DLLEXPORT EN_getqualrouting(EN_Project p, int *mode, int *events)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  mode = water quality routing method (see EN_QualRouting)
+**           events = number of node updates made by event-driven
+**                    routing since the quality solver was initialized
+**  Returns: error code
+**  Purpose: retrieves the water quality routing method
+**----------------------------------------------------------------
+*/
+{
+    *mode = p->quality.RouteMode;
+    *events = (int)p->quality.Events.Count;
+    return 0;
+}
+
+int DLLEXPORT EN_setfullsort(EN_Project p, int fullsort)
+/*----------------------------------------------------------------
+**  Input:   fullsort = 1 if all nodes are re-sorted whenever flow
+**                      directions change, 0 if only the nodes
+**                      affected by the changed links are re-ordered
+**  Output:  none
+**  Returns: error code
+**  Purpose: selects how the nodes are kept in topological order
+**           for water quality routing
+**----------------------------------------------------------------
+*/
+{
+    if (!p->Openflag) return 102;
+    p->quality.FullSort = (fullsort != 0);
+    return 0;
+}
+
 /********************************************************************
 
     Analysis Options Functions
@@ -1436,6 +1920,9 @@ int DLLEXPORT EN_setflowunits(EN_Project p, int units)
             net->Curve[i].X[j] = net->Curve[i].X[j] / xfactor;
             net->Curve[i].Y[j] = net->Curve[i].Y[j] / yfactor;
         }
+
+        // Rebuild curve's lookup table if hydraulics are open
+        if (updatecurvetab(p, i) > 0) return 101;
     }
     return 0;
 }
@@ -1726,6 +2213,57 @@ int DLLEXPORT EN_setqualtype(EN_Project p, int qualType, char *chemName,
     return 0;
 }
 
+/********************************************************************
+
+    Network Edit Functions
+
+********************************************************************/
+
+int DLLEXPORT EN_beginedit(EN_Project p)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Returns: error code
+**  Purpose: starts a transaction that batches the addition and
+**           deletion of nodes, links, patterns and controls
+**----------------------------------------------------------------
+*/
+{
+    // Cannot modify network structure while solvers are active
+    if (!p->Openflag) return 102;
+    if (p->hydraul.OpenHflag || p->quality.OpenQflag) return 262;
+    return beginedit(p);
+}
+
+int DLLEXPORT EN_commitedit(EN_Project p)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Returns: error code
+**  Purpose: ends an edit transaction by removing all deleted
+**           nodes & links and renumbering the remaining objects
+**----------------------------------------------------------------
+*/
+{
+    if (!p->Openflag) return 102;
+    return commitedit(p);
+}
+
+int DLLEXPORT EN_getediting(EN_Project p, int *editing)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  editing = 1 if an edit transaction is active, 0 if not
+**  Returns: error code
+**  Purpose: checks if an edit transaction is active
+**----------------------------------------------------------------
+*/
+{
+    *editing = 0;
+    if (!p->Openflag) return 102;
+    *editing = p->editor.Active;
+    return 0;
+}
+
 /********************************************************************
 
     Node Functions
@@ -1746,7 +2284,7 @@ int DLLEXPORT EN_addnode(EN_Project p, char *id, int nodeType, int *index)
     Hydraul  *hyd = &p->hydraul;
     Quality  *qual = &p->quality;
 
-    int i, nIdx, size;
+    int i, nIdx, size, errcode;
     Stank *tank;
     Snode *node;
     Scontrol *control;
@@ -1766,12 +2304,21 @@ int DLLEXPORT EN_addnode(EN_Project p, char *id, int nodeType, int *index)
     if (nodeType < EN_JUNCTION || nodeType > EN_TANK) return 251; 
 
     // Grow node-related arrays to accomodate the new node
-    size = (net->Nnodes + 2) * sizeof(Snode);
-    net->Node = (Snode *)realloc(net->Node, size);
-    size = (net->Nnodes + 2) * sizeof(double);
-    hyd->NodeDemand = (double *)realloc(hyd->NodeDemand, size);
-    qual->NodeQual = (double *)realloc(qual->NodeQual, size);
-    hyd->NodeHead = (double *)realloc(hyd->NodeHead, size);
+    // (geometrically during an edit transaction, see EDIT.C)
+    if (p->editor.Active)
+    {
+        errcode = editreservenode(p, nodeType);
+        if (errcode) return errcode;
+    }
+    else
+    {
+        size = (net->Nnodes + 2) * sizeof(Snode);
+        net->Node = (Snode *)realloc(net->Node, size);
+        size = (net->Nnodes + 2) * sizeof(double);
+        hyd->NodeDemand = (double *)realloc(hyd->NodeDemand, size);
+        qual->NodeQual = (double *)realloc(qual->NodeQual, size);
+        hyd->NodeHead = (double *)realloc(hyd->NodeHead, size);
+    }
 
     // Actions taken when a new Junction is added
     if (nodeType == EN_JUNCTION)
@@ -1796,7 +2343,9 @@ int DLLEXPORT EN_addnode(EN_Project p, char *id, int nodeType, int *index)
             net->Tank[i].Node += 1;
         }
         // shift indices of Links, if necessary
-        for (i = 1; i <= net->Nlinks; i++)
+        // (only links connected to tanks during an edit transaction)
+        if (p->editor.Active) editinsertjunc(p);
+        else for (i = 1; i <= net->Nlinks; i++)
         {
             if (net->Link[i].N1 > net->Njuncs - 1) net->Link[i].N1 += 1;
             if (net->Link[i].N2 > net->Njuncs - 1) net->Link[i].N2 += 1;
@@ -1820,7 +2369,10 @@ int DLLEXPORT EN_addnode(EN_Project p, char *id, int nodeType, int *index)
         net->Ntanks++;
 
         // resize tanks array
-        net->Tank = (Stank *)realloc(net->Tank, (net->Ntanks + 1) * sizeof(Stank));
+        if (!p->editor.Active)
+        {
+            net->Tank = (Stank *)realloc(net->Tank, (net->Ntanks + 1) * sizeof(Stank));
+        }
         tank = &net->Tank[net->Ntanks];
 
         // set default values for new tank or reservoir
@@ -1901,11 +2453,15 @@ int DLLEXPORT EN_deletenode(EN_Project p, int index, int actionCode)
         if (incontrols(p, NODE, index)) return 261;
         for (i = 1; i <= net->Nlinks; i++)
         {
+            if (p->editor.Active && p->editor.LinkDeleted[i]) continue;
             if (net->Link[i].N1 == index ||
                 net->Link[i].N2 == index)  return 259;
         }
     }
 
+    // Deletion is deferred until an edit transaction is committed
+    if (p->editor.Active) return editdeletenode(p, index);
+
     // Get a reference to the node & its type
     node = &net->Node[index];
     EN_getnodetype(p, index, &nodeType);
@@ -2254,6 +2810,31 @@ int DLLEXPORT EN_getnodevalue(EN_Project p, int index, int property, double *val
     return 0;
 }
 
+int DLLEXPORT EN_getnodevaluelist(EN_Project p, int property, int count,
+                                  const int *indices, double *values)
+/*----------------------------------------------------------------
+**  Input:   property = node property code (see EN_NodeProperty)
+**           count = number of nodes
+**           indices = node indices
+**  Output:  values = property value of each node
+**  Returns: error code
+**  Purpose: retrieves a property value for a list of nodes at once
+**----------------------------------------------------------------
+*/
+{
+    int i, errcode;
+
+    if (!p->Openflag) return 102;
+    if (count < 0) return 202;
+    if (count > 0 && (indices == NULL || values == NULL)) return 205;
+    for (i = 0; i < count; i++)
+    {
+        errcode = EN_getnodevalue(p, indices[i], property, &values[i]);
+        if (errcode > 100) return errcode;
+    }
+    return 0;
+}
+
 int DLLEXPORT EN_setnodevalue(EN_Project p, int index, int property, double value)
 /*----------------------------------------------------------------
 **  Input:   index = node index
@@ -2985,6 +3566,34 @@ int DLLEXPORT EN_setbasedemand(EN_Project p, int nodeIndex, int demandIndex,
     return 0;
 }
 
+int DLLEXPORT EN_setbasedemandlist(EN_Project p, int count, const int *nodes,
+                                   const int *demandIndices, const double *baseDemands)
+/*----------------------------------------------------------------
+**  Input:   count = number of demands
+**           nodes = node index of each demand
+**           demandIndices = demand category index of each demand
+**           baseDemands = baseline value of each demand
+**  Output:  none
+**  Returns: error code
+**  Purpose: sets the baseline values for a list of demand categories
+**           at once
+**----------------------------------------------------------------
+*/
+{
+    int i, errcode;
+
+    if (!p->Openflag) return 102;
+    if (count < 0) return 202;
+    if (count > 0 && (nodes == NULL || demandIndices == NULL ||
+        baseDemands == NULL)) return 205;
+    for (i = 0; i < count; i++)
+    {
+        errcode = EN_setbasedemand(p, nodes[i], demandIndices[i], baseDemands[i]);
+        if (errcode > 100) return errcode;
+    }
+    return 0;
+}
+
 int DLLEXPORT EN_getdemandname(EN_Project p, int nodeIndex, int demandIndex,
                                char *demandName)
 /*----------------------------------------------------------------
@@ -3152,16 +3761,25 @@ int DLLEXPORT EN_addlink(EN_Project p, char *id, int linkType,
     }
 
     // Grow link-related arrays to accomodate the new link
+    // (geometrically during an edit transaction, see EDIT.C)
+    if (p->editor.Active)
+    {
+        errcode = editreservelink(p, linkType);
+        if (errcode) return errcode;
+    }
     net->Nlinks++;
     p->parser.MaxLinks = net->Nlinks;
     n = net->Nlinks;
-    size = (n + 1) * sizeof(Slink);
-    net->Link = (Slink *)realloc(net->Link, size);
-    size = (n + 1) * sizeof(double);
-    hyd->LinkFlow = (double *)realloc(hyd->LinkFlow, size);
-    hyd->LinkSetting = (double *)realloc(hyd->LinkSetting, size);
-    size = (n + 1) * sizeof(StatusType);
-    hyd->LinkStatus = (StatusType *)realloc(hyd->LinkStatus, size);
+    if (!p->editor.Active)
+    {
+        size = (n + 1) * sizeof(Slink);
+        net->Link = (Slink *)realloc(net->Link, size);
+        size = (n + 1) * sizeof(double);
+        hyd->LinkFlow = (double *)realloc(hyd->LinkFlow, size);
+        hyd->LinkSetting = (double *)realloc(hyd->LinkSetting, size);
+        size = (n + 1) * sizeof(StatusType);
+        hyd->LinkStatus = (StatusType *)realloc(hyd->LinkStatus, size);
+    }
 
     // Set properties for the new link
     link = &net->Link[n];
@@ -3172,8 +3790,11 @@ int DLLEXPORT EN_addlink(EN_Project p, char *id, int linkType,
     {
         // Grow pump array to accomodate the new link
         net->Npumps++;
-        size = (net->Npumps + 1) * sizeof(Spump);
-        net->Pump = (Spump *)realloc(net->Pump, size);
+        if (!p->editor.Active)
+        {
+            size = (net->Npumps + 1) * sizeof(Spump);
+            net->Pump = (Spump *)realloc(net->Pump, size);
+        }
         pump = &net->Pump[net->Npumps];
         pump->Link = n;
         pump->Ptype = NOCURVE;
@@ -3194,8 +3815,11 @@ int DLLEXPORT EN_addlink(EN_Project p, char *id, int linkType,
     {
         // Grow valve array to accomodate the new link
         net->Nvalves++;
-        size = (net->Nvalves + 1) * sizeof(Svalve);
-        net->Valve = (Svalve *)realloc(net->Valve, size);
+        if (!p->editor.Active)
+        {
+            size = (net->Nvalves + 1) * sizeof(Svalve);
+            net->Valve = (Svalve *)realloc(net->Valve, size);
+        }
         net->Valve[net->Nvalves].Link = n;
     }
 
@@ -3243,6 +3867,7 @@ int DLLEXPORT EN_addlink(EN_Project p, char *id, int linkType,
     link->Vertices = NULL;
 
     hashtable_insert(net->LinkHashTable, link->ID, n);
+    if (p->editor.Active) editaddlink(p, n);
     *index = n;
     return 0;
 }
@@ -3283,6 +3908,9 @@ int DLLEXPORT EN_deletelink(EN_Project p, int index, int actionCode)
         if (actionCode > 0) return 261;
     }
 
+    // Deletion is deferred until an edit transaction is committed
+    if (p->editor.Active) return editdeletelink(p, index);
+
     // Get references to the link and its type
     link = &net->Link[index];
     EN_getlinktype(p, index, &linkType);
@@ -3543,6 +4171,8 @@ int DLLEXPORT EN_setlinknodes(EN_Project p, int index, int node1, int node2)
     // Check that nodes exist
     if (node1 < 0 || node1 > net->Nnodes) return 203;
     if (node2 < 0 || node2 > net->Nnodes) return 203;
+    if (p->editor.Active &&
+        (p->editor.NodeDeleted[node1] || p->editor.NodeDeleted[node2])) return 203;
 
     // Check that nodes are not the same
     if (node1 == node2) return 222;
@@ -3562,6 +4192,50 @@ int DLLEXPORT EN_setlinknodes(EN_Project p, int index, int node1, int node2)
     // Assign new end nodes to link
     net->Link[index].N1 = node1;
     net->Link[index].N2 = node2;
+    if (p->editor.Active) editaddlink(p, index);
+    return 0;
+}
+
+int DLLEXPORT EN_getadjacency(EN_Project p, int *rowPtr, int *colIdx, int *linkIdx)
+/*----------------------------------------------------------------
+**  Input:   none
+**  Output:  rowPtr = start of each node's neighbors in colIdx/linkIdx
+**                    (Nnodes+1 entries)
+**           colIdx = indexes of neighboring nodes (2*Nlinks entries)
+**           linkIdx = indexes of connecting links (2*Nlinks entries)
+**  Returns: error code
+**  Purpose: exports the network's node adjacency lists in compressed
+**           sparse row (CSR) format using 0-based indexes
+**----------------------------------------------------------------
+*/
+{
+    Network *net = &p->network;
+    Padjlist alink;
+    int i, k, errcode;
+
+    if (!p->Openflag) return 102;
+    if (rowPtr == NULL || colIdx == NULL || linkIdx == NULL) return 206;
+
+    // Adjacency lists are only guaranteed to be up to date while
+    // a solver is open -- otherwise (re-)build them from the links
+    if (net->Adjlist == NULL || !(p->hydraul.OpenHflag || p->quality.OpenQflag))
+    {
+        errcode = buildadjlists(net);
+        if (errcode) return errcode;
+    }
+
+    k = 0;
+    for (i = 1; i <= net->Nnodes; i++)
+    {
+        rowPtr[i - 1] = k;
+        for (alink = net->Adjlist[i]; alink != NULL; alink = alink->next)
+        {
+            colIdx[k] = alink->node - 1;
+            linkIdx[k] = alink->link - 1;
+            k++;
+        }
+    }
+    rowPtr[net->Nnodes] = k;
     return 0;
 }
 
@@ -3786,6 +4460,31 @@ int DLLEXPORT EN_getlinkvalue(EN_Project p, int index, int property, double *val
     return 0;
 }
 
+int DLLEXPORT EN_getlinkvaluelist(EN_Project p, int property, int count,
+                                  const int *indices, double *values)
+/*----------------------------------------------------------------
+**  Input:   property = link property code (see EN_LinkProperty)
+**           count = number of links
+**           indices = link indices
+**  Output:  values = property value of each link
+**  Returns: error code
+**  Purpose: retrieves a property value for a list of links at once
+**----------------------------------------------------------------
+*/
+{
+    int i, errcode;
+
+    if (!p->Openflag) return 102;
+    if (count < 0) return 202;
+    if (count > 0 && (indices == NULL || values == NULL)) return 205;
+    for (i = 0; i < count; i++)
+    {
+        errcode = EN_getlinkvalue(p, indices[i], property, &values[i]);
+        if (errcode > 100) return errcode;
+    }
+    return 0;
+}
+
 int DLLEXPORT EN_setlinkvalue(EN_Project p, int index, int property, double value)
 /*----------------------------------------------------------------
 **  Input:   index = link index
@@ -3992,6 +4691,32 @@ int DLLEXPORT EN_setlinkvalue(EN_Project p, int index, int property, double valu
     return 0;
 }
 
+int DLLEXPORT EN_setlinkvaluelist(EN_Project p, int property, int count,
+                                  const int *indices, const double *values)
+/*----------------------------------------------------------------
+**  Input:   property = link property code (see EN_LinkProperty)
+**           count = number of links
+**           indices = link indices
+**           values = property value of each link
+**  Output:  none
+**  Returns: error code
+**  Purpose: sets a property value for a list of links at once
+**----------------------------------------------------------------
+*/
+{
+    int i, errcode;
+
+    if (!p->Openflag) return 102;
+    if (count < 0) return 202;
+    if (count > 0 && (indices == NULL || values == NULL)) return 205;
+    for (i = 0; i < count; i++)
+    {
+        errcode = EN_setlinkvalue(p, indices[i], property, values[i]);
+        if (errcode > 100) return errcode;
+    }
+    return 0;
+}
+
 int DLLEXPORT EN_setpipedata(EN_Project p, int index, double length,
                              double diam, double rough, double mloss)
 /*----------------------------------------------------------------
@@ -4153,6 +4878,36 @@ int DLLEXPORT EN_getpumptype(EN_Project p, int linkIndex, int *pumpType)
     return 0;
 }
 
+int DLLEXPORT EN_getpumpenergy(EN_Project p, int linkIndex, double *kwHrs,
+                               double *cost)
+/*----------------------------------------------------------------
+**  Input:   linkIndex = index of a pump link
+**  Output:  kwHrs = energy consumed by the pump (kw-hrs)
+**           cost = cost of the energy consumed by the pump
+**  Returns: error code
+**  Purpose: retrieves the energy used by a pump since the hydraulic
+**           analysis was initialized
+**----------------------------------------------------------------
+*/
+{
+    Network *net = &p->network;
+    Spump *pump;
+
+    *kwHrs = 0.0;
+    *cost = 0.0;
+    if (!p->Openflag) return 102;
+    if (linkIndex < 1 || linkIndex > net->Nlinks) return 204;
+    if (PUMP != net->Link[linkIndex].Type) return 216;
+
+    // Cumulative values of addenergy() -- saveenergy() converts them
+    // to time-averaged ones at the end of a simulation
+    pump = &net->Pump[findpump(net, linkIndex)];
+    if (pump->Energy.TotalCost == MISSING) return 0;
+    *kwHrs = pump->Energy.KwHrs;
+    *cost = pump->Energy.TotalCost;
+    return 0;
+}
+
 int DLLEXPORT EN_getheadcurveindex(EN_Project p, int linkIndex, int *curveIndex)
 /*----------------------------------------------------------------
 **  Input:   linkIndex = index of a pump link
@@ -4270,7 +5025,12 @@ int DLLEXPORT EN_addpattern(EN_Project p, char *id)
 
     // Expand the project's array of patterns
     n = net->Npats + 1;
-    net->Pattern = (Spattern *)realloc(net->Pattern, (n + 1) * sizeof(Spattern));
+    if (p->editor.Active)
+    {
+        err = editreservepattern(p, 1);
+        if (err) return err;
+    }
+    else net->Pattern = (Spattern *)realloc(net->Pattern, (n + 1) * sizeof(Spattern));
 
     // Assign properties to the new pattern
     pat = &net->Pattern[n];
@@ -4513,6 +5273,88 @@ int DLLEXPORT EN_setpattern(EN_Project p, int index, double *values, int len)
     return 0;
 }
 
+int DLLEXPORT EN_addpatterns(EN_Project p, int nPatterns, char *ids,
+                             double *values, int len, int *firstIndex)
+/*----------------------------------------------------------------
+**  Input:   nPatterns = number of time patterns to add
+**           ids = ID names of the new patterns, each one terminated
+**                 by a null character and stored one after another
+**           values = pattern factors of the new patterns
+**                    (nPatterns x len, row-major)
+**           len = number of time periods of each pattern
+**  Output:  firstIndex = index of the first new pattern (the new
+**                        patterns have consecutive indices)
+**  Returns: error code
+**  Purpose: adds a set of time patterns to a project at once
+**----------------------------------------------------------------
+*/
+{
+    Network *net = &p->network;
+    Parser  *parser = &p->parser;
+
+    int i, j, n, errcode = 0;
+    char *id;
+    Spattern *pat;
+    HashTable *patIDs;
+
+    // Check for valid arguments
+    *firstIndex = 0;
+    if (!p->Openflag) return 102;
+    if (nPatterns <= 0 || len <= 0) return 202;
+    if (ids == NULL || values == NULL) return 205;
+
+    // Check that all ID names are valid and unique
+    patIDs = hashtable_create();
+    if (patIDs == NULL) return 101;
+    for (i = 1; i <= net->Npats; i++) hashtable_insert(patIDs, net->Pattern[i].ID, i);
+    id = ids;
+    for (i = 1; i <= nPatterns && !errcode; i++)
+    {
+        if (!namevalid(id)) errcode = 252;
+        else if (hashtable_find(patIDs, id) > 0) errcode = 215;
+        else hashtable_insert(patIDs, id, net->Npats + i);
+        id += strlen(id) + 1;
+    }
+    hashtable_free(patIDs);
+    if (errcode) return errcode;
+
+    // Expand the project's array of patterns once
+    n = net->Npats + nPatterns;
+    if (p->editor.Active) errcode = editreservepattern(p, nPatterns);
+    else
+    {
+        pat = (Spattern *)realloc(net->Pattern, (n + 1) * sizeof(Spattern));
+        if (pat == NULL) errcode = 101;
+        else net->Pattern = pat;
+    }
+    if (errcode) return errcode;
+
+    // Assign properties to the new patterns
+    id = ids;
+    for (i = net->Npats + 1; i <= n; i++)
+    {
+        pat = &net->Pattern[i];
+        strcpy(pat->ID, id);
+        id += strlen(id) + 1;
+        pat->Comment = NULL;
+        pat->Length = len;
+        pat->F = (double *)malloc(len * sizeof(double));
+        if (pat->F == NULL)
+        {
+            // Abort if memory allocation error
+            for (j = net->Npats + 1; j < i; j++) free(net->Pattern[j].F);
+            return 101;
+        }
+        memcpy(pat->F, &values[(size_t)(i - net->Npats - 1) * len], len * sizeof(double));
+    }
+
+    // Update the number of patterns
+    *firstIndex = net->Npats + 1;
+    net->Npats = n;
+    parser->MaxPats = n;
+    return 0;
+}
+
 /********************************************************************
 
     Data Curve Functions
@@ -4768,6 +5610,9 @@ int DLLEXPORT EN_setcurvevalue(EN_Project p, int curveIndex, int pointIndex,
     // Insert new point into curve
     curve->X[n] = x;
     curve->Y[n] = y;
+
+    // Rebuild curve's lookup table if hydraulics are open
+    if (updatecurvetab(p, curveIndex) > 0) return 101;
     
     // Adjust parameters for pumps using curve as a head curve
     return adjustpumpparams(p, curveIndex);
@@ -4842,6 +5687,9 @@ int DLLEXPORT EN_setcurve(EN_Project p, int index, double *xValues,
         curve->X[j] = xValues[j];
         curve->Y[j] = yValues[j];
     }
+
+    // Rebuild curve's lookup table if hydraulics are open
+    if (updatecurvetab(p, index) > 0) return 101;
     
     // Adjust parameters for pumps using curve as a head curve
     return adjustpumpparams(p, index);
@@ -4873,7 +5721,7 @@ int DLLEXPORT EN_addcontrol(EN_Project p, int type, int linkIndex, double settin
     Parser *parser = &p->parser;
 
     char status = ACTIVE;
-    int  n;
+    int  n, errcode;
     long t = 0;
     double s = setting, lvl = level;
     double *Ucf = p->Ucf;
@@ -4885,6 +5733,7 @@ int DLLEXPORT EN_addcontrol(EN_Project p, int type, int linkIndex, double settin
 
     // Check that controlled link exists
     if (linkIndex <= 0 || linkIndex > net->Nlinks) return 204;
+    if (p->editor.Active && p->editor.LinkDeleted[linkIndex]) return 204;
 
     // Cannot control check valve
     if (net->Link[linkIndex].Type == CVPIPE) return 207;
@@ -4894,6 +5743,7 @@ int DLLEXPORT EN_addcontrol(EN_Project p, int type, int linkIndex, double settin
     if (type == EN_LOWLEVEL || type == EN_HILEVEL)
     {
         if (nodeIndex < 1 || nodeIndex > net->Nnodes) return 203;
+        if (p->editor.Active && p->editor.NodeDeleted[nodeIndex]) return 203;
     }
     else nodeIndex = 0;
     if (s < 0.0 || lvl < 0.0) return 202;
@@ -4933,7 +5783,12 @@ int DLLEXPORT EN_addcontrol(EN_Project p, int type, int linkIndex, double settin
 
     // Expand project's array of controls
     n = net->Ncontrols + 1;
-    net->Control = (Scontrol *)realloc(net->Control, (n + 1) * sizeof(Scontrol));
+    if (p->editor.Active)
+    {
+        errcode = editreservecontrol(p);
+        if (errcode) return errcode;
+    }
+    else net->Control = (Scontrol *)realloc(net->Control, (n + 1) * sizeof(Scontrol));
 
     // Set properties of the new control
     control = &net->Control[n];
@@ -5097,6 +5952,7 @@ int DLLEXPORT EN_setcontrol(EN_Project p, int index, int type, int linkIndex,
         return 0;
     }
     if (linkIndex < 0 || linkIndex > net->Nlinks) return 204;
+    if (p->editor.Active && p->editor.LinkDeleted[linkIndex]) return 204;
 
     // Cannot control check valve
     if (net->Link[linkIndex].Type == CVPIPE) return 207;
@@ -5106,6 +5962,7 @@ int DLLEXPORT EN_setcontrol(EN_Project p, int index, int type, int linkIndex,
     if (type == EN_LOWLEVEL || type == EN_HILEVEL)
     {
         if (nodeIndex < 1 || nodeIndex > net->Nnodes) return 203;
+        if (p->editor.Active && p->editor.NodeDeleted[nodeIndex]) return 203;
     }
     else nodeIndex = 0;
     if (s < 0.0 || lvl < 0.0) return 202;
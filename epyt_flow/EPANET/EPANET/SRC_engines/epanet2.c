@@ -166,6 +166,34 @@ int DLLEXPORT ENusehydfile(char *filename)
     return EN_usehydfile(_defaultProject, filename);
 }
 
+int DLLEXPORT ENgetleaksignatures(int nCandidates, const int *nodes,
+                                  const double *emitterCoeffs, int nSensors,
+                                  const int *sensors, int nThreads, double *pressureDrops)
+{
+    return EN_getleaksignatures(_defaultProject, nCandidates, nodes, emitterCoeffs,
+                                nSensors, sensors, nThreads, pressureDrops);
+}
+
+int DLLEXPORT ENgetbackwardinfluence(int nSensors, const int *sensors, int nTimes,
+                                     const double *times, long binSize, double minWeight,
+                                     int capacity, int *count, int *rows, int *nodes,
+                                     double *injTimes, double *weights)
+{
+    return EN_getbackwardinfluence(_defaultProject, nSensors, sensors, nTimes, times,
+                                   binSize, minWeight, capacity, count, rows, nodes,
+                                   injTimes, weights);
+}
+
+int DLLEXPORT ENrunbatch(int nScenarios, const long *params, const int *eventStart,
+                         const long *eventTimes, const int *eventTargets,
+                         const double *eventValues, int nSensors, const int *sensors,
+                         int nPeriods, int nThreads, double *values, int *errcodes)
+{
+    return EN_runbatch(_defaultProject, nScenarios, params, eventStart, eventTimes,
+                       eventTargets, eventValues, nSensors, sensors, nPeriods, nThreads,
+                       values, errcodes);
+}
+
 /********************************************************************
 
     Water Quality Analysis Functions
@@ -232,6 +260,105 @@ int DLLEXPORT ENgetresultindex(int type, int index, int *value)
     return EN_getresultindex(_defaultProject, type, index, value);
 }
 
+int DLLEXPORT ENsetprofiling(int enabled)
+{
+    return EN_setprofiling(_defaultProject, enabled);
+}
+
+int DLLEXPORT ENgetprofile(int phase, EN_API_FLOAT_TYPE *seconds, int *calls,
+                           int *iterations)
+{
+    double v = 0.0;
+    int errcode = EN_getprofile(_defaultProject, phase, &v, calls, iterations);
+    *seconds = (EN_API_FLOAT_TYPE)v;
+    return errcode;
+}
+
+int DLLEXPORT ENsettracing(int size)
+{
+    return EN_settracing(_defaultProject, size);
+}
+
+int DLLEXPORT ENgettrace(int maxEvents, int *phases, double *starts,
+                         double *durations, int *count, int *dropped)
+{
+    return EN_gettrace(_defaultProject, maxEvents, phases, starts, durations,
+                       count, dropped);
+}
+
+int DLLEXPORT ENgettraceclock(double *seconds)
+{
+    return EN_gettraceclock(_defaultProject, seconds);
+}
+
+int DLLEXPORT ENsetdiagnostics(int enabled)
+{
+    return EN_setdiagnostics(_defaultProject, enabled);
+}
+
+int DLLEXPORT ENgetdiagnosticscount(int *count)
+{
+    return EN_getdiagnosticscount(_defaultProject, count);
+}
+
+int DLLEXPORT ENgetdiagnostics(int field, int count, double *values)
+{
+    return EN_getdiagnostics(_defaultProject, field, count, values);
+}
+
+int DLLEXPORT ENgetmemoryusage(int category, double *bytes)
+{
+    return EN_getmemoryusage(_defaultProject, category, bytes);
+}
+
+int DLLEXPORT ENgetsolvermemory(double *bytes)
+{
+    return EN_getsolvermemory(_defaultProject, bytes);
+}
+
+int DLLEXPORT ENsetwarmstart(int enabled)
+{
+    return EN_setwarmstart(_defaultProject, enabled);
+}
+
+int DLLEXPORT ENsetwarmstarttol(double tolerance)
+{
+    return EN_setwarmstarttol(_defaultProject, tolerance);
+}
+
+int DLLEXPORT ENgetwarmstart(int *steps, int *warmStarted, int *accepted, int *reused)
+{
+    return EN_getwarmstart(_defaultProject, steps, warmStarted, accepted, reused);
+}
+
+int DLLEXPORT ENsetobservations(int nSensors, const int *objects, const int *indices,
+                                const int *properties, const double *scales, int nTimes,
+                                const double *times, const double *values)
+{
+    return EN_setobservations(_defaultProject, nSensors, objects, indices, properties,
+                              scales, nTimes, times, values);
+}
+
+int DLLEXPORT ENgetresidual(double *sum, int *count)
+{
+    return EN_getresidual(_defaultProject, sum, count);
+}
+
+int DLLEXPORT ENsetqualrouting(int mode)
+{
+    return EN_setqualrouting(_defaultProject, mode);
+}
+
+int DLLEXPORT ENgetqualrouting(int *mode, int *events)
+{
+    return EN_getqualrouting(_defaultProject, mode, events);
+}
+
+int DLLEXPORT ENsetfullsort(int fullsort)
+{
+    return EN_setfullsort(_defaultProject, fullsort);
+}
+
 
 /********************************************************************
 
@@ -289,6 +416,27 @@ int DLLEXPORT ENsetqualtype(int qualType, char *chemName, char *chemUnits,
     return EN_setqualtype(_defaultProject, qualType, chemName, chemUnits, traceNode);
 }
 
+/********************************************************************
+
+    Network Edit Functions
+
+********************************************************************/
+
+int DLLEXPORT ENbeginedit()
+{
+    return EN_beginedit(_defaultProject);
+}
+
+int DLLEXPORT ENcommitedit()
+{
+    return EN_commitedit(_defaultProject);
+}
+
+int DLLEXPORT ENgetediting(int *editing)
+{
+    return EN_getediting(_defaultProject, editing);
+}
+
 /********************************************************************
 
     Node Functions
@@ -333,6 +481,12 @@ int DLLEXPORT ENgetnodevalue(int index, int property, EN_API_FLOAT_TYPE *value)
     return errcode;
 }
 
+int DLLEXPORT ENgetnodevaluelist(int property, int count, const int *indices,
+              double *values)
+{
+    return EN_getnodevaluelist(_defaultProject, property, count, indices, values);
+}
+
 int DLLEXPORT ENsetnodevalue(int index, int property, EN_API_FLOAT_TYPE value)
 {
     return EN_setnodevalue(_defaultProject, index, property, value);
@@ -422,6 +576,12 @@ int DLLEXPORT ENsetbasedemand(int nodeIndex, int demandIndex,
     return EN_setbasedemand(_defaultProject, nodeIndex, demandIndex, baseDemand);
 }
 
+int DLLEXPORT ENsetbasedemandlist(int count, const int *nodes, const int *demandIndices,
+              const double *baseDemands)
+{
+    return EN_setbasedemandlist(_defaultProject, count, nodes, demandIndices, baseDemands);
+}
+
 int  DLLEXPORT ENsetdemandpattern(int nodeIndex, int demandIndex, int patIndex)
 {
     return EN_setdemandpattern(_defaultProject, nodeIndex, demandIndex, patIndex);
@@ -493,6 +653,11 @@ int DLLEXPORT ENsetlinknodes(int index, int node1, int node2)
     return EN_setlinknodes(_defaultProject, index, node1, node2);
 }
 
+int DLLEXPORT ENgetadjacency(int *rowPtr, int *colIdx, int *linkIdx)
+{
+    return EN_getadjacency(_defaultProject, rowPtr, colIdx, linkIdx);
+}
+
 int DLLEXPORT ENgetlinkvalue(int index, int property, EN_API_FLOAT_TYPE *value)
 {
     double v = 0.0;
@@ -501,11 +666,23 @@ int DLLEXPORT ENgetlinkvalue(int index, int property, EN_API_FLOAT_TYPE *value)
     return errcode;
 }
 
+int DLLEXPORT ENgetlinkvaluelist(int property, int count, const int *indices,
+              double *values)
+{
+    return EN_getlinkvaluelist(_defaultProject, property, count, indices, values);
+}
+
 int DLLEXPORT ENsetlinkvalue(int index, int property, EN_API_FLOAT_TYPE value)
 {
     return EN_setlinkvalue(_defaultProject, index, property, value);
 }
 
+int DLLEXPORT ENsetlinkvaluelist(int property, int count, const int *indices,
+              const double *values)
+{
+    return EN_setlinkvaluelist(_defaultProject, property, count, indices, values);
+}
+
 int DLLEXPORT ENsetpipedata(int index, EN_API_FLOAT_TYPE length,
               EN_API_FLOAT_TYPE diam, EN_API_FLOAT_TYPE rough, EN_API_FLOAT_TYPE mloss)
 {
@@ -538,6 +715,11 @@ int DLLEXPORT ENgetpumptype(int linkIndex, int *pumpType)
     return EN_getpumptype(_defaultProject, linkIndex, pumpType);
 }
 
+int DLLEXPORT ENgetpumpenergy(int linkIndex, double *kwHrs, double *cost)
+{
+    return EN_getpumpenergy(_defaultProject, linkIndex, kwHrs, cost);
+}
+
 int DLLEXPORT ENgetheadcurveindex(int linkIndex, int *curveIndex)
 {
     return EN_getheadcurveindex(_defaultProject, linkIndex, curveIndex);
@@ -621,6 +803,12 @@ int DLLEXPORT ENsetpattern(int index, EN_API_FLOAT_TYPE *values, int len)
     return errcode;
 }
 
+int DLLEXPORT ENaddpatterns(int nPatterns, char *ids, double *values, int len,
+              int *firstIndex)
+{
+    return EN_addpatterns(_defaultProject, nPatterns, ids, values, len, firstIndex);
+}
+
 /********************************************************************
 
     Data Curve Functions
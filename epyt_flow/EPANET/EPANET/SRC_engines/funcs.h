@@ -13,6 +13,12 @@
 #ifndef FUNCS_H
 #define FUNCS_H
 
+// strtok() keeps its position in a global -- the parsers use the
+// reentrant version so that projects can be opened concurrently
+#ifdef _WIN32
+#define strtok_r strtok_s
+#endif
+
 // ------- PROJECT.C ------------
 
 void    initpointers(Project *);
@@ -61,6 +67,76 @@ char    *geterrmsg(int, char *);
 void    errmsg(Project *, int);
 void    writewin(void (*vp)(char *), char *);
 
+// ------- PROFILE.C ---------------
+
+double  profclock(void);
+void    profstop(Project *, int, double);
+void    profreset(Profile *);
+int     proftrace(Profile *, int);
+int     profgettrace(Profile *, int, int *, double *, double *, int *, int *);
+
+// ------- DIAGNOSTICS.C -----------
+
+int     diagenable(Project *, int);
+int     diagstart(Project *);
+int     diagrecord(Project *, long, int, double);
+int     diaggetfield(Project *, int, int, double *);
+
+// ------- WARMSTART.C -------------
+
+int     warmstartenable(Project *, int);
+void    warmstartclear(Project *);
+void    warmstartinit(Project *);
+int     warmstartapply(Project *, long);
+int     warmstartaccept(Project *, double);
+int     warmstartrecord(Project *, long);
+void    warmstartkeep(Project *);
+int     warmstartrestore(Project *);
+
+// ------- OBSERVE.C ---------------
+
+int     observeset(Project *, int, const int *, const int *, const int *,
+                   const double *, int, const double *, const double *);
+void    observeclear(Project *);
+void    observeinit(Project *);
+int     observerecord(Project *, long);
+
+// ------- MEMORY.C ----------------
+
+int     memusage(Project *, int, double *);
+int     solvermemory(Project *, double *);
+
+// ------- LEAKSIG.C ---------------
+
+int     leaksignatures(Project *, int, const int *, const double *, int,
+                       const int *, int, double *);
+
+// ------- BATCH.C -----------------
+
+int     runbatch(Project *, int, const long *, const int *, const long *,
+                 const int *, const double *, int, const int *, int, int,
+                 double *, int *);
+
+// ------- ADJOINT.C ---------------
+
+int     backwardinfluence(Project *, int, const int *, int, const double *,
+                          long, double, int, int *, int *, int *, double *,
+                          double *);
+
+// ------- EDIT.C ------------------
+
+int     beginedit(Project *);
+int     commitedit(Project *);
+void    freeedit(Project *);
+int     editreservenode(Project *, int);
+int     editreservelink(Project *, int);
+int     editreservepattern(Project *, int);
+int     editreservecontrol(Project *);
+void    editinsertjunc(Project *);
+void    editaddlink(Project *, int);
+int     editdeletenode(Project *, int);
+int     editdeletelink(Project *, int);
+
 // ------- INPUT1.C ----------------
 
 int     getdata(Project *);
@@ -118,6 +194,7 @@ int     ruledata(Project *);
 void    ruleerrmsg(Project *);
 void    adjustrules(Project *, int, int);
 void    adjusttankrules(Project *);
+void    remaprules(Project *, const int *, const int *);
 Spremise *getpremise(Spremise *, int);
 Saction  *getaction(Saction *, int);
 int     writerule(Project *, FILE *, int);
@@ -165,6 +242,15 @@ void    matrixcoeffs(Project *);
 void    emitterheadloss(Project *, int, double *, double *);           
 void    demandheadloss(Project *, int, double, double, double *, double *);
 
+// ------- CURVETAB.C -----------------
+
+int     opencurvetabs(Project *);
+void    closecurvetabs(Project *);
+int     updatecurvetab(Project *, int);
+void    curvesegment(Project *, int, double, double *, double *);
+double  curvevalue(Project *, int, int, double);
+double  curvetabsize(Scurve *);
+
 // ------- QUALITY.C --------------------
 
 int     openqual(Project *);
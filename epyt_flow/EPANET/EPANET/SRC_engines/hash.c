@@ -175,3 +175,22 @@ void hashtable_free(HashTable *ht)
     }
     free(ht);
 }
+
+// Compute the number of bytes allocated by a hash table
+size_t hashtable_memsize(HashTable *ht)
+{
+    DataEntry *entry;
+    size_t size;
+    int i;
+
+    if (ht == NULL) return 0;
+    size = HASHTABLEMAXSIZE * sizeof(HashTable);
+    for (i = 0; i < HASHTABLEMAXSIZE; i++)
+    {
+        for (entry = ht[i]; entry != NULL; entry = entry->next)
+        {
+            size += sizeof(DataEntry) + strlen(entry->key) + 1;
+        }
+    }
+    return size;
+}
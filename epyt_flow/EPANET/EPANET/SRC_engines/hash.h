@@ -24,5 +24,6 @@ char      *hashtable_findkey(HashTable *, char *);
 void      hashtable_free(HashTable *);
 int       hashtable_update(HashTable *ht, char *key, int new_data);
 int       hashtable_delete(HashTable *ht, char *key);
+size_t    hashtable_memsize(HashTable *);
 
 #endif
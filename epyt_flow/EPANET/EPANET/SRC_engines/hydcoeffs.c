@@ -52,7 +52,7 @@ static void    pipecoeff(Project *pr, int k);
 static void    DWpipecoeff(Project *pr, int k);
 static double  frictionFactor(double q, double e, double s, double *dfdq);
 
-static void    pumpcoeff(Project *pr, int k);
+static void    pumpcoeff(Project *pr, int p);
 static void    curvecoeff(Project *pr, int i, double q, double *h0, double *r);
 
 static void    valvecoeff(Project *pr, int k);
@@ -139,8 +139,7 @@ void headlosscoeffs(Project *pr)
         case PIPE:
             pipecoeff(pr, k);
             break;
-        case PUMP:
-            pumpcoeff(pr, k);
+        case PUMP:          // evaluated below
             break;
         case PBV:
             pbvcoeff(pr, k);
@@ -158,6 +157,10 @@ void headlosscoeffs(Project *pr)
             else hyd->P[k] = 0.0;
         }
     }
+
+    // Pumps are evaluated from the pump list (which avoids
+    // searching for the pump object of each pump link)
+    for (k = 1; k <= net->Npumps; k++) pumpcoeff(pr, k);
 }
 
 
@@ -670,18 +673,18 @@ double frictionFactor(double q, double e, double s, double *dfdq)
 }
 
 
-void  pumpcoeff(Project *pr, int k)
+void  pumpcoeff(Project *pr, int p)
 /*
 **--------------------------------------------------------------
-**   Input:   k = link index
+**   Input:   p = pump index
 **   Output:  none
-**   Purpose: computes P & Y coeffs. for pump in link k
+**   Purpose: computes P & Y coeffs. for pump p
 **--------------------------------------------------------------
 */
 {
     Hydraul *hyd = &pr->hydraul;
 
-    int    p;                // Pump index
+    int    k;                // Link index
     double h0,               // Shutoff head
            q,                // Abs. value of flow
            r,                // Flow resistance coeff.
@@ -691,6 +694,10 @@ void  pumpcoeff(Project *pr, int k)
            hgrad;            // Head loss gradient
     Spump  *pump;
 
+    // Obtain reference to pump object and its link
+    pump = &pr->network.Pump[p];
+    k = pump->Link;
+
     // Use high resistance pipe if pump closed or cannot deliver head
     setting = hyd->LinkSetting[k];
     if (hyd->LinkStatus[k] <= CLOSED || setting == 0.0)
@@ -700,10 +707,7 @@ void  pumpcoeff(Project *pr, int k)
         return;
     }
 
-    // Obtain reference to pump object
     q = ABS(hyd->LinkFlow[k]);
-    p = findpump(&pr->network, k);
-    pump = &pr->network.Pump[p];
 
     // If no pump curve treat pump as an open valve
     if (pump->Ptype == NOCURVE)
@@ -803,27 +807,12 @@ void  curvecoeff(Project *pr, int i, double q, double *h0, double *r)
 **-------------------------------------------------------------------
 */
 {
-    int   k1, k2, npts;
-    double *x, *y;
-    Scurve *curve;
-
     // Remember that curve is stored in untransformed units
     q *= pr->Ucf[FLOW];
-    curve = &pr->network.Curve[i];
-    x = curve->X;                      // x = flow
-    y = curve->Y;                      // y = head
-    npts = curve->Npts;
-
-    // Find linear segment of curve that brackets flow q
-    k2 = 0;
-    while (k2 < npts && x[k2] < q) k2++;
-    if (k2 == 0) k2++;
-    else if (k2 == npts)  k2--;
-    k1 = k2 - 1;
-
-    // Compute slope and intercept of this segment
-    *r = (y[k2] - y[k1]) / (x[k2] - x[k1]);
-    *h0 = y[k1] - (*r)*x[k1];
+
+    // Find slope and intercept of linear segment of curve
+    // that brackets flow q
+    curvesegment(pr, i, q, h0, r);
 
     // Convert units
     *h0 = (*h0) / pr->Ucf[HEAD];
@@ -57,12 +57,17 @@ int  openhyd(Project *pr)
     if (pr->network.Nnodes < 2) errcode = 223;
     else if (pr->network.Ntanks == 0) errcode = 224;
 
-    // Allocate memory for sparse matrix structures (see SMATRIX.C)
-    ERRCODE(createsparse(pr));
+    // Allocate memory for sparse matrix structures (see SMATRIX.C) --
+    // re-use the structure kept from the previous run if possible
+    if (pr->warmstart.Enabled) ERRCODE(warmstartrestore(pr));
+    else ERRCODE(createsparse(pr));
 
     // Allocate memory for hydraulic variables
     ERRCODE(allocmatrix(pr));
 
+    // Build lookup tables of data curves (see CURVETAB.C)
+    ERRCODE(opencurvetabs(pr));
+
     // Check for unconnected nodes
     if (!errcode) for (i = 1; i <= pr->network.Njuncs; i++)
     {
@@ -176,6 +181,15 @@ void inithyd(Project *pr, int initflag)
     time->Htime = 0;
     time->Hydstep = 0;
     time->Rtime = time->Rstep;
+
+    // Start a new diagnostics stream
+    pr->diagnostics.Count = 0;
+
+    // Keep the solutions of the last run for warm starts
+    if (pr->warmstart.Enabled) warmstartinit(pr);
+
+    // Start a new sum of residuals
+    observeinit(pr);
 }
 
 
@@ -196,14 +210,37 @@ int   runhyd(Project *pr, long *t)
     int   iter;          // Iteration count
     int   errcode;       // Error code
     double relerr;       // Solution accuracy
+    double t0 = 0.0,     // Profiling start times
+           t1 = 0.0;
     
     // Find new demands & control actions
+    if (pr->diagnostics.Enabled && diagstart(pr)) return 101;
+    PROFSTART(pr, t0);
     *t = time->Htime;
+    PROFSTART(pr, t1);
     demands(pr);
+    PROFSTOP(pr, EN_PROF_DEMANDS, t1);
+    PROFSTART(pr, t1);
     controls(pr);
+    PROFSTOP(pr, EN_PROF_CONTROLS, t1);
+
+    // Start from the solution of the previous run if available
+    if (pr->warmstart.Enabled && warmstartapply(pr, *t) && pr->diagnostics.Enabled)
+    {
+        pr->diagnostics.Flags |= EN_DIAGFLAG_WARMSTART;
+    }
 
     // Solve network hydraulic equations
+    PROFSTART(pr, t1);
     errcode = hydsolve(pr,&iter,&relerr);
+    PROFSTOP(pr, EN_PROF_HYDSOLVE, t1);
+    if (pr->profile.Enabled) pr->profile.Iterations += iter;
+    if (pr->diagnostics.Enabled && diagrecord(pr, *t, iter, relerr) && !errcode)
+    {
+        errcode = 101;
+    }
+    if (pr->warmstart.Enabled && !errcode) errcode = warmstartrecord(pr, *t);
+    if (pr->observations.Nsensors > 0 && !errcode) errcode = observerecord(pr, *t);
     if (!errcode)
     {
         // Report new status & save results
@@ -219,6 +256,7 @@ int   runhyd(Project *pr, long *t)
         // Report any warning conditions
         if (!errcode) errcode = writehydwarn(pr,iter,relerr);
    }
+   PROFSTOP(pr, EN_PROF_RUNHYD, t0);
    return errcode;
 }
 
@@ -238,16 +276,29 @@ int  nexthyd(Project *pr, long *tstep)
 
     long  hydstep;         // Actual time step
     int   errcode = 0;     // Error code
+    double t0 = 0.0,       // Profiling start times
+           t1 = 0.0;
 
     // Save current results to hydraulics file and
     // force end of simulation if Haltflag is active
-    if (pr->outfile.Saveflag) errcode = savehyd(pr, &time->Htime);
+    PROFSTART(pr, t0);
+    if (pr->outfile.Saveflag)
+    {
+        PROFSTART(pr, t1);
+        errcode = savehyd(pr, &time->Htime);
+        PROFSTOP(pr, EN_PROF_SAVEHYD, t1);
+    }
     if (hyd->Haltflag) time->Htime = time->Dur;
 
     // Compute next time step & update tank levels
     *tstep = 0;
     hydstep = 0;
-    if (time->Htime < time->Dur) hydstep = timestep(pr);
+    if (time->Htime < time->Dur)
+    {
+        PROFSTART(pr, t1);
+        hydstep = timestep(pr);
+        PROFSTOP(pr, EN_PROF_TIMESTEP, t1);
+    }
     if (pr->outfile.Saveflag) errcode = savehydstep(pr,&hydstep);
 
     // Compute pumping energy
@@ -271,6 +322,7 @@ int  nexthyd(Project *pr, long *tstep)
         if (pr->quality.OpenQflag) time->Qtime++;
     }
     *tstep = hydstep;
+    PROFSTOP(pr, EN_PROF_NEXTHYD, t0);
     return errcode;
 }
 
@@ -284,8 +336,10 @@ void  closehyd(Project *pr)
 **--------------------------------------------------------------
 */
 {
-    freesparse(pr);
+    if (pr->warmstart.Enabled) warmstartkeep(pr);
+    else freesparse(pr);
     freematrix(pr);
+    closecurvetabs(pr);
 }
 
 
@@ -953,7 +1007,6 @@ void  getenergy(Project *pr, int k, double *kw, double *eff)
            e;       // pump efficiency
     double q4eff;   // flow at nominal pump speed of 1.0
     double speed;   // current speed setting
-    Scurve *curve;
     Slink  *link = &net->Link[k];
 
     // No energy if link is closed
@@ -977,8 +1030,7 @@ void  getenergy(Project *pr, int k, double *kw, double *eff)
         if ((i = net->Pump[j].Ecurve) > 0)
         {
             q4eff = q / speed * pr->Ucf[FLOW];
-            curve = &net->Curve[i];
-            e = interp(curve->Npts,curve->X, curve->Y, q4eff);
+            e = curvevalue(pr, i, FALSE, q4eff);
 
             // Sarbu and Borza pump speed adjustment
             e = 100.0 - ((100.0-e) * pow(1.0/speed, 0.1));
@@ -1050,7 +1102,6 @@ double  tankvolume(Project *pr, int i, double h)
     int j;
     double y, v;
     Stank *tank = &net->Tank[i];
-    Scurve *curve;
 
     // Use level*area if no volume curve
     j = tank->Vcurve;
@@ -1060,9 +1111,8 @@ double  tankvolume(Project *pr, int i, double h)
     // remembering that volume curve is in original units.
     else
     {
-        curve = &net->Curve[j];
         y = (h - net->Node[tank->Node].El) * pr->Ucf[HEAD];
-        v = interp(curve->Npts, curve->X, curve->Y, y) / pr->Ucf[VOLUME];
+        v = curvevalue(pr, j, FALSE, y) / pr->Ucf[VOLUME];
         return v;
     }
 }
@@ -1093,8 +1143,7 @@ double  tankgrade(Project *pr, int i, double v)
     // Remember that volume curve is stored in original units.
     else
     {
-        Scurve *curve = &net->Curve[j];
-        y = interp(curve->Npts, curve->Y, curve->X, v * pr->Ucf[VOLUME]);
+        y = curvevalue(pr, j, TRUE, v * pr->Ucf[VOLUME]);
         h = net->Node[tank->Node].El + y / pr->Ucf[HEAD];
         return h;
     }
@@ -33,6 +33,7 @@ typedef struct {
 
 // Exported functions
 int  hydsolve(Project *, int *, double *);
+int  hydsolvefixed(Project *, int *, double *);
 
 // Imported functions
 extern int  linsolve(Smatrix *, int);  //(see SMATRIX.C)
@@ -94,6 +95,9 @@ int  hydsolve(Project *pr, int *iter, double *relerr)
     int    statChange;            // Non-valve status change flag
     Hydbalance hydbal;            // Hydraulic balance errors
     double fullDemand;            // Full demand for a node (cfs)
+    double t0 = 0.0;              // Profiling start time
+    int    converged = FALSE;     // Convergence flag
+    int    accepted = FALSE;      // Warm start accepted flag
 
     // Initialize status checking & relaxation factor
     nextcheck = hyd->CheckFreq;
@@ -118,15 +122,25 @@ int  hydsolve(Project *pr, int *iter, double *relerr)
         // head loss gradients, & F = flow correction terms.
         // Solution for H is returned in F from call to linsolve().
 
+        PROFSTART(pr, t0);
         headlosscoeffs(pr);
+        PROFSTOP(pr, EN_PROF_HEADLOSSCOEFFS, t0);
+        PROFSTART(pr, t0);
         matrixcoeffs(pr);
+        PROFSTOP(pr, EN_PROF_MATRIXCOEFFS, t0);
+        PROFSTART(pr, t0);
         errcode = linsolve(sm, net->Njuncs);
+        PROFSTOP(pr, EN_PROF_LINSOLVE, t0);
 
         // Matrix ill-conditioning problem - if control valve causing problem,
         // fix its status & continue, otherwise quit with no solution.
         if (errcode > 0)
         {
-            if (badvalve(pr, sm->Order[errcode])) continue;
+            if (badvalve(pr, sm->Order[errcode]))
+            {
+                pr->diagnostics.BadValves++;
+                continue;
+            }
             else break;
         }
 
@@ -146,6 +160,7 @@ int  hydsolve(Project *pr, int *iter, double *relerr)
         }
 
         // Apply solution damping & check for change in valve status
+        PROFSTART(pr, t0);
         hyd->RelaxFactor = 1.0;
         valveChange = FALSE;
         if (hyd->DampLimit > 0.0)
@@ -153,6 +168,7 @@ int  hydsolve(Project *pr, int *iter, double *relerr)
             if (*relerr <= hyd->DampLimit)
             {
                 hyd->RelaxFactor = 0.6;
+                pr->diagnostics.Flags |= EN_DIAGFLAG_DAMPED;
                 valveChange = valvestatus(pr);
             }
         }
@@ -160,18 +176,31 @@ int  hydsolve(Project *pr, int *iter, double *relerr)
         {
             valveChange = valvestatus(pr);
         }
+        PROFSTOP(pr, EN_PROF_STATUSCHECKS, t0);
 
         // Check for convergence
-        if (hasconverged(pr, relerr, &hydbal))
+        converged = hasconverged(pr, relerr, &hydbal);
+
+        // Accept a warm started solution that the first trial changed
+        // by less than the warm start tolerance
+        if (!converged && *iter == 1 &&
+            warmstartaccept(pr, hydbal.maxflowchange))
+        {
+            converged = (hyd->DemandModel == PDA) ? pdaconverged(pr) : 1;
+            accepted = converged;
+        }
+        if (converged)
         {
             // We have convergence - quit if we are into extra iterations
             if (*iter > hyd->MaxIter) break;
 
             // Quit if no status changes occur
+            PROFSTART(pr, t0);
             statChange = FALSE;
             if (valveChange)    statChange = TRUE;
             if (linkstatus(pr)) statChange = TRUE;
             if (pswitch(pr))    statChange = TRUE;
+            PROFSTOP(pr, EN_PROF_STATUSCHECKS, t0);
             if (!statChange)    break;
 
             // We have a status change so continue the iterations
@@ -182,7 +211,9 @@ int  hydsolve(Project *pr, int *iter, double *relerr)
         // check  on pumps, CV's, and pipes connected to tank
         else if (*iter <= hyd->MaxCheck && *iter == nextcheck)
         {
+            PROFSTART(pr, t0);
             linkstatus(pr);
+            PROFSTOP(pr, EN_PROF_STATUSCHECKS, t0);
             nextcheck += hyd->CheckFreq;
         }
         (*iter)++;
@@ -208,10 +239,70 @@ int  hydsolve(Project *pr, int *iter, double *relerr)
     hyd->MaxHeadError = hydbal.maxheaderror;
     hyd->MaxFlowChange = hydbal.maxflowchange;
     hyd->Iterations = *iter;
+    if (converged) pr->diagnostics.Flags |= EN_DIAGFLAG_CONVERGED;
+    if (accepted && *iter == 1)
+    {
+        pr->warmstart.Accepted++;
+        pr->diagnostics.Flags |= EN_DIAGFLAG_WARMACCEPTED;
+    }
+    // (without extra trials *iter exceeds MaxIter merely because the
+    // trial limit was reached)
+    if (hyd->ExtraIter > 0 && *iter > hyd->MaxIter)
+    {
+        pr->diagnostics.Flags |= EN_DIAGFLAG_EXTRATRIALS;
+    }
     return errcode;
 }
 
 
+int  hydsolvefixed(Project *pr, int *iter, double *relerr)
+/*
+**-------------------------------------------------------------------
+**  Input:   none
+**  Output:  *iter   = # of iterations to reach solution
+**           *relerr = convergence error in solution
+**           returns error code (or -1 if not converged)
+**  Purpose: solves network nodal equations for heads and flows
+**           starting from the current solution while keeping the
+**           status of all links fixed
+**
+**  Notes:   In contrast to hydsolve(), neither status checks nor
+**           solution damping are applied and nothing is written to
+**           the status report, profiling or diagnostics records --
+**           i.e. only the project's hydraulic work arrays are
+**           modified.
+**-------------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Smatrix *sm = &hyd->smatrix;
+
+    int    i;
+    int    errcode = 0;
+    Hydbalance hydbal;
+
+    hyd->RelaxFactor = 1.0;
+    hydbal.maxheaderror = 0.0;
+    hydbal.maxflowchange = 0.0;
+    for (*iter = 1; *iter <= hyd->MaxIter; (*iter)++)
+    {
+        headlosscoeffs(pr);
+        matrixcoeffs(pr);
+        errcode = linsolve(sm, net->Njuncs);
+        if (errcode > 0) return 110;
+
+        for (i = 1; i <= net->Njuncs; i++)
+        {
+            hyd->NodeHead[i] = sm->F[sm->Row[i]];
+        }
+        *relerr = newflows(pr, &hydbal);
+        if (hasconverged(pr, relerr, &hydbal)) return 0;
+    }
+    return -1;
+}
+
+
 int  badvalve(Project *pr, int n)
 /*
 **-----------------------------------------------------------------
@@ -111,6 +111,19 @@ extern "C" {
 
   int  DLLEXPORT ENusehydfile(char *filename);
 
+  int  DLLEXPORT ENgetleaksignatures(int nCandidates, const int *nodes,
+                 const double *emitterCoeffs, int nSensors, const int *sensors,
+                 int nThreads, double *pressureDrops);
+
+  int  DLLEXPORT ENgetbackwardinfluence(int nSensors, const int *sensors, int nTimes,
+                 const double *times, long binSize, double minWeight, int capacity,
+                 int *count, int *rows, int *nodes, double *injTimes, double *weights);
+
+  int  DLLEXPORT ENrunbatch(int nScenarios, const long *params, const int *eventStart,
+                 const long *eventTimes, const int *eventTargets, const double *eventValues,
+                 int nSensors, const int *sensors, int nPeriods, int nThreads,
+                 double *values, int *errcodes);
+
 /********************************************************************
 
     Water Quality Analysis Functions
@@ -159,6 +172,46 @@ extern "C" {
   
   int  DLLEXPORT ENgetresultindex(int type, int index, int *value);
 
+  int  DLLEXPORT ENsetprofiling(int enabled);
+
+  int  DLLEXPORT ENgetprofile(int phase, EN_API_FLOAT_TYPE *seconds, int *calls,
+                 int *iterations);
+
+  int  DLLEXPORT ENsettracing(int size);
+
+  int  DLLEXPORT ENgettrace(int maxEvents, int *phases, double *starts,
+                 double *durations, int *count, int *dropped);
+
+  int  DLLEXPORT ENgettraceclock(double *seconds);
+
+  int  DLLEXPORT ENsetdiagnostics(int enabled);
+
+  int  DLLEXPORT ENgetdiagnosticscount(int *count);
+
+  int  DLLEXPORT ENgetdiagnostics(int field, int count, double *values);
+
+  int  DLLEXPORT ENgetmemoryusage(int category, double *bytes);
+
+  int  DLLEXPORT ENgetsolvermemory(double *bytes);
+
+  int  DLLEXPORT ENsetwarmstart(int enabled);
+
+  int  DLLEXPORT ENsetwarmstarttol(double tolerance);
+
+  int  DLLEXPORT ENgetwarmstart(int *steps, int *warmStarted, int *accepted, int *reused);
+
+  int  DLLEXPORT ENsetobservations(int nSensors, const int *objects, const int *indices,
+                 const int *properties, const double *scales, int nTimes,
+                 const double *times, const double *values);
+
+  int  DLLEXPORT ENgetresidual(double *sum, int *count);
+
+  int  DLLEXPORT ENsetqualrouting(int mode);
+
+  int  DLLEXPORT ENgetqualrouting(int *mode, int *events);
+
+  int  DLLEXPORT ENsetfullsort(int fullsort);
+
 /********************************************************************
 
     Analysis Options Functions
@@ -185,6 +238,18 @@ extern "C" {
   int  DLLEXPORT ENsetqualtype(int qualType, char *chemName, char *chemUnits,
                  char *traceNode);
 
+/********************************************************************
+
+    Network Edit Functions
+
+********************************************************************/
+
+  int  DLLEXPORT ENbeginedit();
+
+  int  DLLEXPORT ENcommitedit();
+
+  int  DLLEXPORT ENgetediting(int *editing);
+
 /********************************************************************
 
     Node Functions
@@ -205,6 +270,9 @@ extern "C" {
 
    int DLLEXPORT ENgetnodevalue(int index, int property, EN_API_FLOAT_TYPE *value);
 
+   int DLLEXPORT ENgetnodevaluelist(int property, int count, const int *indices,
+                 double *values);
+
    int DLLEXPORT ENsetnodevalue(int index, int property, EN_API_FLOAT_TYPE value);
 
    int DLLEXPORT ENsetjuncdata(int index, EN_API_FLOAT_TYPE elev,
@@ -246,6 +314,9 @@ extern "C" {
   int DLLEXPORT ENsetbasedemand(int nodeIndex, int demandIndex,
                 EN_API_FLOAT_TYPE baseDemand);
 
+  int DLLEXPORT ENsetbasedemandlist(int count, const int *nodes, const int *demandIndices,
+                const double *baseDemands);
+
   int DLLEXPORT ENgetdemandpattern(int nodeIndex, int demandIndex, int *patIndex);
 
   int DLLEXPORT ENsetdemandpattern(int nodeIndex, int demandIndex, int patIndex);
@@ -278,10 +349,18 @@ extern "C" {
 
   int DLLEXPORT ENsetlinknodes(int index, int node1, int node2);
 
+  int DLLEXPORT ENgetadjacency(int *rowPtr, int *colIdx, int *linkIdx);
+
   int DLLEXPORT ENgetlinkvalue(int index, int property, EN_API_FLOAT_TYPE *value);
 
+  int DLLEXPORT ENgetlinkvaluelist(int property, int count, const int *indices,
+                double *values);
+
   int DLLEXPORT ENsetlinkvalue(int index, int property, EN_API_FLOAT_TYPE value);
 
+  int DLLEXPORT ENsetlinkvaluelist(int property, int count, const int *indices,
+                const double *values);
+
   int DLLEXPORT ENsetpipedata(int index, EN_API_FLOAT_TYPE length,
                 EN_API_FLOAT_TYPE diam, EN_API_FLOAT_TYPE rough,
                 EN_API_FLOAT_TYPE mloss);
@@ -300,6 +379,8 @@ extern "C" {
 
   int DLLEXPORT ENgetpumptype(int linkIndex, int *pumpType);
 
+  int DLLEXPORT ENgetpumpenergy(int linkIndex, double *kwHrs, double *cost);
+
   int DLLEXPORT ENgetheadcurveindex(int linkIndex, int *curveIndex);
 
   int DLLEXPORT ENsetheadcurveindex(int linkIndex, int curveIndex);
@@ -330,6 +411,9 @@ extern "C" {
 
   int DLLEXPORT ENsetpattern(int index, EN_API_FLOAT_TYPE *values, int len);
 
+  int DLLEXPORT ENaddpatterns(int nPatterns, char *ids, double *values, int len,
+                int *firstIndex);
+
 /********************************************************************
 
     Data Curve Functions
@@ -365,6 +365,102 @@ typedef struct Project *EN_Project;
   */
   int DLLEXPORT EN_savehydfile(EN_Project ph, const char *filename);
 
+  /**
+  @brief Computes the pressure drops at a set of sensor nodes caused by candidate leaks,
+  relative to the current hydraulic solution.
+  @param ph an EPANET project handle.
+  @param nCandidates the number of candidate leaks.
+  @param nodes the junction index of each candidate leak (starting from 1).
+  @param emitterCoeffs the emitter coefficient of each candidate leak
+  (flow units / (pressure units)^N, see @ref EN_EMITTER).
+  @param nSensors the number of sensor nodes.
+  @param sensors the index of each sensor node (starting from 1).
+  @param nThreads the number of threads.
+  @param[out] pressureDrops the pressure drop at each sensor node caused by each candidate
+  leak -- an array of nSensors x nCandidates values in row-major order.
+  @return an error code, or the warning code 1 if the solution of some candidates did
+  not converge.
+
+  Call this function after ::EN_runH, i.e. while the solution of the current time period
+  is available. Each candidate leak is modelled as an emitter at its junction (replacing
+  any existing emitter). Starting from the current solution, the network equations are
+  solved again with the status of all links, the tank levels and the demands held fixed.
+  The candidates are distributed over the given number of threads, all of which share the
+  structure (incl. the symbolic factorization) of the project's sparse matrix.
+  The project's solution is not modified.
+  */
+  int DLLEXPORT EN_getleaksignatures(EN_Project ph, int nCandidates, const int *nodes,
+                const double *emitterCoeffs, int nSensors, const int *sensors,
+                int nThreads, double *pressureDrops);
+
+  /**
+  @brief Computes the influence of all upstream nodes on the water sampled at a set of
+  sensor nodes by tracing the water backwards through the saved hydraulic results.
+  @param ph an EPANET project handle.
+  @param nSensors the number of sensor nodes.
+  @param sensors the index of each sensor node (starting from 1).
+  @param nTimes the number of sample times.
+  @param times the sample times (in seconds).
+  @param binSize the length of a time bin (in seconds).
+  @param minWeight the smallest weight that is reported.
+  @param capacity the length of the output arrays.
+  @param[out] count the number of entries of the influence matrix.
+  @param[out] rows the sample of each entry (sensor x nTimes + sample time).
+  @param[out] nodes the node index of each entry (starting from 1).
+  @param[out] injTimes the mean time (in seconds) at which the sampled water passed the node.
+  @param[out] weights the fraction of the sampled water that passed the node during the
+  time bin of the entry.
+  @return an error code.
+
+  A hydraulic analysis must have been run and saved to a hydraulics file (e.g. by
+  ::EN_solveH) before calling this function. The water sampled at each sensor node and
+  sample time is routed against the flow direction of the stored hydraulic periods: it is
+  split among the inflowing links of junctions in proportion to their flows, delayed by
+  the time it took to pass each pipe under the flows of all stored hydraulic periods
+  (incl. flow reversals), and mixed completely within tanks. Water that entered the
+  network from a reservoir or as a negative demand is not traced further.
+  If \p count exceeds \p capacity, only the first \p capacity entries are written and the
+  function should be called again with larger arrays.
+  The project's hydraulic results are not modified.
+  */
+  int DLLEXPORT EN_getbackwardinfluence(EN_Project ph, int nSensors, const int *sensors,
+                int nTimes, const double *times, long binSize, double minWeight,
+                int capacity, int *count, int *rows, int *nodes, double *injTimes,
+                double *weights);
+
+  /**
+  @brief Simulates a batch of variants (scenarios) of a project's network on a pool of threads.
+  @param ph an EPANET project handle.
+  @param nScenarios the number of scenarios.
+  @param params the simulation duration, hydraulic time step and reporting time step
+  (in seconds) of each scenario -- an array of nScenarios x 3 values. Values <= 0 keep
+  the network's time parameter.
+  @param eventStart the index of the first event of each scenario -- an array of
+  nScenarios + 1 values, the last of which is the total number of events.
+  @param eventTimes the time (in seconds) of each event, sorted within each scenario.
+  @param eventTargets the object type (\b EN_NODE or \b EN_LINK), index (starting from 1)
+  and property code (see @ref EN_NodeProperty and @ref EN_LinkProperty) of each event.
+  @param eventValues the property value that is set by each event.
+  @param nSensors the number of sensors.
+  @param sensors the object type, index and property code of each sensor.
+  @param nPeriods the number of reporting periods.
+  @param nThreads the number of threads.
+  @param[out] values the sensor readings -- an array of nScenarios x nPeriods x nSensors
+  values. Readings of periods that are not simulated are left unchanged.
+  @param[out] errcodes the error (or warning) code of each scenario.
+  @return an error code.
+
+  The network, in its current state, is written to a temporary input file which each
+  thread loads into a project of its own. A thread simulates one scenario after the other:
+  time steps are shortened so that the events take effect at their exact times, and the
+  properties changed by events are restored after a scenario. Hydraulics and water quality
+  (if any) are simulated together; nothing is written to the project's report or output file.
+  */
+  int DLLEXPORT EN_runbatch(EN_Project ph, int nScenarios, const long *params,
+                const int *eventStart, const long *eventTimes, const int *eventTargets,
+                const double *eventValues, int nSensors, const int *sensors, int nPeriods,
+                int nThreads, double *values, int *errcodes);
+
   /**
   @brief Closes the hydraulic solver freeing all of its allocated memory.
   @return an error code.
@@ -654,6 +750,251 @@ typedef struct Project *EN_Project;
   */
   int  DLLEXPORT EN_getresultindex(EN_Project ph, int type, int index, int *value);
 
+  /**
+  @brief Turns the timing of simulation phases on or off.
+  @param ph an EPANET project handle.
+  @param enabled 1 to enable profiling, 0 to disable it.
+  @return an error code.
+
+  Enabling profiling clears all previously collected profiling data. When profiling is
+  disabled, the overhead on the simulation is limited to a flag check per phase.
+  */
+  int  DLLEXPORT EN_setprofiling(EN_Project ph, int enabled);
+
+  /**
+  @brief Retrieves the profiling data collected for a simulation phase.
+  @param ph an EPANET project handle.
+  @param phase the simulation phase (see @ref EN_ProfilePhase).
+  @param[out] seconds the accumulated wall clock time (in seconds) spent in the phase.
+  @param[out] calls the number of times the phase was entered.
+  @param[out] iterations the total number of hydraulic trials (\b EN_PROF_HYDSOLVE only).
+  @return an error code.
+  */
+  int  DLLEXPORT EN_getprofile(EN_Project ph, int phase, double *seconds,
+                 int *calls, int *iterations);
+
+  /**
+  @brief Turns the recording of a timeline of simulation phases on or off.
+  @param ph an EPANET project handle.
+  @param size the capacity (in events) of the trace ring buffer, 0 disables tracing.
+  @return an error code.
+
+  Each time a simulation phase (see @ref EN_ProfilePhase) is left, an event holding
+  the phase, its start time and its duration is written to a ring buffer. Once the
+  buffer is full the oldest events are overwritten. Calling this function clears
+  all previously recorded events.
+  */
+  int  DLLEXPORT EN_settracing(EN_Project ph, int size);
+
+  /**
+  @brief Retrieves (and removes) the oldest events from the trace ring buffer.
+  @param ph an EPANET project handle.
+  @param maxEvents the size of the output arrays.
+  @param[out] phases the simulation phase of each event (see @ref EN_ProfilePhase).
+  @param[out] starts the time (in seconds) at which each phase was entered.
+  @param[out] durations the time (in seconds) spent in each phase.
+  @param[out] count the number of events retrieved.
+  @param[out] dropped the number of events lost due to buffer overflow since the last call.
+  @return an error code.
+
+  Time stamps refer to the clock read by @ref EN_gettraceclock.
+  */
+  int  DLLEXPORT EN_gettrace(EN_Project ph, int maxEvents, int *phases,
+                 double *starts, double *durations, int *count, int *dropped);
+
+  /**
+  @brief Reads the monotonic clock used to time stamp trace events.
+  @param ph an EPANET project handle.
+  @param[out] seconds the current time of the clock.
+  @return an error code.
+  */
+  int  DLLEXPORT EN_gettraceclock(EN_Project ph, double *seconds);
+
+  /**
+  @brief Turns the recording of per time step convergence diagnostics on or off.
+  @param ph an EPANET project handle.
+  @param enabled 1 to record diagnostics, 0 not to.
+  @return an error code.
+
+  Once enabled, every hydraulic time step solved appends a record (see
+  @ref EN_DiagnosticField) to the diagnostics stream. The stream is cleared whenever
+  the hydraulic solver is initialized and whenever this function is called.
+  */
+  int  DLLEXPORT EN_setdiagnostics(EN_Project ph, int enabled);
+
+  /**
+  @brief Retrieves the number of hydraulic time steps in the diagnostics stream.
+  @param ph an EPANET project handle.
+  @param[out] count the number of recorded time steps.
+  @return an error code.
+  */
+  int  DLLEXPORT EN_getdiagnosticscount(EN_Project ph, int *count);
+
+  /**
+  @brief Retrieves one field of the convergence diagnostics for all recorded time steps.
+  @param ph an EPANET project handle.
+  @param field the field to retrieve (see @ref EN_DiagnosticField).
+  @param count the size of the values array.
+  @param[out] values the field's value for each of the first count recorded time steps.
+  @return an error code.
+  */
+  int  DLLEXPORT EN_getdiagnostics(EN_Project ph, int field, int count, double *values);
+
+  /**
+  @brief Retrieves the amount of memory a project currently holds for one category of data.
+  @param ph an EPANET project handle.
+  @param category the memory category (see @ref EN_MemoryCategory).
+  @param[out] bytes the number of bytes allocated for that category.
+  @return an error code.
+
+  The hydraulic and water quality work arrays, the sparse matrix and the pipe segments
+  are only allocated while the respective solver is opened. @ref EN_MEM_FILES reports
+  the disk space used by the scratch files rather than memory.
+  */
+  int  DLLEXPORT EN_getmemoryusage(EN_Project ph, int category, double *bytes);
+
+  /**
+  @brief Estimates the memory the hydraulic and water quality solvers allocate when opened.
+  @param ph an EPANET project handle.
+  @param[out] bytes the number of bytes that opening the (closed) solvers adds to the memory
+  reported by @ref EN_getmemoryusage -- 0 if both solvers are open.
+  @return an error code.
+
+  The solvers are not opened and the project is left unchanged. The sparse matrix structure
+  is built and discarded again to account for the fill-ins of its factor, unless a structure
+  cached for warm starts will be re-used. Pipe segments are not included.
+  */
+  int  DLLEXPORT EN_getsolvermemory(EN_Project ph, double *bytes);
+
+  /**
+  @brief Turns warm starts of re-runs of the hydraulic analysis on or off.
+  @param ph an EPANET project handle.
+  @param enabled 1 to warm start re-runs, 0 not to.
+  @return an error code.
+
+  Once enabled, the solution of every hydraulic time step is recorded. After the
+  hydraulic solver has been re-initialized (see @ref EN_initH), each time step starts
+  from the previous run's solution at the same time (if any) instead of the previous
+  time step's solution -- after small changes of the model (e.g. pipe roughnesses or
+  valve settings) only a few trials are needed per time step. Furthermore, the node
+  re-ordering and symbolic factorization of the sparse matrix are kept when the solver
+  is closed and re-used when it is opened again, unless links or nodes were added,
+  deleted or re-connected in between.
+
+  The recorded solutions take memory proportional to the number of time steps times
+  the number of links & junctions. Calling this function discards them; it can not be
+  called while the hydraulic solver is open.
+  */
+  int  DLLEXPORT EN_setwarmstart(EN_Project ph, int enabled);
+
+  /**
+  @brief Sets the tolerance for accepting warm started time steps early.
+  @param ph an EPANET project handle.
+  @param tolerance the largest absolute flow change (in flow units) of the first trial
+  for which a warm started time step is accepted -- 0 (default) to solve every time
+  step to full accuracy.
+  @return an error code.
+
+  A time step that starts from the previous run's solution (see @ref EN_setwarmstart)
+  is accepted after its first trial if that trial changed no link flow by more than
+  the tolerance, i.e. if the previous run's solution already satisfies the current
+  equations. The check is made for each time step on its own, after the demands and
+  controls of that step were applied, and the status checks of a converged solution
+  still apply. Accepted steps are flagged with @ref EN_DIAGFLAG_WARMACCEPTED.
+  */
+  int  DLLEXPORT EN_setwarmstarttol(EN_Project ph, double tolerance);
+
+  /**
+  @brief Retrieves statistics of the current warm started run of the hydraulic analysis.
+  @param ph an EPANET project handle.
+  @param[out] steps the number of time steps solved since the solver was initialized.
+  @param[out] warmStarted the number of those time steps that started from the
+              previous run's solution.
+  @param[out] accepted the number of warm started time steps that were accepted after
+              their first trial (see @ref EN_setwarmstarttol).
+  @param[out] reused 1 if the solver re-used the sparse matrix structure of the
+              previous run, 0 if not.
+  @return an error code.
+  */
+  int  DLLEXPORT EN_getwarmstart(EN_Project ph, int *steps, int *warmStarted,
+                                 int *accepted, int *reused);
+
+  /**
+  @brief Sets observed sensor readings that the hydraulic analysis is compared with.
+  @param ph an EPANET project handle.
+  @param nSensors the number of sensors (0 to discard all observations).
+  @param objects the object type of each sensor (@ref EN_NODE or @ref EN_LINK).
+  @param indices the node or link index of each sensor (starting from 1).
+  @param properties the measured property of each sensor (see @ref EN_NodeProperty
+         and @ref EN_LinkProperty).
+  @param scales the factor the residuals of each sensor are multiplied with.
+  @param nTimes the number of observed time points.
+  @param times the observed time points (in seconds, strictly ascending).
+  @param values the observed readings (\p nTimes x \p nSensors, row by row) in the
+         units of @ref EN_getnodevalue and @ref EN_getlinkvalue -- NaN if missing.
+  @return an error code.
+
+  Every hydraulic time step at an observed time point adds the squared differences
+  between the simulated and the observed readings (multiplied by the sensor's scale) to a
+  sum that is retrieved by @ref EN_getresidual. The sum is reset whenever the hydraulic
+  solver is initialized. This function can not be called while the hydraulic solver is open.
+  */
+  int  DLLEXPORT EN_setobservations(EN_Project ph, int nSensors, const int *objects,
+                                    const int *indices, const int *properties,
+                                    const double *scales, int nTimes, const double *times,
+                                    const double *values);
+
+  /**
+  @brief Retrieves the residuals of the hydraulic analysis with respect to the
+  observed sensor readings set by @ref EN_setobservations.
+  @param ph an EPANET project handle.
+  @param[out] sum the sum of the squared (scaled) residuals.
+  @param[out] count the number of residuals (i.e. of non-missing observed readings
+              at the time points simulated so far).
+  @return an error code.
+  */
+  int  DLLEXPORT EN_getresidual(EN_Project ph, double *sum, int *count);
+
+  /**
+  @brief Selects how constituents are transported through the pipes of a network.
+  @param ph an EPANET project handle.
+  @param mode the routing method (see @ref EN_QualRouting).
+  @return an error code.
+
+  With @ref EN_ROUTE_EVENTS, a node is only updated when the leading segment of one of
+  its inflow pipes is used up (or, for tanks, every quality time step) instead of all
+  nodes being updated every quality time step. This skips the work on pipes whose
+  contents are uniform, e.g. when tracing a source in a large network. Since the
+  concentrations of reactive constituents change continuously, water age and reacting
+  chemicals are always transported over fixed quality time steps.
+
+  This function can not be called while the water quality solver is open.
+  */
+  int  DLLEXPORT EN_setqualrouting(EN_Project ph, int mode);
+
+  /**
+  @brief Retrieves the water quality routing method.
+  @param ph an EPANET project handle.
+  @param[out] mode the routing method (see @ref EN_QualRouting).
+  @param[out] events the number of node updates made by event-driven routing since
+              the water quality solver was initialized.
+  @return an error code.
+  */
+  int  DLLEXPORT EN_getqualrouting(EN_Project ph, int *mode, int *events);
+
+  /**
+  @brief Selects how the nodes are kept in topological (upstream to downstream) order
+  for water quality routing.
+  @param ph an EPANET project handle.
+  @param fullsort 1 to re-sort all nodes whenever the flow direction of a link changes,
+              0 (default) to only re-order the nodes affected by the changed links.
+  @return an error code.
+
+  Both settings give the same water quality results -- a full sort is slower and mainly
+  serves as a reference for checking the incremental update.
+  */
+  int  DLLEXPORT EN_setfullsort(EN_Project ph, int fullsort);
+
   /********************************************************************
 
   Analysis Options Functions
@@ -759,6 +1100,51 @@ typedef struct Project *EN_Project;
 
   /********************************************************************
 
+  Network Edit Functions
+
+  ********************************************************************/
+
+  /**
+  @brief Starts a transaction that batches changes to the network's structure.
+  @param ph an EPANET project handle.
+  @return an error code.
+
+  While a transaction is active, nodes, links, demands, time patterns and controls
+  can be added and deleted at a cost that does not grow with the size of the network:
+  the network's arrays grow geometrically, adding a junction only renumbers the links
+  connected to tanks and reservoirs, and deletions are deferred until the transaction
+  is committed with @ref EN_commitedit.
+
+  Deleted nodes and links can no longer be found by their ID names but keep their
+  indices (and are still counted by @ref EN_getcount) until the transaction is committed.
+  Indices retrieved during a transaction may therefore change when it is committed.
+
+  The hydraulic and water quality solvers can not be opened while a transaction is
+  active (error code 263).
+  */
+  int DLLEXPORT EN_beginedit(EN_Project ph);
+
+  /**
+  @brief Ends a transaction started with @ref EN_beginedit.
+  @param ph an EPANET project handle.
+  @return an error code.
+
+  All nodes and links deleted during the transaction -- together with the links,
+  simple and rule-based controls that contain them -- are removed in a single pass
+  and the remaining objects are renumbered. Nothing is done if no transaction is active.
+  */
+  int DLLEXPORT EN_commitedit(EN_Project ph);
+
+  /**
+  @brief Checks if a transaction started with @ref EN_beginedit is active.
+  @param ph an EPANET project handle.
+  @param[out] editing 1 if a transaction is active, 0 if not.
+  @return an error code.
+  */
+  int DLLEXPORT EN_getediting(EN_Project ph, int *editing);
+
+  /********************************************************************
+
   Node Functions
 
   ********************************************************************/
@@ -843,6 +1229,22 @@ typedef struct Project *EN_Project;
   */
   int  DLLEXPORT EN_getnodevalue(EN_Project ph, int index, int property, double *value);
 
+  /**
+  @brief Retrieves a property value for a list of nodes at once.
+  @param ph an EPANET project handle.
+  @param property the property to retrieve (see @ref EN_NodeProperty).
+  @param count the number of nodes.
+  @param indices the indices of the nodes (starting from 1).
+  @param[out] values the current value of the property of each node.
+  @return an error code.
+
+  Equivalent to calling @ref EN_getnodevalue for every node in \b indices --
+  use it to retrieve the values of a subset of nodes (e.g. sensor locations) at every
+  time step without one library call per node.
+  */
+  int  DLLEXPORT EN_getnodevaluelist(EN_Project ph, int property, int count,
+                 const int *indices, double *values);
+
   /**
   @brief Sets a property value for a node.
   @param ph an EPANET project handle.
@@ -1016,6 +1418,21 @@ typedef struct Project *EN_Project;
   int  DLLEXPORT EN_setbasedemand(EN_Project ph, int nodeIndex, int demandIndex,
                  double baseDemand);
 
+  /**
+  @brief Sets the base demands of a list of demand categories at once.
+  @param ph an EPANET project handle.
+  @param count the number of demand categories.
+  @param nodes the node index of each demand category (starting from 1).
+  @param demandIndices the index of each demand category for its node (starting from 1).
+  @param baseDemands the new base demand of each demand category.
+  @return an error code.
+
+  Equivalent to calling @ref EN_setbasedemand for every demand category. If an error
+  occurs, the demand categories before the failing one have already been changed.
+  */
+  int  DLLEXPORT EN_setbasedemandlist(EN_Project ph, int count, const int *nodes,
+                 const int *demandIndices, const double *baseDemands);
+
   /**
   @brief Retrieves the index of a time pattern assigned to one of a node's demand categories.
   @param ph an EPANET project handle.
@@ -1189,6 +1606,22 @@ typedef struct Project *EN_Project;
   */
   int  DLLEXPORT EN_setlinknodes(EN_Project ph, int index, int node1, int node2);
 
+  /**
+  @brief Retrieves the node adjacency of the network in compressed sparse row (CSR) format.
+  @param ph an EPANET project handle.
+  @param[out] rowPtr an array of size \b EN_NODECOUNT + 1 receiving the offsets of each
+  node's neighbors in \b colIdx and \b linkIdx.
+  @param[out] colIdx an array of size 2 * \b EN_LINKCOUNT receiving the indexes of the
+  neighboring nodes.
+  @param[out] linkIdx an array of size 2 * \b EN_LINKCOUNT receiving the indexes of the
+  connecting links.
+  @return an error code.
+
+  All returned indexes start from 0 (i.e. node/link index - 1). Each link appears twice,
+  once in the neighbors of each of its end nodes.
+  */
+  int  DLLEXPORT EN_getadjacency(EN_Project ph, int *rowPtr, int *colIdx, int *linkIdx);
+
   /**
   @brief Retrieves a property value for a link.
   @param ph an EPANET project handle.
@@ -1201,6 +1634,20 @@ typedef struct Project *EN_Project;
   */
   int  DLLEXPORT EN_getlinkvalue(EN_Project ph, int index, int property, double *value);
 
+  /**
+  @brief Retrieves a property value for a list of links at once.
+  @param ph an EPANET project handle.
+  @param property the property to retrieve (see @ref EN_LinkProperty).
+  @param count the number of links.
+  @param indices the indices of the links (starting from 1).
+  @param[out] values the current value of the property of each link.
+  @return an error code.
+
+  Equivalent to calling @ref EN_getlinkvalue for every link in \b indices.
+  */
+  int  DLLEXPORT EN_getlinkvaluelist(EN_Project ph, int property, int count,
+                 const int *indices, double *values);
+
   /**
   @brief Sets a property value for a link.
   @param ph an EPANET project handle.
@@ -1213,6 +1660,21 @@ typedef struct Project *EN_Project;
   */
   int  DLLEXPORT EN_setlinkvalue(EN_Project ph, int index, int property, double value);
 
+  /**
+  @brief Sets a property value for a list of links at once.
+  @param ph an EPANET project handle.
+  @param property the property to set (see @ref EN_LinkProperty).
+  @param count the number of links.
+  @param indices the indices of the links (starting from 1).
+  @param values the new value of the property of each link.
+  @return an error code.
+
+  Equivalent to calling @ref EN_setlinkvalue for every link in \b indices. If an error
+  occurs, the links before the failing one have already been changed.
+  */
+  int  DLLEXPORT EN_setlinkvaluelist(EN_Project ph, int property, int count,
+                 const int *indices, const double *values);
+
   /**
   @brief Sets a group of properties for a pipe link.
   @param ph an EPANET project handle.
@@ -1276,6 +1738,21 @@ typedef struct Project *EN_Project;
   */
   int  DLLEXPORT EN_getpumptype(EN_Project ph, int linkIndex, int *pumpType);
 
+  /**
+  @brief Retrieves the energy used by a pump since the hydraulic analysis was initialized.
+  @param ph an EPANET project handle.
+  @param linkIndex the index of a pump link (starting from 1).
+  @param[out] kwHrs the energy consumed by the pump (kw-hrs).
+  @param[out] cost the cost of the energy consumed by the pump.
+  @return an error code.
+
+  The values are accumulated at every hydraulic time step (see @ref EN_nextH) and
+  can be retrieved while a hydraulic analysis is running -- e.g. for comparing
+  the energy usage of different pump schedules.
+  */
+  int  DLLEXPORT EN_getpumpenergy(EN_Project ph, int linkIndex, double *kwHrs,
+                 double *cost);
+
   /**
   @brief Retrieves the curve assigned to a pump's head curve.
   @param ph an EPANET project handle.
@@ -1402,6 +1879,28 @@ typedef struct Project *EN_Project;
   */
   int  DLLEXPORT EN_setpattern(EN_Project ph, int index, double *values, int len);
 
+  /**
+  @brief Adds a set of new time patterns to a project at once.
+  @param ph an EPANET project handle.
+  @param nPatterns the number of time patterns to add.
+  @param ids the ID names of the new patterns, each one terminated by a null
+  character and stored one after another.
+  @param values the pattern factors of all new patterns.
+  @param len the number of factor values of each pattern.
+  @param[out] firstIndex the index of the first new pattern.
+  @return an error code.
+
+  \b values is a zero-based array that contains \b nPatterns x \b len elements,
+  the factors of the i-th pattern starting at element i x \b len.
+  The new patterns are assigned consecutive indices starting at \b firstIndex.
+
+  Use this function instead of calling @ref EN_addpattern and @ref EN_setpattern
+  for every pattern when adding a large number of patterns (e.g. one demand pattern
+  per node). No pattern is added if any of the ID names is invalid or already in use.
+  */
+  int  DLLEXPORT EN_addpatterns(EN_Project ph, int nPatterns, char *ids,
+                 double *values, int len, int *firstIndex);
+
   /********************************************************************
 
   Data Curve Functions
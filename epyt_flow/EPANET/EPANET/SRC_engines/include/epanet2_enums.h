@@ -138,6 +138,92 @@ typedef enum {
   EN_DEMANDREDUCTION = 6  //!< % demand reduction at pressure deficient nodes
 } EN_AnalysisStatistic;
 
+/// Profiling phases
+/**
+These constants identify the phases of a simulation whose accumulated run times and
+number of calls are recorded when profiling is enabled with @ref EN_setprofiling.
+They are retrieved with @ref EN_getprofile. Phases are nested as indicated by their
+indentation in the list below -- e.g. the time spent in \b EN_PROF_LINSOLVE is also
+included in \b EN_PROF_HYDSOLVE and \b EN_PROF_RUNHYD.
+*/
+typedef enum {
+  EN_PROF_RUNHYD         = 0,  //!< Hydraulic solution of a time period (@ref EN_runH)
+  EN_PROF_DEMANDS        = 1,  //!<   Computation of nodal demands
+  EN_PROF_CONTROLS       = 2,  //!<   Evaluation of simple controls
+  EN_PROF_HYDSOLVE       = 3,  //!<   Newton iterations of the hydraulic solver
+  EN_PROF_HEADLOSSCOEFFS = 4,  //!<     Computation of head loss coefficients
+  EN_PROF_MATRIXCOEFFS   = 5,  //!<     Assembly of the linear system
+  EN_PROF_LINSOLVE       = 6,  //!<     Solution of the linear system
+  EN_PROF_STATUSCHECKS   = 7,  //!<     Status checks of valves, pumps and links
+  EN_PROF_NEXTHYD        = 8,  //!< Advancement to the next hydraulic time period (@ref EN_nextH)
+  EN_PROF_SAVEHYD        = 9,  //!<   Writing of results to the hydraulics file
+  EN_PROF_TIMESTEP       = 10, //!<   Computation of the next time step incl. tank levels & rules
+  EN_PROF_RUNQUAL        = 11, //!< Initialization of a water quality time period (@ref EN_runQ)
+  EN_PROF_SORTNODES      = 12, //!<   Topological sorting of nodes
+  EN_PROF_SAVEOUTPUT     = 13, //!<   Writing of results to the output file
+  EN_PROF_TRANSPORT      = 14, //!< Water quality transport (@ref EN_nextQ, @ref EN_stepQ)
+  EN_PROF_REACT          = 15, //!<   Reactions within pipes and tanks
+  EN_PROF_ADVECT         = 16, //!<   Advection of pipe segments
+  EN_PROF_MIX            = 17  //!<   Mixing at nodes
+} EN_ProfilePhase;
+
+/// Hydraulic step diagnostics
+/**
+These fields of the per time step convergence diagnostics are retrieved by
+@ref EN_getdiagnostics once their recording was turned on with @ref EN_setdiagnostics.
+*/
+typedef enum {
+  EN_DIAG_TIME            = 0, //!< Hydraulic time of the step (sec)
+  EN_DIAG_ITERATIONS      = 1, //!< Number of hydraulic trials taken
+  EN_DIAG_RELERROR        = 2, //!< Relative flow change (convergence error)
+  EN_DIAG_MAXHEADERROR    = 3, //!< Max. head loss error (project head units)
+  EN_DIAG_MAXFLOWCHANGE   = 4, //!< Max. flow change (project flow units)
+  EN_DIAG_STATUSCHANGES   = 5, //!< Number of links whose status changed during the step
+  EN_DIAG_BADVALVES       = 6, //!< Number of ill-conditioned matrices fixed by opening a control valve
+  EN_DIAG_DEFICIENTNODES  = 7, //!< Number of pressure deficient nodes (PDA)
+  EN_DIAG_DEMANDREDUCTION = 8, //!< Demand reduction (%) at pressure deficient nodes (PDA)
+  EN_DIAG_FLAGS           = 9  //!< Combination of @ref EN_DiagnosticFlag bits
+} EN_DiagnosticField;
+
+/// Hydraulic step diagnostic flags
+/**
+Bits of the @ref EN_DIAG_FLAGS field of the hydraulic step diagnostics.
+*/
+typedef enum {
+  EN_DIAGFLAG_CONVERGED    = 1, //!< Solution met the convergence criteria
+  EN_DIAGFLAG_EXTRATRIALS  = 2, //!< Extra trials were needed (i.e. status cycling)
+  EN_DIAGFLAG_DAMPED       = 4, //!< Solution damping was applied
+  EN_DIAGFLAG_REUSEDORDER  = 8, //!< Node re-ordering & symbolic factorization were reused
+  EN_DIAGFLAG_WARMSTART    = 16, //!< Solution started from the previous run's (see @ref EN_setwarmstart)
+  EN_DIAGFLAG_WARMACCEPTED = 32  //!< Warm start accepted within the tolerance (see @ref EN_setwarmstarttol)
+} EN_DiagnosticFlag;
+
+/// Memory categories
+/**
+These are the categories of memory held by a project that can be retrieved with
+@ref EN_getmemoryusage.
+*/
+typedef enum {
+  EN_MEM_NETWORK    = 0, //!< Network objects, demands, patterns, curves, controls, ID hash tables & adjacency lists
+  EN_MEM_HYDRAULICS = 1, //!< Hydraulic solution, work arrays of the hydraulic solver & solutions recorded for warm starts
+  EN_MEM_SPARSE     = 2, //!< Sparse matrix incl. the structure of its Cholesky factor (also if cached for warm starts)
+  EN_MEM_QUALITY    = 3, //!< Water quality solution & work arrays of the quality solver
+  EN_MEM_SEGMENTS   = 4, //!< Memory pool of the pipe segments used for water quality routing
+  EN_MEM_OUTPUT     = 5, //!< Buffer used for writing results to the binary output file
+  EN_MEM_PROFILING  = 6, //!< Trace buffer & recorded solver diagnostics
+  EN_MEM_FILES      = 7  //!< Disk space used by the hydraulics & binary output files
+} EN_MemoryCategory;
+
+/// Water quality routing modes
+/**
+These are the modes of routing water quality through the pipe network that can be
+selected with @ref EN_setqualrouting.
+*/
+typedef enum {
+  EN_ROUTE_STEPS  = 0, //!< Transport over fixed quality time steps (default)
+  EN_ROUTE_EVENTS = 1  //!< Transport driven by the arrival of pipe segments at nodes
+} EN_QualRouting;
+
 /// Types of network objects
 /**
 The types of objects that comprise a network model.
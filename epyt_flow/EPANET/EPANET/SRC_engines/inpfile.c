@@ -42,7 +42,7 @@ void saveauxdata(Project *pr, FILE *f)
 */
 {
     int sect, newsect;
-    char *tok;
+    char *tok, *next;
     char write;
     char line[MAXLINE + 1];
     char s[MAXLINE + 1];
@@ -61,7 +61,7 @@ void saveauxdata(Project *pr, FILE *f)
     while (fgets(line, MAXLINE, InFile) != NULL)
     {
         strcpy(s, line);
-        tok = strtok(s, SEPSTR);
+        tok = strtok_r(s, SEPSTR, &next);
         if (tok == NULL) continue;
 
         // Check if line begins with a new section heading
@@ -92,8 +92,8 @@ void saveauxdata(Project *pr, FILE *f)
             {
             case _TAGS:
                 if (*tok == ';' ||
-                    (match("NODE", tok) && findnode(&pr->network, strtok(NULL, SEPSTR))) ||
-                    (match("LINK", tok) && findlink(&pr->network, strtok(NULL, SEPSTR))))
+                    (match("NODE", tok) && findnode(&pr->network, strtok_r(NULL, SEPSTR, &next))) ||
+                    (match("LINK", tok) && findlink(&pr->network, strtok_r(NULL, SEPSTR, &next))))
                     write = TRUE;
                 break;
             case _LABELS:
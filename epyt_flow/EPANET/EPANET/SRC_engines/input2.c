@@ -55,6 +55,7 @@ int netsize(Project *pr)
 
     char line[MAXLINE + 1]; // Line from input data file
     char *tok;              // First token of line
+    char *next;             // Position of tokenizer
     int sect, newsect;      // Input data sections
     int errcode = 0;        // Error code
     Spattern *pattern;
@@ -87,7 +88,7 @@ int netsize(Project *pr)
     while (fgets(line, MAXLINE, parser->InFile) != NULL)
     {
         // Skip blank lines & those beginning with a comment
-        tok = strtok(line, SEPSTR);
+        tok = strtok_r(line, SEPSTR, &next);
         if (tok == NULL) continue;
         if (*tok == ';') continue;
 
@@ -758,16 +759,16 @@ double hour(char *time, char *units)
 {
     int n;
     double y[3];
-    char *s;
+    char *s, *next;
 
     // Separate clock time into hrs, min, sec
     for (n = 0; n < 3; n++) y[n] = 0.0;
     n = 0;
-    s = strtok(time, ":");
+    s = strtok_r(time, ":", &next);
     while (s != NULL && n <= 3)
     {
         if (!getfloat(s, &y[n])) return -1.0;
-        s = strtok(NULL, ":");
+        s = strtok_r(NULL, ":", &next);
         n++;
     }
 
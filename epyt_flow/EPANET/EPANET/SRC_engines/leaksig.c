@@ -0,0 +1,358 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       leaksig.c
+ Description:  computes the pressure signatures of candidate leaks (emitters)
+               by warm-started Newton solves around the current hydraulic
+               solution
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "types.h"
+#include "funcs.h"
+
+// Imported functions
+extern int hydsolvefixed(Project *, int *, double *);  //(see HYDSOLVER.C)
+
+// Work space of a thread -- a shallow copy of the project whose
+// hydraulic work arrays and nodes are private, while everything
+// else (incl. the sparse matrix structure and its symbolic
+// factorization) is shared with the project
+typedef struct {
+    Project  pr;                 // Project with private work arrays
+    Project  *base;              // Project holding the base solution
+    int      id;                 // Thread index
+    int      nthreads;           // Number of threads
+    int      ncandidates;        // Number of candidate leaks
+    const int    *nodes;         // Nodes of candidate leaks
+    const double *coeffs;        // Emitter coeffs. of candidate leaks
+    int      nsensors;           // Number of sensor nodes
+    const int    *sensors;       // Sensor nodes
+    double   *out;               // Pressure drops (sensors x candidates)
+    int      errcode;            // Error code
+    int      unconverged;        // # candidates without convergence
+} LeakWorker;
+
+// Local functions
+static int   allocworker(LeakWorker *, Project *);
+static void  freeworker(LeakWorker *);
+static void  restorebase(LeakWorker *);
+static void  solvecandidates(LeakWorker *);
+
+#ifdef _WIN32
+static DWORD WINAPI workerthread(LPVOID);
+#else
+static void *workerthread(void *);
+#endif
+
+
+int leaksignatures(Project *pr, int ncandidates, const int *nodes,
+                   const double *coeffs, int nsensors, const int *sensors,
+                   int nthreads, double *out)
+/*
+**--------------------------------------------------------------
+**  Input:   ncandidates = number of candidate leaks
+**           nodes = junction index of each candidate leak
+**           coeffs = emitter head loss coeff. of each candidate leak
+**                    (internal units, see Snode.Ke)
+**           nsensors = number of sensor nodes
+**           sensors = index of each sensor node
+**           nthreads = number of threads
+**  Output:  out = pressure drop at each sensor node caused by each
+**                 candidate leak (nsensors x ncandidates, row-major)
+**  Returns: error code (or 1 if some candidates did not converge)
+**  Purpose: computes the pressure drops of a set of candidate
+**           leaks relative to the current hydraulic solution
+**
+**  Notes:   Each candidate leak is modelled as an (additional)
+**           emitter at its node. Starting from the current solution,
+**           the network equations are re-solved with the statuses of
+**           all links, tank levels and demands held fixed. The
+**           candidates are distributed over the threads, each one
+**           re-using the project's sparse matrix structure.
+**--------------------------------------------------------------
+*/
+{
+    int i, errcode = 0, unconverged = 0;
+    LeakWorker *workers;
+
+    nthreads = MAX(1, MIN(nthreads, ncandidates));
+    workers = (LeakWorker *)calloc(nthreads, sizeof(LeakWorker));
+    if (workers == NULL) return 101;
+
+    for (i = 0; i < nthreads; i++)
+    {
+        workers[i].id = i;
+        workers[i].nthreads = nthreads;
+        workers[i].ncandidates = ncandidates;
+        workers[i].nodes = nodes;
+        workers[i].coeffs = coeffs;
+        workers[i].nsensors = nsensors;
+        workers[i].sensors = sensors;
+        workers[i].out = out;
+        if (!errcode) errcode = allocworker(&workers[i], pr);
+    }
+
+    // Solve for all candidates
+    if (!errcode)
+    {
+        if (nthreads == 1) solvecandidates(&workers[0]);
+        else
+        {
+#ifdef _WIN32
+            HANDLE *threads = (HANDLE *)calloc(nthreads, sizeof(HANDLE));
+            if (threads == NULL) errcode = 101;
+            else
+            {
+                for (i = 0; i < nthreads; i++)
+                {
+                    threads[i] = CreateThread(NULL, 0, workerthread, &workers[i], 0, NULL);
+                    if (threads[i] == NULL) solvecandidates(&workers[i]);
+                }
+                for (i = 0; i < nthreads; i++)
+                {
+                    if (threads[i] == NULL) continue;
+                    WaitForSingleObject(threads[i], INFINITE);
+                    CloseHandle(threads[i]);
+                }
+                free(threads);
+            }
+#else
+            pthread_t *threads = (pthread_t *)calloc(nthreads, sizeof(pthread_t));
+            int *started = (int *)calloc(nthreads, sizeof(int));
+            if (threads == NULL || started == NULL) errcode = 101;
+            else
+            {
+                for (i = 0; i < nthreads; i++)
+                {
+                    started[i] = pthread_create(&threads[i], NULL, workerthread,
+                                                &workers[i]) == 0;
+                    if (!started[i]) solvecandidates(&workers[i]);
+                }
+                for (i = 0; i < nthreads; i++)
+                {
+                    if (started[i]) pthread_join(threads[i], NULL);
+                }
+            }
+            free(threads);
+            free(started);
+#endif
+        }
+    }
+
+    for (i = 0; i < nthreads; i++)
+    {
+        if (!errcode) errcode = workers[i].errcode;
+        unconverged += workers[i].unconverged;
+        freeworker(&workers[i]);
+    }
+    free(workers);
+    if (!errcode && unconverged > 0) errcode = 1;
+    return errcode;
+}
+
+
+int allocworker(LeakWorker *w, Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   pr = project holding the base solution
+**  Output:  returns error code
+**  Purpose: creates a thread's copy of a project with private
+**           hydraulic work arrays
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    int nnodes = net->Nnodes + 1;
+    int nlinks = net->Nlinks + 1;
+    int errcode = 0;
+    Hydraul *hyd;
+    Smatrix *sm;
+
+    // Shallow copy of the project -- profiling, diagnostics and
+    // status reporting are turned off since they are not private
+    w->base = pr;
+    w->pr = *pr;
+    w->pr.profile.Enabled = FALSE;
+    w->pr.profile.Tracing = FALSE;
+    w->pr.diagnostics.Enabled = FALSE;
+    w->pr.report.Statflag = FALSE;
+
+    hyd = &w->pr.hydraul;
+    sm = &hyd->smatrix;
+    w->pr.network.Node = (Snode *)calloc(nnodes, sizeof(Snode));
+    hyd->NodeHead = (double *)calloc(nnodes, sizeof(double));
+    hyd->NodeDemand = (double *)calloc(nnodes, sizeof(double));
+    hyd->DemandFlow = (double *)calloc(nnodes, sizeof(double));
+    hyd->EmitterFlow = (double *)calloc(nnodes, sizeof(double));
+    hyd->Xflow = (double *)calloc(nnodes, sizeof(double));
+    hyd->LinkFlow = (double *)calloc(nlinks, sizeof(double));
+    hyd->P = (double *)calloc(nlinks, sizeof(double));
+    hyd->Y = (double *)calloc(nlinks, sizeof(double));
+    sm->Aij = (double *)calloc(sm->Ncoeffs + 1, sizeof(double));
+    sm->Aii = (double *)calloc(nnodes, sizeof(double));
+    sm->F = (double *)calloc(nnodes, sizeof(double));
+    sm->temp = (double *)calloc(nnodes, sizeof(double));
+    sm->link = (int *)calloc(nnodes, sizeof(int));
+    sm->first = (int *)calloc(nnodes, sizeof(int));
+    ERRCODE(MEMCHECK(w->pr.network.Node));
+    ERRCODE(MEMCHECK(hyd->NodeHead));
+    ERRCODE(MEMCHECK(hyd->NodeDemand));
+    ERRCODE(MEMCHECK(hyd->DemandFlow));
+    ERRCODE(MEMCHECK(hyd->EmitterFlow));
+    ERRCODE(MEMCHECK(hyd->Xflow));
+    ERRCODE(MEMCHECK(hyd->LinkFlow));
+    ERRCODE(MEMCHECK(hyd->P));
+    ERRCODE(MEMCHECK(hyd->Y));
+    ERRCODE(MEMCHECK(sm->Aij));
+    ERRCODE(MEMCHECK(sm->Aii));
+    ERRCODE(MEMCHECK(sm->F));
+    ERRCODE(MEMCHECK(sm->temp));
+    ERRCODE(MEMCHECK(sm->link));
+    ERRCODE(MEMCHECK(sm->first));
+    if (!errcode)
+    {
+        memcpy(w->pr.network.Node, net->Node, nnodes * sizeof(Snode));
+    }
+    return errcode;
+}
+
+
+void freeworker(LeakWorker *w)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: frees a thread's private work arrays
+**--------------------------------------------------------------
+*/
+{
+    Hydraul *hyd = &w->pr.hydraul;
+    Smatrix *sm = &hyd->smatrix;
+
+    // Nothing was allocated if the copy was never made
+    if (w->base == NULL) return;
+
+    free(w->pr.network.Node);
+    free(hyd->NodeHead);
+    free(hyd->NodeDemand);
+    free(hyd->DemandFlow);
+    free(hyd->EmitterFlow);
+    free(hyd->Xflow);
+    free(hyd->LinkFlow);
+    free(hyd->P);
+    free(hyd->Y);
+    free(sm->Aij);
+    free(sm->Aii);
+    free(sm->F);
+    free(sm->temp);
+    free(sm->link);
+    free(sm->first);
+}
+
+
+void restorebase(LeakWorker *w)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: resets a thread's solution to the base solution
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &w->base->network;
+    Hydraul *base = &w->base->hydraul;
+    Hydraul *hyd = &w->pr.hydraul;
+    int i;
+    int nnodes = net->Nnodes + 1;
+    int nlinks = net->Nlinks + 1;
+
+    memcpy(hyd->NodeHead, base->NodeHead, nnodes * sizeof(double));
+    memcpy(hyd->EmitterFlow, base->EmitterFlow, nnodes * sizeof(double));
+    memcpy(hyd->LinkFlow, base->LinkFlow, nlinks * sizeof(double));
+
+    // After a solution, NodeDemand holds the actual outflow (demand
+    // + emitter flow) and DemandFlow the full demand (see hydsolve)
+    for (i = 1; i <= net->Njuncs; i++)
+    {
+        hyd->NodeDemand[i] = base->DemandFlow[i];
+        if (base->DemandModel == PDA)
+        {
+            hyd->DemandFlow[i] = base->NodeDemand[i] - base->EmitterFlow[i];
+        }
+        else hyd->DemandFlow[i] = base->DemandFlow[i];
+    }
+}
+
+
+void solvecandidates(LeakWorker *w)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: solves for every nthreads-th candidate leak
+**--------------------------------------------------------------
+*/
+{
+    Project *pr = &w->pr;
+    Snode *node = pr->network.Node;
+    double *head = pr->hydraul.NodeHead;
+    double *basehead = w->base->hydraul.NodeHead;
+    double ucf = pr->Ucf[PRESSURE];
+    double ke, relerr;
+    int c, j, n, s, iter, errcode;
+
+    for (c = w->id; c < w->ncandidates; c += w->nthreads)
+    {
+        // Add the candidate's emitter and solve from the base solution
+        n = w->nodes[c];
+        ke = node[n].Ke;
+        node[n].Ke = w->coeffs[c];
+        restorebase(w);
+        errcode = hydsolvefixed(pr, &iter, &relerr);
+        node[n].Ke = ke;
+        if (errcode > 0)
+        {
+            w->errcode = errcode;
+            return;
+        }
+        if (errcode < 0) w->unconverged++;
+
+        // Pressure drops at sensor nodes
+        for (j = 0; j < w->nsensors; j++)
+        {
+            s = w->sensors[j];
+            w->out[(size_t)j * w->ncandidates + c] = (basehead[s] - head[s]) * ucf;
+        }
+    }
+}
+
+
+#ifdef _WIN32
+DWORD WINAPI workerthread(LPVOID arg)
+{
+    solvecandidates((LeakWorker *)arg);
+    return 0;
+}
+#else
+void *workerthread(void *arg)
+{
+    solvecandidates((LeakWorker *)arg);
+    return NULL;
+}
+#endif
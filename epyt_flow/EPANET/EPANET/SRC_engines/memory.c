@@ -0,0 +1,529 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       memory.c
+ Description:  accounting of the memory allocated by a project
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "types.h"
+#include "funcs.h"
+#include "mempool.h"
+
+// Imported functions
+extern int  createsparse(Project *);   //(see SMATRIX.C)
+extern void freesparse(Project *);     //(see SMATRIX.C)
+
+// Size of a 1-based array of n items of a given type
+#define ARRAYSIZE(n, type) ((double)((n) + 1) * sizeof(type))
+
+static double networkmemory(Project *);
+static double hydraulicsmemory(Project *);
+static double hydworkmemory(Network *);
+static double adjlistmemory(Network *);
+static double sparsememory(Project *);
+static int    sparseestimate(Project *, double *);
+static double smatrixmemory(Smatrix *, int, int, int);
+static double warmstartmemory(SHydRun *);
+static double qualitymemory(Project *);
+static double outputmemory(Project *);
+static double profilingmemory(Project *);
+static double filesmemory(Project *);
+static double filesize(const char *);
+
+
+int memusage(Project *pr, int category, double *bytes)
+/*
+**--------------------------------------------------------------
+**  Input:   category = a memory category (see EN_MemoryCategory)
+**  Output:  bytes = number of bytes currently allocated
+**  Returns: error code
+**  Purpose: computes the amount of memory a project currently
+**           holds for a given category
+**--------------------------------------------------------------
+*/
+{
+    *bytes = 0.0;
+    switch (category)
+    {
+    case EN_MEM_NETWORK:
+        *bytes = networkmemory(pr);
+        break;
+    case EN_MEM_HYDRAULICS:
+        *bytes = hydraulicsmemory(pr);
+        break;
+    case EN_MEM_SPARSE:
+        *bytes = sparsememory(pr);
+        break;
+    case EN_MEM_QUALITY:
+        *bytes = qualitymemory(pr);
+        break;
+    case EN_MEM_SEGMENTS:
+        if (pr->quality.OpenQflag)
+        {
+            *bytes = (double)mempool_size(pr->quality.SegPool);
+        }
+        break;
+    case EN_MEM_OUTPUT:
+        *bytes = outputmemory(pr);
+        break;
+    case EN_MEM_PROFILING:
+        *bytes = profilingmemory(pr);
+        break;
+    case EN_MEM_FILES:
+        *bytes = filesmemory(pr);
+        break;
+    default:
+        return 251;
+    }
+    return 0;
+}
+
+
+double networkmemory(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns number of bytes
+**  Purpose: computes the memory held by the network's objects,
+**           demands, patterns, curves, controls, rules, ID hash
+**           tables and node adjacency lists
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Parser *parser = &pr->parser;
+    int i;
+    double bytes = 0.0;
+    Pdemand demand;
+    Pvertices vertices;
+    Spremise *premise;
+    Saction *action;
+
+    bytes += ARRAYSIZE(MAX(parser->MaxNodes, net->Nnodes), Snode);
+    bytes += ARRAYSIZE(MAX(parser->MaxLinks, net->Nlinks), Slink);
+    bytes += ARRAYSIZE(MAX(parser->MaxTanks, net->Ntanks), Stank);
+    bytes += ARRAYSIZE(MAX(parser->MaxPumps, net->Npumps), Spump);
+    bytes += ARRAYSIZE(MAX(parser->MaxValves, net->Nvalves), Svalve);
+    bytes += ARRAYSIZE(MAX(parser->MaxControls, net->Ncontrols), Scontrol);
+    bytes += ARRAYSIZE(net->Npats, Spattern);
+    bytes += ARRAYSIZE(net->Ncurves, Scurve);
+    bytes += ARRAYSIZE(net->Nrules, Srule);
+
+    for (i = 1; i <= net->Nnodes; i++)
+    {
+        for (demand = net->Node[i].D; demand != NULL; demand = demand->next)
+        {
+            bytes += sizeof(struct Sdemand);
+            if (demand->Name) bytes += strlen(demand->Name) + 1;
+        }
+        if (net->Node[i].S) bytes += sizeof(struct Ssource);
+        if (net->Node[i].Comment) bytes += strlen(net->Node[i].Comment) + 1;
+    }
+    for (i = 1; i <= net->Nlinks; i++)
+    {
+        vertices = net->Link[i].Vertices;
+        if (vertices) bytes += sizeof(struct Svertices) +
+                               2.0 * vertices->Capacity * sizeof(double);
+        if (net->Link[i].Comment) bytes += strlen(net->Link[i].Comment) + 1;
+    }
+    for (i = 0; i <= net->Npats; i++)
+    {
+        bytes += (double)net->Pattern[i].Length * sizeof(double);
+    }
+    // There is no Curve[0]
+    for (i = 1; i <= net->Ncurves; i++)
+    {
+        bytes += 2.0 * net->Curve[i].Capacity * sizeof(double);
+    }
+    for (i = 1; i <= net->Nrules; i++)
+    {
+        for (premise = net->Rule[i].Premises; premise; premise = premise->next)
+        {
+            bytes += sizeof(Spremise);
+        }
+        for (action = net->Rule[i].ThenActions; action; action = action->next)
+        {
+            bytes += sizeof(Saction);
+        }
+        for (action = net->Rule[i].ElseActions; action; action = action->next)
+        {
+            bytes += sizeof(Saction);
+        }
+    }
+
+    bytes += (double)hashtable_memsize(net->NodeHashTable);
+    bytes += (double)hashtable_memsize(net->LinkHashTable);
+
+    bytes += adjlistmemory(net);
+    return bytes;
+}
+
+
+double adjlistmemory(Network *net)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns number of bytes
+**  Purpose: computes the memory held by the node adjacency lists
+**--------------------------------------------------------------
+*/
+{
+    int i;
+    double bytes = 0.0;
+    Padjlist alink;
+
+    if (net->Adjlist == NULL) return 0.0;
+    bytes += ARRAYSIZE(net->Nnodes, Padjlist);
+    for (i = 0; i <= net->Nnodes; i++)
+    {
+        for (alink = net->Adjlist[i]; alink != NULL; alink = alink->next)
+        {
+            bytes += sizeof(struct Sadjlist);
+        }
+    }
+    return bytes;
+}
+
+
+double hydraulicsmemory(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns number of bytes
+**  Purpose: computes the memory held by the hydraulic solution
+**           and the hydraulic solver's work arrays
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    int nnodes = MAX(pr->parser.MaxNodes, net->Nnodes);
+    int nlinks = MAX(pr->parser.MaxLinks, net->Nlinks);
+    int i;
+    double bytes = 0.0;
+    Scurvetab *tab;
+
+    // Solution arrays allocated along with the network
+    bytes += 2.0 * ARRAYSIZE(nnodes, double);
+    bytes += 2.0 * ARRAYSIZE(nlinks, double) + ARRAYSIZE(nlinks, StatusType);
+
+    // Work arrays allocated when the hydraulic solver is opened
+    if (hyd->OpenHflag) bytes += hydworkmemory(net);
+
+    // Lookup tables of data curves
+    if (hyd->CurveTab != NULL)
+    {
+        bytes += ARRAYSIZE(hyd->Ncurvetabs, Scurvetab);
+        for (i = 1; i <= hyd->Ncurvetabs; i++)
+        {
+            tab = &hyd->CurveTab[i];
+            bytes += 2.0 * tab->Npts * sizeof(double);
+            bytes += (double)(tab->Nxbins + tab->Nybins) * sizeof(int);
+        }
+    }
+
+    // Solutions recorded for warm starts
+    bytes += warmstartmemory(&pr->warmstart.Prev);
+    bytes += warmstartmemory(&pr->warmstart.Curr);
+    return bytes;
+}
+
+
+double hydworkmemory(Network *net)
+/*
+**--------------------------------------------------------------
+**  Input:   net = network
+**  Output:  returns number of bytes
+**  Purpose: computes the size of the work arrays allocated when
+**           the hydraulic solver is opened
+**--------------------------------------------------------------
+*/
+{
+    double bytes = 0.0;
+
+    bytes += 2.0 * ARRAYSIZE(net->Nlinks, double);
+    bytes += 2.0 * ARRAYSIZE(net->Nnodes, double);
+    bytes += ARRAYSIZE(MAX(net->Nnodes, net->Nlinks), double);
+    bytes += ARRAYSIZE(net->Nlinks + net->Ntanks, StatusType);
+    return bytes;
+}
+
+
+int solvermemory(Project *pr, double *bytes)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  bytes = number of bytes
+**  Returns: error code
+**  Purpose: computes the memory that opening the hydraulic and
+**           water quality solvers allocates in addition to the
+**           memory currently held (0 if both are open)
+**
+**  Notes:   The solvers are not opened -- only the structure of
+**           the sparse matrix is built and discarded again (see
+**           sparseestimate()). Pipe segments and the event queue
+**           of event-driven routing are not included.
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Quality *qual = &pr->quality;
+
+    int i, errcode = 0;
+    double sparse = 0.0;
+
+    *bytes = 0.0;
+    if (!pr->hydraul.OpenHflag)
+    {
+        *bytes += hydworkmemory(net);
+        *bytes += ARRAYSIZE(net->Ncurves, Scurvetab);
+        for (i = 1; i <= net->Ncurves; i++)
+        {
+            *bytes += curvetabsize(&net->Curve[i]);
+        }
+        errcode = sparseestimate(pr, &sparse);
+        *bytes += sparse;
+    }
+    if (!qual->OpenQflag && qual->Qualflag != NONE)
+    {
+        *bytes += ARRAYSIZE(net->Nlinks, FlowDirection);
+        *bytes += ARRAYSIZE(net->Nlinks, double);
+        *bytes += 2.0 * ARRAYSIZE(net->Nlinks + net->Ntanks, Pseg);
+        *bytes += ARRAYSIZE(net->Nlinks + net->Ntanks, int);
+        *bytes += 5.0 * ARRAYSIZE(net->Nnodes, int) + ARRAYSIZE(net->Nlinks, int);
+    }
+    return errcode;
+}
+
+
+int sparseestimate(Project *pr, double *bytes)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  bytes = number of bytes
+**  Returns: error code
+**  Purpose: computes the memory the sparse matrix of the (closed)
+**           hydraulic solver will hold once the solver is opened
+**
+**  Notes:   The number of fill-ins of the Cholesky factor is only
+**           known after re-ordering the nodes, so the structure is
+**           built on the solver's (unused) sparse matrix and freed
+**           again. The node adjacency lists, which are rebuilt on
+**           the way and kept by the opened solver, are included
+**           and restored to their previous state.
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Warmstart *ws = &pr->warmstart;
+
+    int errcode, hadlists = (net->Adjlist != NULL);
+    double lists = adjlistmemory(net);
+    Smatrix closed;
+
+    // A cached structure is re-used and already accounted for
+    *bytes = 0.0;
+    if (ws->Enabled && ws->CacheValid) return 0;
+
+    closed = hyd->smatrix;
+    errcode = createsparse(pr);
+    if (!errcode)
+    {
+        *bytes = smatrixmemory(&hyd->smatrix, net->Nnodes, net->Nlinks,
+                               net->Njuncs);
+        *bytes += adjlistmemory(net) - lists;
+    }
+    freesparse(pr);
+    hyd->smatrix = closed;
+    if (hadlists) ERRCODE(buildadjlists(net));
+    else freeadjlists(net);
+    return errcode;
+}
+
+
+double warmstartmemory(SHydRun *run)
+/*
+**--------------------------------------------------------------
+**  Input:   run = solutions recorded for a simulation run
+**  Output:  returns number of bytes
+**  Purpose: computes the memory held by recorded solutions
+**--------------------------------------------------------------
+*/
+{
+    if (run->Time == NULL) return 0.0;
+    return (double)run->Capacity * (sizeof(long) + sizeof(double) *
+           ((double)run->Nlinks + 3.0 * MAX(run->Njuncs, 1)));
+}
+
+
+double sparsememory(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns number of bytes
+**  Purpose: computes the memory held by the sparse matrix of the
+**           hydraulic solver, incl. the structure of its
+**           Cholesky factor and a structure cached for warm starts
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Warmstart *ws = &pr->warmstart;
+    double bytes = 0.0;
+
+    if (pr->hydraul.OpenHflag)
+    {
+        bytes += smatrixmemory(&pr->hydraul.smatrix, net->Nnodes, net->Nlinks,
+                               net->Njuncs);
+    }
+    if (ws->CacheValid)
+    {
+        bytes += smatrixmemory(&ws->Cache, ws->CacheNnodes, ws->CacheNlinks,
+                               ws->CacheNjuncs);
+        bytes += 2.0 * ARRAYSIZE(ws->CacheNlinks, int);
+    }
+    return bytes;
+}
+
+
+double smatrixmemory(Smatrix *sm, int nnodes, int nlinks, int n)
+/*
+**--------------------------------------------------------------
+**  Input:   sm = sparse matrix
+**           nnodes = number of nodes
+**           nlinks = number of links
+**           n = number of junctions (rows)
+**  Output:  returns number of bytes
+**  Purpose: computes the memory held by a sparse matrix
+**--------------------------------------------------------------
+*/
+{
+    double bytes = 0.0;
+
+    if (sm->Order) bytes += 2.0 * ARRAYSIZE(nnodes, int);
+    if (sm->Ndx) bytes += ARRAYSIZE(nlinks, int);
+    if (sm->XLNZ) bytes += ARRAYSIZE(n + 1, int);
+    if (sm->NZSUB) bytes += 2.0 * ARRAYSIZE(sm->Ncoeffs + 1, int);
+    if (sm->Aij) bytes += ARRAYSIZE(sm->Ncoeffs, double);
+    if (sm->Aii) bytes += 3.0 * ARRAYSIZE(n, double) + 2.0 * ARRAYSIZE(n, int);
+    return bytes;
+}
+
+
+double qualitymemory(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns number of bytes
+**  Purpose: computes the memory held by the water quality
+**           solution and the quality solver's work arrays
+**           (without the pipe segments)
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Quality *qual = &pr->quality;
+    double bytes = 0.0;
+
+    bytes += ARRAYSIZE(MAX(pr->parser.MaxNodes, net->Nnodes), double);
+    if (!qual->OpenQflag) return bytes;
+    if (qual->FlowDir) bytes += ARRAYSIZE(net->Nlinks, FlowDirection);
+    if (qual->PipeRateCoeff) bytes += ARRAYSIZE(net->Nlinks, double);
+    if (qual->FirstSeg) bytes += 2.0 * ARRAYSIZE(net->Nlinks + net->Ntanks, Pseg);
+    if (qual->SortedNodes) bytes += ARRAYSIZE(net->Nlinks + net->Ntanks, int);
+    if (qual->Sort.Pos) bytes += 5.0 * ARRAYSIZE(net->Nnodes, int) +
+                                 ARRAYSIZE(net->Nlinks, int);
+    if (qual->Events.Cout)
+    {
+        bytes += (double)qual->Events.Maxheap * (sizeof(int) + sizeof(double)) +
+                 4.0 * ARRAYSIZE(net->Nnodes, double) +
+                 3.0 * ARRAYSIZE(net->Nlinks, double) +
+                 2.0 * ARRAYSIZE(net->Nnodes, int) + sizeof(int) +
+                 4.0 * ARRAYSIZE(net->Nlinks, int);
+    }
+    return bytes;
+}
+
+
+double outputmemory(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns number of bytes
+**  Purpose: computes the size of the buffer that is temporarily
+**           allocated whenever results are written to the
+**           binary output file
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+
+    if (pr->outfile.OutFile == NULL) return 0.0;
+    return ARRAYSIZE(MAX(net->Nnodes, net->Nlinks), REAL4);
+}
+
+
+double profilingmemory(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns number of bytes
+**  Purpose: computes the memory held by the trace buffer and
+**           the recorded solver diagnostics
+**--------------------------------------------------------------
+*/
+{
+    Profile *prof = &pr->profile;
+    Diagnostics *diag = &pr->diagnostics;
+    double bytes = 0.0;
+
+    if (prof->Trace) bytes += (double)prof->TraceSize * sizeof(STraceEvent);
+    if (diag->Steps) bytes += (double)diag->Capacity * sizeof(SHydDiag);
+    if (diag->StartStatus) bytes += (double)diag->StatusSize * sizeof(StatusType);
+    return bytes;
+}
+
+
+double filesmemory(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns number of bytes
+**  Purpose: computes the disk space used by the hydraulics and
+**           binary output files
+**--------------------------------------------------------------
+*/
+{
+    Outfile *out = &pr->outfile;
+    double bytes = 0.0;
+
+    if (out->HydFile) bytes += filesize(out->HydFname);
+    if (out->OutFile) bytes += filesize(out->OutFname);
+    return bytes;
+}
+
+
+double filesize(const char *fname)
+/*
+**--------------------------------------------------------------
+**  Input:   fname = name of a file
+**  Output:  returns the file's size in bytes (0 if not found)
+**--------------------------------------------------------------
+*/
+{
+    struct stat info;
+
+    if (strlen(fname) == 0 || stat(fname, &info) != 0) return 0.0;
+    return (double)info.st_size;
+}
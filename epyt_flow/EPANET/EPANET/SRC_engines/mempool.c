@@ -140,3 +140,17 @@ char * mempool_alloc(struct Mempool *mempool, size_t size)
 
     return ptr;
 }
+
+size_t mempool_size(struct Mempool *mempool)
+{
+    struct MemBlock *memBlock;
+    size_t size;
+
+    if (mempool == NULL) return 0;
+    size = sizeof(struct Mempool);
+    for (memBlock = mempool->first; memBlock; memBlock = memBlock->next)
+    {
+        size += sizeof(struct MemBlock) + ALLOC_BLOCK_SIZE;
+    }
+    return size;
+}
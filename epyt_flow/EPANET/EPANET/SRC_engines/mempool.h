@@ -20,5 +20,6 @@ struct Mempool * mempool_create();
 void   mempool_delete(struct Mempool *mempool);
 void   mempool_reset(struct Mempool *mempool);
 char * mempool_alloc(struct Mempool *mempool, size_t size);
+size_t mempool_size(struct Mempool *mempool);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,179 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       observe.c
+ Description:  residuals of a hydraulic analysis with respect to a set of
+               observed sensor readings
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+/*
+ Once a set of observations is given, every hydraulic time step whose time
+ equals an observed time point compares the simulated values of the sensors
+ with the observed readings (missing readings are NaN). The sum of the
+ squared (scaled) residuals and the number of residuals are accumulated
+ from the time the hydraulic solver is initialized -- so that a calibration
+ only needs to retrieve two numbers per simulation run.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "epanet2_2.h"
+#include "types.h"
+#include "funcs.h"
+
+
+int observeset(Project *pr, int nSensors, const int *objects, const int *indices,
+               const int *properties, const double *scales, int nTimes,
+               const double *times, const double *values)
+/*
+**--------------------------------------------------------------
+**  Input:   nSensors = number of sensors
+**           objects = object type of each sensor (EN_NODE or EN_LINK)
+**           indices = node or link index of each sensor
+**           properties = measured property of each sensor
+**           scales = scaling factor of each sensor's residuals
+**           nTimes = number of observed time points
+**           times = observed time points (sec, ascending)
+**           values = observed readings (nTimes x nSensors)
+**  Output:  returns error code
+**  Purpose: replaces the observations the residuals are computed of
+**--------------------------------------------------------------
+*/
+{
+    Observations *obs = &pr->observations;
+    int i, errcode = 0;
+    double v;
+
+    // Check that the sensors & time points are valid
+    if (nSensors < 0 || nTimes < 0) return 202;
+    for (i = 0; i < nSensors; i++)
+    {
+        if (objects[i] == EN_NODE)
+        {
+            errcode = EN_getnodevalue(pr, indices[i], properties[i], &v);
+        }
+        else if (objects[i] == EN_LINK)
+        {
+            errcode = EN_getlinkvalue(pr, indices[i], properties[i], &v);
+        }
+        else errcode = 251;
+        if (errcode) return errcode;
+    }
+    for (i = 1; i < nTimes; i++)
+    {
+        if (times[i] <= times[i - 1]) return 213;
+    }
+
+    observeclear(pr);
+    if (nSensors == 0 || nTimes == 0) return 0;
+
+    obs->Object = (int *)calloc(nSensors, sizeof(int));
+    obs->Index = (int *)calloc(nSensors, sizeof(int));
+    obs->Property = (int *)calloc(nSensors, sizeof(int));
+    obs->Scale = (double *)calloc(nSensors, sizeof(double));
+    obs->Time = (long *)calloc(nTimes, sizeof(long));
+    obs->Value = (double *)calloc((size_t)nTimes * nSensors, sizeof(double));
+    ERRCODE(MEMCHECK(obs->Object));
+    ERRCODE(MEMCHECK(obs->Index));
+    ERRCODE(MEMCHECK(obs->Property));
+    ERRCODE(MEMCHECK(obs->Scale));
+    ERRCODE(MEMCHECK(obs->Time));
+    ERRCODE(MEMCHECK(obs->Value));
+    if (errcode)
+    {
+        observeclear(pr);
+        return errcode;
+    }
+
+    memcpy(obs->Object, objects, nSensors * sizeof(int));
+    memcpy(obs->Index, indices, nSensors * sizeof(int));
+    memcpy(obs->Property, properties, nSensors * sizeof(int));
+    memcpy(obs->Scale, scales, nSensors * sizeof(double));
+    memcpy(obs->Value, values, (size_t)nTimes * nSensors * sizeof(double));
+    for (i = 0; i < nTimes; i++) obs->Time[i] = (long)ROUND(times[i]);
+    obs->Nsensors = nSensors;
+    obs->Ntimes = nTimes;
+    observeinit(pr);
+    return 0;
+}
+
+
+void observeclear(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: discards all observations
+**--------------------------------------------------------------
+*/
+{
+    Observations *obs = &pr->observations;
+
+    free(obs->Object);
+    free(obs->Index);
+    free(obs->Property);
+    free(obs->Scale);
+    free(obs->Time);
+    free(obs->Value);
+    memset(obs, 0, sizeof(Observations));
+}
+
+
+void observeinit(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: resets the residuals at the start of a hydraulic run
+**--------------------------------------------------------------
+*/
+{
+    Observations *obs = &pr->observations;
+
+    obs->Next = 0;
+    obs->Count = 0;
+    obs->Sum = 0.0;
+}
+
+
+int observerecord(Project *pr, long t)
+/*
+**--------------------------------------------------------------
+**  Input:   t = current hydraulic time (sec)
+**  Output:  returns error code
+**  Purpose: adds the residuals of the current time step if it
+**           is an observed time point
+**--------------------------------------------------------------
+*/
+{
+    Observations *obs = &pr->observations;
+    int i, errcode = 0;
+    double v, r, *observed;
+
+    // Skip the observed time points the run has already passed
+    while (obs->Next < obs->Ntimes && obs->Time[obs->Next] < t) obs->Next++;
+    if (obs->Next >= obs->Ntimes || obs->Time[obs->Next] != t) return 0;
+
+    observed = &obs->Value[(size_t)obs->Next * obs->Nsensors];
+    for (i = 0; i < obs->Nsensors; i++)
+    {
+        if (observed[i] != observed[i]) continue;   // Missing reading (NaN)
+        if (obs->Object[i] == EN_NODE)
+        {
+            errcode = EN_getnodevalue(pr, obs->Index[i], obs->Property[i], &v);
+        }
+        else errcode = EN_getlinkvalue(pr, obs->Index[i], obs->Property[i], &v);
+        if (errcode) return errcode;
+        r = (v - observed[i]) * obs->Scale[i];
+        obs->Sum += r * r;
+        obs->Count++;
+    }
+    obs->Next++;
+    return 0;
+}
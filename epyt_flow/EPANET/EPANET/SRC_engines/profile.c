@@ -0,0 +1,166 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       profile.c
+ Description:  timing of simulation phases for performance profiling
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "funcs.h"
+
+
+double profclock()
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns a monotonic wall clock time in seconds
+**  Purpose: reads a high resolution clock for profiling
+**--------------------------------------------------------------
+*/
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+
+void profstop(Project *pr, int phase, double t0)
+/*
+**--------------------------------------------------------------
+**  Input:   phase = index of the profiled phase (see EN_ProfilePhase)
+**           t0 = time at which the phase was entered
+**  Output:  none
+**  Purpose: adds the time elapsed since t0 to a phase's total
+**           and/or records it in the trace ring buffer
+**--------------------------------------------------------------
+*/
+{
+    Profile *prof = &pr->profile;
+    STraceEvent *event;
+    double t1 = profclock();
+
+    if (prof->Enabled)
+    {
+        prof->Time[phase] += t1 - t0;
+        prof->Calls[phase]++;
+    }
+    if (prof->Tracing)
+    {
+        event = &prof->Trace[prof->TraceCount % prof->TraceSize];
+        event->Phase = phase;
+        event->Start = t0;
+        event->Duration = t1 - t0;
+        prof->TraceCount++;
+    }
+}
+
+
+void profreset(Profile *prof)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: clears all accumulated profiling data
+**--------------------------------------------------------------
+*/
+{
+    memset(prof->Time, 0, sizeof(prof->Time));
+    memset(prof->Calls, 0, sizeof(prof->Calls));
+    prof->Iterations = 0;
+}
+
+
+int proftrace(Profile *prof, int size)
+/*
+**--------------------------------------------------------------
+**  Input:   size = capacity of the trace ring buffer
+**                  (0 disables tracing)
+**  Output:  returns error code
+**  Purpose: (re)allocates the trace ring buffer and clears it
+**--------------------------------------------------------------
+*/
+{
+    prof->Tracing = FALSE;
+    free(prof->Trace);
+    prof->Trace = NULL;
+    prof->TraceSize = 0;
+    prof->TraceHead = 0;
+    prof->TraceCount = 0;
+    prof->TraceDropped = 0;
+    if (size <= 0) return 0;
+
+    prof->Trace = (STraceEvent *)calloc(size, sizeof(STraceEvent));
+    if (prof->Trace == NULL) return 101;
+    prof->TraceSize = size;
+    prof->Tracing = TRUE;
+    return 0;
+}
+
+
+int profgettrace(Profile *prof, int maxevents, int *phases, double *starts,
+                 double *durations, int *count, int *dropped)
+/*
+**--------------------------------------------------------------
+**  Input:   maxevents = max. number of events to retrieve
+**  Output:  phases, starts, durations = arrays receiving the
+**             events in chronological order
+**           count = number of events retrieved
+**           dropped = number of events lost due to buffer
+**             overflow since the last call
+**  Returns: error code
+**  Purpose: removes the oldest events from the trace ring buffer
+**--------------------------------------------------------------
+*/
+{
+    long n;
+    STraceEvent *event;
+
+    *count = 0;
+    *dropped = 0;
+    if (prof->Trace == NULL) return 0;
+
+    // Skip events that have been overwritten
+    if (prof->TraceCount - prof->TraceHead > prof->TraceSize)
+    {
+        prof->TraceDropped += prof->TraceCount - prof->TraceHead - prof->TraceSize;
+        prof->TraceHead = prof->TraceCount - prof->TraceSize;
+    }
+
+    for (n = 0; n < maxevents && prof->TraceHead < prof->TraceCount; n++)
+    {
+        event = &prof->Trace[prof->TraceHead % prof->TraceSize];
+        phases[n] = event->Phase;
+        starts[n] = event->Start;
+        durations[n] = event->Duration;
+        prof->TraceHead++;
+    }
+    *count = (int)n;
+    *dropped = (int)prof->TraceDropped;
+    prof->TraceDropped = 0;
+    return 0;
+}
@@ -382,6 +382,9 @@ void freedata(Project *pr)
 {
     int j;
 
+    // Free memory of an uncommitted edit transaction
+    freeedit(pr);
+
     // Free memory for computed results
     free(pr->hydraul.NodeDemand);
     free(pr->hydraul.NodeHead);
@@ -549,7 +552,7 @@ int  addlinkvertex(Slink *link, double x, double y)
 **----------------------------------------------------------------
 */
 {
-    static int CHUNKSIZE = 5;
+    const int CHUNKSIZE = 5;
     int n;
     Pvertices vertices;
     if (link->Vertices == NULL)
@@ -763,6 +766,9 @@ int valvecheck(Project *pr, int index, int type, int j1, int j2)
         {
             valve = &net->Valve[k];
             if (valve->Link == index) continue;
+
+            // Valves deleted in an edit transaction no longer count
+            if (pr->editor.Active && pr->editor.LinkDeleted[valve->Link]) continue;
             link = &net->Link[valve->Link];
             vj1 = link->N1;
             vj2 = link->N2;
@@ -1172,11 +1178,15 @@ void getTmpName(char *fname)
 //  Output:  an unused file name
 //  Purpose: creates a temporary file name with an "en" prefix
 //           or a blank name if an error occurs.
+//  Note:    the (empty) file is created so that the name cannot be
+//           handed out again -- to another project in the same or in
+//           another process -- before the caller removes it.
 //----------------------------------------------------------------
 {
 #ifdef _WIN32
 
     char* name = NULL;
+    FILE* f = NULL;
 
     // --- use Windows _tempnam function to get a pointer to an
     //     unused file name that begins with "en"
@@ -1186,6 +1196,8 @@ void getTmpName(char *fname)
     {
         // --- copy the file name to fname
         if (strlen(name) < MAXFNAME) strncpy(fname, name, MAXFNAME);
+        if ((f = fopen(fname, "a")) == NULL) strcpy(fname, "");
+        else fclose(f);
 
         // --- free the pointer returned by _tempnam
         free(name);
@@ -1204,7 +1216,6 @@ void getTmpName(char *fname)
     FILE *f = fdopen(mkstemp(fname), "r");
     if (f == NULL) strcpy(fname, "");
     else fclose(f);
-    remove(fname);
 #endif
 }
 
@@ -25,6 +25,7 @@ const double Q_STAGNANT = 0.005 / GPMperCFS;     // 0.005 gpm = 1.114e-5 cfs
 
 // Exported functions
 double  findsourcequal(Project *, int, double, long);
+double  sourceconc(Project *, int, double);
 
 // Imported functions
 extern char    setreactflag(Project *);
@@ -34,12 +35,15 @@ extern void    initsegs(Project *);
 extern void    reversesegs(Project *, int);
 extern int     sortnodes(Project *);
 extern void    transport(Project *, long);
+extern void    transportevents(Project *, long);
+extern void    freeevents(Project *);
 
 // Local functions
 static double  sourcequal(Project *, Psource);
 static void    evalmassbalance(Project *);
 static double  findstoredmass(Project *);
 static int     flowdirchanged(Project *);
+static void    routequal(Project *, long);
 
 
 int openqual(Project *pr)
@@ -85,11 +89,26 @@ int openqual(Project *pr)
     // Allocate memory for topologically sorted nodes
     qual->SortedNodes = (int *)calloc(n, sizeof(int));
 
+    // Allocate work space for re-sorting nodes after flow reversals
+    n = net->Nnodes + 1;
+    qual->Sort.Pos = (int *)calloc(n, sizeof(int));
+    qual->Sort.Mark = (int *)calloc(n, sizeof(int));
+    qual->Sort.Stack = (int *)calloc(n, sizeof(int));
+    qual->Sort.Delta = (int *)calloc(n, sizeof(int));
+    qual->Sort.Nodes = (int *)calloc(n, sizeof(int));
+    qual->Sort.Changed = (int *)calloc(net->Nlinks + 1, sizeof(int));
+
     ERRCODE(MEMCHECK(qual->FlowDir));
     ERRCODE(MEMCHECK(qual->PipeRateCoeff));
     ERRCODE(MEMCHECK(qual->FirstSeg));
     ERRCODE(MEMCHECK(qual->LastSeg));
     ERRCODE(MEMCHECK(qual->SortedNodes));
+    ERRCODE(MEMCHECK(qual->Sort.Pos));
+    ERRCODE(MEMCHECK(qual->Sort.Mark));
+    ERRCODE(MEMCHECK(qual->Sort.Stack));
+    ERRCODE(MEMCHECK(qual->Sort.Delta));
+    ERRCODE(MEMCHECK(qual->Sort.Nodes));
+    ERRCODE(MEMCHECK(qual->Sort.Changed));
     return errcode;
 }
 
@@ -162,12 +181,18 @@ int initqual(Project *pr)
     // Initialize link flow direction indicator
     for (i = 1; i <= net->Nlinks; i++) qual->FlowDir[i] = ZERO_FLOW;
 
+    // Nodes are fully sorted at the first hydraulic time step
+    qual->Sort.Valid = FALSE;
+
     // Initialize avg. reaction rates
     qual->Wbulk = 0.0;
     qual->Wwall = 0.0;
     qual->Wtank = 0.0;
     qual->Wsource = 0.0;
 
+    // Reset the count of transport events
+    qual->Events.Count = 0;
+
     // Initialize mass balance components
     qual->MassBalance.initial = findstoredmass(pr);
     qual->MassBalance.inflow = 0.0;
@@ -197,8 +222,11 @@ int runqual(Project *pr, long *t)
     long hydtime = 0;       // Hydraulic solution time
     long hydstep = 0;       // Hydraulic time step
     int errcode = 0;
+    double t0 = 0.0,        // Profiling start times
+           t1 = 0.0;
 
     // Update reported simulation time
+    PROFSTART(pr, t0);
     *t = time->Qtime;
 
     // Read hydraulic solution from hydraulics file
@@ -207,8 +235,11 @@ int runqual(Project *pr, long *t)
         // Read hydraulic results from file
         if (!hyd->OpenHflag)
         {
-            if (!readhyd(pr, &hydtime)) return 307;
-            if (!readhydstep(pr, &hydstep)) return 307;
+            if (!readhyd(pr, &hydtime) || !readhydstep(pr, &hydstep))
+            {
+                PROFSTOP(pr, EN_PROF_RUNQUAL, t0);
+                return 307;
+            }
             time->Htime = hydtime;
         }
 
@@ -217,12 +248,18 @@ int runqual(Project *pr, long *t)
         {
             if (pr->outfile.Saveflag)
             {
+                PROFSTART(pr, t1);
                 errcode = saveoutput(pr);
+                PROFSTOP(pr, EN_PROF_SAVEOUTPUT, t1);
                 pr->report.Nperiods++;
             }
             time->Rtime += time->Rstep;
         }
-        if (errcode) return errcode;
+        if (errcode)
+        {
+            PROFSTOP(pr, EN_PROF_RUNQUAL, t0);
+            return errcode;
+        }
 
         // If simulating water quality
         if (qual->Qualflag != NONE && time->Qtime < time->Dur)
@@ -233,11 +270,14 @@ int runqual(Project *pr, long *t)
             // ... topologically sort network nodes if flow directions change
             if (flowdirchanged(pr) == TRUE)
             {
+                PROFSTART(pr, t1);
                 errcode = sortnodes(pr);
+                PROFSTOP(pr, EN_PROF_SORTNODES, t1);
             }
         }
         if (!hyd->OpenHflag) time->Htime = hydtime + hydstep;
     }
+    PROFSTOP(pr, EN_PROF_RUNQUAL, t0);
     return errcode;
 }
 
@@ -268,13 +308,23 @@ int nextqual(Project *pr, long *tstep)
     // Perform water quality routing over this time step
     if (qual->Qualflag != NONE && hydstep > 0)
     {
-        // Repeat over each quality time step until tstep is reached
-        qtime = 0;
-        while (!qual->OutOfMemory && qtime < hydstep)
+        // Route over the entire time step at once if transport is
+        // driven by events (only possible for non-reactive constituents)
+        if (qual->RouteMode == EN_ROUTE_EVENTS && !qual->Reactflag)
+        {
+            transportevents(pr, hydstep);
+        }
+
+        // Otherwise repeat over each quality time step until tstep is reached
+        else
         {
-            dt = MIN(time->Qstep, hydstep - qtime);
-            qtime += dt;
-            transport(pr, dt);
+            qtime = 0;
+            while (!qual->OutOfMemory && qtime < hydstep)
+            {
+                dt = MIN(time->Qstep, hydstep - qtime);
+                qtime += dt;
+                transport(pr, dt);
+            }
         }
         if (qual->OutOfMemory) errcode = 101;
     }
@@ -335,7 +385,7 @@ int stepqual(Project *pr, long *tleft)
             dt = hstep;
 
             // ... transport quality over local time step
-            if (qual->Qualflag != NONE) transport(pr, dt);
+            if (qual->Qualflag != NONE) routequal(pr, dt);
             time->Qtime += dt;
 
             // ... quit if running quality concurrently with hydraulics
@@ -349,7 +399,7 @@ int stepqual(Project *pr, long *tleft)
         // Otherwise transport quality over current local time step
         else
         {
-            if (qual->Qualflag != NONE) transport(pr, dt);
+            if (qual->Qualflag != NONE) routequal(pr, dt);
             time->Qtime += dt;
         }
 
@@ -396,11 +446,19 @@ int closequal(Project *pr)
     if (qual->Qualflag != NONE)
     {
         if (qual->SegPool) mempool_delete(qual->SegPool);
+        qual->SegPool = NULL;
         FREE(qual->FirstSeg);
         FREE(qual->LastSeg);
         FREE(qual->PipeRateCoeff);
         FREE(qual->FlowDir);
         FREE(qual->SortedNodes);
+        FREE(qual->Sort.Pos);
+        FREE(qual->Sort.Mark);
+        FREE(qual->Sort.Stack);
+        FREE(qual->Sort.Delta);
+        FREE(qual->Sort.Nodes);
+        FREE(qual->Sort.Changed);
+        freeevents(pr);
     }
     return errcode;
 }
@@ -460,11 +518,46 @@ double findsourcequal(Project *pr, int n, double volout, long tstep)
 */
 {
     Network *net = &pr->network;
-    Hydraul *hyd = &pr->hydraul;
     Quality *qual = &pr->quality;
     Times   *time = &pr->times;
 
     double massadded = 0.0, c;
+
+    // Added source concentration depends on the node's outflow rate
+    c = sourceconc(pr, n, volout / tstep);
+    if (c == 0.0) return 0.0;
+
+    // Source mass added over time step = source concen. * outflow volume
+    massadded = c * volout;
+
+    // Update source's total mass added
+    net->Node[n].S->Smass += massadded;
+
+    // Update Wsource
+    if (time->Htime >= time->Rstart)
+    {
+        qual->Wsource += massadded;
+    }
+    return c;
+}
+
+
+double sourceconc(Project *pr, int n, double qout)
+/*
+**---------------------------------------------------------------------
+**   Input:   n = node index
+**            qout = rate of node outflow
+**   Output:  returns concentration added by an external quality source.
+**   Purpose: computes the concentration (if any) that an external
+**            quality source adds to a node's outflow.
+**---------------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Quality *qual = &pr->quality;
+
+    double c;
     Psource source;
 
     // Sources only apply to CHEMICAL analyses
@@ -474,7 +567,7 @@ double findsourcequal(Project *pr, int n, double volout, long tstep)
     source = net->Node[n].S;
     if (source == NULL)    return 0.0;
     if (source->C0 == 0.0) return 0.0;
-    if (volout / tstep <= Q_STAGNANT) return 0.0;
+    if (qout <= Q_STAGNANT) return 0.0;
 
     // Added source concentration depends on source type
     c = sourcequal(pr, source);
@@ -487,7 +580,7 @@ double findsourcequal(Project *pr, int n, double volout, long tstep)
             // ... source requires a negative demand at the node
             if (hyd->NodeDemand[n] < 0.0)
             {
-                c = -c * hyd->NodeDemand[n] * tstep / volout;
+                c = -c * hyd->NodeDemand[n] / qout;
             }
             else c = 0.0;
         }
@@ -496,7 +589,7 @@ double findsourcequal(Project *pr, int n, double volout, long tstep)
         // Mass Inflow Booster Source:
         case MASS:
             // ... convert source input from mass/sec to concentration
-            c = c * tstep / volout;
+            c = c / qout;
             break;
 
         // Setpoint Booster Source:
@@ -511,18 +604,6 @@ double findsourcequal(Project *pr, int n, double volout, long tstep)
         case FLOWPACED:
             break;
     }
-
-    // Source mass added over time step = source concen. * outflow volume
-    massadded = c * volout;
-
-    // Update source's total mass added
-    source->Smass += massadded;
-
-    // Update Wsource
-    if (time->Htime >= time->Rstart)
-    {
-        qual->Wsource += massadded;
-    }
     return c;
 }
 
@@ -660,6 +741,7 @@ int flowdirchanged(Project *pr)
     double q;
 
     // Examine each network link
+    qual->Sort.Nchanged = 0;
     for (k = 1; k <= pr->network.Nlinks; k++)
     {
         // Determine sign (+1 or -1) of new flow rate
@@ -678,8 +760,35 @@ int flowdirchanged(Project *pr)
         // negligible then the network still needs to be re-sorted)
         if (newdir != olddir) result = TRUE;
 
+        // ... links with a new non-negligible flow direction are the
+        //     only ones that can violate the current node order
+        if (newdir != olddir && newdir != 0)
+        {
+            qual->Sort.Changed[qual->Sort.Nchanged++] = k;
+        }
+
         // ... replace old flow direction with the new direction
         qual->FlowDir[k] = newdir;
     }
     return result;
 }
+
+
+void routequal(Project *pr, long tstep)
+/*
+**--------------------------------------------------------------
+**   Input:   tstep = length of current time step
+**   Output:  none
+**   Purpose: transports constituent mass through the pipe network
+**            using the selected routing mode.
+**--------------------------------------------------------------
+*/
+{
+    Quality *qual = &pr->quality;
+
+    if (qual->RouteMode == EN_ROUTE_EVENTS && !qual->Reactflag)
+    {
+        transportevents(pr, tstep);
+    }
+    else transport(pr, tstep);
+}
@@ -13,10 +13,12 @@ Last Updated: 05/15/2019
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
 #include "mempool.h"
 #include "types.h"
+#include "funcs.h"
 
 // Macro to compute the volume of a link
 #define LINKVOL(k) (0.785398 * net->Link[(k)].Len * SQR(net->Link[(k)].Diam))
@@ -24,15 +26,22 @@ Last Updated: 05/15/2019
 // Macro to get link flow compatible with flow saved to hydraulics file
 #define LINKFLOW(k) ((hyd->LinkStatus[k] <= CLOSED) ? 0.0 : hyd->LinkFlow[k])
 
+// Macros to get the downstream & upstream node of a link
+#define DNNODE(k) ((qual->FlowDir[(k)] < 0) ? net->Link[(k)].N1 : net->Link[(k)].N2)
+#define UPNODE(k) ((qual->FlowDir[(k)] < 0) ? net->Link[(k)].N2 : net->Link[(k)].N1)
+
 // Exported functions
 int     sortnodes(Project *);
 void    transport(Project *, long);
 void    initsegs(Project *);
 void    reversesegs(Project *, int);
 void    addseg(Project *, int, double, double);
+void    transportevents(Project *, long);
+void    freeevents(Project *);
 
 // Imported functions
 extern double  findsourcequal(Project *, int, double, long);
+extern double  sourceconc(Project *, int, double);
 extern void    reactpipes(Project *, long);
 extern void    reacttanks(Project *, long);
 extern double  mixtank(Project *, int, double, double, double);
@@ -42,8 +51,22 @@ static void    evalnodeinflow(Project *, int, long, double *, double *);
 static void    evalnodeoutflow(Project *, int, double, long);
 static double  findnodequal(Project *, int, double, double, double, long);
 static double  noflowqual(Project *, int);
-static void    updatemassbalance(Project *, int, double, double, long);
+static void    updatemassbalance(Project *, int, double, double, double);
 static int     selectnonstacknode(Project *, int, int *);
+static int     sortallnodes(Project *);
+static int     updatesort(Project *);
+static int     reordernodes(Project *, int, int);
+static int     searchorder(Project *, int, int, int, int, int, int *);
+static int     cmpint(const void *, const void *);
+
+static int     initevents(Project *, long);
+static void    pushevent(Project *, double, int);
+static int     popevent(Project *, double *, int *);
+static void    updatenode(Project *, int, double);
+static void    evaloutflowqual(Project *, int);
+static void    releaseflow(Project *, int, double);
+static void    removeflow(Project *, int, double, double *, double *);
+static void    schedulelink(Project *, int, double, int);
 
 
 void transport(Project *pr, long tstep)
@@ -62,15 +85,24 @@ void transport(Project *pr, long tstep)
 
     int j, k, m, n;
     double volin, massin, volout, nodequal;
+    double t0 = 0.0, t1 = 0.0, t2 = 0.0, tmix = 0.0;
     Padjlist  alink;
 
+    PROFSTART(pr, t0);
+
     // React contents of each pipe and tank
     if (qual->Reactflag)
     {
+        PROFSTART(pr, t1);
         reactpipes(pr, tstep);
         reacttanks(pr, tstep);
+        PROFSTOP(pr, EN_PROF_REACT, t1);
     }
 
+    // Advection of segments along links is timed as the node loop
+    // minus the time spent mixing inflows at the nodes
+    PROFSTART(pr, t1);
+
     // Analyze each node in topological order
     for (j = 1; j <= net->Nnodes; j++)
     {
@@ -111,7 +143,12 @@ void transport(Project *pr, long tstep)
         volout *= tstep;
 
         // ... find the concentration of flow leaving the node
+        PROFSTART(pr, t2);
         nodequal = findnodequal(pr, n, volin, massin, volout, tstep);
+        if (pr->profile.Enabled || pr->profile.Tracing)
+        {
+            tmix += profclock() - t2;
+        }
 
         // ... examine each link with flow out of the node
         for (alink = net->Adjlist[n]; alink != NULL; alink = alink->next)
@@ -128,6 +165,15 @@ void transport(Project *pr, long tstep)
         }
         updatemassbalance(pr, n, massin, volout, tstep);
     }
+
+    // Mixing is recorded as one phase that ends now and lasts
+    // as long as all node mixing of this step taken together
+    if (pr->profile.Enabled || pr->profile.Tracing)
+    {
+        profstop(pr, EN_PROF_MIX, profclock() - tmix);
+        profstop(pr, EN_PROF_ADVECT, t1 + tmix);
+        profstop(pr, EN_PROF_TRANSPORT, t0);
+    }
 }
 
 void  evalnodeinflow(Project *pr, int k, long tstep, double *volin,
@@ -365,7 +411,7 @@ void evalnodeoutflow(Project *pr, int k, double c, long tstep)
 
 
 void updatemassbalance(Project *pr, int n, double massin,
-                       double volout, long tstep)
+                       double volout, double tstep)
 /*
 **--------------------------------------------------------------
 **   Input:   n = node index
@@ -416,7 +462,27 @@ int sortnodes(Project *pr)
 **--------------------------------------------------------------
 **   Input:   none
 **   Output:  returns an error code
-**   Purpose: topologically sorts nodes from upstream to downstream.
+**   Purpose: topologically sorts nodes from upstream to downstream
+**            after the flow direction of any link has changed.
+**   Note:    if the current order has no cycles then only the
+**            nodes affected by the changed links are re-ordered
+**            (unless a full sort is forced with EN_setfullsort).
+**--------------------------------------------------------------
+*/
+{
+    Quality *qual = &pr->quality;
+
+    if (qual->Sort.Valid && !qual->FullSort && updatesort(pr)) return 0;
+    return sortallnodes(pr);
+}
+
+
+int sortallnodes(Project *pr)
+/*
+**--------------------------------------------------------------
+**   Input:   none
+**   Output:  returns an error code
+**   Purpose: topologically sorts all nodes from upstream to downstream.
 **   Note:    links with negligible flow are ignored since they can
 **            create spurious cycles that cause the sort to fail.
 **--------------------------------------------------------------
@@ -430,6 +496,7 @@ int sortnodes(Project *pr)
     int *stack = NULL;
     int stacksize = 0;
     int numsorted = 0;
+    int cyclic = FALSE;
     int errcode = 0;
     FlowDirection dir;
     Padjlist  alink;
@@ -469,6 +536,7 @@ int sortnodes(Project *pr)
                 //  ... add a non-sorted node connected to a sorted one to stack
                 j = selectnonstacknode(pr, numsorted, indegree);
                 if (j == 0) break;  // This shouldn't happen.
+                cyclic = TRUE;
                 indegree[j] = 0;
                 stacksize++;
                 stack[stacksize] = j;
@@ -514,10 +582,165 @@ int sortnodes(Project *pr)
     if (numsorted < net->Nnodes) errcode = 120;
     FREE(indegree);
     FREE(stack);
+
+    // Save the position of each node for later incremental updates
+    // (which are only possible if the sorted order has no cycles)
+    if (!errcode)
+    {
+        for (i = 1; i <= net->Nnodes; i++) qual->Sort.Pos[qual->SortedNodes[i]] = i;
+    }
+    qual->Sort.Valid = !errcode && !cyclic;
     return errcode;
 }
 
 
+int updatesort(Project *pr)
+/*
+**--------------------------------------------------------------
+**   Input:   none
+**   Output:  returns TRUE if the sorted nodes were updated or
+**            FALSE if a full sort is required
+**   Purpose: restores the topological order of the sorted nodes
+**            after flow reversals by re-ordering only the nodes
+**            between the end nodes of each link that now flows
+**            against the order (Pearce-Kelly algorithm).
+**   Note:    a full sort is required if the new flow directions
+**            contain a cycle or if re-ordering would visit more
+**            nodes than a full sort (i.e. most of the network
+**            has reversed its flow).
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Quality *qual = &pr->quality;
+    int i, k;
+
+    // Re-ordering visits each node at a higher cost than a full sort
+    qual->Sort.Budget = net->Nnodes / 4;
+
+    // Links whose flow became negligible can not violate the order and
+    // a re-ordering never violates a link that already follows it
+    for (i = 0; i < qual->Sort.Nchanged; i++)
+    {
+        k = qual->Sort.Changed[i];
+        if (qual->Sort.Pos[UPNODE(k)] < qual->Sort.Pos[DNNODE(k)]) continue;
+        if (!reordernodes(pr, UPNODE(k), DNNODE(k)))
+        {
+            memset(qual->Sort.Mark, 0, (net->Nnodes + 1) * sizeof(int));
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+
+int reordernodes(Project *pr, int u, int v)
+/*
+**--------------------------------------------------------------
+**   Input:   u = upstream node of a link
+**            v = downstream node of the link (sorted before u)
+**   Output:  returns FALSE if the link closes a cycle or if the
+**            search exceeds its budget
+**   Purpose: moves the nodes upstream of u in front of the nodes
+**            downstream of v, considering only the nodes sorted
+**            between v and u.
+**--------------------------------------------------------------
+*/
+{
+    Quality *qual = &pr->quality;
+    Ssort *sort = &qual->Sort;
+
+    int i, nf, nb;
+    int lb = sort->Pos[v];
+    int ub = sort->Pos[u];
+
+    // Find the positions of the nodes downstream of v and upstream of u
+    nf = searchorder(pr, v, lb, ub, 1, u, sort->Delta);
+    if (nf < 0) return FALSE;
+    nb = searchorder(pr, u, lb, ub, -1, 0, &sort->Delta[nf]);
+    if (nb < 0) return FALSE;
+
+    // Upstream nodes keep their relative order followed by the
+    // downstream nodes, both placed into the freed positions
+    qsort(sort->Delta, nf, sizeof(int), cmpint);
+    qsort(&sort->Delta[nf], nb, sizeof(int), cmpint);
+    for (i = 0; i < nb; i++) sort->Nodes[i] = qual->SortedNodes[sort->Delta[nf + i]];
+    for (i = 0; i < nf; i++) sort->Nodes[nb + i] = qual->SortedNodes[sort->Delta[i]];
+    qsort(sort->Delta, nb + nf, sizeof(int), cmpint);
+    for (i = 0; i < nb + nf; i++)
+    {
+        qual->SortedNodes[sort->Delta[i]] = sort->Nodes[i];
+        sort->Pos[sort->Nodes[i]] = sort->Delta[i];
+        sort->Mark[sort->Nodes[i]] = FALSE;
+    }
+    return TRUE;
+}
+
+
+int searchorder(Project *pr, int n, int lb, int ub, int dir, int target,
+                int *delta)
+/*
+**--------------------------------------------------------------
+**   Input:   n = start node
+**            lb, ub = positions bounding the search
+**            dir = 1 to search downstream or -1 to search upstream
+**            target = node that closes a cycle if it is reached
+**   Output:  delta = positions of the nodes found;
+**            returns number of nodes found or -1 if target is reached
+**            or if more nodes are found than the remaining budget
+**   Purpose: finds all nodes connected to node n by links with flow
+**            in the search direction that are sorted between lb and ub.
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Quality *qual = &pr->quality;
+    Ssort *sort = &qual->Sort;
+
+    int i, k, m;
+    int count = 0;
+    int stacksize = 0;
+    Padjlist alink;
+
+    sort->Mark[n] = TRUE;
+    sort->Stack[++stacksize] = n;
+    while (stacksize > 0)
+    {
+        i = sort->Stack[stacksize--];
+        delta[count++] = sort->Pos[i];
+        if (--sort->Budget < 0) return -1;
+        for (alink = net->Adjlist[i]; alink != NULL; alink = alink->next)
+        {
+            // ... skip links with negligible flow or flow against the search
+            k = alink->link;
+            m = alink->node;
+            if (qual->FlowDir[k] == 0) continue;
+            if ((dir > 0) != (DNNODE(k) == m)) continue;
+
+            // ... add node m to the search if it lies between the bounds
+            if (m == target) return -1;
+            if (sort->Mark[m] || sort->Pos[m] <= lb || sort->Pos[m] >= ub) continue;
+            sort->Mark[m] = TRUE;
+            sort->Stack[++stacksize] = m;
+        }
+    }
+    return count;
+}
+
+
+int cmpint(const void *a, const void *b)
+/*
+**--------------------------------------------------------------
+**   Input:   a, b = pointers to integers
+**   Output:  returns the sign of *a - *b
+**   Purpose: compares two integers for qsort.
+**--------------------------------------------------------------
+*/
+{
+    return (*(const int *)a > *(const int *)b) - (*(const int *)a < *(const int *)b);
+}
+
+
 int selectnonstacknode(Project *pr, int numsorted, int *indegree)
 /*
 **--------------------------------------------------------------
@@ -692,3 +915,571 @@ void addseg(Project *pr, int k, double v, double c)
     if (qual->LastSeg[k] != NULL)  qual->LastSeg[k]->prev = seg;
     qual->LastSeg[k] = seg;
 }
+
+
+void transportevents(Project *pr, long tstep)
+/*
+**--------------------------------------------------------------
+**   Input:   tstep = length of current time step
+**   Output:  none
+**   Purpose: transports constituent mass through the pipe network
+**            under a period of constant hydraulic conditions by
+**            only updating a node when the leading segment of one
+**            of its inflow links has been used up.
+**   Note:    this function is only used for non-reactive
+**            substances -- the quality of a junction's outflow
+**            can only change when a new segment reaches it.
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Quality *qual = &pr->quality;
+    Sqevents *ev = &qual->Events;
+
+    int i, j, k, n;
+    double t, t0 = 0.0;
+
+    PROFSTART(pr, t0);
+    if (initevents(pr, tstep))
+    {
+        qual->OutOfMemory = TRUE;
+        return;
+    }
+
+    // Find the quality of each node's outflow at the start of the period
+    for (j = 1; j <= net->Nnodes; j++) evaloutflowqual(pr, qual->SortedNodes[j]);
+
+    // Schedule the arrival of each link's leading segment at its downstream node
+    for (k = 1; k <= net->Nlinks; k++) schedulelink(pr, k, 0.0, FALSE);
+
+    // Tanks mix their contents continuously -- update them every quality time step
+    for (i = 1; i <= net->Ntanks; i++)
+    {
+        if (net->Tank[i].A == 0.0) continue;
+        for (t = (double)pr->times.Qstep; t < ev->Tend; t += pr->times.Qstep)
+        {
+            pushevent(pr, t, net->Tank[i].Node);
+        }
+    }
+
+    // Process all events in chronological order
+    while (!qual->OutOfMemory && popevent(pr, &t, &n))
+    {
+        updatenode(pr, n, t);
+        ev->Count++;
+    }
+
+    // Bring all nodes up to the end of the period
+    for (j = 1; j <= net->Nnodes && !qual->OutOfMemory; j++)
+    {
+        updatenode(pr, qual->SortedNodes[j], ev->Tend);
+    }
+    ev->Nheap = 0;
+    PROFSTOP(pr, EN_PROF_TRANSPORT, t0);
+}
+
+
+void freeevents(Project *pr)
+/*
+**--------------------------------------------------------------
+**   Input:   none
+**   Output:  none
+**   Purpose: frees the work space of the event-driven routing.
+**--------------------------------------------------------------
+*/
+{
+    Sqevents *ev = &pr->quality.Events;
+
+    FREE(ev->HeapNode);
+    FREE(ev->HeapTime);
+    FREE(ev->Cout);
+    FREE(ev->Srcq);
+    FREE(ev->Qout);
+    FREE(ev->Tnode);
+    FREE(ev->Tpush);
+    FREE(ev->Tpull);
+    FREE(ev->Tarr);
+    FREE(ev->Upnode);
+    FREE(ev->Dnnode);
+    FREE(ev->Inflows);
+    FREE(ev->Outflows);
+    FREE(ev->Adjlinks);
+    ev->Nheap = 0;
+    ev->Maxheap = 0;
+}
+
+
+int initevents(Project *pr, long tstep)
+/*
+**--------------------------------------------------------------
+**   Input:   tstep = length of current time step
+**   Output:  returns 1 if out of memory, 0 otherwise
+**   Purpose: initializes the work space of the event-driven
+**            routing for a new period.
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Quality *qual = &pr->quality;
+    Sqevents *ev = &qual->Events;
+
+    int k, n, m;
+    int nn = net->Nnodes + 1, nl = net->Nlinks + 1;
+    double q;
+
+    // Allocate the work space when it is used for the first time
+    if (ev->Cout == NULL)
+    {
+        ev->Maxheap = nn + nl;
+        ev->HeapNode = (int *)calloc(ev->Maxheap, sizeof(int));
+        ev->HeapTime = (double *)calloc(ev->Maxheap, sizeof(double));
+        ev->Cout = (double *)calloc(nn, sizeof(double));
+        ev->Srcq = (double *)calloc(nn, sizeof(double));
+        ev->Qout = (double *)calloc(nn, sizeof(double));
+        ev->Tnode = (double *)calloc(nn, sizeof(double));
+        ev->Tpush = (double *)calloc(nl, sizeof(double));
+        ev->Tpull = (double *)calloc(nl, sizeof(double));
+        ev->Tarr = (double *)calloc(nl, sizeof(double));
+        ev->Upnode = (int *)calloc(nl, sizeof(int));
+        ev->Dnnode = (int *)calloc(nl, sizeof(int));
+        ev->Inflows = (int *)calloc(nn + 1, sizeof(int));
+        ev->Outflows = (int *)calloc(nn, sizeof(int));
+        ev->Adjlinks = (int *)calloc(2 * nl, sizeof(int));
+        if (!ev->HeapNode || !ev->HeapTime || !ev->Cout || !ev->Srcq ||
+            !ev->Qout || !ev->Tnode || !ev->Tpush || !ev->Tpull ||
+            !ev->Tarr || !ev->Upnode || !ev->Dnnode || !ev->Inflows ||
+            !ev->Outflows || !ev->Adjlinks)
+        {
+            freeevents(pr);
+            return 1;
+        }
+    }
+
+    // All nodes and links start at time zero of the period
+    ev->Nheap = 0;
+    ev->Tend = (double)tstep;
+    for (n = 1; n <= net->Nnodes; n++)
+    {
+        ev->Tnode[n] = 0.0;
+        ev->Srcq[n] = 0.0;
+        ev->Qout[n] = 0.0;
+        if (net->Node[n].Type == JUNCTION)
+        {
+            ev->Qout[n] = MAX(0.0, hyd->NodeDemand[n]);
+        }
+        ev->Inflows[n] = 0;
+        ev->Outflows[n] = 0;
+    }
+    ev->Inflows[nn] = 0;
+
+    // Count the inflow & outflow links of each node (links without
+    // flow can be ignored)
+    for (k = 1; k <= net->Nlinks; k++)
+    {
+        ev->Tpush[k] = 0.0;
+        ev->Tpull[k] = 0.0;
+        ev->Tarr[k] = -1.0;
+        ev->Upnode[k] = UPNODE(k);
+        ev->Dnnode[k] = DNNODE(k);
+        q = fabs(LINKFLOW(k));
+        if (q == 0.0) continue;
+        ev->Qout[ev->Upnode[k]] += q;
+        ev->Inflows[ev->Dnnode[k]]++;
+        ev->Outflows[ev->Upnode[k]]++;
+    }
+
+    // Group the links by node -- each node's inflow links are followed
+    // by its outflow links (the positions are first set to the end of
+    // each group and then moved to its start while filling it)
+    m = 0;
+    for (n = 1; n <= net->Nnodes; n++)
+    {
+        m += ev->Inflows[n];
+        ev->Inflows[n] = m;
+        m += ev->Outflows[n];
+        ev->Outflows[n] = m;
+    }
+    ev->Inflows[nn] = m;
+    for (k = net->Nlinks; k >= 1; k--)
+    {
+        if (LINKFLOW(k) == 0.0) continue;
+        ev->Adjlinks[--ev->Inflows[ev->Dnnode[k]]] = k;
+        ev->Adjlinks[--ev->Outflows[ev->Upnode[k]]] = k;
+    }
+    return 0;
+}
+
+
+void pushevent(Project *pr, double t, int n)
+/*
+**--------------------------------------------------------------
+**   Input:   t = time of event
+**            n = node index
+**   Output:  none
+**   Purpose: schedules an update of a node (events at or after
+**            the end of the period are dropped).
+**--------------------------------------------------------------
+*/
+{
+    Sqevents *ev = &pr->quality.Events;
+
+    int i, p, size;
+    int *nodes;
+    double *times;
+
+    if (t >= ev->Tend) return;
+
+    // Grow the heap if it is full
+    if (ev->Nheap == ev->Maxheap)
+    {
+        size = 2 * ev->Maxheap;
+        nodes = (int *)realloc(ev->HeapNode, size * sizeof(int));
+        if (nodes) ev->HeapNode = nodes;
+        times = (double *)realloc(ev->HeapTime, size * sizeof(double));
+        if (times) ev->HeapTime = times;
+        if (!nodes || !times)
+        {
+            pr->quality.OutOfMemory = TRUE;
+            return;
+        }
+        ev->Maxheap = size;
+    }
+
+    // Sift the new event up the heap
+    i = ev->Nheap++;
+    while (i > 0)
+    {
+        p = (i - 1) / 2;
+        if (ev->HeapTime[p] <= t) break;
+        ev->HeapTime[i] = ev->HeapTime[p];
+        ev->HeapNode[i] = ev->HeapNode[p];
+        i = p;
+    }
+    ev->HeapTime[i] = t;
+    ev->HeapNode[i] = n;
+}
+
+
+int popevent(Project *pr, double *t, int *n)
+/*
+**--------------------------------------------------------------
+**   Input:   none
+**   Output:  t = time of event
+**            n = node index
+**            returns 1 if an event was found, 0 otherwise
+**   Purpose: removes the earliest event from the heap.
+**--------------------------------------------------------------
+*/
+{
+    Sqevents *ev = &pr->quality.Events;
+
+    int i, c;
+    double tlast;
+
+    if (ev->Nheap == 0) return 0;
+    *t = ev->HeapTime[0];
+    *n = ev->HeapNode[0];
+
+    // Sift the last event down from the top of the heap
+    ev->Nheap--;
+    tlast = ev->HeapTime[ev->Nheap];
+    i = 0;
+    while ((c = 2 * i + 1) < ev->Nheap)
+    {
+        if (c + 1 < ev->Nheap && ev->HeapTime[c + 1] < ev->HeapTime[c]) c++;
+        if (tlast <= ev->HeapTime[c]) break;
+        ev->HeapTime[i] = ev->HeapTime[c];
+        ev->HeapNode[i] = ev->HeapNode[c];
+        i = c;
+    }
+    ev->HeapTime[i] = tlast;
+    ev->HeapNode[i] = ev->HeapNode[ev->Nheap];
+    return 1;
+}
+
+
+void updatenode(Project *pr, int n, double t)
+/*
+**--------------------------------------------------------------
+**   Input:   n = node index
+**            t = time (sec) within the current period
+**   Output:  none
+**   Purpose: moves the flow through a node since its last update
+**            and finds the new quality of its outflow.
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Quality *qual = &pr->quality;
+    Sqevents *ev = &qual->Events;
+
+    int i, k;
+    int first = ev->Inflows[n], mid = ev->Outflows[n], last = ev->Inflows[n + 1];
+    double volin = 0.0, massin = 0.0, volout, dt, cold, massadded;
+
+    // Remove the flow that reached the node from its inflow links
+    for (i = first; i < mid; i++)
+    {
+        k = ev->Adjlinks[i];
+        releaseflow(pr, k, t);
+        removeflow(pr, k, t, &volin, &massin);
+    }
+
+    // Update the mass balance -- a junction's outflow quality was
+    // constant since its last update
+    dt = t - ev->Tnode[n];
+    volout = ev->Qout[n] * dt;
+    qual->SourceQual = ev->Srcq[n];
+    updatemassbalance(pr, n, massin, volout, dt);
+    if (qual->Qualflag == CHEM && ev->Srcq[n] > 0.0)
+    {
+        massadded = ev->Srcq[n] * volout;
+        net->Node[n].S->Smass += massadded;
+        if (pr->times.Htime >= pr->times.Rstart) qual->Wsource += massadded;
+    }
+
+    // A tank releases its outflow at the quality it has after mixing
+    // in its inflow (as done by fixed step routing)
+    cold = ev->Cout[n];
+    if (net->Node[n].Type == TANK)
+    {
+        mixtank(pr, n, volin, massin, volout);
+        evaloutflowqual(pr, n);
+    }
+
+    // Release the node's outflow into its outflow links
+    for (i = mid; i < last; i++) releaseflow(pr, ev->Adjlinks[i], t);
+
+    // Find the new quality of the node's outflow
+    evaloutflowqual(pr, n);
+    ev->Tnode[n] = t;
+
+    // Schedule the next arrival on inflow links whose leading segment
+    // was used up (or that received a new segment)
+    for (i = first; i < mid; i++)
+    {
+        k = ev->Adjlinks[i];
+        if (ev->Tarr[k] <= t)
+        {
+            ev->Tarr[k] = -1.0;
+            schedulelink(pr, k, t, FALSE);
+        }
+    }
+
+    // Schedule the arrival of a new segment on outflow links whose
+    // contents were uniform
+    for (i = mid; i < last; i++)
+    {
+        k = ev->Adjlinks[i];
+        if (ev->Tarr[k] < 0.0) schedulelink(pr, k, t, ev->Cout[n] != cold);
+    }
+}
+
+
+void evaloutflowqual(Project *pr, int n)
+/*
+**--------------------------------------------------------------
+**   Input:   n = node index
+**   Output:  none
+**   Purpose: finds the current quality of a node's outflow from
+**            the leading segments of its inflow links, including
+**            any source contribution.
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Quality *qual = &pr->quality;
+    Sqevents *ev = &qual->Events;
+
+    int i, k;
+    double q, qin = 0.0, massin = 0.0, c;
+    Pseg seg;
+
+    // Mix the current inflows of the node -- links without
+    // volume pass on the quality of their upstream node
+    for (i = ev->Inflows[n]; i < ev->Outflows[n]; i++)
+    {
+        k = ev->Adjlinks[i];
+        q = fabs(LINKFLOW(k));
+        seg = qual->FirstSeg[k];
+        c = seg ? seg->c : ev->Cout[ev->Upnode[k]];
+        qin += q;
+        massin += q * c;
+    }
+
+    if (net->Node[n].Type == JUNCTION)
+    {
+        // ... dilute inflow with any external negative demand
+        qin -= MIN(0.0, hyd->NodeDemand[n]);
+        if (qin > 0.0) qual->NodeQual[n] = massin / qin;
+    }
+    else if (net->Node[n].Type == TANK)
+    {
+        qual->NodeQual[n] = net->Tank[n - net->Njuncs].C;
+    }
+
+    // For source tracing analysis the trace node's quality is fixed
+    ev->Srcq[n] = 0.0;
+    if (qual->Qualflag == TRACE)
+    {
+        if (n == qual->TraceNode)
+        {
+            if (net->Node[n].Type == RESERVOIR) ev->Srcq[n] = 100.0;
+            else ev->Srcq[n] = MAX(100.0 - qual->NodeQual[n], 0.0);
+            qual->NodeQual[n] = 100.0;
+        }
+        ev->Cout[n] = qual->NodeQual[n];
+        return;
+    }
+
+    // Combine any external source quality with the node quality
+    ev->Srcq[n] = sourceconc(pr, n, ev->Qout[n]);
+    ev->Cout[n] = qual->NodeQual[n];
+    if (ev->Srcq[n] == 0.0) return;
+    switch (net->Node[n].Type)
+    {
+    case JUNCTION:
+        qual->NodeQual[n] += ev->Srcq[n];
+        ev->Cout[n] = qual->NodeQual[n];
+        break;
+
+    case TANK:
+        ev->Cout[n] = qual->NodeQual[n] + ev->Srcq[n];
+        break;
+
+    case RESERVOIR:
+        qual->NodeQual[n] = ev->Srcq[n];
+        ev->Cout[n] = ev->Srcq[n];
+        break;
+    }
+}
+
+
+void releaseflow(Project *pr, int k, double t)
+/*
+**--------------------------------------------------------------
+**   Input:   k = link index
+**            t = time (sec) within the current period
+**   Output:  none
+**   Purpose: releases the flow volume that entered a link since
+**            it was last updated at its upstream node's current
+**            outflow quality.
+**--------------------------------------------------------------
+*/
+{
+    Hydraul *hyd = &pr->hydraul;
+    Quality *qual = &pr->quality;
+    Sqevents *ev = &qual->Events;
+
+    double v, c;
+    Pseg seg;
+
+    v = fabs(LINKFLOW(k)) * (t - ev->Tpush[k]);
+    ev->Tpush[k] = t;
+    if (v <= 0.0) return;
+    c = ev->Cout[ev->Upnode[k]];
+
+    // ... mix with the link's last segment if their qualities are close
+    //     (the quality of the leading segment must not change between
+    //     updates of the downstream node)
+    seg = qual->LastSeg[k];
+    if (seg && (seg->c == c ||
+        (seg != qual->FirstSeg[k] && fabs(seg->c - c) < qual->Ctol)))
+    {
+        seg->c = (seg->c * seg->v + c * v) / (seg->v + v);
+        seg->v += v;
+    }
+
+    // ... otherwise add a new segment at the upstream end of the link
+    else addseg(pr, k, v, c);
+}
+
+
+void removeflow(Project *pr, int k, double t, double *volin, double *massin)
+/*
+**--------------------------------------------------------------
+**   Input:   k = link index
+**            t = time (sec) within the current period
+**   Output:  volin = flow volume entering the downstream node
+**            massin = mass entering the downstream node
+**   Purpose: removes the flow volume that left a link since it
+**            was last updated from the link's leading segments.
+**--------------------------------------------------------------
+*/
+{
+    Hydraul *hyd = &pr->hydraul;
+    Quality *qual = &pr->quality;
+    Sqevents *ev = &qual->Events;
+
+    double q, v, vseg;
+    Pseg seg;
+
+    q = fabs(LINKFLOW(k));
+    v = q * (t - ev->Tpull[k]);
+    ev->Tpull[k] = t;
+    while ((seg = qual->FirstSeg[k]) != NULL)
+    {
+        // ... a segment is used up if what remains of it would pass
+        //     into the node within a microsecond (i.e. round-off)
+        if (seg->v <= v + q * 1.e-6)
+        {
+            vseg = seg->v;
+            qual->FirstSeg[k] = seg->prev;
+            if (qual->FirstSeg[k] == NULL) qual->LastSeg[k] = NULL;
+            seg->prev = qual->FreeSeg;
+            qual->FreeSeg = seg;
+        }
+        else if (v > 0.0)
+        {
+            vseg = v;
+            seg->v -= v;
+        }
+        else break;
+        *volin += vseg;
+        *massin += vseg * seg->c;
+        v = MAX(0.0, v - vseg);
+    }
+}
+
+
+void schedulelink(Project *pr, int k, double t, int changed)
+/*
+**--------------------------------------------------------------
+**   Input:   k = link index
+**            t = time (sec) within the current period
+**            changed = TRUE if the quality of the upstream node's
+**                      outflow changed at time t
+**   Output:  none
+**   Purpose: schedules an update of a link's downstream node for
+**            when the link's leading segment will be used up.
+**--------------------------------------------------------------
+*/
+{
+    Hydraul *hyd = &pr->hydraul;
+    Quality *qual = &pr->quality;
+    Sqevents *ev = &qual->Events;
+
+    double q;
+    Pseg seg;
+
+    q = fabs(LINKFLOW(k));
+    if (q == 0.0) return;
+
+    // A link without volume passes on any change at once
+    seg = qual->FirstSeg[k];
+    if (seg == NULL)
+    {
+        if (changed) pushevent(pr, t, ev->Dnnode[k]);
+        return;
+    }
+
+    // Nothing will arrive if the link's contents are uniform and
+    // equal to what enters it
+    if (seg == qual->LastSeg[k] && seg->c == ev->Cout[ev->Upnode[k]]) return;
+
+    // The leading segment can not be used up before time t
+    ev->Tarr[k] = MAX(t, ev->Tpull[k] + seg->v / q);
+    pushevent(pr, ev->Tarr[k], ev->Dnnode[k]);
+}
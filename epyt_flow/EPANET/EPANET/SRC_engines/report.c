@@ -50,6 +50,7 @@ static void writelimits(Project *, int, int);
 static int  checklimits(Report *, double *, int, int);
 static char *fillstr(char *, char, int);
 static int  getnodetype(Network *, int);
+static char *datestamp(char *);
 
 int clearreport(Project *pr)
 /*
@@ -192,15 +193,12 @@ void writelogo(Project *pr)
     int major;
     int minor;
     char s[80];
-    time_t timer; // time_t structure & functions time() &
-                  // ctime() are defined in time.h
 
     version = CODEVERSION;
     major = version / 10000;
     minor = (version % 10000) / 100;
 
-    time(&timer);
-    strcpy(rpt->DateStamp, ctime(&timer));
+    datestamp(rpt->DateStamp);
     rpt->PageNum = 1;
     rpt->LineNum = 2;
     fprintf(rpt->RptFile, FMT18);
@@ -291,7 +289,7 @@ void writesummary(Project *pr)
   if (qual->Qualflag == NONE || time->Dur == 0.0) sprintf(s, FMT29);
   else if (qual->Qualflag == CHEM)  sprintf(s, FMT30, qual->ChemName);
   else if (qual->Qualflag == TRACE) sprintf(s, FMT31, net->Node[qual->TraceNode].ID);
-  else if (qual->Qualflag == AGE)   printf(s, FMT32);
+  else if (qual->Qualflag == AGE)   sprintf(s, FMT32);
   writeline(pr, s);
   if (qual->Qualflag != NONE && time->Dur > 0)
   {
@@ -1437,9 +1435,8 @@ void writetime(Project *pr, char *fmt)
 **----------------------------------------------------------------
 */
 {
-    time_t timer;
-    time(&timer);
-    sprintf(pr->Msg, fmt, ctime(&timer));
+    char s[26];
+    sprintf(pr->Msg, fmt, datestamp(s));
     writeline(pr, pr->Msg);
 }
 
@@ -1487,3 +1484,22 @@ int getnodetype(Network *net, int i)
     if (net->Tank[i - net->Njuncs].A == 0.0) return 1;
     return 2;
 }
+
+char *datestamp(char *s)
+/*
+**---------------------------------------------------------
+**  Writes the current date & time to s (26 bytes).
+**  NOTE: ctime() returns a shared buffer -- the reentrant
+**        versions are used instead.
+**---------------------------------------------------------
+*/
+{
+    time_t timer;
+    time(&timer);
+#ifdef _WIN32
+    ctime_s(s, 26, &timer);
+#else
+    ctime_r(&timer, s);
+#endif
+    return s;
+}
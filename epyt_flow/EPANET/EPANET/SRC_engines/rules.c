@@ -426,6 +426,58 @@ void adjusttankrules(Project *pr)
     }
 }
 
+void remaprules(Project *pr, const int *nodemap, const int *linkmap)
+//-----------------------------------------------------------
+//    Deletes rules that refer to deleted nodes or links and
+//    renumbers the nodes and links in all other rules
+//    (a new index of 0 marks a deleted object).
+//-----------------------------------------------------------
+{
+    Network *net = &pr->network;
+
+    int i, delete;
+    Spremise *p;
+    Saction *a;
+
+    // Delete rules that refer to a deleted object
+    for (i = net->Nrules; i >= 1; i--)
+    {
+        delete = FALSE;
+        for (p = net->Rule[i].Premises; p != NULL && !delete; p = p->next)
+        {
+            if (p->object == r_NODE && nodemap[p->index] == 0) delete = TRUE;
+            if (p->object == r_LINK && linkmap[p->index] == 0) delete = TRUE;
+        }
+        for (a = net->Rule[i].ThenActions; a != NULL && !delete; a = a->next)
+        {
+            if (linkmap[a->link] == 0) delete = TRUE;
+        }
+        for (a = net->Rule[i].ElseActions; a != NULL && !delete; a = a->next)
+        {
+            if (linkmap[a->link] == 0) delete = TRUE;
+        }
+        if (delete) deleterule(pr, i);
+    }
+
+    // Renumber the objects of the remaining rules
+    for (i = 1; i <= net->Nrules; i++)
+    {
+        for (p = net->Rule[i].Premises; p != NULL; p = p->next)
+        {
+            if (p->object == r_NODE) p->index = nodemap[p->index];
+            if (p->object == r_LINK) p->index = linkmap[p->index];
+        }
+        for (a = net->Rule[i].ThenActions; a != NULL; a = a->next)
+        {
+            a->link = linkmap[a->link];
+        }
+        for (a = net->Rule[i].ElseActions; a != NULL; a = a->next)
+        {
+            a->link = linkmap[a->link];
+        }
+    }
+}
+
 Spremise *getpremise(Spremise *premises, int i)
 //----------------------------------------------------------
 //    Return the i-th premise in a rule
@@ -17,6 +17,7 @@
 #include <stdio.h>
 
 #include "hash.h"
+#include "epanet2_enums.h"
 
 /*
 -------------------------------------------
@@ -53,6 +54,7 @@ typedef  int          INT4;
 #define   VISCOS    1.1E-5     // Kinematic viscosity of water
                                // @ 20 deg C (sq ft/sec)
 #define   MINPDIFF  0.1        // PDA min. pressure difference (psi or m)
+#define   MAXPROFPHASES 32     // Max. # of profiled simulation phases
 #define   SEPSTR    " \t\n\r"  // Token separator characters
 #ifdef M_PI
   #define   PI        M_PI
@@ -108,6 +110,19 @@ typedef  int          INT4;
 #define UCHAR(x) (((x) >= 'a' && (x) <= 'z') ? ((x)&~32) : (x))
                                               // uppercase char of x
 /*
+---------------------------------------------------------------------
+   Macros to time a simulation phase if profiling is enabled
+   (t is a local double holding the phase's start time)
+---------------------------------------------------------------------
+*/
+#define PROFSTART(pr, t) \
+    do { if ((pr)->profile.Enabled || (pr)->profile.Tracing) \
+             (t) = profclock(); } while(0)
+#define PROFSTOP(pr, phase, t) \
+    do { if ((pr)->profile.Enabled || (pr)->profile.Tracing) \
+             profstop((pr), (phase), (t)); } while(0)
+
+/*
 ------------------------------------------------------
    Macro to evaluate function x with error checking
    (Fatal errors are numbered higher than 100)
@@ -338,6 +353,19 @@ typedef struct             // Curve Object
   double    *Y;            // y-values
 } Scurve;
 
+typedef struct             // Curve Lookup Table
+{
+  int       Npts;          // number of points (0 if no table)
+  int       Nxbins;        // number of bins of x-values (0 if none)
+  int       Nybins;        // number of bins of y-values (0 if none)
+  double    Xscale;        // bins per unit of x
+  double    Yscale;        // bins per unit of y
+  int       *Xbin;         // first point at or above each x-value bin
+  int       *Ybin;         // first point at or above each y-value bin
+  double    *H0;           // intercept of each curve segment
+  double    *R;            // slope of each curve segment
+} Scurvetab;
+
 struct Sdemand             // Demand List Item
 {
   double Base;             // baseline demand
@@ -537,6 +565,41 @@ typedef struct                 // Mass Balance Components
     double    ratio;           // ratio of mass added to mass lost
 } SmassBalance;
 
+typedef struct                 // Event-Driven Quality Routing
+{
+    int       Nheap;           // number of pending events
+    int       Maxheap;         // capacity of the event heap
+    int      *HeapNode;        // node updated by each event
+    double   *HeapTime;        // time of each event
+    double    Tend;            // length of the current routing period
+    double   *Cout;            // quality of each node's outflow
+    double   *Srcq;            // source quality added at each node
+    double   *Qout;            // outflow rate of each node
+    double   *Tnode;           // last update time of each node
+    double   *Tpush;           // time up to which flow entered each link
+    double   *Tpull;           // time up to which flow left each link
+    double   *Tarr;            // arrival time of each link's leading segment
+    int      *Upnode;          // upstream node of each link
+    int      *Dnnode;          // downstream node of each link
+    int      *Inflows;         // start of each node's inflow links in Adjlinks
+    int      *Outflows;        // start of each node's outflow links in Adjlinks
+    int      *Adjlinks;        // links with flow grouped by node
+    long      Count;           // number of events processed
+} Sqevents;
+
+typedef struct                 // Incremental Topological Sort
+{
+    int       Valid;           // TRUE if sorted nodes have no cycles
+    int       Budget;          // nodes left to visit before a full sort
+    int      *Pos;             // position of each node in SortedNodes
+    int      *Mark;            // search mark of each node
+    int      *Stack;           // depth-first search stack
+    int      *Delta;           // positions of the re-ordered nodes
+    int      *Nodes;           // re-ordered nodes
+    int       Nchanged;        // number of links with a new flow direction
+    int      *Changed;         // links with a new (non-negligible) flow direction
+} Ssort;
+
 /*
 ------------------------------------------------------
   Wrapper Data Structures
@@ -752,6 +815,9 @@ typedef struct {
 
   Smatrix smatrix;         // Sparse matrix storage
 
+  Scurvetab *CurveTab;     // Lookup tables of curves
+  int       Ncurvetabs;    // Number of curves with lookup tables
+
 } Hydraul;
 
 // Forward declaration of the Mempool structure defined in mempool.h
@@ -764,6 +830,8 @@ typedef struct {
     Qualflag,              // Water quality analysis flag
     OpenQflag,             // Quality system opened flag
     Reactflag,             // Reaction indicator
+    RouteMode,             // Quality routing mode (see EN_QualRouting)
+    FullSort,              // Always re-sort all nodes flag
     OutOfMemory,           // Out of memory indicator
     TraceNode,             // Source node for flow tracing
     *SortedNodes;          // Topologically sorted node indexes
@@ -807,6 +875,12 @@ typedef struct {
   SmassBalance
     MassBalance;           // Mass balance components
 
+  Sqevents
+    Events;                // Event-driven routing work space
+
+  Ssort
+    Sort;                  // Incremental node sorting work space
+
 } Quality;
 
 // Pipe Network Wrapper
@@ -841,6 +915,138 @@ typedef struct {
 
 } Network;
 
+// Trace Event Object
+typedef struct {
+  int    Phase;                 // Simulation phase (see EN_ProfilePhase)
+  double Start;                 // Time at which the phase was entered (sec)
+  double Duration;              // Time spent in the phase (sec)
+} STraceEvent;
+
+// Performance Profiling Wrapper
+typedef struct {
+  int
+    Enabled,                    // Profiling enabled flag
+    Tracing,                    // Tracing enabled flag
+    TraceSize;                  // Capacity of the trace ring buffer
+  double
+    Time[MAXPROFPHASES];        // Accumulated wall clock time (sec) per phase
+  long
+    Calls[MAXPROFPHASES],       // Number of times each phase was entered
+    Iterations,                 // Total hydraulic trials taken by hydsolve
+    TraceHead,                  // # of trace events already retrieved
+    TraceCount,                 // # of trace events recorded
+    TraceDropped;               // # of trace events overwritten
+  STraceEvent
+    *Trace;                     // Ring buffer of trace events
+} Profile;
+
+// Hydraulic Step Diagnostics Record
+typedef struct {
+  long   Time;                  // Hydraulic time (sec)
+  int    Iterations;            // Number of hydraulic trials taken
+  double RelativeError;         // Total flow change / total flow
+  double MaxHeadError;          // Max. error for link head loss (ft)
+  double MaxFlowChange;         // Max. change in link flow (cfs)
+  int    StatusChanges;         // Number of links that changed status
+  int    BadValves;             // Number of ill-conditioning events
+  int    DeficientNodes;        // Number of pressure deficient nodes
+  double DemandReduction;       // % demand reduction at deficient nodes
+  int    Flags;                 // Combination of EN_DiagnosticFlag bits
+} SHydDiag;
+
+// Solver Diagnostics Wrapper
+typedef struct {
+  int
+    Enabled,                    // Diagnostics recording enabled flag
+    Count,                      // Number of recorded steps
+    Capacity,                   // Allocated size of Steps
+    StatusSize,                 // Allocated size of StartStatus
+    BadValves,                  // Ill-conditioning events in current step
+    Flags;                      // Diagnostic flags of current step
+  SHydDiag
+    *Steps;                     // Records of hydraulic steps
+  StatusType
+    *StartStatus;               // Link status at start of current step
+} Diagnostics;
+
+// Network Edit Transaction Wrapper
+typedef struct {
+  int
+    Active,                     // Edit transaction in progress flag
+    NodeCapacity,               // Allocated size of node arrays
+    LinkCapacity,               // Allocated size of link arrays
+    TankCapacity,               // Allocated size of Tank array
+    PumpCapacity,               // Allocated size of Pump array
+    ValveCapacity,              // Allocated size of Valve array
+    PatCapacity,                // Allocated size of Pattern array
+    ControlCapacity,            // Allocated size of Control array
+    Ndeleted,                   // # nodes & links pending deletion
+    NtankLinks;                 // # links connected to tanks/reservoirs
+  char
+    *NodeDeleted,               // Nodes pending deletion flags
+    *LinkDeleted,               // Links pending deletion flags
+    *IsTankLink;                // Links connected to tanks/reservoirs flags
+  int
+    *TankLinks;                 // Links connected to tanks/reservoirs
+} Editor;
+
+// Hydraulic States of a Simulation Run
+typedef struct {
+  int
+    Count,                      // Number of recorded time steps
+    Capacity,                   // Allocated number of time steps
+    Njuncs,                     // Number of junctions per time step
+    Nlinks;                     // Number of links per time step
+  long
+    *Time;                      // Hydraulic time of each step (sec)
+  double
+    *Flow,                      // Link flows (Count x Nlinks)
+    *Head,                      // Junction heads (Count x Njuncs)
+    *Emitter,                   // Junction emitter flows (Count x Njuncs)
+    *Demand;                    // Junction demand flows (Count x Njuncs)
+} SHydRun;
+
+// Warm Start Wrapper (re-runs of a hydraulic analysis)
+typedef struct {
+  int
+    Enabled,                    // Warm starts enabled flag
+    Next,                       // Next step of the previous run to match
+    Hits,                       // Steps warm started in the current run
+    Applied,                    // Current step warm started flag
+    Accepted,                   // Steps accepted within the tolerance
+    Reused,                     // Cached matrix structure reused flag
+    CacheValid,                 // Matrix structure cached flag
+    CacheNnodes,                // Number of nodes of the cached structure
+    CacheNjuncs,                // Number of junctions of the cached structure
+    CacheNlinks,                // Number of links of the cached structure
+    *CacheEnds;                 // End nodes of each link of the cached structure
+  double
+    Tolerance;                  // Max. flow change of an accepted warm start
+  SHydRun
+    Prev,                       // States of the previous run
+    Curr;                       // States of the current run
+  Smatrix
+    Cache;                      // Cached sparse matrix structure
+} Warmstart;
+
+// Observed Sensor Readings (residuals of a hydraulic analysis)
+typedef struct {
+  int
+    Nsensors,                   // Number of sensors
+    Ntimes,                     // Number of observed time points
+    Next,                       // Next observed time point to match
+    Count,                      // Number of residuals of the current run
+    *Object,                    // Object type of each sensor (EN_NODE or EN_LINK)
+    *Index,                     // Node or link index of each sensor
+    *Property;                  // Measured property of each sensor
+  long
+    *Time;                      // Observed time points (sec)
+  double
+    *Scale,                     // Scaling factor of each sensor's residuals
+    *Value,                     // Observed readings (Ntimes x Nsensors)
+    Sum;                        // Sum of squared residuals of the current run
+} Observations;
+
 // Overall Project Wrapper
 typedef struct Project {
 
@@ -852,6 +1058,11 @@ typedef struct Project {
   Rules      rules;              // Rule-based controls wrapper
   Hydraul    hydraul;            // Hydraulics solver wrapper
   Quality    quality;            // Water quality solver wrapper
+  Profile    profile;            // Performance profiling wrapper
+  Diagnostics diagnostics;       // Solver diagnostics wrapper
+  Editor     editor;             // Network edit transaction wrapper
+  Warmstart  warmstart;          // Warm start wrapper
+  Observations observations;     // Observed sensor readings wrapper
 
   double Ucf[MAXVAR];            // Unit conversion factors
 
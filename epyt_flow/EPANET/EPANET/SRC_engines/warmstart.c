@@ -0,0 +1,446 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       warmstart.c
+ Description:  re-runs of a hydraulic analysis that start each time step
+               from the solution of the previous run and re-use the
+               structure of the sparse matrix
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+*/
+/*
+ Once enabled, the converged flows and heads of every hydraulic time step
+ are recorded. The next run of the analysis (i.e. after the solver was
+ re-initialized) uses the recorded state of a time step as the initial
+ solution of the same time step -- after small changes of the model
+ (e.g. of pipe roughnesses or valve settings) only a few trials are needed.
+ If a tolerance is set, a warm started step whose first trial changes the
+ flows by no more than the tolerance is accepted after that trial.
+ When the hydraulic solver is closed, the node re-ordering and symbolic
+ factorization of its sparse matrix are kept and re-used when the solver is
+ opened again, unless the network's structure has changed in between.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "funcs.h"
+
+// Imported functions
+extern int  createsparse(Project *);   //(see SMATRIX.C)
+extern void freesparse(Project *);     //(see SMATRIX.C)
+extern const double QZERO;             //(see HYDRAUL.C)
+
+// Local functions
+static void  freerun(SHydRun *);
+static int   growrun(SHydRun *, int, int);
+static void  appendtail(SHydRun *, SHydRun *);
+static void  freecache(Project *);
+static int   samestructure(Project *);
+
+
+int warmstartenable(Project *pr, int enabled)
+/*
+**--------------------------------------------------------------
+**  Input:   enabled = TRUE to start recording, FALSE to stop it
+**  Output:  returns error code
+**  Purpose: turns warm starts on or off; both discard all
+**           recorded states and the cached matrix structure
+**--------------------------------------------------------------
+*/
+{
+    warmstartclear(pr);
+    pr->warmstart.Enabled = enabled ? TRUE : FALSE;
+    return 0;
+}
+
+
+void warmstartclear(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: discards all recorded states and the cached matrix
+**           structure
+**--------------------------------------------------------------
+*/
+{
+    Warmstart *ws = &pr->warmstart;
+
+    freerun(&ws->Prev);
+    freerun(&ws->Curr);
+    freecache(pr);
+    ws->Next = 0;
+    ws->Hits = 0;
+    ws->Applied = FALSE;
+    ws->Accepted = 0;
+    ws->Reused = FALSE;
+}
+
+
+void warmstartinit(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: makes the states recorded by the current run the
+**           states of the previous run
+**
+**  Notes:   Called whenever the hydraulic solver is initialized.
+**           A run that was stopped early is completed by the
+**           states of the previous run. States recorded for a
+**           different number of junctions or links are discarded.
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Warmstart *ws = &pr->warmstart;
+    SHydRun run;
+
+    if (ws->Curr.Count > 0)
+    {
+        appendtail(&ws->Curr, &ws->Prev);
+        run = ws->Prev;
+        ws->Prev = ws->Curr;
+        ws->Curr = run;
+    }
+    ws->Curr.Count = 0;
+    if (ws->Prev.Njuncs != net->Njuncs || ws->Prev.Nlinks != net->Nlinks)
+    {
+        freerun(&ws->Prev);
+    }
+    ws->Next = 0;
+    ws->Hits = 0;
+    ws->Applied = FALSE;
+    ws->Accepted = 0;
+}
+
+
+int warmstartapply(Project *pr, long t)
+/*
+**--------------------------------------------------------------
+**  Input:   t = current hydraulic time (sec)
+**  Output:  returns TRUE if a state of the previous run was used
+**  Purpose: initializes the solution of the current time step with
+**           the solution of the previous run at the same time
+**
+**  Notes:   Called after demands & controls have been updated.
+**           Link status is left as is -- only the flows of open
+**           links, the junction heads, the emitter flows and (for
+**           a pressure driven analysis) the demand flows are set.
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    Warmstart *ws = &pr->warmstart;
+    SHydRun *run = &ws->Prev;
+
+    int i, k;
+    double *flow, *head, *emitter, *demand;
+
+    // Find the time step of the previous run (times are increasing)
+    ws->Applied = FALSE;
+    while (ws->Next < run->Count && run->Time[ws->Next] < t) ws->Next++;
+    if (ws->Next >= run->Count || run->Time[ws->Next] != t) return FALSE;
+    k = ws->Next++;
+
+    flow = run->Flow + (size_t)k * run->Nlinks;
+    head = run->Head + (size_t)k * run->Njuncs;
+    emitter = run->Emitter + (size_t)k * run->Njuncs;
+    demand = run->Demand + (size_t)k * run->Njuncs;
+
+    for (i = 1; i <= net->Nlinks; i++)
+    {
+        if (hyd->LinkStatus[i] <= CLOSED) continue;
+        if (ABS(flow[i-1]) > QZERO) hyd->LinkFlow[i] = flow[i-1];
+    }
+    for (i = 1; i <= net->Njuncs; i++)
+    {
+        hyd->NodeHead[i] = head[i-1];
+        if (net->Node[i].Ke > 0.0) hyd->EmitterFlow[i] = emitter[i-1];
+        if (hyd->DemandModel == PDA && hyd->NodeDemand[i] > 0.0)
+        {
+            hyd->DemandFlow[i] = MIN(MAX(demand[i-1], 0.0), hyd->NodeDemand[i]);
+        }
+    }
+    ws->Hits++;
+    ws->Applied = TRUE;
+    return TRUE;
+}
+
+
+int warmstartaccept(Project *pr, double maxflowchange)
+/*
+**--------------------------------------------------------------
+**  Input:   maxflowchange = largest flow change of the first
+**                           trial (cfs)
+**  Output:  returns TRUE if the solution can be accepted
+**  Purpose: checks if the first trial of a warm started time step
+**           changed the previous run's solution by less than the
+**           warm start tolerance
+**
+**  Notes:   The tolerance is given in flow units, so that a step
+**           whose equations the previous run's solution already
+**           satisfies is not solved to full accuracy again. The
+**           status checks of a converged solution still apply.
+**--------------------------------------------------------------
+*/
+{
+    Warmstart *ws = &pr->warmstart;
+
+    if (!ws->Enabled || !ws->Applied || ws->Tolerance <= 0.0) return FALSE;
+    return maxflowchange * pr->Ucf[FLOW] <= ws->Tolerance;
+}
+
+
+int warmstartrecord(Project *pr, long t)
+/*
+**--------------------------------------------------------------
+**  Input:   t = current hydraulic time (sec)
+**  Output:  returns error code
+**  Purpose: records the solution of the time step just solved
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Hydraul *hyd = &pr->hydraul;
+    SHydRun *run = &pr->warmstart.Curr;
+
+    int i, k;
+    double *head, *emitter, *demand;
+
+    if (growrun(run, net->Njuncs, net->Nlinks)) return 101;
+
+    k = run->Count++;
+    run->Time[k] = t;
+    memcpy(run->Flow + (size_t)k * run->Nlinks, &hyd->LinkFlow[1],
+           run->Nlinks * sizeof(double));
+    head = run->Head + (size_t)k * run->Njuncs;
+    emitter = run->Emitter + (size_t)k * run->Njuncs;
+    demand = run->Demand + (size_t)k * run->Njuncs;
+    for (i = 1; i <= net->Njuncs; i++)
+    {
+        head[i-1] = hyd->NodeHead[i];
+        emitter[i-1] = hyd->EmitterFlow[i];
+
+        // NodeDemand holds the actual outflow after a solution
+        demand[i-1] = hyd->NodeDemand[i] - hyd->EmitterFlow[i];
+    }
+    return 0;
+}
+
+
+void warmstartkeep(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: moves the sparse matrix of the hydraulic solver, which
+**           is about to be closed, into the cache
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Warmstart *ws = &pr->warmstart;
+    int k;
+
+    freecache(pr);
+    ws->CacheEnds = (int *)calloc(2 * net->Nlinks + 1, sizeof(int));
+    if (ws->CacheEnds == NULL)
+    {
+        freesparse(pr);
+        return;
+    }
+    for (k = 1; k <= net->Nlinks; k++)
+    {
+        ws->CacheEnds[2*k-1] = net->Link[k].N1;
+        ws->CacheEnds[2*k] = net->Link[k].N2;
+    }
+    ws->CacheNnodes = net->Nnodes;
+    ws->CacheNjuncs = net->Njuncs;
+    ws->CacheNlinks = net->Nlinks;
+    ws->Cache = pr->hydraul.smatrix;
+    memset(&pr->hydraul.smatrix, 0, sizeof(Smatrix));
+    ws->CacheValid = TRUE;
+}
+
+
+int warmstartrestore(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns error code
+**  Purpose: sets up the sparse matrix of the hydraulic solver,
+**           which is about to be opened, either from the cache or
+**           from scratch
+**--------------------------------------------------------------
+*/
+{
+    Warmstart *ws = &pr->warmstart;
+
+    ws->Reused = FALSE;
+    if (ws->CacheValid && samestructure(pr))
+    {
+        pr->hydraul.smatrix = ws->Cache;
+        memset(&ws->Cache, 0, sizeof(Smatrix));
+        ws->CacheValid = FALSE;
+        FREE(ws->CacheEnds);
+        ws->Reused = TRUE;
+
+        // Adjacency lists are expected to be up to date by the solver
+        return buildadjlists(&pr->network);
+    }
+    freecache(pr);
+    return createsparse(pr);
+}
+
+
+int samestructure(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns TRUE if the cached matrix structure fits the
+**           current network
+**--------------------------------------------------------------
+*/
+{
+    Network *net = &pr->network;
+    Warmstart *ws = &pr->warmstart;
+    int k;
+
+    if (ws->CacheNnodes != net->Nnodes || ws->CacheNjuncs != net->Njuncs ||
+        ws->CacheNlinks != net->Nlinks) return FALSE;
+    for (k = 1; k <= net->Nlinks; k++)
+    {
+        if (ws->CacheEnds[2*k-1] != net->Link[k].N1 ||
+            ws->CacheEnds[2*k] != net->Link[k].N2) return FALSE;
+    }
+    return TRUE;
+}
+
+
+void freecache(Project *pr)
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: frees the cached matrix structure
+**--------------------------------------------------------------
+*/
+{
+    Warmstart *ws = &pr->warmstart;
+    Smatrix sm;
+
+    if (ws->CacheValid)
+    {
+        // Let freesparse() free the cached instead of the solver's matrix
+        sm = pr->hydraul.smatrix;
+        pr->hydraul.smatrix = ws->Cache;
+        freesparse(pr);
+        pr->hydraul.smatrix = sm;
+    }
+    memset(&ws->Cache, 0, sizeof(Smatrix));
+    FREE(ws->CacheEnds);
+    ws->CacheValid = FALSE;
+}
+
+
+void freerun(SHydRun *run)
+/*
+**--------------------------------------------------------------
+**  Input:   run = states of a simulation run
+**  Output:  none
+**  Purpose: frees the recorded states of a simulation run
+**--------------------------------------------------------------
+*/
+{
+    FREE(run->Time);
+    FREE(run->Flow);
+    FREE(run->Head);
+    FREE(run->Emitter);
+    FREE(run->Demand);
+    run->Count = 0;
+    run->Capacity = 0;
+    run->Njuncs = 0;
+    run->Nlinks = 0;
+}
+
+
+void appendtail(SHydRun *run, SHydRun *prev)
+/*
+**--------------------------------------------------------------
+**  Input:   run = states of the current run
+**           prev = states of the previous run
+**  Output:  none
+**  Purpose: appends the states of the previous run that are later
+**           than the last state of the current run
+**--------------------------------------------------------------
+*/
+{
+    int k, n;
+    long last = run->Time[run->Count - 1];
+
+    if (prev->Njuncs != run->Njuncs || prev->Nlinks != run->Nlinks) return;
+    for (k = 0; k < prev->Count; k++)
+    {
+        if (prev->Time[k] <= last) continue;
+        if (growrun(run, run->Njuncs, run->Nlinks)) return;
+        n = run->Count++;
+        run->Time[n] = prev->Time[k];
+        memcpy(run->Flow + (size_t)n * run->Nlinks, prev->Flow + (size_t)k * prev->Nlinks,
+               run->Nlinks * sizeof(double));
+        memcpy(run->Head + (size_t)n * run->Njuncs, prev->Head + (size_t)k * prev->Njuncs,
+               run->Njuncs * sizeof(double));
+        memcpy(run->Emitter + (size_t)n * run->Njuncs, prev->Emitter + (size_t)k * prev->Njuncs,
+               run->Njuncs * sizeof(double));
+        memcpy(run->Demand + (size_t)n * run->Njuncs, prev->Demand + (size_t)k * prev->Njuncs,
+               run->Njuncs * sizeof(double));
+    }
+}
+
+
+int growrun(SHydRun *run, int njuncs, int nlinks)
+/*
+**--------------------------------------------------------------
+**  Input:   run = states of a simulation run
+**           njuncs = number of junctions
+**           nlinks = number of links
+**  Output:  returns error code
+**  Purpose: makes room for recording another time step
+**--------------------------------------------------------------
+*/
+{
+    int capacity;
+    long *time;
+    double *flow, *head, *emitter, *demand;
+
+    // States of a different network can not be extended
+    if (run->Njuncs != njuncs || run->Nlinks != nlinks)
+    {
+        freerun(run);
+        run->Njuncs = njuncs;
+        run->Nlinks = nlinks;
+    }
+    if (run->Count < run->Capacity) return 0;
+
+    capacity = MAX(2 * run->Capacity, 32);
+    time = (long *)realloc(run->Time, capacity * sizeof(long));
+    if (time) run->Time = time;
+    flow = (double *)realloc(run->Flow, (size_t)capacity * nlinks * sizeof(double));
+    if (flow) run->Flow = flow;
+    head = (double *)realloc(run->Head, (size_t)capacity * MAX(njuncs, 1) * sizeof(double));
+    if (head) run->Head = head;
+    emitter = (double *)realloc(run->Emitter, (size_t)capacity * MAX(njuncs, 1) * sizeof(double));
+    if (emitter) run->Emitter = emitter;
+    demand = (double *)realloc(run->Demand, (size_t)capacity * MAX(njuncs, 1) * sizeof(double));
+    if (demand) run->Demand = demand;
+    if (!time || !flow || !head || !emitter || !demand) return 101;
+    run->Capacity = capacity;
+    return 0;
+}
@@ -0,0 +1,469 @@
+/*
+ ******************************************************************************
+ Project:      OWA EPANET
+ Version:      2.2
+ Module:       enbench.c
+ Description:  micro-benchmarks of the hydraulic and water quality kernels
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/18/2026
+ ******************************************************************************
+
+ Usage: enbench <.inp file or directory> [-n repetitions] [-o results.json]
+
+ Every .inp file (of the directory) is loaded and the following kernels are
+ timed over the given number of repetitions:
+
+   createsparse    -- node re-ordering (genmmd) & symbolic factorization
+   coeffs          -- headlosscoeffs() + matrixcoeffs()
+   linsolve        -- numeric factorization + solve
+   hydsolve        -- a complete (cold started) hydraulic solution
+   transport       -- water quality transport over one quality time step
+   reactpipes      -- pipe reactions over one quality time step
+   msx_transport   -- EPANET-MSX transport over one quality time step
+   msx_react       -- EPANET-MSX reactions over one quality time step
+
+ The EPANET-MSX kernels are only timed if the benchmark was compiled with
+ WITH_MSX and an .msx file of the same name exists next to the .inp file.
+ Results (incl. hardware and compiler information) are written as JSON.
+*/
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+#endif
+
+#include "types.h"
+#include "funcs.h"
+#include "epanet2_2.h"
+
+#ifdef WITH_MSX
+#include "epanet2.h"
+#include "epanetmsx.h"
+#endif
+
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS "unknown"
+#endif
+
+#define MAXFILES 1024
+
+// Imported functions (not declared in funcs.h)
+extern int  createsparse(Project *);
+extern void freesparse(Project *);
+extern int  linsolve(Smatrix *, int);
+extern int  hydsolve(Project *, int *, double *);
+extern void demands(Project *);
+extern void transport(Project *, long);
+extern void reactpipes(Project *, long);
+
+// Timing statistics of a kernel
+typedef struct {
+    const char *name;
+    int    n;
+    double total, min, max, sumsq;
+} Stats;
+
+
+static void statsinit(Stats *s, const char *name)
+{
+    s->name = name;
+    s->n = 0;
+    s->total = 0.0;
+    s->min = 0.0;
+    s->max = 0.0;
+    s->sumsq = 0.0;
+}
+
+
+static void statsadd(Stats *s, double dt)
+{
+    if (s->n == 0 || dt < s->min) s->min = dt;
+    if (s->n == 0 || dt > s->max) s->max = dt;
+    s->total += dt;
+    s->sumsq += dt * dt;
+    s->n++;
+}
+
+
+static void writestring(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+
+static void writestats(FILE *f, Stats *s, int last)
+{
+    double mean = 0.0, stddev = 0.0;
+
+    if (s->n > 0)
+    {
+        mean = s->total / s->n;
+        stddev = sqrt(fmax(0.0, s->sumsq / s->n - mean * mean));
+    }
+    fprintf(f, "        \"%s\": {\"repetitions\": %d, \"total\": %.9g, "
+               "\"mean\": %.9g, \"min\": %.9g, \"max\": %.9g, \"stddev\": %.9g}%s\n",
+            s->name, s->n, s->total, mean, s->min, s->max, stddev, last ? "" : ",");
+}
+
+
+static void writehardware(FILE *f)
+{
+    char cpu[256] = "unknown";
+    long ncpus = 0;
+    double memory = 0.0;
+    char os[256] = "unknown";
+
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    MEMORYSTATUSEX ms;
+
+    GetSystemInfo(&si);
+    ncpus = si.dwNumberOfProcessors;
+    ms.dwLength = sizeof(ms);
+    if (GlobalMemoryStatusEx(&ms)) memory = (double)ms.ullTotalPhys;
+    strcpy(os, "Windows");
+#else
+    FILE *cpuinfo;
+    char line[512], *p;
+    struct utsname un;
+
+    cpuinfo = fopen("/proc/cpuinfo", "r");
+    if (cpuinfo != NULL)
+    {
+        while (fgets(line, sizeof(line), cpuinfo) != NULL)
+        {
+            if (strncmp(line, "model name", 10) == 0 && (p = strchr(line, ':')) != NULL)
+            {
+                p++;
+                while (*p == ' ' || *p == '\t') p++;
+                p[strcspn(p, "\r\n")] = '\0';
+                strncpy(cpu, p, sizeof(cpu) - 1);
+                break;
+            }
+        }
+        fclose(cpuinfo);
+    }
+    ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    memory = (double)sysconf(_SC_PHYS_PAGES) * (double)sysconf(_SC_PAGE_SIZE);
+    if (uname(&un) == 0)
+    {
+        snprintf(os, sizeof(os), "%s %s %s", un.sysname, un.release, un.machine);
+    }
+#endif
+
+    fprintf(f, "  \"hardware\": {\"cpu\": ");
+    writestring(f, cpu);
+    fprintf(f, ", \"cpus\": %ld, \"memory_bytes\": %.0f, \"os\": ", ncpus, memory);
+    writestring(f, os);
+    fprintf(f, "},\n");
+#ifdef __VERSION__
+    fprintf(f, "  \"compiler\": ");
+    writestring(f, __VERSION__);
+    fprintf(f, ",\n");
+#endif
+    fprintf(f, "  \"cflags\": ");
+    writestring(f, BENCH_CFLAGS);
+    fprintf(f, ",\n");
+}
+
+
+static int benchhydraulics(EN_Project ph, int nreps, Stats *stats)
+/*
+**  Times createsparse, coeffs, linsolve and hydsolve (stats[0..3])
+*/
+{
+    Project *pr = (Project *)ph;
+    Smatrix *sm = &pr->hydraul.smatrix;
+    int i, iter, errcode;
+    double t0, relerr;
+
+    errcode = EN_openH(ph);
+    if (errcode > 100) return errcode;
+
+    for (i = 0; i < nreps && !errcode; i++)
+    {
+        freesparse(pr);
+        t0 = profclock();
+        errcode = createsparse(pr);
+        statsadd(&stats[0], profclock() - t0);
+    }
+
+    for (i = 0; i < nreps && !errcode; i++)
+    {
+        EN_initH(ph, EN_INITFLOW);
+        demands(pr);
+        t0 = profclock();
+        hydsolve(pr, &iter, &relerr);
+        statsadd(&stats[3], profclock() - t0);
+    }
+
+    // linsolve() overwrites the matrix with its factorization,
+    // hence the coefficients are re-computed before each solve
+    for (i = 0; i < nreps && !errcode; i++)
+    {
+        t0 = profclock();
+        headlosscoeffs(pr);
+        matrixcoeffs(pr);
+        statsadd(&stats[1], profclock() - t0);
+        t0 = profclock();
+        linsolve(sm, pr->network.Njuncs);
+        statsadd(&stats[2], profclock() - t0);
+    }
+
+    EN_closeH(ph);
+    return errcode;
+}
+
+
+static int benchquality(EN_Project ph, int nreps, Stats *stats)
+/*
+**  Times transport and reactpipes (stats[0..1]) -- a first order decay
+**  of a chemical is analyzed if the network has no quality model
+*/
+{
+    Project *pr = (Project *)ph;
+    int i, k, qualtype, tracenode, nlinks, nnodes, errcode = 0;
+    long t, qstep;
+    double kb, t0;
+
+    EN_getqualtype(ph, &qualtype, &tracenode);
+    if (qualtype == EN_NONE)
+    {
+        EN_setqualtype(ph, EN_CHEM, "Chlorine", "mg/L", "");
+        EN_getcount(ph, EN_LINKCOUNT, &nlinks);
+        EN_getcount(ph, EN_NODECOUNT, &nnodes);
+        for (k = 1; k <= nlinks; k++)
+        {
+            EN_getlinkvalue(ph, k, EN_KBULK, &kb);
+            if (kb == 0.0) EN_setlinkvalue(ph, k, EN_KBULK, -0.5);
+        }
+        for (k = 1; k <= nnodes; k++) EN_setnodevalue(ph, k, EN_INITQUAL, 1.0);
+    }
+
+    ERRCODE(EN_solveH(ph));
+    if (errcode > 100) return errcode;
+    errcode = 0;
+    ERRCODE(EN_openQ(ph));
+    ERRCODE(EN_initQ(ph, EN_NOSAVE));
+    ERRCODE(EN_runQ(ph, &t));
+    if (errcode > 100) return errcode;
+    errcode = 0;
+
+    qstep = pr->times.Qstep;
+    for (i = 0; i < nreps; i++)
+    {
+        t0 = profclock();
+        transport(pr, qstep);
+        statsadd(&stats[0], profclock() - t0);
+    }
+    for (i = 0; i < nreps; i++)
+    {
+        t0 = profclock();
+        reactpipes(pr, qstep);
+        statsadd(&stats[1], profclock() - t0);
+    }
+
+    EN_closeQ(ph);
+    return errcode;
+}
+
+
+#ifdef WITH_MSX
+static int benchmsx(const char *inpfile, const char *msxfile, int nreps,
+                    Stats *stats)
+/*
+**  Times EPANET-MSX transport and reactions (stats[0..1]) using the
+**  per phase profiling of EPANET-MSX
+*/
+{
+    int i, calls, errcode = 0;
+    double t, tleft, seconds;
+    char rptfile[MAXFNAME + 1];
+
+    getTmpName(rptfile);
+    errcode = ENopen(inpfile, rptfile, "");
+    if (errcode > 100) return errcode;
+    errcode = MSXopen((char *)msxfile);
+    if (!errcode) errcode = MSXsolveH();
+
+    for (i = 0; i < nreps && !errcode; i++)
+    {
+        MSXsetprofiling(1);
+        errcode = MSXinit(0);
+        tleft = 1.0;
+        while (!errcode && tleft > 0.0) errcode = MSXstep(&t, &tleft);
+        MSXgetprofile(MSX_PROF_TRANSPORT, &seconds, &calls);
+        if (calls > 0) statsadd(&stats[0], seconds / calls);
+        MSXgetprofile(MSX_PROF_REACT, &seconds, &calls);
+        if (calls > 0) statsadd(&stats[1], seconds / calls);
+    }
+    MSXsetprofiling(0);
+
+    MSXclose();
+    ENclose();
+    remove(rptfile);
+    return errcode;
+}
+#endif
+
+
+static int benchnetwork(FILE *f, const char *inpfile, int nreps, int last)
+{
+    EN_Project ph = NULL;
+    Stats stats[8];
+    int nnodes = 0, nlinks = 0, errcode, i, nstats = 6;
+    char rptfile[MAXFNAME + 1];
+#ifdef WITH_MSX
+    char msxfile[MAXFNAME + 1];
+    FILE *msx;
+#endif
+
+    statsinit(&stats[0], "createsparse");
+    statsinit(&stats[1], "coeffs");
+    statsinit(&stats[2], "linsolve");
+    statsinit(&stats[3], "hydsolve");
+    statsinit(&stats[4], "transport");
+    statsinit(&stats[5], "reactpipes");
+    statsinit(&stats[6], "msx_transport");
+    statsinit(&stats[7], "msx_react");
+
+    // Reports (e.g. warnings) are written to a temporary file
+    // so that they do not interfere with the results
+    getTmpName(rptfile);
+    EN_createproject(&ph);
+    errcode = EN_open(ph, inpfile, rptfile, "");
+    if (errcode <= 100)
+    {
+        EN_getcount(ph, EN_NODECOUNT, &nnodes);
+        EN_getcount(ph, EN_LINKCOUNT, &nlinks);
+        errcode = benchhydraulics(ph, nreps, &stats[0]);
+        if (errcode <= 100) errcode = benchquality(ph, nreps, &stats[4]);
+    }
+    EN_deleteproject(ph);
+    remove(rptfile);
+
+#ifdef WITH_MSX
+    strncpy(msxfile, inpfile, MAXFNAME - 4);
+    msxfile[MAXFNAME - 4] = '\0';
+    if (strlen(msxfile) > 4) strcpy(msxfile + strlen(msxfile) - 4, ".msx");
+    if (errcode <= 100 && (msx = fopen(msxfile, "r")) != NULL)
+    {
+        fclose(msx);
+        nstats = 8;
+        errcode = benchmsx(inpfile, msxfile, nreps, &stats[6]);
+    }
+#endif
+
+    fprintf(f, "    {\n      \"file\": ");
+    writestring(f, inpfile);
+    fprintf(f, ",\n      \"nodes\": %d,\n      \"links\": %d,\n", nnodes, nlinks);
+    fprintf(f, "      \"error\": %d,\n      \"kernels\": {\n", errcode > 100 ? errcode : 0);
+    for (i = 0; i < nstats; i++) writestats(f, &stats[i], i == nstats - 1);
+    fprintf(f, "      }\n    }%s\n", last ? "" : ",");
+
+    if (errcode > 100) fprintf(stderr, "%s: error %d\n", inpfile, errcode);
+    return errcode;
+}
+
+
+static int cmpnames(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+
+static int listnetworks(const char *path, char **files)
+/*
+**  Collects the .inp file(s) given by path (a file or a directory)
+*/
+{
+    int n = 0;
+    size_t len;
+
+#ifndef _WIN32
+    DIR *dir;
+    struct dirent *entry;
+
+    dir = opendir(path);
+    if (dir != NULL)
+    {
+        while ((entry = readdir(dir)) != NULL && n < MAXFILES)
+        {
+            len = strlen(entry->d_name);
+            if (len < 4 || strcmp(entry->d_name + len - 4, ".inp") != 0) continue;
+            files[n] = (char *)malloc(strlen(path) + len + 2);
+            sprintf(files[n], "%s/%s", path, entry->d_name);
+            n++;
+        }
+        closedir(dir);
+        qsort(files, n, sizeof(char *), cmpnames);
+        return n;
+    }
+#endif
+    len = strlen(path);
+    files[0] = (char *)malloc(len + 1);
+    strcpy(files[0], path);
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    char *files[MAXFILES];
+    const char *path = NULL, *outfile = NULL;
+    int i, n, nreps = 100, errors = 0;
+    FILE *f = stdout;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) nreps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) outfile = argv[++i];
+        else path = argv[i];
+    }
+    if (path == NULL || nreps <= 0)
+    {
+        fprintf(stderr, "Usage: %s <.inp file or directory> [-n repetitions] "
+                        "[-o results.json]\n", argv[0]);
+        return 1;
+    }
+    if (outfile != NULL && (f = fopen(outfile, "w")) == NULL)
+    {
+        fprintf(stderr, "Can not open %s\n", outfile);
+        return 1;
+    }
+
+    n = listnetworks(path, files);
+    fprintf(f, "{\n  \"timestamp\": %ld,\n", (long)time(NULL));
+    writehardware(f);
+    fprintf(f, "  \"repetitions\": %d,\n  \"time_unit\": \"s\",\n  \"networks\": [\n", nreps);
+    for (i = 0; i < n; i++)
+    {
+        if (benchnetwork(f, files[i], nreps, i == n - 1) > 100) errors++;
+        free(files[i]);
+    }
+    fprintf(f, "  ]\n}\n");
+
+    if (f != stdout) fclose(f);
+    return errors > 0 ? 2 : 0;
+}
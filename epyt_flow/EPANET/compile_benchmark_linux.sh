@@ -0,0 +1,11 @@
+#!/bin/bash
+# Builds the micro-benchmark of the EPANET (and EPANET-MSX) kernels -- compiler flags
+# can be overridden by setting CFLAGS, e.g. CFLAGS="-O2" bash compile_benchmark_linux.sh
+mkdir -p "../customlibs/"
+CFLAGS="${CFLAGS:--O3 -march=native}"
+SOURCES=$(ls EPANET/SRC_engines/*.c | grep -v "/main.c$")
+MSX_FLAGS=""
+if [ -f "../customlibs/libepanetmsx2_2_0.so" ]; then
+    MSX_FLAGS="-DWITH_MSX -IEPANET-MSX/Src/include ../customlibs/libepanetmsx2_2_0.so -Wl,-rpath,\$ORIGIN"
+fi
+gcc -w $CFLAGS -DBENCH_CFLAGS="\"$CFLAGS\"" -o "../customlibs/enbench" benchmark/enbench.c $SOURCES -IEPANET/SRC_engines -IEPANET/SRC_engines/include $MSX_FLAGS -lm -pthread
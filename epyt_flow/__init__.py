@@ -17,7 +17,11 @@ def compile_libraries_unix(lib_epanet_name: str, compile_script_name: str,
 
     update = False
     if os.path.isfile(path_to_lib_epanet):
-        if os.path.getmtime(__file__) > os.path.getmtime(path_to_lib_epanet):
+        sources_mtime = max(os.path.getmtime(os.path.join(root, f_name))
+                            for root, _, files in os.walk(path_to_epanet)
+                            for f_name in files if f_name.endswith((".c", ".h", ".sh")))
+        if max(os.path.getmtime(__file__), sources_mtime) > \
+                os.path.getmtime(path_to_lib_epanet):
             update = True
 
     if not os.path.isfile(path_to_lib_epanet) or update:
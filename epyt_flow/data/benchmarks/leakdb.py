@@ -31,6 +31,7 @@ from ...utils import get_temp_folder, to_seconds, unpack_zip_archive, create_pat
     download_if_necessary
 from ...metrics import f1_score, true_positive_rate, true_negative_rate
 from ...simulation import ScenarioSimulator
+from ...simulation.demand_synthesis import synthesize_leakdb_demands
 from ...simulation.events import AbruptLeakage, IncipientLeakage
 from ...simulation import ScenarioConfig
 from ...simulation.scada import ScadaData
@@ -431,61 +432,6 @@ def load_scenarios(scenarios_id: list[int], use_net1: bool = True,
                       "reporting_time_step": hydraulic_time_step} | network_config.general_params
 
     # Add demand patterns
-    def gen_dem(download_dir, use_net1):
-        # Taken from https://github.com/KIOS-Research/LeakDB/blob/master/CCWI-WDSA2018/Dataset_Generator_Py3/demandGenerator.py
-        week_pat = scipy.io.loadmat(os.path.join(download_dir, "weekPat_30min.mat"))
-        a_w = week_pat['Aw']
-        nw = week_pat['nw']
-        year_offset = scipy.io.loadmat(os.path.join(download_dir, "yearOffset_30min.mat"))
-        a_y = year_offset['Ay']
-        ny = year_offset['ny']
-
-        # Create yearly component
-        days = 365
-
-        t = (288/6)*days    # one year period in five minute intervals
-        w = 2*np.pi/t
-        k = np.arange(1, days*288/6+1, 1)   # number of time steps in time series
-        n = ny[0][0]    # number of fourier coefficients
-        h_y = [1]*len(k)
-
-        for i in range(1, n+1):
-            h_y = np.column_stack((h_y, np.sin(i*w*k), np.cos(i*w*k)))
-
-        unc_y = 0.1
-        a_y_r = a_y*(1-unc_y + 2*unc_y*np.random.rand(int(a_y.shape[0]), int(a_y.shape[1])))
-        year_offset = np.dot(h_y, a_y_r)
-
-        # Create weekly component
-        t = (288/6)*7   # one week period in five minute intervals
-        w = 2*np.pi/t
-        k = np.arange(1, days*288/6+1, 1)   # number of time steps in time series
-        n = nw[0][0]    # number of fourier coefficients
-        h_w = [1]*len(k)
-        for i in range(1, n+1):
-            h_w = np.column_stack((h_w, np.sin(i*w*k), np.cos(i*w*k)))
-
-        unc_w = 0.1
-        a_w_r = a_w*(1-unc_w + 2*unc_w*np.random.rand(int(a_w.shape[0]), int(a_w.shape[1])))
-        week_year_pat = np.dot(h_w, a_w_r)
-
-        # Create random component
-        unc_r = 0.05
-        random = np.random.normal(0, (-unc_r+2*unc_r),
-                                  (int(week_year_pat.shape[0]), int(week_year_pat.shape[1])))
-
-        # Create demand
-        base = 1
-        variation = 0.75 + np.random.normal(0, 0.07)  # from 0 to 1
-        dem = base * (year_offset+1) * (week_year_pat*variation+1) * (random+1)
-
-        dem = dem.tolist()
-        dem_final = []
-        for d in dem:
-            dem_final.append(d[0])
-
-        return dem_final
-
     week_pattern_url = "https://github.com/KIOS-Research/LeakDB/raw/master/CCWI-WDSA2018/" +\
         "Dataset_Generator_Py3/weekPat_30min.mat"
     year_offset_url = "https://github.com/KIOS-Research/LeakDB/raw/master/CCWI-WDSA2018/" +\
@@ -496,6 +442,9 @@ def load_scenarios(scenarios_id: list[int], use_net1: bool = True,
     download_if_necessary(os.path.join(download_dir, "yearOffset_30min.mat"),
                           year_offset_url, verbose)
 
+    week_pat = scipy.io.loadmat(os.path.join(download_dir, "weekPat_30min.mat"))
+    year_offset = scipy.io.loadmat(os.path.join(download_dir, "yearOffset_30min.mat"))
+
     for s_id in scenarios_id:   # Create new .inp files with demands if necessary
         f_inp_in = os.path.join(download_dir,
                                 f"{'Net1' if use_net1 is True else 'Hanoi'}_LeakDB_ID={s_id}.inp")
@@ -510,20 +459,20 @@ def load_scenarios(scenarios_id: list[int], use_net1: bool = True,
 
                 wdn.epanet_api.deletePatternsAll()
 
+                # Demand patterns of all junctions are synthesized at once -- taken from
+                # https://github.com/KIOS-Research/LeakDB/blob/master/CCWI-WDSA2018/Dataset_Generator_Py3/demandGenerator.py
                 reservoir_nodes_id = wdn.epanet_api.getNodeReservoirNameID()
-                for node_id in network_config.sensor_config.nodes:
-                    if node_id in network_config.sensor_config.tanks or\
-                            node_id in reservoir_nodes_id:
-                        continue
-
-                    node_idx = wdn.epanet_api.getNodeIndex(node_id)
-                    base_demand = wdn.epanet_api.getNodeBaseDemands(node_idx)[1][0]
-
-                    my_demand_pattern = np.array(gen_dem(download_dir, use_net1))
-
-                    wdn.set_node_demand_pattern(node_id=node_id, base_demand=base_demand,
-                                                demand_pattern_id=f"demand_{node_id}",
-                                                demand_pattern=my_demand_pattern)
+                nodes_id = [node_id for node_id in network_config.sensor_config.nodes
+                            if node_id not in network_config.sensor_config.tanks and
+                            node_id not in reservoir_nodes_id]
+                base_demands = np.array([wdn.epanet_api.getNodeBaseDemands(
+                    wdn.epanet_api.getNodeIndex(node_id))[1][0] for node_id in nodes_id])
+
+                demand_patterns = synthesize_leakdb_demands(len(nodes_id), week_pat["Aw"],
+                                                            year_offset["Ay"], seed=s_id)
+                wdn.set_node_demand_patterns(nodes_id, base_demands,
+                                             [f"demand_{node_id}" for node_id in nodes_id],
+                                             demand_patterns)
 
                 wdn.epanet_api.saveInputFile(f_inp_in)
 
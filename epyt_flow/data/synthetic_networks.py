@@ -0,0 +1,456 @@
+"""
+Module provides functions for generating synthetic water distribution networks of
+(almost) arbitrary size -- e.g. for benchmarking and performance regression tests
+without having to download any network.
+
+The generated networks are fully determined by their parameters and the seed, i.e.
+generating a network twice results in identical .inp (and .msx) files.
+"""
+import os
+import hashlib
+import numpy as np
+
+from ..simulation import ScenarioConfig
+from ..utils import get_temp_folder
+from .networks import load_inp
+
+
+SYNTHETIC_TOPOLOGIES = ["tree", "ring", "grid", "hybrid"]
+
+_GRID_SPACING = 100.            # Distance (m) between neighboring junctions
+_MEAN_BASE_DEMAND = .05         # Mean base demand (LPS) of a junction
+_DESIGN_VELOCITY = .8           # Velocity (m/s) used for sizing the pipes
+_TANK_HEIGHT = 25.              # Max. water level (m) of the tanks
+_SUPPLY_HEAD = 40.              # Head (m) above the highest junction provided by the sources
+_FILE_VERSION = 2               # Revision of the written files (invalidates cached files)
+
+
+def _write_rows(f, row_format: str, columns: list[np.ndarray], chunk_size: int = 100000) -> None:
+    n_rows = len(columns[0])
+    for start in range(0, n_rows, chunk_size):
+        rows = zip(*(c[start:start + chunk_size].tolist() for c in columns))
+        f.write("".join(row_format.format(*row) for row in rows))
+
+
+def _create_patterns(rng: np.random.Generator, n_patterns: int) -> np.ndarray:
+    t = np.arange(24)
+    phase = rng.uniform(-2, 2, size=(n_patterns, 1))
+    amplitude = rng.uniform(.3, .6, size=(n_patterns, 1))
+    patterns = 1. + amplitude * np.sin(2. * np.pi * (t - 9. - phase) / 24.) + \
+        .5 * amplitude * np.sin(4. * np.pi * (t - 7. - phase) / 24.) + \
+        rng.normal(0, .05, size=(n_patterns, 24))
+    patterns = np.clip(patterns, .1, None)
+
+    return patterns / patterns.mean(axis=1, keepdims=True)
+
+
+def write_synthetic_network(f_inp_out: str, n_nodes: int, topology: str = "hybrid",
+                            loop_density: float = .1, n_reservoirs: int = 1, n_tanks: int = 1,
+                            n_pumps: int = 1, n_prvs: int = 0, n_patterns: int = 4,
+                            include_rules: bool = True, simulation_duration: int = 24,
+                            f_msx_out: str = None, seed: int = 42) -> None:
+    """
+    Generates a synthetic water distribution network and writes it to an .inp file
+    (and optionally an .msx file).
+
+    The junctions are placed on a (square) grid. All junctions are connected by a spanning
+    tree (i.e. a branched network) consisting of the rows of the grid and a trunk main
+    along the first column -- the pipes of the spanning tree are sized according to the
+    demand they have to convey. Depending on the topology, additional pipes are added:
+
+        - "tree": No additional pipes -- i.e. a purely branched network.
+        - "ring": A ring main along the last column of the grid.
+        - "grid": All remaining pipes of the grid -- i.e. a fully looped network.
+        - "hybrid": A ring main and a fraction ('loop_density') of the remaining pipes of
+          the grid, selected at random.
+
+    The reservoirs are connected to junctions evenly spread over the network -- the first
+    'n_pumps' reservoirs are connected by a pump, all others by a pipe. Any remaining pumps
+    are booster pumps that replace randomly selected pipes of the spanning tree, as do the PRVs.
+    Tanks are connected by a pipe to junctions evenly spread over the network. If requested,
+    each pump connected to a reservoir is switched on and off by two rules, depending on the
+    water level in one of the tanks.
+
+    The .inp file is written in chunks, memory consumption grows linearly with the number of
+    junctions -- networks with up to 10^7 junctions can be generated on common hardware.
+    Note that the networks are not designed to be hydraulically realistic but to be solvable
+    (by a pressure-driven analysis) for all sizes -- the .inp file selects a pressure-driven
+    analysis with the same parameters as
+    :func:`~epyt_flow.data.networks.get_default_hydraulic_options`.
+
+    Parameters
+    ----------
+    f_inp_out : `str`
+        Path to the .inp file.
+    n_nodes : `int`
+        Number of junctions.
+    topology : `str`, optional
+        Topology of the network -- must be one of the following:
+        "tree", "ring", "grid", or "hybrid".
+
+        The default is "hybrid".
+    loop_density : `float`, optional
+        Fraction (in [0, 1]) of the remaining pipes of the grid that are added to
+        a "hybrid" network -- ignored for all other topologies.
+
+        The default is 0.1
+    n_reservoirs : `int`, optional
+        Number of reservoirs.
+
+        The default is 1.
+    n_tanks : `int`, optional
+        Number of tanks.
+
+        The default is 1.
+    n_pumps : `int`, optional
+        Number of pumps.
+
+        The default is 1.
+    n_prvs : `int`, optional
+        Number of pressure reducing valves.
+
+        The default is 0.
+    n_patterns : `int`, optional
+        Number of (hourly) demand patterns -- each junction is assigned one of those
+        at random.
+
+        The default is 4.
+    include_rules : `bool`, optional
+        If True, rules switching the pumps on and off, depending on the water level
+        in the tanks, are added.
+
+        The default is True.
+    simulation_duration : `int`, optional
+        Simulation duration in hours.
+
+        The default is 24.
+    f_msx_out : `str`, optional
+        Path to an .msx file -- if not None, an .msx file specifying a chlorine decay
+        (with chlorine being injected at all reservoirs) is written as well.
+
+        The default is None.
+    seed : `int`, optional
+        Seed of the random number generator.
+
+        The default is 42.
+    """
+    if not isinstance(f_inp_out, str):
+        raise TypeError("'f_inp_out' must be an instance of 'str' but not of " +
+                        f"'{type(f_inp_out)}'")
+    if not isinstance(n_nodes, int):
+        raise TypeError(f"'n_nodes' must be an instance of 'int' but not of '{type(n_nodes)}'")
+    if n_nodes < 2:
+        raise ValueError("'n_nodes' must be at least 2")
+    if topology not in SYNTHETIC_TOPOLOGIES:
+        raise ValueError(f"'topology' must be one of the following: {SYNTHETIC_TOPOLOGIES}")
+    if not isinstance(loop_density, (float, int)) or not 0 <= loop_density <= 1:
+        raise ValueError("'loop_density' must be in [0, 1]")
+    for param_name, param, min_value in [("n_reservoirs", n_reservoirs, 1),
+                                         ("n_tanks", n_tanks, 0), ("n_pumps", n_pumps, 0),
+                                         ("n_prvs", n_prvs, 0), ("n_patterns", n_patterns, 1),
+                                         ("simulation_duration", simulation_duration, 1)]:
+        if not isinstance(param, int):
+            raise TypeError(f"'{param_name}' must be an instance of 'int' but not of " +
+                            f"'{type(param)}'")
+        if param < min_value:
+            raise ValueError(f"'{param_name}' must be at least {min_value}")
+    if not isinstance(include_rules, bool):
+        raise TypeError("'include_rules' must be an instance of 'bool' but not of " +
+                        f"'{type(include_rules)}'")
+    if f_msx_out is not None and not isinstance(f_msx_out, str):
+        raise TypeError("'f_msx_out' must be an instance of 'str' but not of " +
+                        f"'{type(f_msx_out)}'")
+    if not isinstance(seed, int):
+        raise TypeError(f"'seed' must be an instance of 'int' but not of '{type(seed)}'")
+
+    rng = np.random.default_rng(seed)
+
+    # Junctions
+    n = n_nodes
+    width = int(np.ceil(np.sqrt(n)))
+    nodes_idx = np.arange(n, dtype=np.int64)
+    nodes_col = nodes_idx % width
+    nodes_row = nodes_idx // width
+    nodes_x = nodes_col * _GRID_SPACING
+    nodes_y = nodes_row * _GRID_SPACING
+
+    extent = width * _GRID_SPACING
+    elevation = 20. + 10. * np.sin(2. * np.pi * nodes_x / extent) * \
+        np.cos(2. * np.pi * nodes_y / extent) + 10. * nodes_y / extent + \
+        rng.normal(0, 1., size=n)
+    elevation = np.clip(elevation, 0, None)
+    base_demand = rng.lognormal(np.log(_MEAN_BASE_DEMAND), .5, size=n)
+    demand_pattern = rng.integers(0, n_patterns, size=n)
+    patterns = _create_patterns(rng, n_patterns)
+
+    # Spanning tree: rows of the grid + trunk main along the first column.
+    # Edges are oriented from the upstream to the downstream junction.
+    row_length = np.minimum(width, n - nodes_row * width)
+    horizontal = nodes_idx[(nodes_col < width - 1) & (nodes_idx + 1 < n)]
+    trunk = nodes_idx[(nodes_col == 0) & (nodes_idx + width < n)]
+    tree_from = np.concatenate((horizontal, trunk))
+    tree_to = np.concatenate((horizontal + 1, trunk + width))
+    n_downstream = np.concatenate((row_length[horizontal] - nodes_col[horizontal] - 1,
+                                   n - trunk - width)) + 1
+
+    flow = n_downstream * _MEAN_BASE_DEMAND * 1e-3
+    tree_diameter = 1000. * np.sqrt(4. * flow / (np.pi * _DESIGN_VELOCITY))
+    tree_diameter = np.clip(np.ceil(tree_diameter / 50.) * 50., 100., None)
+
+    # Additional (loop) pipes
+    vertical = nodes_idx[(nodes_col > 0) & (nodes_idx + width < n)]
+    if topology == "tree":
+        loops = vertical[:0]
+    elif topology == "ring":
+        loops = vertical[nodes_col[vertical] == width - 1]
+    elif topology == "grid":
+        loops = vertical
+    else:
+        is_ring = nodes_col[vertical] == width - 1
+        loops = vertical[is_ring | (rng.random(len(vertical)) < loop_density)]
+    loops_diameter = rng.choice([100., 150.], size=len(loops))
+
+    # Booster pumps and PRVs replace pipes of the spanning tree
+    n_source_pumps = min(n_pumps, n_reservoirs)
+    n_booster_pumps = n_pumps - n_source_pumps
+    if n_booster_pumps + n_prvs > len(horizontal):
+        raise ValueError("Too many booster pumps and PRVs for the given number of junctions")
+    replaced = rng.choice(len(horizontal), size=n_booster_pumps + n_prvs, replace=False)
+    boosters, prvs = replaced[:n_booster_pumps], replaced[n_booster_pumps:]
+    is_pipe = np.ones(len(tree_from), dtype=bool)
+    is_pipe[replaced] = False
+
+    pipes_from = np.concatenate((tree_from[is_pipe], loops))
+    pipes_to = np.concatenate((tree_to[is_pipe], loops + width))
+    pipes_diameter = np.concatenate((tree_diameter[is_pipe], loops_diameter))
+    n_pipes = len(pipes_from)
+    pipes_length = rng.uniform(.8, 1.2, size=n_pipes) * _GRID_SPACING
+    pipes_roughness = rng.uniform(90., 140., size=n_pipes).round()
+
+    # Reservoirs and tanks
+    max_elevation = float(elevation.max())
+    total_demand = float(base_demand.sum())
+    reservoirs_junction = (np.arange(n_reservoirs) * n) // n_reservoirs
+    reservoirs_head = np.where(np.arange(n_reservoirs) < n_source_pumps,
+                               elevation[reservoirs_junction],
+                               max_elevation + _SUPPLY_HEAD)
+    tanks_junction = ((np.arange(n_tanks) + .5) * n / n_tanks).astype(np.int64)
+    tank_elevation = max_elevation + _SUPPLY_HEAD - .8 * _TANK_HEIGHT
+
+    # Write .inp file
+    with open(f_inp_out, "w", encoding="utf-8") as f:
+        f.write("[TITLE]\n")
+        f.write(f"Synthetic network: {n} junctions, topology '{topology}', seed {seed}\n\n")
+
+        f.write("[JUNCTIONS]\n;ID\tElev\tDemand\tPattern\n")
+        _write_rows(f, " J{0}\t{1:.2f}\t{2:.4f}\tPAT{3}\n",
+                    [nodes_idx, elevation, base_demand, demand_pattern])
+
+        f.write("\n[RESERVOIRS]\n;ID\tHead\tPattern\n")
+        for k in range(n_reservoirs):
+            f.write(f" R{k}\t{reservoirs_head[k]:.2f}\t\n")
+
+        f.write("\n[TANKS]\n;ID\tElevation\tInitLevel\tMinLevel\tMaxLevel\tDiameter\tMinVol\n")
+        for k in range(n_tanks):
+            f.write(f" T{k}\t{tank_elevation:.2f}\t{.6 * _TANK_HEIGHT:.1f}\t1\t" +
+                    f"{_TANK_HEIGHT:.1f}\t20\t0\n")
+
+        f.write("\n[PIPES]\n;ID\tNode1\tNode2\tLength\tDiameter\tRoughness\tMinorLoss\tStatus\n")
+        _write_rows(f, " P{0}\tJ{1}\tJ{2}\t{3:.1f}\t{4:.0f}\t{5:.0f}\t0\tOpen\n",
+                    [np.arange(n_pipes), pipes_from, pipes_to, pipes_length, pipes_diameter,
+                     pipes_roughness])
+        for k in range(n_source_pumps, n_reservoirs):
+            f.write(f" PR{k}\tR{k}\tJ{reservoirs_junction[k]}\t50\t" +
+                    f"{max(tree_diameter.max(), 300.):.0f}\t130\t0\tOpen\n")
+        for k in range(n_tanks):
+            f.write(f" PT{k}\tT{k}\tJ{tanks_junction[k]}\t50\t300\t130\t0\tOpen\n")
+
+        f.write("\n[PUMPS]\n;ID\tNode1\tNode2\tParameters\n")
+        for k in range(n_source_pumps):
+            f.write(f" PU{k}\tR{k}\tJ{reservoirs_junction[k]}\tHEAD PC{k}\t;\n")
+        for k, i in enumerate(boosters, start=n_source_pumps):
+            f.write(f" PU{k}\tJ{tree_from[i]}\tJ{tree_to[i]}\tHEAD PC{k}\t;\n")
+
+        f.write("\n[VALVES]\n;ID\tNode1\tNode2\tDiameter\tType\tSetting\tMinorLoss\n")
+        for k, i in enumerate(prvs):
+            f.write(f" V{k}\tJ{tree_from[i]}\tJ{tree_to[i]}\t{tree_diameter[i]:.0f}\tPRV\t" +
+                    f"{rng.uniform(30., 50.):.1f}\t0\n")
+
+        f.write("\n[PATTERNS]\n;ID\tMultipliers\n")
+        for k in range(n_patterns):
+            for j in range(0, 24, 6):
+                f.write(f" PAT{k}\t" + "\t".join(f"{m:.4f}" for m in patterns[k, j:j+6]) + "\n")
+
+        # Single-point head curves -- EPANET shuts a pump off at twice its design flow
+        f.write("\n[CURVES]\n;ID\tX-Value\tY-Value\n")
+        for k in range(n_source_pumps):
+            design_flow = 1.2 * total_demand / n_reservoirs
+            design_head = max_elevation + _SUPPLY_HEAD - reservoirs_head[k]
+            f.write(f";PUMP: \n PC{k}\t{design_flow:.2f}\t{design_head:.2f}\n")
+        for k, i in enumerate(boosters, start=n_source_pumps):
+            design_flow = 1.2 * n_downstream[i] * _MEAN_BASE_DEMAND
+            f.write(f";PUMP: \n PC{k}\t{design_flow:.2f}\t10.00\n")
+
+        f.write("\n[RULES]\n")
+        if include_rules is True and n_tanks != 0:
+            for k in range(n_source_pumps):
+                tank_id = f"T{k % n_tanks}"
+                f.write(f"RULE PUMP{k}_OFF\nIF TANK {tank_id} LEVEL ABOVE " +
+                        f"{.9 * _TANK_HEIGHT:.1f}\nTHEN PUMP PU{k} STATUS IS CLOSED\n\n")
+                f.write(f"RULE PUMP{k}_ON\nIF TANK {tank_id} LEVEL BELOW " +
+                        f"{.3 * _TANK_HEIGHT:.1f}\nTHEN PUMP PU{k} STATUS IS OPEN\n\n")
+
+        f.write("\n[REACTIONS]\n Order Bulk 1\n Order Wall 1\n Global Bulk -0.5\n" +
+                " Global Wall 0\n")
+
+        f.write("\n[TIMES]\n")
+        f.write(f" Duration {simulation_duration}:00\n Hydraulic Timestep 1:00\n" +
+                " Quality Timestep 0:05\n Pattern Timestep 1:00\n Pattern Start 0:00\n" +
+                " Report Timestep 1:00\n Report Start 0:00\n Start ClockTime 12 am\n" +
+                " Statistic None\n")
+
+        f.write("\n[REPORT]\n Status No\n Summary No\n")
+
+        f.write("\n[OPTIONS]\n Units LPS\n Headloss H-W\n Specific Gravity 1.0\n" +
+                " Viscosity 1.0\n Trials 200\n Accuracy 0.001\n Unbalanced Continue 10\n" +
+                " Pattern PAT0\n Demand Multiplier 1.0\n Emitter Exponent 0.5\n" +
+                " Demand Model PDA\n Minimum Pressure 0\n Required Pressure 0.1\n" +
+                " Pressure Exponent 0.5\n" +
+                " Quality None mg/L\n Diffusivity 1.0\n Tolerance 0.01\n")
+
+        f.write("\n[COORDINATES]\n;Node\tX-Coord\tY-Coord\n")
+        _write_rows(f, " J{0}\t{1:.2f}\t{2:.2f}\n", [nodes_idx, nodes_x, nodes_y])
+        for k in range(n_reservoirs):
+            i = reservoirs_junction[k]
+            f.write(f" R{k}\t{nodes_x[i] - .5 * _GRID_SPACING:.2f}\t" +
+                    f"{nodes_y[i] - .5 * _GRID_SPACING:.2f}\n")
+        for k in range(n_tanks):
+            i = tanks_junction[k]
+            f.write(f" T{k}\t{nodes_x[i] + .5 * _GRID_SPACING:.2f}\t" +
+                    f"{nodes_y[i] + .5 * _GRID_SPACING:.2f}\n")
+
+        f.write("\n[END]\n")
+
+    # Write .msx file
+    if f_msx_out is not None:
+        with open(f_msx_out, "w", encoding="utf-8") as f:
+            f.write("[TITLE]\nChlorine decay\n\n")
+            f.write("[OPTIONS]\n AREA_UNITS M2\n RATE_UNITS HR\n SOLVER EUL\n" +
+                    " TIMESTEP 300\n\n")
+            f.write("[SPECIES]\n BULK CL2 MG\n\n")
+            f.write("[COEFFICIENTS]\n PARAMETER Kb 0.3\n\n")
+            f.write("[PIPES]\n RATE CL2 -Kb*CL2\n\n")
+            f.write("[TANKS]\n RATE CL2 -Kb*CL2\n\n")
+            f.write("[QUALITY]\n")
+            for k in range(n_reservoirs):
+                f.write(f" NODE R{k} CL2 1.0\n")
+            f.write("\n[REPORT]\n SPECIES CL2 YES\n")
+
+
+def load_synthetic_network(n_nodes: int, topology: str = "hybrid", loop_density: float = .1,
+                           n_reservoirs: int = 1, n_tanks: int = 1, n_pumps: int = 1,
+                           n_prvs: int = 0, n_patterns: int = 4, include_rules: bool = True,
+                           simulation_duration: int = 24, include_msx: bool = False,
+                           seed: int = 42, download_dir: str = get_temp_folder(),
+                           include_empty_sensor_config: bool = True,
+                           flow_units_id: int = None) -> ScenarioConfig:
+    """
+    Loads (and generates if necessary) a synthetic water distribution network --
+    see :func:`~epyt_flow.data.synthetic_networks.write_synthetic_network` for details.
+
+    Generated networks are cached in 'download_dir' -- i.e. a network is only generated
+    if there is no .inp file for the given parameters.
+
+    Parameters
+    ----------
+    n_nodes : `int`
+        Number of junctions.
+    topology : `str`, optional
+        Topology of the network -- must be one of the following:
+        "tree", "ring", "grid", or "hybrid".
+
+        The default is "hybrid".
+    loop_density : `float`, optional
+        Fraction (in [0, 1]) of the remaining pipes of the grid that are added to
+        a "hybrid" network -- ignored for all other topologies.
+
+        The default is 0.1
+    n_reservoirs : `int`, optional
+        Number of reservoirs.
+
+        The default is 1.
+    n_tanks : `int`, optional
+        Number of tanks.
+
+        The default is 1.
+    n_pumps : `int`, optional
+        Number of pumps.
+
+        The default is 1.
+    n_prvs : `int`, optional
+        Number of pressure reducing valves.
+
+        The default is 0.
+    n_patterns : `int`, optional
+        Number of (hourly) demand patterns.
+
+        The default is 4.
+    include_rules : `bool`, optional
+        If True, rules switching the pumps on and off are added.
+
+        The default is True.
+    simulation_duration : `int`, optional
+        Simulation duration in hours.
+
+        The default is 24.
+    include_msx : `bool`, optional
+        If True, an .msx file specifying a chlorine decay is generated and
+        included in the returned scenario configuration.
+
+        The default is False.
+    seed : `int`, optional
+        Seed of the random number generator.
+
+        The default is 42.
+    download_dir : `str`, optional
+        Path to the directory where the .inp (and .msx) file is stored.
+
+        The default is the OS-specific temporary directory (e.g. "C:\\\\temp", "/tmp/", etc.)
+    include_empty_sensor_config : `bool`, optional
+        If True, an empty sensor configuration is included -- note that this requires
+        loading the network into EPANET, which might take a while for very large networks.
+
+        The default is True.
+    flow_units_id : `int`, optional
+        Specifies the flow units to be used in this scenario.
+        If None, the units from the .inp file (i.e. LPS) will be used.
+
+        The default is None.
+
+    Returns
+    -------
+    :class:`~epyt_flow.simulation.scenario_config.ScenarioConfig`
+        Synthetic network loaded into a scenario configuration that can be passed on to
+        :class:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator`.
+    """
+    params = (n_nodes, topology, float(loop_density), n_reservoirs, n_tanks, n_pumps, n_prvs,
+              n_patterns, include_rules, simulation_duration, seed, _FILE_VERSION)
+    digest = hashlib.sha1(repr(params).encode()).hexdigest()[:10]
+    f_name = os.path.join(download_dir, f"synthetic_{topology}_{n_nodes}_{digest}")
+    f_inp = f_name + ".inp"
+    f_msx = f_name + ".msx" if include_msx is True else None
+
+    if not os.path.isfile(f_inp) or (f_msx is not None and not os.path.isfile(f_msx)):
+        os.makedirs(download_dir, exist_ok=True)
+        write_synthetic_network(f_inp, n_nodes, topology=topology, loop_density=loop_density,
+                                n_reservoirs=n_reservoirs, n_tanks=n_tanks, n_pumps=n_pumps,
+                                n_prvs=n_prvs, n_patterns=n_patterns, include_rules=include_rules,
+                                simulation_duration=simulation_duration, f_msx_out=f_msx,
+                                seed=seed)
+
+    config = load_inp(f_inp, include_empty_sensor_config=include_empty_sensor_config,
+                      flow_units_id=flow_units_id)
+    if f_msx is not None:
+        config = ScenarioConfig(scenario_config=config, f_msx_in=f_msx)
+
+    return config
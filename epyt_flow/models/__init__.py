@@ -1,2 +1,3 @@
 from .event_detector import *
 from .sensor_interpolation_detector import *
+from .streaming_detection import *
@@ -2,6 +2,8 @@
 Module provides a base class for event detectors.
 """
 from abc import abstractmethod, ABC
+from typing import Union
+import numpy as np
 
 from ..simulation.scada import ScadaData
 
@@ -9,10 +11,74 @@ from ..simulation.scada import ScadaData
 class EventDetector(ABC):
     """
     Base class for event detectors.
+
+    Besides detecting events in completed SCADA data (see :func:`apply`), every detector can
+    be applied to a stream of sensor readings (see :func:`update`) -- e.g. while the simulation
+    is still running (see :class:`~epyt_flow.models.streaming_detection.StreamingEventDetection`).
     """
     def __init__(self, **kwds):
+        self.__n_time_points_seen = 0
+
         super().__init__(**kwds)
 
+    @property
+    def n_time_points_seen(self) -> int:
+        """
+        Gets the number of time points that were passed to :func:`update` so far.
+
+        Returns
+        -------
+        `int`
+            Number of time points.
+        """
+        return self.__n_time_points_seen
+
+    def reset_stream(self) -> None:
+        """
+        Resets the stream of sensor readings (see :func:`update`) -- i.e. the next
+        time point passed to :func:`update` is considered to be the first one.
+        """
+        self.__n_time_points_seen = 0
+
+    def partial_fit(self, scada_data: Union[ScadaData, np.ndarray]) -> None:
+        """
+        Updates this detector with another chunk of SCADA data that represents the
+        normal operating state.
+
+        Parameters
+        ----------
+        scada_data : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData` or `numpy.ndarray`
+            Chunk of SCADA data.
+        """
+        raise NotImplementedError(f"'{type(self).__name__}' does not support 'partial_fit'")
+
+    def update(self, scada_data: Union[ScadaData, np.ndarray]) -> list[int]:
+        """
+        Applies this detector to the next time points of a stream of sensor readings.
+
+        Detectors that do not look at single time points only (e.g. detectors working on a
+        sliding window) have to override this function -- by default, :func:`apply` is
+        called on the new time points.
+
+        Parameters
+        ----------
+        scada_data : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData` or `numpy.ndarray`
+            New time points (i.e. sensor readings).
+
+        Returns
+        -------
+        `list[int]`
+            List of suspicious time points -- counted from the beginning of the stream.
+        """
+        n_time_points = len(scada_data.sensor_readings_time) \
+            if isinstance(scada_data, ScadaData) else scada_data.shape[0]
+
+        offset = self.__n_time_points_seen
+        suspicious_time_points = [offset + int(t) for t in self.apply(scada_data)]
+        self.__n_time_points_seen += n_time_points
+
+        return suspicious_time_points
+
     @abstractmethod
     def apply(self, scada_data: ScadaData) -> list[int]:
         """
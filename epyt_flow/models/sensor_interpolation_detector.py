@@ -12,7 +12,17 @@ from ..simulation.scada import ScadaData
 
 class SensorInterpolationDetector(EventDetector):
     """
-    Class implementing a residual-based event detector based on sensor interpolation.
+    Class implementing a residual-based event detector based on sensor interpolation --
+    i.e. every sensor is predicted from all other sensors, and a time point is flagged as
+    suspicious if the prediction error of any sensor exceeds its threshold
+    (1.2 times the largest prediction error on the training data).
+
+    For the default (linear) regressor, all leave-one-out regressions are computed at once
+    from the (regularized) covariance matrix of the sensor readings: the coefficients of
+    predicting sensor j from all other sensors are given by -P[j, k] / P[j, j], where P
+    denotes the inverse of the covariance matrix. The covariance matrix is accumulated over
+    chunks of time points, which allows for fitting the detector to data that does not fit into
+    memory (see :func:`partial_fit`).
 
     Parameters
     ----------
@@ -21,11 +31,42 @@ class SensorInterpolationDetector(EventDetector):
         Must implement the usual `fit` and `predict` functions.
 
         The default is `sklearn.linear_model.LinearRegression`
+    regularization : `float`, optional
+        Ridge regularization of the linear regressions -- relative to the average
+        variance of all sensors. Only used if `regressor_type` is
+        `sklearn.linear_model.LinearRegression`.
+
+        The default is 1e-8.
+    block_size : `int`, optional
+        Number of time points that are processed at once.
+
+        The default is 4096.
     """
-    def __init__(self, regressor_type: Any = LinearRegression, **kwds):
+    def __init__(self, regressor_type: Any = LinearRegression, regularization: float = 1e-8,
+                 block_size: int = 4096, **kwds):
+        if not isinstance(regularization, (float, int)):
+            raise TypeError("'regularization' must be an instance of 'float' " +
+                            f"but not of '{type(regularization)}'")
+        if regularization < 0:
+            raise ValueError("'regularization' can not be negative")
+        if not isinstance(block_size, int):
+            raise TypeError("'block_size' must be an instance of 'int' " +
+                            f"but not of '{type(block_size)}'")
+        if block_size <= 0:
+            raise ValueError("'block_size' must be positive")
+
         self.__regressor_type = regressor_type
+        self.__regularization = float(regularization)
+        self.__block_size = block_size
         self.__regressors = []
 
+        # Sufficient statistics & closed-form model of the linear sensor interpolation
+        self.__n_samples = 0
+        self.__mean = None
+        self.__scatter = None
+        self.__weights = None
+        self.__thresholds = None
+
         super().__init__(**kwds)
 
     @property
@@ -40,6 +81,57 @@ class SensorInterpolationDetector(EventDetector):
         """
         return self.__regressor_type
 
+    @property
+    def regularization(self) -> float:
+        """
+        Gets the (relative) ridge regularization of the linear regressions.
+
+        Returns
+        -------
+        `float`
+            Regularization.
+        """
+        return self.__regularization
+
+    @property
+    def block_size(self) -> int:
+        """
+        Gets the number of time points that are processed at once.
+
+        Returns
+        -------
+        `int`
+            Block size.
+        """
+        return self.__block_size
+
+    @property
+    def n_samples(self) -> int:
+        """
+        Gets the number of time points the (linear) detector was fitted to.
+
+        Returns
+        -------
+        `int`
+            Number of time points.
+        """
+        return self.__n_samples
+
+    @property
+    def thresholds(self) -> np.ndarray:
+        """
+        Gets the threshold of the prediction error of each sensor.
+
+        Returns
+        -------
+        `numpy.ndarray`
+            Thresholds.
+        """
+        if self.__is_linear():
+            return deepcopy(self.__thresholds)
+        else:
+            return np.array([threshold for _, _, _, threshold in self.__regressors])
+
     @property
     def regressors(self) -> list[Any]:
         """
@@ -48,13 +140,104 @@ class SensorInterpolationDetector(EventDetector):
         Returns
         -------
         `list[Any]`
-            Fitted regressors.
+            Fitted regressors -- i.e. tuples of the input indices, the output index,
+            the regressor, and the threshold.
         """
-        return deepcopy(self.__regressors)
+        if not self.__is_linear():
+            return deepcopy(self.__regressors)
+        if self.__weights is None:
+            return []
+
+        regressors = []
+        n_sensors = self.__weights.shape[0]
+        for output_idx in range(n_sensors):
+            input_idx = list(range(n_sensors))
+            input_idx.remove(output_idx)
+
+            coef = -self.__weights[input_idx, output_idx]
+            model = LinearRegression()
+            model.coef_ = coef
+            model.intercept_ = self.__mean[output_idx] - coef @ self.__mean[input_idx]
+            model.n_features_in_ = n_sensors - 1
+
+            regressors.append((input_idx, output_idx, model, self.__thresholds[output_idx]))
+
+        return regressors
 
     def __eq__(self, other) -> bool:
-        return self.__regressor_type == other.regressor_type and \
-            all(self.__regressors == other.regressors)
+        if not isinstance(other, SensorInterpolationDetector):
+            return False
+        if self.__regressor_type != other.regressor_type:
+            return False
+        if not self.__is_linear():
+            return self.__regressors == other.regressors
+
+        return self.__regularization == other.regularization and \
+            self.__n_samples == other.n_samples and \
+            np.array_equal(self.__thresholds, other.thresholds)
+
+    def __is_linear(self) -> bool:
+        return self.__regressor_type is LinearRegression
+
+    @staticmethod
+    def __get_data(scada_data: Union[ScadaData, np.ndarray]) -> np.ndarray:
+        if isinstance(scada_data, ScadaData):
+            return scada_data.get_data()
+        elif isinstance(scada_data, np.ndarray):
+            return scada_data
+        else:
+            raise TypeError("'scada_data' must be an instance of " +
+                            "'epyt_flow.simulation.ScadaData' or 'numpy.ndarray' " +
+                            f"but not of '{type(scada_data)}'")
+
+    def __get_blocks(self, data: np.ndarray):
+        for t in range(0, data.shape[0], self.__block_size):
+            yield np.asarray(data[t:t + self.__block_size], dtype=np.float64)
+
+    def __accumulate(self, data: np.ndarray) -> None:
+        # Merge the mean & scatter matrix of every block into the running statistics
+        # (pairwise update by Chan et al.)
+        for X in self.__get_blocks(data):
+            n = X.shape[0]
+            if n == 0:
+                continue
+            mean = X.mean(axis=0)
+            Xc = X - mean
+            scatter = Xc.T @ Xc
+
+            if self.__n_samples == 0:
+                self.__mean = mean
+                self.__scatter = scatter
+            else:
+                if mean.shape != self.__mean.shape:
+                    raise ValueError("Number of sensors does not match the fitted detector")
+                n_total = self.__n_samples + n
+                delta = mean - self.__mean
+                self.__mean = self.__mean + delta * (n / n_total)
+                self.__scatter += scatter + np.outer(delta, delta) * (self.__n_samples * n / n_total)
+            self.__n_samples += n
+
+    def __update_model(self) -> None:
+        # Inverse of the regularized covariance matrix -- scaling its columns by the
+        # inverse diagonal yields the prediction errors of all leave-one-out regressions
+        cov = self.__scatter / self.__n_samples
+        scale = np.trace(cov) / cov.shape[0]
+        if scale <= 0:
+            scale = 1.
+        cov[np.diag_indices_from(cov)] += max(self.__regularization, 1e-12) * scale
+
+        precision = np.linalg.inv(cov)
+        self.__weights = precision / np.diag(precision)
+
+    def __compute_errors(self, X: np.ndarray) -> np.ndarray:
+        return np.abs((X - self.__mean) @ self.__weights)
+
+    def __max_errors(self, data: np.ndarray) -> np.ndarray:
+        max_errors = np.zeros(self.__weights.shape[0])
+        for X in self.__get_blocks(data):
+            if X.shape[0] > 0:
+                max_errors = np.maximum(max_errors, self.__compute_errors(X).max(axis=0))
+        return max_errors
 
     def fit(self, scada_data: Union[ScadaData, np.ndarray]) -> None:
         """
@@ -64,12 +247,17 @@ class SensorInterpolationDetector(EventDetector):
         Parameters
         ----------
         scada_data : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData` or `numpy.ndarray`
-            SCADA data to fit this detector.
+            SCADA data to fit this detector -- in the linear case, this can also be a
+            memory-mapped array (e.g. `numpy.memmap`), which is processed block-wise.
         """
-        if isinstance(scada_data, ScadaData):
-            data = scada_data.get_data()
-        else:
-            data = scada_data
+        data = self.__get_data(scada_data)
+
+        if self.__is_linear():
+            self.__n_samples = 0
+            self.__accumulate(data)
+            self.__update_model()
+            self.__thresholds = 1.2 * self.__max_errors(data)
+            return
 
         self.__regressors = []
         for output_idx in range(data.shape[1]):
@@ -87,6 +275,37 @@ class SensorInterpolationDetector(EventDetector):
 
             self.__regressors.append((input_idx, output_idx, model, threshold))
 
+    def partial_fit(self, scada_data: Union[ScadaData, np.ndarray]) -> None:
+        """
+        Updates the (linear) detector with another chunk of SCADA data that represents
+        the normal operating state -- e.g. the chunks of an out-of-core data set, or the
+        results of a running simulation.
+
+        The sensor interpolation is identical to fitting the detector to all chunks at once.
+        The thresholds, however, are the running maximum of the prediction errors on each chunk
+        when it was added -- i.e. they are based on the model at that time.
+
+        Parameters
+        ----------
+        scada_data : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData` or `numpy.ndarray`
+            Chunk of SCADA data.
+        """
+        if not self.__is_linear():
+            raise ValueError("'partial_fit' is only supported for the linear sensor " +
+                             "interpolation (i.e. 'sklearn.linear_model.LinearRegression')")
+
+        data = self.__get_data(scada_data)
+
+        self.__accumulate(data)
+        if self.__n_samples == 0:
+            return
+        self.__update_model()
+
+        thresholds = 1.2 * self.__max_errors(data)
+        if self.__thresholds is not None and self.__thresholds.shape == thresholds.shape:
+            thresholds = np.maximum(self.__thresholds, thresholds)
+        self.__thresholds = thresholds
+
     def apply(self, scada_data: Union[ScadaData, np.ndarray]) -> list[int]:
         """
         Applies this detector to given SCADA data and returns suspicious time points.
@@ -101,13 +320,22 @@ class SensorInterpolationDetector(EventDetector):
         `list[int]`
             List of suspicious time points.
         """
-        suspicious_time_points = []
+        X = self.__get_data(scada_data)
 
-        if isinstance(scada_data, ScadaData):
-            X = scada_data.get_data()
-        else:
-            X = scada_data
+        if self.__is_linear():
+            if self.__weights is None:
+                raise ValueError("Detector has not been fitted yet")
+
+            suspicious_time_points = []
+            for t, X_block in zip(range(0, X.shape[0], self.__block_size),
+                                  self.__get_blocks(X)):
+                errors = self.__compute_errors(X_block)
+                suspicious = np.any(errors > self.__thresholds, axis=1)
+                suspicious_time_points += (t + np.flatnonzero(suspicious)).tolist()
 
+            return suspicious_time_points
+
+        suspicious_time_points = []
         for input_idx, output_idx, model, threshold in self.__regressors:
             y_pred = model.predict(X[:, input_idx])
             y = X[:, output_idx]
@@ -0,0 +1,290 @@
+"""
+Module provides a pipeline stage for applying an event detector to the results of a
+running simulation -- i.e. events are detected while the simulation is still running.
+"""
+from typing import Any, Callable, Generator, Union
+from queue import Queue, Empty
+from threading import Thread
+import numpy as np
+
+from .event_detector import EventDetector
+from ..simulation.scada import ScadaData
+
+
+class StreamingEventDetection():
+    """
+    Class for applying an event detector to a stream of sensor readings in a background thread
+    -- e.g. to the SCADA data of every time step of
+    :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.run_simulation_as_generator`.
+
+    The sensor readings are passed to the detector through a bounded queue: the simulation is
+    never slowed down by the detector unless the detector falls behind by more than
+    `max_pending` time steps, in which case the simulation waits -- this bounds the delay
+    between simulating a time step and evaluating it. All time steps that are pending when the
+    detector becomes ready are evaluated at once (see :func:`EventDetector.update`).
+
+    Optionally, the detector is first fitted to the beginning of the stream
+    (see :func:`EventDetector.partial_fit`) -- i.e. the first `n_training_time_points`
+    time points are assumed to represent the normal operating state.
+
+    Usage with a running simulation:
+
+    .. code-block:: python
+
+        with StreamingEventDetection(detector, n_training_time_points=48*7) as detection:
+            for scada_data in detection.process(sim.run_simulation_as_generator()):
+                ...
+
+        print(detection.suspicious_times)
+
+    Parameters
+    ----------
+    detector : :class:`~epyt_flow.models.event_detector.EventDetector`
+        Event detector.
+    n_training_time_points : `int`, optional
+        Number of time points at the beginning of the stream which are used for fitting the
+        detector instead of detecting events.
+
+        The default is zero.
+    max_pending : `int`, optional
+        Maximum number of time steps (i.e. calls of :func:`push`) that wait for being evaluated.
+
+        The default is 64.
+    callback : `Callable[[list[int], numpy.ndarray], None]`, optional
+        Function that is called (from the background thread) whenever suspicious
+        time points are found -- the suspicious time points (counted from the beginning
+        of the stream) and their times (in seconds) are passed to it.
+
+        The default is None.
+    """
+    def __init__(self, detector: EventDetector, n_training_time_points: int = 0,
+                 max_pending: int = 64,
+                 callback: Callable[[list[int], np.ndarray], None] = None, **kwds):
+        if not isinstance(detector, EventDetector):
+            raise TypeError("'detector' must be an instance of " +
+                            "'epyt_flow.models.EventDetector' but not of " +
+                            f"'{type(detector)}'")
+        if not isinstance(n_training_time_points, int):
+            raise TypeError("'n_training_time_points' must be an instance of 'int' " +
+                            f"but not of '{type(n_training_time_points)}'")
+        if n_training_time_points < 0:
+            raise ValueError("'n_training_time_points' can not be negative")
+        if not isinstance(max_pending, int):
+            raise TypeError("'max_pending' must be an instance of 'int' " +
+                            f"but not of '{type(max_pending)}'")
+        if max_pending <= 0:
+            raise ValueError("'max_pending' must be positive")
+        if callback is not None and not callable(callback):
+            raise TypeError("'callback' must be callable")
+
+        self.__detector = detector
+        self.__n_training_time_points = n_training_time_points
+        self.__max_pending = max_pending
+        self.__callback = callback
+
+        self.__queue = None
+        self.__thread = None
+        self.__error = None
+        self.__training_data = []
+        self.__n_training_data = 0
+        self.__n_time_points = 0
+        self.__suspicious_time_points = []
+        self.__suspicious_times = []
+
+        super().__init__(**kwds)
+
+    @property
+    def detector(self) -> EventDetector:
+        """
+        Gets the event detector.
+
+        Returns
+        -------
+        :class:`~epyt_flow.models.event_detector.EventDetector`
+            Event detector.
+        """
+        return self.__detector
+
+    @property
+    def suspicious_time_points(self) -> list[int]:
+        """
+        Gets the suspicious time points found so far -- counted from the beginning of the
+        stream (incl. the training time points).
+
+        Returns
+        -------
+        `list[int]`
+            Suspicious time points.
+        """
+        return list(self.__suspicious_time_points)
+
+    @property
+    def suspicious_times(self) -> list[Any]:
+        """
+        Gets the times (in seconds) of the suspicious time points found so far.
+
+        Returns
+        -------
+        `list[Any]`
+            Times of the suspicious time points.
+        """
+        return list(self.__suspicious_times)
+
+    @property
+    def n_pending(self) -> int:
+        """
+        Gets the (approximate) number of time steps that are waiting for being evaluated.
+
+        Returns
+        -------
+        `int`
+            Number of pending time steps.
+        """
+        return 0 if self.__queue is None else self.__queue.qsize()
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def start(self) -> None:
+        """
+        Starts the background thread -- called automatically by :func:`push` if necessary.
+        """
+        if self.__thread is not None:
+            return
+
+        self.__queue = Queue(maxsize=self.__max_pending)
+        self.__error = None
+        self.__detector.reset_stream()
+        self.__thread = Thread(target=self.__run, daemon=True)
+        self.__thread.start()
+
+    def close(self) -> None:
+        """
+        Waits until all pending time steps are evaluated and stops the background thread.
+        Exceptions raised by the detector are re-raised here.
+        """
+        if self.__thread is None:
+            return
+
+        self.__queue.put(None)
+        self.__thread.join()
+        self.__thread = None
+        self.__queue = None
+
+        self.__raise_error()
+
+    def __raise_error(self) -> None:
+        if self.__error is not None:
+            error, self.__error = self.__error, None
+            raise RuntimeError("Event detector failed") from error
+
+    def push(self, scada_data: Union[ScadaData, np.ndarray],
+             sensor_readings_time: np.ndarray = None) -> None:
+        """
+        Passes the next time points (i.e. sensor readings) to the detector -- blocks if
+        the detector falls behind by more than `max_pending` calls.
+
+        Parameters
+        ----------
+        scada_data : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData` or `numpy.ndarray`
+            Sensor readings of the next time points.
+        sensor_readings_time : `numpy.ndarray`, optional
+            Times (in seconds) of the time points -- only needed if `scada_data` is
+            a `numpy.ndarray`.
+
+            The default is None.
+        """
+        if isinstance(scada_data, ScadaData):
+            sensor_readings_time = scada_data.sensor_readings_time
+            data = scada_data.get_data()
+        elif isinstance(scada_data, np.ndarray):
+            data = scada_data.reshape(-1, scada_data.shape[-1])
+            if sensor_readings_time is None:
+                sensor_readings_time = np.arange(self.__n_time_points,
+                                                 self.__n_time_points + data.shape[0])
+        else:
+            raise TypeError("'scada_data' must be an instance of " +
+                            "'epyt_flow.simulation.ScadaData' or 'numpy.ndarray' " +
+                            f"but not of '{type(scada_data)}'")
+
+        self.__raise_error()
+        self.start()
+        self.__n_time_points += data.shape[0]
+        self.__queue.put((data, np.asarray(sensor_readings_time)))
+
+    def process(self, simulation: Generator[ScadaData, Any, None]
+                ) -> Generator[ScadaData, None, None]:
+        """
+        Passes the SCADA data of every time step of a running simulation to the detector,
+        and yields it unchanged.
+
+        Parameters
+        ----------
+        simulation : `Generator[ScadaData, Any, None]`
+            Generator of the simulation results -- e.g. returned by
+            :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.run_simulation_as_generator`.
+
+        Returns
+        -------
+        `Generator[ScadaData, None, None]`
+            SCADA data of every time step.
+        """
+        for scada_data in simulation:
+            if scada_data is not None:
+                self.push(scada_data)
+            yield scada_data
+
+    def __run(self) -> None:
+        done = False
+        while not done:
+            # Evaluate all time steps that are pending at once
+            items = [self.__queue.get()]
+            while True:
+                try:
+                    items.append(self.__queue.get_nowait())
+                except Empty:
+                    break
+            done = items[-1] is None
+            items = [item for item in items if item is not None]
+            if len(items) == 0 or self.__error is not None:
+                continue
+
+            try:
+                self.__process(np.concatenate([data for data, _ in items], axis=0),
+                               np.concatenate([times for _, times in items]))
+            except Exception as ex:
+                self.__error = ex
+
+    def __process(self, data: np.ndarray, times: np.ndarray) -> None:
+        # Fit the detector to the beginning of the stream
+        n_training = min(self.__n_training_time_points - self.__n_training_data, data.shape[0])
+        if n_training > 0:
+            self.__training_data.append(data[:n_training])
+            self.__n_training_data += n_training
+            data, times = data[n_training:], times[n_training:]
+
+            if self.__n_training_data == self.__n_training_time_points:
+                self.__detector.partial_fit(np.concatenate(self.__training_data, axis=0))
+                self.__training_data = []
+
+        if data.shape[0] == 0:
+            return
+
+        # The detector counts the time points after the training time points only
+        n_seen = self.__detector.n_time_points_seen
+        suspicious = self.__detector.update(data)
+        if len(suspicious) == 0:
+            return
+
+        local_idx = [t - n_seen for t in suspicious]
+        time_points = [self.__n_training_time_points + t for t in suspicious]
+        suspicious_times = times[local_idx]
+
+        self.__suspicious_time_points += time_points
+        self.__suspicious_times += suspicious_times.tolist()
+        if self.__callback is not None:
+            self.__callback(time_points, suspicious_times)
@@ -3,6 +3,7 @@ This module contains a class for managing recourses such as scenarios or SCADA d
 """
 from typing import Any
 import uuid
+import threading
 
 
 class ResourceManager():
@@ -11,6 +12,7 @@ class ResourceManager():
     """
     def __init__(self):
         self.__resources = {}
+        self.__resources_lock = threading.Lock()
 
     def __create_uuid(self) -> str:
         return str(uuid.uuid4())
@@ -46,7 +48,8 @@ class ResourceManager():
             UUID of the new item.
         """
         new_item_uuid = self.__create_uuid()
-        self.__resources[new_item_uuid] = item
+        with self.__resources_lock:
+            self.__resources[new_item_uuid] = item
 
         return new_item_uuid
 
@@ -64,10 +67,23 @@ class ResourceManager():
         `Any`
             Resource item.
         """
-        if item_uuid not in self.__resources:
-            raise ValueError(f"Invalid UUID '{item_uuid}'")
+        with self.__resources_lock:
+            if item_uuid not in self.__resources:
+                raise ValueError(f"Invalid UUID '{item_uuid}'")
 
-        return self.__resources[item_uuid]
+            return self.__resources[item_uuid]
+
+    def get_all_items(self) -> dict[str, Any]:
+        """
+        Gets all items together with their UUIDs.
+
+        Returns
+        -------
+        `dict[str, Any]`
+            Copy of the mapping of UUIDs to resource items.
+        """
+        with self.__resources_lock:
+            return dict(self.__resources)
 
     def close_item(self, item: Any):
         """
@@ -88,8 +104,9 @@ class ResourceManager():
         item_uuid : `str`
             UUID of the item.
         """
-        if item_uuid not in self.__resources:
-            raise ValueError(f"Invalid UUID '{item_uuid}'")
+        with self.__resources_lock:
+            if item_uuid not in self.__resources:
+                raise ValueError(f"Invalid UUID '{item_uuid}'")
+            item = self.__resources.pop(item_uuid)
 
-        self.close_item(self.__resources[item_uuid])
-        del self.__resources[item_uuid]
+        self.close_item(item)
@@ -28,7 +28,8 @@ class ScenarioLeakageHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_leakages = self.scenario_mgr.get(scenario_id).leakages
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_leakages = self.scenario_mgr.get(scenario_id).leakages
             self.send_json_response(resp, my_leakages)
         except Exception as ex:
             warnings.warn(str(ex))
@@ -57,7 +58,8 @@ class ScenarioLeakageHandler(ScenarioBaseHandler):
                 self.send_json_parsing_error(resp)
                 return
 
-            self.scenario_mgr.get(scenario_id).add_leakage(leakage)
+            with self.scenario_mgr.get_lock(scenario_id):
+                self.scenario_mgr.get(scenario_id).add_leakage(leakage)
         except Exception as ex:
             warnings.warn(str(ex))
             resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
@@ -83,7 +85,8 @@ class ScenarioSensorFaultHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_sensor_faults = self.scenario_mgr.get(scenario_id).sensor_faults
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_sensor_faults = self.scenario_mgr.get(scenario_id).sensor_faults
             self.send_json_response(resp, my_sensor_faults)
         except Exception as ex:
             warnings.warn(str(ex))
@@ -112,7 +115,8 @@ class ScenarioSensorFaultHandler(ScenarioBaseHandler):
                 self.send_json_parsing_error(resp)
                 return
 
-            self.scenario_mgr.get(scenario_id).add_sensor_fault(sensor_fault)
+            with self.scenario_mgr.get_lock(scenario_id):
+                self.scenario_mgr.get(scenario_id).add_sensor_fault(sensor_fault)
         except Exception as ex:
             warnings.warn(str(ex))
             resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
@@ -3,6 +3,7 @@ This module provides REST API handlers for some requests concerning scenarios.
 """
 import warnings
 import os
+import threading
 import falcon
 
 from ..base_handler import BaseHandler
@@ -14,7 +15,18 @@ from ...simulation import ScenarioSimulator, SensorConfig
 class ScenarioManager(ResourceManager):
     """
     Class for managing all scenarios that are currently used by the REST API.
+
+    Each scenario is guarded by a lock (see :func:`get_lock`) which must be held by every
+    request (and every simulation job) that uses the scenario. All scenarios using EPANET-MSX
+    share one lock since EPANET-MSX relies on a global project.
     """
+    def __init__(self, **kwds):
+        self.__locks = {}
+        self.__locks_lock = threading.Lock()
+        self.__msx_lock = threading.Lock()
+
+        super().__init__(**kwds)
+
     def create(self, **kwds) -> str:
         """
         Creates a new scenario -- e.g. loading a given .inp file or
@@ -25,7 +37,41 @@ class ScenarioManager(ResourceManager):
         `str`
             UUID of the new scenario.
         """
-        return self.create_new_item(ScenarioSimulator(**kwds))
+        my_scenario = ScenarioSimulator(**kwds)
+        scenario_id = self.create_new_item(my_scenario)
+
+        with self.__locks_lock:
+            self.__locks[scenario_id] = self.__msx_lock if my_scenario.f_msx_in is not None \
+                else threading.Lock()
+
+        return scenario_id
+
+    def get_lock(self, scenario_id: str) -> threading.Lock:
+        """
+        Gets the lock guarding a given scenario.
+
+        Parameters
+        ----------
+        scenario_id : `str`
+            UUID of the scenario.
+
+        Returns
+        -------
+        `threading.Lock`
+            Lock of the scenario.
+        """
+        with self.__locks_lock:
+            if scenario_id not in self.__locks:
+                raise ValueError(f"Invalid UUID '{scenario_id}'")
+            return self.__locks[scenario_id]
+
+    def remove(self, item_uuid: str) -> None:
+        # Wait for all requests and simulation jobs that are currently using the scenario
+        with self.get_lock(item_uuid):
+            super().remove(item_uuid)
+
+        with self.__locks_lock:
+            self.__locks.pop(item_uuid, None)
 
     def close_item(self, item: ScenarioSimulator) -> None:
         item.close()
@@ -121,11 +167,11 @@ class ScenarioExportHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_scenario = self.scenario_mgr.get(scenario_id)
-
             f_inp_out = self.__create_temp_file_path(scenario_id, "inp")
             f_msx_out = self.__create_temp_file_path(scenario_id, "msx")
-            my_scenario.save_to_epanet_file(f_inp_out, f_msx_out)
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_scenario = self.scenario_mgr.get(scenario_id)
+                my_scenario.save_to_epanet_file(f_inp_out, f_msx_out)
 
             if os.path.isfile(f_msx_out):
                 f_out = self.__create_temp_file_path(scenario_id, "zip")
@@ -162,7 +208,8 @@ class ScenarioConfigHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_sceanrio_config = self.scenario_mgr.get(scenario_id).get_scenario_config()
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_sceanrio_config = self.scenario_mgr.get(scenario_id).get_scenario_config()
             self.send_json_response(resp, my_sceanrio_config)
         except Exception as ex:
             warnings.warn(str(ex))
@@ -215,7 +262,8 @@ class ScenarioTopologyHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_topology = self.scenario_mgr.get(scenario_id).get_topology()
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_topology = self.scenario_mgr.get(scenario_id).get_topology()
             self.send_json_response(resp, my_topology)
         except Exception as ex:
             warnings.warn(str(ex))
@@ -242,8 +290,9 @@ class ScenarioGeneralParamsHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_general_params = self.scenario_mgr.get(scenario_id).get_scenario_config().\
-                general_params
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_general_params = self.scenario_mgr.get(scenario_id).get_scenario_config().\
+                    general_params
             self.send_json_response(resp, my_general_params)
         except Exception as ex:
             warnings.warn(str(ex))
@@ -272,7 +321,8 @@ class ScenarioGeneralParamsHandler(ScenarioBaseHandler):
                 self.send_json_parsing_error(resp)
                 return
 
-            self.scenario_mgr.get(scenario_id).set_general_parameters(**general_params)
+            with self.scenario_mgr.get_lock(scenario_id):
+                self.scenario_mgr.get(scenario_id).set_general_parameters(**general_params)
         except Exception as ex:
             warnings.warn(str(ex))
             resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
@@ -298,7 +348,8 @@ class ScenarioSensorConfigHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_sensor_config = self.scenario_mgr.get(scenario_id).sensor_config
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_sensor_config = self.scenario_mgr.get(scenario_id).sensor_config
             self.send_json_response(resp, my_sensor_config)
         except Exception as ex:
             warnings.warn(str(ex))
@@ -327,8 +378,9 @@ class ScenarioSensorConfigHandler(ScenarioBaseHandler):
                 self.send_json_parsing_error(resp)
                 return
 
-            my_scenario = self.scenario_mgr.get(scenario_id)
-            my_scenario.sensor_config = sensor_config
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_scenario = self.scenario_mgr.get(scenario_id)
+                my_scenario.sensor_config = sensor_config
         except Exception as ex:
             warnings.warn(str(ex))
             resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
@@ -361,10 +413,11 @@ class ScenarioNodeDemandPatternHandler(ScenarioBaseHandler):
 
             params = self.load_json_data_from_request(req)
 
-            my_scenario = self.scenario_mgr.get(scenario_id)
-            my_scenario.set_node_demand_pattern(node_id, params["base_demand"],
-                                                params["demand_pattern_id"],
-                                                params["demand_pattern"])
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_scenario = self.scenario_mgr.get(scenario_id)
+                my_scenario.set_node_demand_pattern(node_id, params["base_demand"],
+                                                    params["demand_pattern_id"],
+                                                    params["demand_pattern"])
         except Exception as ex:
             warnings.warn(str(ex))
             resp.data = str(ex)
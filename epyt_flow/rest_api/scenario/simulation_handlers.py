@@ -6,6 +6,7 @@ import falcon
 
 from .handlers import ScenarioBaseHandler
 from ..scada_data.handlers import ScadaDataManager
+from ..simulation_jobs.handlers import SimulationJobManager
 
 
 class ScenarioSimulationHandler(ScenarioBaseHandler):
@@ -47,8 +48,9 @@ class ScenarioSimulationHandler(ScenarioBaseHandler):
 
             params = self.load_json_data_from_request(req)
 
-            my_scenario = self.scenario_mgr.get(scenario_id)
-            res = my_scenario.run_simulation(**params)
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_scenario = self.scenario_mgr.get(scenario_id)
+                res = my_scenario.run_simulation(**params)
 
             data_id = self.scada_data_mgr.create_new_item(res)
             self.send_json_response(resp, {"data_id": data_id})
@@ -73,8 +75,9 @@ class ScenarioSimulationHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_scenario = self.scenario_mgr.get(scenario_id)
-            res = my_scenario.run_simulation()
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_scenario = self.scenario_mgr.get(scenario_id)
+                res = my_scenario.run_simulation()
 
             data_id = self.scada_data_mgr.create_new_item(res)
             self.send_json_response(resp, {"data_id": data_id})
@@ -118,8 +121,9 @@ class ScenarioBasicQualitySimulationHandler(ScenarioBaseHandler):
 
             params = self.load_json_data_from_request(req)
 
-            my_scenario = self.scenario_mgr.get(scenario_id)
-            res = my_scenario.run_basic_quality_simulation(**params)
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_scenario = self.scenario_mgr.get(scenario_id)
+                res = my_scenario.run_basic_quality_simulation(**params)
 
             data_id = self.scada_data_mgr.create_new_item(res)
             self.send_json_response(resp, {"data_id": data_id})
@@ -163,8 +167,9 @@ class ScenarioAdvancedQualitySimulationHandler(ScenarioBaseHandler):
 
             params = self.load_json_data_from_request(req)
 
-            my_scenario = self.scenario_mgr.get(scenario_id)
-            res = my_scenario.run_advanced_quality_simulation(**params)
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_scenario = self.scenario_mgr.get(scenario_id)
+                res = my_scenario.run_advanced_quality_simulation(**params)
 
             data_id = self.scada_data_mgr.create_new_item(res)
             self.send_json_response(resp, {"data_id": data_id})
@@ -172,3 +177,58 @@ class ScenarioAdvancedQualitySimulationHandler(ScenarioBaseHandler):
             warnings.warn(str(ex))
             resp.data = str(ex)
             resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
+
+
+class ScenarioSimulationJobHandler(ScenarioBaseHandler):
+    """
+    Class for handling POST requests for submitting an asynchronous simulation job
+    of a given scenario.
+
+    Parameters
+    ----------
+    job_mgr : :class:`~epyt_flow.rest_api.simulation_jobs.handlers.SimulationJobManager`
+        Simulation job manager.
+    """
+    def __init__(self, job_mgr: SimulationJobManager, **kwds):
+        self.job_mgr = job_mgr
+
+        super().__init__(**kwds)
+
+    def on_post(self, req: falcon.Request, resp: falcon.Response, scenario_id: str) -> None:
+        """
+        Submits a new simulation job of a given scenario -- the results can be streamed
+        (in time-chunked binary frames) as soon as they become available.
+
+        Additional arguments (e.g. "chunk_size", "max_buffered_chunks", "frozen_sensor_config",
+        "export_raw_data") are passed to
+        :class:`~epyt_flow.rest_api.simulation_jobs.handlers.SimulationJob`.
+
+        Parameters
+        ----------
+        req : `falcon.Request`
+            Request instance.
+        resp : `falcon.Response`
+            Response instance.
+        scenario_id : `str`
+            UUID of the scenario.
+        """
+        try:
+            if self.scenario_mgr.validate_uuid(scenario_id) is False:
+                self.send_invalid_resource_id_error(resp)
+                return
+
+            params = self.load_json_data_from_request(req)
+            if params is None:
+                params = {}
+
+            my_scenario = self.scenario_mgr.get(scenario_id)
+            job_id = self.job_mgr.submit(my_scenario, self.scenario_mgr.get_lock(scenario_id),
+                                         **params)
+
+            self.send_json_response(resp, {"job_id": job_id})
+        except (TypeError, ValueError) as ex:
+            self.send_error(resp, str(ex))
+        except Exception as ex:
+            warnings.warn(str(ex))
+            resp.data = str(ex)
+            resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
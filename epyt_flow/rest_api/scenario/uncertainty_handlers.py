@@ -28,7 +28,8 @@ class ScenarioModelUncertaintyHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_model_uncertainties = self.scenario_mgr.get(scenario_id).model_uncertainty
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_model_uncertainties = self.scenario_mgr.get(scenario_id).model_uncertainty
             self.send_json_response(resp, my_model_uncertainties)
         except Exception as ex:
             warnings.warn(str(ex))
@@ -57,7 +58,8 @@ class ScenarioModelUncertaintyHandler(ScenarioBaseHandler):
                 self.send_json_parsing_error(resp)
                 return
 
-            self.scenario_mgr.get(scenario_id).model_uncertainty = model_uncertainty
+            with self.scenario_mgr.get_lock(scenario_id):
+                self.scenario_mgr.get(scenario_id).model_uncertainty = model_uncertainty
         except Exception as ex:
             warnings.warn(str(ex))
             resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
@@ -83,7 +85,8 @@ class ScenarioSensorUncertaintyHandler(ScenarioBaseHandler):
                 self.send_invalid_resource_id_error(resp)
                 return
 
-            my_sensor_noise = self.scenario_mgr.get(scenario_id).sensor_noise
+            with self.scenario_mgr.get_lock(scenario_id):
+                my_sensor_noise = self.scenario_mgr.get(scenario_id).sensor_noise
             self.send_json_response(resp, my_sensor_noise)
         except Exception as ex:
             warnings.warn(str(ex))
@@ -112,7 +115,8 @@ class ScenarioSensorUncertaintyHandler(ScenarioBaseHandler):
                 self.send_json_parsing_error(resp)
                 return
 
-            self.scenario_mgr.get(scenario_id).sensor_noise = sensor_noise
+            with self.scenario_mgr.get_lock(scenario_id):
+                self.scenario_mgr.get(scenario_id).sensor_noise = sensor_noise
         except Exception as ex:
             warnings.warn(str(ex))
             resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
@@ -1,6 +1,7 @@
 """
 This module provides the EPyT-Flow REST API server.
 """
+from socketserver import ThreadingMixIn
 from wsgiref.simple_server import make_server, WSGIServer
 import falcon
 
@@ -12,7 +13,10 @@ from .scenario.uncertainty_handlers import ScenarioModelUncertaintyHandler, \
     ScenarioSensorUncertaintyHandler
 from .scenario.event_handlers import ScenarioLeakageHandler, ScenarioSensorFaultHandler
 from .scenario.simulation_handlers import ScenarioSimulationHandler, \
-    ScenarioBasicQualitySimulationHandler, ScenarioAdvancedQualitySimulationHandler
+    ScenarioBasicQualitySimulationHandler, ScenarioAdvancedQualitySimulationHandler, \
+    ScenarioSimulationJobHandler
+from .simulation_jobs.handlers import SimulationJobManager, SimulationJobHandler, \
+    SimulationJobStreamHandler
 from .scada_data.handlers import ScadaDataManager, ScadaDataSensorConfigHandler, \
     ScadaDataRemoveHandler, ScadaDataSensorFaultsHandler, ScadaDataConvertUnitsHandler
 from .scada_data.data_handlers import ScadaDataPressuresHandler, ScadaDataDemandsHandler, \
@@ -24,6 +28,14 @@ from .scada_data.export_handlers import ScadaDataExportHandler, ScadaDataXlsxExp
     ScadaDataMatlabExportHandler, ScadaDataNumpyExportHandler
 
 
+class ThreadingWSGIServer(ThreadingMixIn, WSGIServer):
+    """
+    WSGI server handling each request in a separate thread -- required for serving
+    status requests while results of simulation jobs are streamed.
+    """
+    daemon_threads = True
+
+
 class RestApiService():
     """
     Class implementing the REST API server.
@@ -34,13 +46,18 @@ class RestApiService():
         Port of the server.
 
         The default is 8080
+    n_simulation_workers : `int`, optional
+        Number of workers for running asynchronous simulation jobs.
+
+        The default is 4.
     """
-    def __init__(self, port: int = 8080):
+    def __init__(self, port: int = 8080, n_simulation_workers: int = 4):
         self.app = falcon.App()
         self.__port = port
 
         self.scenario_mgr = ScenarioManager()
         self.scada_data_mgr = ScadaDataManager()
+        self.simulation_job_mgr = SimulationJobManager(n_workers=n_simulation_workers)
 
         self.app.add_route("/scenario/new",
                            ScenarioNewHandler(self.scenario_mgr))
@@ -77,6 +94,14 @@ class RestApiService():
                            ScenarioAdvancedQualitySimulationHandler(scenario_mgr=self.scenario_mgr,
                                                                     scada_data_mgr=
                                                                     self.scada_data_mgr))
+        self.app.add_route("/scenario/{scenario_id}/simulation/jobs",
+                           ScenarioSimulationJobHandler(scenario_mgr=self.scenario_mgr,
+                                                        job_mgr=self.simulation_job_mgr))
+
+        self.app.add_route("/simulation_jobs/{job_id}",
+                           SimulationJobHandler(self.simulation_job_mgr))
+        self.app.add_route("/simulation_jobs/{job_id}/stream",
+                           SimulationJobStreamHandler(self.simulation_job_mgr))
 
         self.app.add_route("/scada_data/{data_id}",
                            ScadaDataRemoveHandler(self.scada_data_mgr))
@@ -133,11 +158,14 @@ class RestApiService():
         """
         Returns a new web server.
         """
-        return make_server("", self.__port, self.app)
+        return make_server("", self.__port, self.app, server_class=ThreadingWSGIServer)
 
     def run(self) -> None:
         """
         Runs the REST service.
         """
-        with self.make_server() as httpd:
-            httpd.serve_forever()
+        try:
+            with self.make_server() as httpd:
+                httpd.serve_forever()
+        finally:
+            self.simulation_job_mgr.close()
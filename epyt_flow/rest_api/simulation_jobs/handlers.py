@@ -0,0 +1,508 @@
+"""
+This module provides REST API handlers and a resource manager for asynchronous simulation jobs
+-- i.e. simulations that are run in a pool of background workers and whose results are streamed
+back to the client in time-chunked binary frames.
+"""
+from typing import Any, Generator
+import struct
+import queue
+import threading
+import time
+import warnings
+from concurrent.futures import ThreadPoolExecutor
+import numpy as np
+import falcon
+
+from ..base_handler import BaseHandler
+from ..res_manager import ResourceManager
+from ...serialization import my_packb
+from ...simulation.scenario_simulator import ScenarioSimulator
+from ...simulation.scada.scada_data import ScadaData
+
+
+JOB_STATUS_QUEUED = "queued"
+JOB_STATUS_RUNNING = "running"
+JOB_STATUS_FINISHED = "finished"
+JOB_STATUS_CANCELLED = "cancelled"
+JOB_STATUS_FAILED = "failed"
+
+STREAM_CONTENT_TYPE = "application/octet-stream"
+
+
+def encode_frame(data: dict) -> bytes:
+    """
+    Encodes a given dictionary as a binary frame -- i.e. a 4 byte (big-endian, unsigned)
+    length prefix followed by the msgpack serialization of the dictionary.
+
+    Numpy arrays are encoded as dictionaries with the keys "dtype", "shape", and "data",
+    where "data" contains the raw (C-ordered) bytes of the array.
+
+    Parameters
+    ----------
+    data : `dict`
+        Data to be encoded.
+
+    Returns
+    -------
+    `bytes`
+        Binary frame.
+    """
+    def __encode(item: Any) -> Any:
+        if isinstance(item, np.ndarray):
+            item = np.ascontiguousarray(item)
+            return {"dtype": item.dtype.str, "shape": list(item.shape), "data": item.tobytes()}
+        return item
+
+    payload = my_packb({key: __encode(value) for key, value in data.items()})
+    return struct.pack(">I", len(payload)) + payload
+
+
+class SimulationJob():
+    """
+    Class implementing an asynchronous simulation job.
+
+    The simulation is run step-by-step (see
+    :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.run_simulation_as_generator`)
+    and the final sensor readings are collected into chunks of a fixed number of time steps.
+    Each chunk is encoded as a binary frame (see :func:`encode_frame`) and put into a bounded
+    buffer. If the buffer is full (i.e. the client does not consume the stream fast enough),
+    the simulation is paused until the client catches up -- the job is cancelled if the
+    client does not consume any frame for `stream_timeout` seconds.
+
+    Parameters
+    ----------
+    scenario : :class:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator`
+        Scenario to be simulated.
+    scenario_lock : `threading.Lock`
+        Lock guarding the scenario -- see
+        :func:`~epyt_flow.rest_api.scenario.handlers.ScenarioManager.get_lock`.
+    chunk_size : `int`, optional
+        Number of time steps per frame.
+
+        The default is 10.
+    max_buffered_chunks : `int`, optional
+        Maximum number of frames that are buffered before the simulation is paused.
+
+        The default is 8.
+    stream_timeout : `float`, optional
+        Maximum time (in seconds) the simulation is paused waiting for the client to consume
+        a frame before the job gets cancelled.
+
+        The default is 60.
+    frozen_sensor_config : `bool`, optional
+        If True, only the required sensor nodes/links will be stored during the simulation.
+
+        The default is True.
+    export_raw_data : `bool`, optional
+        If True, the raw simulation states (instead of the final sensor readings) are streamed.
+
+        The default is False.
+    """
+    def __init__(self, scenario: ScenarioSimulator, scenario_lock: threading.Lock,
+                 chunk_size: int = 10, max_buffered_chunks: int = 8,
+                 stream_timeout: float = 60., frozen_sensor_config: bool = True,
+                 export_raw_data: bool = False):
+        if not isinstance(scenario, ScenarioSimulator):
+            raise TypeError("'scenario' must be an instance of " +
+                            "'epyt_flow.simulation.ScenarioSimulator' but not of " +
+                            f"'{type(scenario)}'")
+        if not isinstance(chunk_size, int) or chunk_size <= 0:
+            raise ValueError("'chunk_size' must be a positive integer")
+        if not isinstance(max_buffered_chunks, int) or max_buffered_chunks <= 0:
+            raise ValueError("'max_buffered_chunks' must be a positive integer")
+        if not isinstance(stream_timeout, (float, int)) or stream_timeout <= 0:
+            raise ValueError("'stream_timeout' must be positive")
+        if not isinstance(frozen_sensor_config, bool):
+            raise TypeError("'frozen_sensor_config' must be an instance of 'bool' but not of " +
+                            f"'{type(frozen_sensor_config)}'")
+        if not isinstance(export_raw_data, bool):
+            raise TypeError("'export_raw_data' must be an instance of 'bool' but not of " +
+                            f"'{type(export_raw_data)}'")
+
+        self.__scenario = scenario
+        self.__scenario_lock = scenario_lock
+        self.__chunk_size = chunk_size
+        self.__stream_timeout = stream_timeout
+        self.__frozen_sensor_config = frozen_sensor_config
+        self.__export_raw_data = export_raw_data
+
+        self.__frames = queue.Queue(maxsize=max_buffered_chunks)
+        self.__cancel_event = threading.Event()
+        self.__done_event = threading.Event()
+        self.__stream_timed_out = False
+        self.__stream_claimed = threading.Lock()
+        self.__status_lock = threading.Lock()
+        self.__status = JOB_STATUS_QUEUED
+        self.__error = None
+        self.__sim_time = 0
+        self.__sim_duration = max(scenario.get_simulation_duration(), 1)
+        self.__n_chunks = 0
+        self.__finished_time = None
+
+    @property
+    def finished_time(self) -> float:
+        """
+        Gets the time at which this job ended -- i.e. finished, got cancelled, or failed.
+
+        Returns
+        -------
+        `float`
+            Time (see `time.monotonic`) at which this job ended,
+            None if the job is still queued or running.
+        """
+        with self.__status_lock:
+            return self.__finished_time
+
+    def get_status(self) -> dict:
+        """
+        Gets the current status of this job.
+
+        Returns
+        -------
+        `dict`
+            Dictionary with the status ("queued", "running", "finished", "cancelled", or
+            "failed"), the progress (in [0, 1]), the number of frames produced so far,
+            and an error message (if the job failed).
+        """
+        with self.__status_lock:
+            return {"status": self.__status,
+                    "progress": min(self.__sim_time / self.__sim_duration, 1.),
+                    "n_chunks": self.__n_chunks,
+                    "error": self.__error}
+
+    def __set_status(self, status: str, error: str = None) -> None:
+        with self.__status_lock:
+            self.__status = status
+            self.__error = error
+
+    def cancel(self) -> None:
+        """
+        Cancels this job -- a running simulation is aborted after the current time step.
+        """
+        self.__cancel_event.set()
+
+    def __put_frame(self, frame: bytes) -> bool:
+        # Block (backpressure) until there is space in the buffer or the job got cancelled
+        # -- a client that does not consume any frame within the timeout is considered gone
+        deadline = time.monotonic() + self.__stream_timeout
+        while not self.__cancel_event.is_set():
+            try:
+                self.__frames.put(frame, timeout=.5)
+                return True
+            except queue.Full:
+                if time.monotonic() >= deadline:
+                    self.__stream_timed_out = True
+                    self.__cancel_event.set()
+
+        return False
+
+    def __encode_chunk(self, chunk: dict) -> bytes:
+        chunk = {data_type: np.concatenate(data, axis=0) for data_type, data in chunk.items()}
+
+        if self.__export_raw_data is True:
+            return encode_frame(chunk)
+
+        scada_data = ScadaData(**chunk,
+                               sensor_config=self.__scenario.sensor_config,
+                               sensor_reading_events=self.__sensor_reading_events,
+                               sensor_noise=self.__scenario.sensor_noise,
+                               frozen_sensor_config=self.__frozen_sensor_config)
+        return encode_frame({"sensor_readings_time": scada_data.sensor_readings_time,
+                             "sensor_readings": scada_data.get_data()})
+
+    def run(self) -> None:
+        """
+        Runs the simulation and produces the frames -- called by a worker of the job manager.
+        """
+        try:
+            with self.__scenario_lock:
+                self.__simulate()
+        finally:
+            with self.__status_lock:
+                self.__finished_time = time.monotonic()
+            self.__done_event.set()
+
+            # End of stream -- if the buffer is full, the stream ends as soon as the client
+            # consumed all buffered frames (see stream_frames)
+            try:
+                self.__frames.put_nowait(None)
+            except queue.Full:
+                pass
+
+    def __simulate(self) -> None:
+        if self.__cancel_event.is_set():
+            self.__set_status(JOB_STATUS_CANCELLED)
+            return
+
+        self.__set_status(JOB_STATUS_RUNNING)
+        try:
+            self.__sensor_reading_events = self.__scenario.sensor_reading_events
+
+            gen = self.__scenario.run_simulation_as_generator(
+                support_abort=True, return_as_dict=True,
+                frozen_sensor_config=self.__frozen_sensor_config)
+
+            chunk = None
+            n_steps = 0
+            try:
+                item = next(gen)
+                while True:
+                    if item is None:    # Abort point
+                        item = gen.send(self.__cancel_event.is_set())
+                        continue
+
+                    if chunk is None:
+                        chunk = {data_type: [] for data_type in item}
+                    for data_type, data in item.items():
+                        chunk[data_type].append(data)
+                    n_steps += 1
+                    with self.__status_lock:
+                        self.__sim_time = int(item["sensor_readings_time"][-1])
+
+                    if n_steps == self.__chunk_size:
+                        if self.__put_frame(self.__encode_chunk(chunk)) is True:
+                            with self.__status_lock:
+                                self.__n_chunks += 1
+                        chunk = None
+                        n_steps = 0
+
+                    item = next(gen)
+            except StopIteration:
+                pass
+
+            if chunk is not None and not self.__cancel_event.is_set():
+                if self.__put_frame(self.__encode_chunk(chunk)) is True:
+                    with self.__status_lock:
+                        self.__n_chunks += 1
+
+            if self.__stream_timed_out is True:
+                self.__set_status(JOB_STATUS_CANCELLED, "Stream timed out")
+            elif self.__cancel_event.is_set():
+                self.__set_status(JOB_STATUS_CANCELLED)
+            else:
+                self.__set_status(JOB_STATUS_FINISHED)
+        except Exception as ex:
+            warnings.warn(str(ex))
+            self.__set_status(JOB_STATUS_FAILED, str(ex))
+
+    def claim_stream(self) -> None:
+        """
+        Claims the stream of frames produced by this job -- a job can only be streamed once.
+        Does not wait for any frame.
+        """
+        if not self.__stream_claimed.acquire(blocking=False):
+            raise ValueError("Job is already streamed")
+
+    def stream_frames(self) -> Generator[bytes, None, None]:
+        """
+        Streams the frames produced by this job -- the stream must have been claimed by
+        calling :func:`claim_stream` before.
+
+        Returns
+        -------
+        `Generator[bytes]`
+            Generator yielding the binary frames.
+        """
+        if not self.__stream_claimed.locked():
+            raise RuntimeError("The stream of the job has not been claimed")
+
+        while True:
+            try:
+                frame = self.__frames.get(timeout=.5)
+            except queue.Empty:
+                if self.__done_event.is_set() or self.__cancel_event.is_set():
+                    return
+                continue
+
+            if frame is None:
+                return
+            yield frame
+
+
+class SimulationJobManager(ResourceManager):
+    """
+    Class for managing asynchronous simulation jobs, which are run in a pool of worker threads.
+
+    Note that jobs of the same scenario are run sequentially -- a job holds the lock of its
+    scenario (see :func:`~epyt_flow.rest_api.scenario.handlers.ScenarioManager.get_lock`)
+    while it is simulating. Jobs that ended are removed after `job_ttl` seconds, no matter
+    whether their results were streamed or not.
+
+    Parameters
+    ----------
+    n_workers : `int`, optional
+        Number of worker threads.
+
+        The default is 4.
+    job_ttl : `float`, optional
+        Time (in seconds) a job is kept after it ended.
+
+        The default is 3600.
+    """
+    def __init__(self, n_workers: int = 4, job_ttl: float = 3600., **kwds):
+        if not isinstance(n_workers, int) or n_workers <= 0:
+            raise ValueError("'n_workers' must be a positive integer")
+        if not isinstance(job_ttl, (float, int)) or job_ttl <= 0:
+            raise ValueError("'job_ttl' must be positive")
+
+        self.__executor = ThreadPoolExecutor(max_workers=n_workers)
+        self.__job_ttl = job_ttl
+        self.__closed_event = threading.Event()
+        self.__reaper = threading.Thread(target=self.__reap, daemon=True)
+
+        super().__init__(**kwds)
+
+        self.__reaper.start()
+
+    def __reap(self) -> None:
+        while not self.__closed_event.wait(min(self.__job_ttl, 60.)):
+            self.remove_ended_jobs()
+
+    def remove_ended_jobs(self) -> None:
+        """
+        Removes all jobs that ended more than `job_ttl` seconds ago --
+        called periodically by a background thread.
+        """
+        now = time.monotonic()
+        for job_id, job in self.get_all_items().items():
+            if job.finished_time is not None and now - job.finished_time >= self.__job_ttl:
+                try:
+                    self.remove(job_id)
+                except ValueError:  # Removed in the meantime
+                    pass
+
+    def submit(self, scenario: ScenarioSimulator, scenario_lock: threading.Lock,
+               **kwds) -> str:
+        """
+        Creates and submits a new simulation job.
+
+        Parameters
+        ----------
+        scenario : :class:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator`
+            Scenario to be simulated.
+        scenario_lock : `threading.Lock`
+            Lock guarding the scenario -- see
+            :func:`~epyt_flow.rest_api.scenario.handlers.ScenarioManager.get_lock`.
+        **kwds
+            Further arguments passed to :class:`SimulationJob`.
+
+        Returns
+        -------
+        `str`
+            UUID of the new job.
+        """
+        job = SimulationJob(scenario, scenario_lock, **kwds)
+        job_id = self.create_new_item(job)
+        self.__executor.submit(job.run)
+
+        return job_id
+
+    def close_item(self, item: SimulationJob) -> None:
+        item.cancel()
+
+    def close(self) -> None:
+        """
+        Cancels all jobs and shuts down the worker threads.
+        """
+        self.__closed_event.set()
+        for job_id in self.get_all_items():
+            try:
+                self.remove(job_id)
+            except ValueError:  # Removed in the meantime
+                pass
+        self.__executor.shutdown(wait=False)
+
+
+class SimulationJobBaseHandler(BaseHandler):
+    """
+    Base class for all handlers concerning simulation jobs.
+
+    Parameters
+    ----------
+    job_mgr : :class:`~epyt_flow.rest_api.simulation_jobs.handlers.SimulationJobManager`
+        Simulation job manager.
+    """
+    def __init__(self, job_mgr: SimulationJobManager):
+        self.job_mgr = job_mgr
+
+
+class SimulationJobHandler(SimulationJobBaseHandler):
+    """
+    Class for handling GET and DELETE requests concerning a given simulation job.
+    """
+    def on_get(self, _, resp: falcon.Response, job_id: str) -> None:
+        """
+        Gets the status of a given simulation job.
+
+        Parameters
+        ----------
+        resp : `falcon.Response`
+            Response instance.
+        job_id : `str`
+            UUID of the simulation job.
+        """
+        try:
+            if self.job_mgr.validate_uuid(job_id) is False:
+                self.send_invalid_resource_id_error(resp)
+                return
+
+            self.send_json_response(resp, self.job_mgr.get(job_id).get_status())
+        except Exception as ex:
+            warnings.warn(str(ex))
+            resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
+
+    def on_delete(self, _, resp: falcon.Response, job_id: str) -> None:
+        """
+        Cancels and removes a given simulation job.
+
+        Parameters
+        ----------
+        resp : `falcon.Response`
+            Response instance.
+        job_id : `str`
+            UUID of the simulation job.
+        """
+        try:
+            if self.job_mgr.validate_uuid(job_id) is False:
+                self.send_invalid_resource_id_error(resp)
+                return
+
+            self.job_mgr.remove(job_id)
+        except Exception as ex:
+            warnings.warn(str(ex))
+            resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
+
+
+class SimulationJobStreamHandler(SimulationJobBaseHandler):
+    """
+    Class for handling GET requests for streaming the results of a given simulation job.
+    """
+    def on_get(self, _, resp: falcon.Response, job_id: str) -> None:
+        """
+        Streams the results of a given simulation job as a sequence of binary frames --
+        see :func:`~epyt_flow.rest_api.simulation_jobs.handlers.encode_frame`
+        for the format of a frame.
+
+        Parameters
+        ----------
+        resp : `falcon.Response`
+            Response instance.
+        job_id : `str`
+            UUID of the simulation job.
+        """
+        try:
+            if self.job_mgr.validate_uuid(job_id) is False:
+                self.send_invalid_resource_id_error(resp)
+                return
+
+            job = self.job_mgr.get(job_id)
+            job.claim_stream()
+
+            resp.content_type = STREAM_CONTENT_TYPE
+            resp.status = falcon.HTTP_200
+            resp.stream = job.stream_frames()
+        except ValueError as ex:
+            self.send_error(resp, str(ex))
+        except Exception as ex:
+            warnings.warn(str(ex))
+            resp.status = falcon.HTTP_INTERNAL_SERVER_ERROR
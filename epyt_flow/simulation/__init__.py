@@ -3,3 +3,11 @@ from .sensor_config import *
 from .scenario_simulator import *
 from .scenario_visualizer import *
 from .parallel_simulation import *
+from .tracing import *
+from .memory_model import *
+from .sensor_placement import *
+from .demand_synthesis import *
+from .calibration import *
+from .pump_scheduling import *
+from .batch_simulation import *
+from .source_identification import *
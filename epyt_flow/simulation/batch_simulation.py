@@ -0,0 +1,409 @@
+"""
+Module provides a runner for simulating a large batch of scenarios (i.e. variants of a network)
+on a pool of threads inside the EPANET library.
+"""
+import ctypes
+from multiprocess import cpu_count
+import numpy as np
+
+from .scenario_config import ScenarioConfig
+from .scenario_simulator import ScenarioSimulator
+from .native_api import EN_NODE, EN_LINK, EN_PRESSURE, EN_FLOW, EN_DEMAND, EN_QUALITY, \
+    EN_LINKQUAL, EN_TANKVOLUME, EN_EMITTER, EN_DURATION, EN_REPORTSTEP, EN_REPORTSTART, \
+    call_native_function, get_node_values, run_batch
+
+
+class BatchScenario():
+    """
+    Class describing a variant (scenario) of a network that is simulated by
+    :class:`BatchSimulation` -- i.e. its time parameters and a timeline of events that
+    change properties of nodes and links at given times.
+
+    Parameters
+    ----------
+    simulation_duration : `int`, optional
+        Number of seconds to be simulated. If None, the duration of the network is used.
+
+        The default is None.
+    hydraulic_time_step : `int`, optional
+        Hydraulic time step (in seconds). If None, the time step of the network is used.
+
+        The default is None.
+    reporting_time_step : `int`, optional
+        Reporting time step (in seconds). If None, the time step of the network is used.
+
+        The default is None.
+    """
+    def __init__(self, simulation_duration: int = None, hydraulic_time_step: int = None,
+                 reporting_time_step: int = None, **kwds):
+        for name, value in [("simulation_duration", simulation_duration),
+                            ("hydraulic_time_step", hydraulic_time_step),
+                            ("reporting_time_step", reporting_time_step)]:
+            if value is not None:
+                if not isinstance(value, int):
+                    raise TypeError(f"'{name}' must be an instance of 'int' " +
+                                    f"but not of '{type(value)}'")
+                if value <= 0:
+                    raise ValueError(f"'{name}' must be positive")
+
+        self.__simulation_duration = simulation_duration
+        self.__hydraulic_time_step = hydraulic_time_step
+        self.__reporting_time_step = reporting_time_step
+        self.__events = []
+        self.__leakages = []
+
+        super().__init__(**kwds)
+
+    @property
+    def simulation_duration(self) -> int:
+        """
+        Gets the number of seconds to be simulated.
+
+        Returns
+        -------
+        `int`
+            Simulation duration -- None if the duration of the network is used.
+        """
+        return self.__simulation_duration
+
+    @property
+    def hydraulic_time_step(self) -> int:
+        """
+        Gets the hydraulic time step (in seconds).
+
+        Returns
+        -------
+        `int`
+            Hydraulic time step -- None if the time step of the network is used.
+        """
+        return self.__hydraulic_time_step
+
+    @property
+    def reporting_time_step(self) -> int:
+        """
+        Gets the reporting time step (in seconds).
+
+        Returns
+        -------
+        `int`
+            Reporting time step -- None if the time step of the network is used.
+        """
+        return self.__reporting_time_step
+
+    @property
+    def events(self) -> list[tuple[int, str, str, int, float]]:
+        """
+        Gets all events -- i.e. time, object type, object ID, property, and value.
+
+        Returns
+        -------
+        `list[tuple[int, str, str, int, float]]`
+            Events.
+        """
+        return list(self.__events)
+
+    @property
+    def leakages(self) -> list[tuple[str, float, int, int]]:
+        """
+        Gets all leakages -- i.e. node ID, emitter coefficient, start and end time.
+
+        Returns
+        -------
+        `list[tuple[str, float, int, int]]`
+            Leakages.
+        """
+        return list(self.__leakages)
+
+    def add_event(self, time: int, object_type: str, object_id: str, property: int,
+                  value: float) -> None:
+        """
+        Adds an event that sets a property of a node or link at a given time -- the
+        property keeps its value until it is changed by another event.
+
+        Parameters
+        ----------
+        time : `int`
+            Time (in seconds) of the event.
+        object_type : `str`
+            Type of the object -- either "node" or "link".
+        object_id : `str`
+            ID of the node or link.
+        property : `int`
+            Property code (see EN_NodeProperty & EN_LinkProperty in EPANET) --
+            e.g. :attr:`~epyt_flow.simulation.native_api.EN_STATUS`.
+        value : `float`
+            New value of the property.
+        """
+        if not isinstance(time, int):
+            raise TypeError(f"'time' must be an instance of 'int' but not of '{type(time)}'")
+        if time < 0:
+            raise ValueError("'time' can not be negative")
+        if object_type not in ("node", "link"):
+            raise ValueError("'object_type' must be either 'node' or 'link'")
+        if not isinstance(object_id, str):
+            raise TypeError("'object_id' must be an instance of 'str' " +
+                            f"but not of '{type(object_id)}'")
+        if not isinstance(property, int):
+            raise TypeError("'property' must be an instance of 'int' " +
+                            f"but not of '{type(property)}'")
+        if not isinstance(value, (float, int)):
+            raise TypeError("'value' must be an instance of 'float' " +
+                            f"but not of '{type(value)}'")
+
+        self.__events.append((time, object_type, object_id, property, float(value)))
+
+    def add_leakage(self, node_id: str, emitter_coeff: float, start_time: int,
+                    end_time: int = None) -> None:
+        """
+        Adds a leakage -- i.e. an emitter that is added to a node for a given period of time.
+
+        Parameters
+        ----------
+        node_id : `str`
+            ID of the leaking node.
+        emitter_coeff : `float`
+            Emitter coefficient of the leakage -- it is added to the emitter coefficient
+            of the node (incl. the emitter coefficients of all other leakages of the node
+            that are active at the same time).
+        start_time : `int`
+            Time (in seconds) at which the leakage starts.
+        end_time : `int`, optional
+            Time (in seconds) at which the leakage ends. If None, it lasts until the end
+            of the simulation.
+
+            The default is None.
+        """
+        if not isinstance(node_id, str):
+            raise TypeError("'node_id' must be an instance of 'str' " +
+                            f"but not of '{type(node_id)}'")
+        if not isinstance(emitter_coeff, (float, int)):
+            raise TypeError("'emitter_coeff' must be an instance of 'float' " +
+                            f"but not of '{type(emitter_coeff)}'")
+        if emitter_coeff <= 0:
+            raise ValueError("'emitter_coeff' must be positive")
+        if not isinstance(start_time, int):
+            raise TypeError("'start_time' must be an instance of 'int' " +
+                            f"but not of '{type(start_time)}'")
+        if start_time < 0:
+            raise ValueError("'start_time' can not be negative")
+        if end_time is not None:
+            if not isinstance(end_time, int):
+                raise TypeError("'end_time' must be an instance of 'int' " +
+                                f"but not of '{type(end_time)}'")
+            if end_time <= start_time:
+                raise ValueError("'end_time' must be greater than 'start_time'")
+
+        self.__leakages.append((node_id, float(emitter_coeff), start_time, end_time))
+
+
+class BatchSimulation():
+    """
+    Class for simulating a large batch of scenarios (i.e. variants of a network, see
+    :class:`BatchScenario`) -- e.g. for generating training data or for Monte-Carlo studies.
+
+    The whole batch is handed to the EPANET library by a single call: the scenarios are
+    simulated on a pool of threads, each of which loads its own copy of the network
+    and simulates one scenario after the other. The Python interpreter lock is not held
+    while the batch is simulated, and the sensor readings of all scenarios are written
+    to a single NumPy array.
+
+    Note that only the network (incl. its EPANET controls and rules) and the event timelines
+    of the scenarios are simulated -- events, control modules, and uncertainties of the
+    scenario configuration run in Python and are therefore ignored.
+    EPANET-MSX scenarios are not supported.
+
+    Parameters
+    ----------
+    scenario_config : :class:`~epyt_flow.simulation.scenario_config.ScenarioConfig`
+        Configuration of the scenario (i.e. network).
+    sensors : `list[tuple[str, str, int]]`, optional
+        Sensors -- i.e. object type ("node" or "link"), object ID, and property code
+        (see EN_NodeProperty & EN_LinkProperty in EPANET) of each sensor.
+        If None, the pressure, flow, demand, node quality, link quality,
+        and tank volume sensors of the sensor configuration are used (in this order).
+
+        The default is None.
+    n_threads : `int`, optional
+        Number of threads. If -1, the number of threads is equal to the number of CPUs.
+
+        The default is -1.
+    """
+    def __init__(self, scenario_config: ScenarioConfig,
+                 sensors: list[tuple[str, str, int]] = None, n_threads: int = -1, **kwds):
+        if not isinstance(scenario_config, ScenarioConfig):
+            raise TypeError("'scenario_config' must be an instance of " +
+                            "'epyt_flow.simulation.ScenarioConfig' but not of " +
+                            f"'{type(scenario_config)}'")
+        if scenario_config.f_msx_in is not None:
+            raise ValueError("Scenarios with an .msx file are not supported")
+        if sensors is not None:
+            if not isinstance(sensors, list):
+                raise TypeError("'sensors' must be an instance of 'list[tuple[str, str, int]]' " +
+                                f"but not of '{type(sensors)}'")
+        if not isinstance(n_threads, int):
+            raise TypeError("'n_threads' must be an instance of 'int' " +
+                            f"but not of '{type(n_threads)}'")
+        if not (n_threads == -1 or n_threads > 0):
+            raise ValueError("'n_threads' must be either -1 or a positive integer")
+
+        self.__n_threads = cpu_count() if n_threads == -1 else n_threads
+        self.__sim = ScenarioSimulator(scenario_config=scenario_config)
+
+        super().__init__(**kwds)
+
+        try:
+            sensor_config = self.__sim.sensor_config
+            if sensors is None:
+                sensors = [("node", node_id, EN_PRESSURE)
+                           for node_id in sensor_config.pressure_sensors] + \
+                    [("link", link_id, EN_FLOW) for link_id in sensor_config.flow_sensors] + \
+                    [("node", node_id, EN_DEMAND) for node_id in sensor_config.demand_sensors] + \
+                    [("node", node_id, EN_QUALITY)
+                     for node_id in sensor_config.quality_node_sensors] + \
+                    [("link", link_id, EN_LINKQUAL)
+                     for link_id in sensor_config.quality_link_sensors] + \
+                    [("node", node_id, EN_TANKVOLUME)
+                     for node_id in sensor_config.tank_volume_sensors]
+            self.__sensors = list(sensors)
+            self.__sensor_targets = np.array([self.__map_target(object_type, object_id, property)
+                                              for object_type, object_id, property in sensors],
+                                             dtype=int).reshape(-1, 3)
+        except Exception:
+            self.close()
+            raise
+
+    def __map_target(self, object_type: str, object_id: str, property: int) -> tuple[int, int, int]:
+        sensor_config = self.__sim.sensor_config
+        if object_type == "node":
+            return EN_NODE, sensor_config.map_node_id_to_idx(object_id), property
+        if object_type == "link":
+            return EN_LINK, sensor_config.map_link_id_to_idx(object_id), property
+        raise ValueError(f"Unknown object type '{object_type}' -- " +
+                         "must be either 'node' or 'link'")
+
+    def __get_time_param(self, param: int) -> int:
+        value = ctypes.c_long()
+        call_native_function(self.__sim.epanet_api, "gettimeparam", ctypes.c_int(param),
+                             ctypes.byref(value))
+        return value.value
+
+    @property
+    def sensors(self) -> list[tuple[str, str, int]]:
+        """
+        Gets the sensors -- i.e. the order of the last axis of the sensor readings.
+
+        Returns
+        -------
+        `list[tuple[str, str, int]]`
+            Object type, object ID, and property code of each sensor.
+        """
+        return list(self.__sensors)
+
+    @property
+    def n_threads(self) -> int:
+        """
+        Gets the number of threads.
+
+        Returns
+        -------
+        `int`
+            Number of threads.
+        """
+        return self.__n_threads
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self) -> None:
+        """
+        Unloads the network.
+        """
+        if self.__sim is not None:
+            self.__sim.close()
+            self.__sim = None
+
+    def run(self, scenarios: list[BatchScenario]) -> np.ndarray:
+        """
+        Simulates a batch of scenarios.
+
+        Parameters
+        ----------
+        scenarios : list[:class:`BatchScenario`]
+            Scenarios.
+
+        Returns
+        -------
+        `numpy.ndarray`
+            Sensor readings (see :attr:`sensors`) of shape (number of scenarios,
+            number of reporting periods, number of sensors) -- periods that are
+            not simulated (i.e. beyond the duration of a scenario) are NaN.
+        """
+        if self.__sim is None:
+            raise RuntimeError("The batch simulation has already been closed")
+        if not isinstance(scenarios, list) or \
+                any(not isinstance(s, BatchScenario) for s in scenarios):
+            raise TypeError("'scenarios' must be an instance of " +
+                            "'list[epyt_flow.simulation.BatchScenario]'")
+        if len(scenarios) == 0:
+            raise ValueError("'scenarios' must not be empty")
+
+        duration = self.__get_time_param(EN_DURATION)
+        reporting_step = self.__get_time_param(EN_REPORTSTEP)
+        reporting_start = self.__get_time_param(EN_REPORTSTART)
+
+        # Leakages are turned into events that change the emitter coefficient of their node
+        leaky_nodes = sorted({node_id for s in scenarios for node_id, _, _, _ in s.leakages})
+        emitter_coeffs = {}
+        if len(leaky_nodes) != 0:
+            emitter_coeffs = dict(zip(leaky_nodes, get_node_values(
+                self.__sim.epanet_api, EN_EMITTER,
+                np.array([self.__sim.sensor_config.map_node_id_to_idx(node_id)
+                          for node_id in leaky_nodes], dtype=int))))
+
+        params, event_start, event_times, event_targets, event_values = [], [0], [], [], []
+        n_periods = 0
+        for s in scenarios:
+            params.append([s.simulation_duration or 0, s.hydraulic_time_step or 0,
+                           s.reporting_time_step or 0])
+            n_periods = max(n_periods,
+                            ((s.simulation_duration or duration) - reporting_start) //
+                            (s.reporting_time_step or reporting_step) + 1)
+
+            events = s.events
+            for node_id in sorted({node_id for node_id, _, _, _ in s.leakages}):
+                leakages = [(emitter_coeff, start_time, end_time)
+                            for leaky_node_id, emitter_coeff, start_time, end_time in s.leakages
+                            if leaky_node_id == node_id]
+
+                # Overlapping leakages of the same node add up -- whenever a leakage starts or
+                # ends, the emitter coefficient is set to the sum of all active leakages
+                change_times = sorted({time for _, start_time, end_time in leakages
+                                       for time in (start_time, end_time) if time is not None})
+                for time in change_times:
+                    events.append((time, "node", node_id, EN_EMITTER,
+                                   emitter_coeffs[node_id] +
+                                   sum(emitter_coeff for emitter_coeff, start_time, end_time
+                                       in leakages if start_time <= time and
+                                       (end_time is None or time < end_time))))
+            events.sort(key=lambda event: event[0])
+
+            for time, object_type, object_id, property, value in events:
+                event_times.append(time)
+                event_targets.append(self.__map_target(object_type, object_id, property))
+                event_values.append(value)
+            event_start.append(len(event_times))
+
+        values, errcodes = run_batch(self.__sim.epanet_api, np.array(params),
+                                     np.array(event_start), np.array(event_times),
+                                     np.array(event_targets, dtype=int).reshape(-1, 3),
+                                     np.array(event_values), self.__sensor_targets,
+                                     max(n_periods, 0), self.__n_threads)
+        if np.any(errcodes > 100):
+            failed = np.flatnonzero(errcodes > 100)
+            raise RuntimeError(f"The simulation of the scenarios {failed.tolist()} failed " +
+                               f"with the error codes {errcodes[failed].tolist()}")
+
+        return values
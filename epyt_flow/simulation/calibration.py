@@ -0,0 +1,381 @@
+"""
+Module provides a harness for calibrating the pipe roughness coefficients and base demands of
+a network against observed SCADA data -- i.e. for evaluating many candidate parameter vectors
+(e.g. proposed by an optimizer) in parallel.
+"""
+from typing import Any
+import ctypes
+from multiprocess import cpu_count
+import numpy as np
+
+from .scenario_config import ScenarioConfig
+from .scenario_simulator import ScenarioSimulator
+from .worker_pool import WorkerPool
+from .scada import ScadaData
+from .native_api import EN_NODE, EN_LINK, EN_PRESSURE, EN_ROUGHNESS, EN_FLOW, \
+    get_native_function, call_native_function, has_native_function, get_node_values, \
+    get_link_values, set_link_values, set_base_demands, set_warm_start, set_observations, \
+    get_residual
+
+
+class _CalibrationWorker():
+    """
+    Loaded copy of the network that evaluates one candidate parameter vector at a time.
+    """
+    def __init__(self, scenario_config: ScenarioConfig, pressure_sensors_idx: np.ndarray,
+                 flow_sensors_idx: np.ndarray, roughness_links_idx: np.ndarray,
+                 demand_nodes_idx: np.ndarray, observed_times: np.ndarray,
+                 observed_values: np.ndarray, scales: np.ndarray, warm_start: bool):
+        self.__sim = ScenarioSimulator(scenario_config=scenario_config)
+        self.__epanet_api = self.__sim.epanet_api
+        self.__pressure_sensors_idx = pressure_sensors_idx
+        self.__flow_sensors_idx = flow_sensors_idx
+        self.__roughness_links_idx = roughness_links_idx
+
+        # Nominal roughness coefficients & base demands of all demand categories
+        self.__roughness = get_link_values(self.__epanet_api, EN_ROUGHNESS, roughness_links_idx)
+
+        n_demands, base_demand = ctypes.c_int(), ctypes.c_double()
+        demand_nodes, demand_categories, base_demands = [], [], []
+        for node_idx in demand_nodes_idx:
+            node = ctypes.c_int(int(node_idx) + 1)
+            call_native_function(self.__epanet_api, "getnumdemands", node,
+                                 ctypes.byref(n_demands))
+            for demand_idx in range(n_demands.value):
+                call_native_function(self.__epanet_api, "getbasedemand", node,
+                                     ctypes.c_int(demand_idx + 1), ctypes.byref(base_demand))
+                demand_nodes.append(node_idx)
+                demand_categories.append(demand_idx)
+                base_demands.append(base_demand.value)
+        self.__demand_nodes_idx = np.array(demand_nodes, dtype=int)
+        self.__demand_categories_idx = np.array(demand_categories, dtype=int)
+        self.__base_demands = np.array(base_demands, dtype=np.float64)
+
+        if warm_start and has_native_function(self.__epanet_api, "setwarmstart"):
+            set_warm_start(self.__epanet_api, True)
+
+        # The residuals are computed inside EPANET if supported
+        self.__in_engine = has_native_function(self.__epanet_api, "setobservations")
+        if self.__in_engine:
+            n_pressure_sensors = len(pressure_sensors_idx)
+            set_observations(self.__epanet_api,
+                             np.repeat([EN_NODE, EN_LINK],
+                                       [n_pressure_sensors, len(flow_sensors_idx)]),
+                             np.concatenate((pressure_sensors_idx, flow_sensors_idx)),
+                             np.repeat([EN_PRESSURE, EN_FLOW],
+                                       [n_pressure_sensors, len(flow_sensors_idx)]),
+                             scales, observed_times, observed_values)
+        else:
+            self.__time_to_row = {int(t): row for row, t in enumerate(observed_times)}
+            self.__observed = observed_values * scales
+            self.__scales = scales
+
+    @property
+    def demand_nodes_idx(self) -> np.ndarray:
+        return self.__demand_nodes_idx
+
+    def close(self) -> None:
+        self.__sim.close()
+
+    def evaluate(self, roughness_factors: np.ndarray,
+                 demand_factors: np.ndarray) -> tuple[float, int]:
+        set_link_values(self.__epanet_api, EN_ROUGHNESS, self.__roughness_links_idx,
+                        self.__roughness * roughness_factors)
+        set_base_demands(self.__epanet_api, self.__demand_nodes_idx,
+                         self.__demand_categories_idx, self.__base_demands * demand_factors)
+
+        run_h, handle = get_native_function(self.__epanet_api, "runH")
+        next_h, _ = get_native_function(self.__epanet_api, "nextH")
+        t, tstep = ctypes.c_long(), ctypes.c_long()
+
+        sum_squared_residuals, n_residuals = 0., 0
+        call_native_function(self.__epanet_api, "openH")
+        try:
+            call_native_function(self.__epanet_api, "initH", ctypes.c_int(0))
+            while True:
+                err = run_h(*handle, ctypes.byref(t))
+                if err > 100:
+                    raise RuntimeError(f"EPANET function 'runH' failed with error code {err}")
+
+                # Compare the sensor readings at the observed time points only
+                row = None if self.__in_engine else self.__time_to_row.get(t.value)
+                if row is not None:
+                    values = np.concatenate((get_node_values(self.__epanet_api, EN_PRESSURE,
+                                                             self.__pressure_sensors_idx),
+                                             get_link_values(self.__epanet_api, EN_FLOW,
+                                                             self.__flow_sensors_idx)))
+                    residuals = values * self.__scales - self.__observed[row]
+                    mask = np.isfinite(residuals)
+                    sum_squared_residuals += float(np.dot(residuals[mask], residuals[mask]))
+                    n_residuals += int(np.count_nonzero(mask))
+
+                err = next_h(*handle, ctypes.byref(tstep))
+                if err > 100:
+                    raise RuntimeError(f"EPANET function 'nextH' failed with error code {err}")
+                if tstep.value <= 0:
+                    break
+
+            if self.__in_engine:
+                sum_squared_residuals, n_residuals = get_residual(self.__epanet_api)
+        finally:
+            call_native_function(self.__epanet_api, "closeH")
+
+        return sum_squared_residuals, n_residuals
+
+
+class ModelCalibration():
+    """
+    Class for calibrating the pipe roughness coefficients and base demands of a network
+    against observed SCADA data -- i.e. for evaluating the objective (deviation from the
+    observed sensor readings) of many candidate parameter vectors in parallel.
+
+    A candidate parameter vector consists of one multiplicative factor per group of links
+    (applied to the nominal roughness coefficients of the links) followed by one
+    multiplicative factor per group of nodes (applied to the nominal base demands of all
+    demand categories of the nodes).
+
+    The candidates are evaluated by a pool of loaded (and warm) copies of the network that
+    are created once and re-used for all evaluations (see
+    :class:`~epyt_flow.simulation.worker_pool.WorkerPool`) -- every copy is only updated by a
+    single bulk call per parameter type. If supported by the EPANET library, the residuals
+    with respect to the observed SCADA data are computed inside EPANET and only the objective
+    is retrieved (see :func:`~epyt_flow.simulation.native_api.set_observations`) -- otherwise,
+    only the pressures and flows at the sensor locations are retrieved. The copies run in
+    threads, which simulate in parallel since the EPANET library is called without holding the
+    Python interpreter lock. If supported by the EPANET library, every copy warm starts its
+    hydraulic analysis from the previously evaluated candidate (see
+    :func:`~epyt_flow.simulation.native_api.set_warm_start`).
+
+    The objective of a candidate is the mean squared residual of all (finite) pressure and flow
+    sensor readings of the observed SCADA data -- the residuals of each sensor can be normalized
+    by the standard deviation of its observed readings.
+
+    Note that only the hydraulics of the network (incl. its EPANET controls and rules) are
+    simulated -- events, control modules, and uncertainties of the scenario are ignored.
+
+    Usage with an optimizer:
+
+    .. code-block:: python
+
+        with ModelCalibration(scenario_config, observed_scada_data,
+                              roughness_groups=[pipes_zone1, pipes_zone2],
+                              demand_groups=[junctions_dma1]) as calibration:
+            objectives = calibration.evaluate(candidates)  # one row per candidate
+
+    Parameters
+    ----------
+    scenario_config : :class:`~epyt_flow.simulation.scenario_config.ScenarioConfig`
+        Configuration of the scenario (i.e. network) that is calibrated.
+    observed_data : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData`
+        Observed SCADA data -- its pressure and flow sensors are used for the calibration.
+    roughness_groups : `list[list[str]]`, optional
+        Groups of link IDs -- the roughness coefficients of each group are scaled by a
+        common factor.
+
+        The default is an empty list.
+    demand_groups : `list[list[str]]`, optional
+        Groups of node IDs -- the base demands of each group are scaled by a common factor.
+
+        The default is an empty list.
+    n_jobs : `int`, optional
+        Number of copies of the network (i.e. candidates that are evaluated in parallel).
+        If -1, the number of copies is equal to the number of CPUs.
+
+        The default is -1.
+    normalize : `bool`, optional
+        If True, the residuals of each sensor are divided by the standard deviation of its
+        observed readings.
+
+        The default is True.
+    warm_start : `bool`, optional
+        If True, the hydraulic analysis of each candidate is warm started from the
+        previous candidate.
+
+        The default is True.
+    """
+    def __init__(self, scenario_config: ScenarioConfig, observed_data: ScadaData,
+                 roughness_groups: list[list[str]] = [], demand_groups: list[list[str]] = [],
+                 n_jobs: int = -1, normalize: bool = True, warm_start: bool = True, **kwds):
+        if not isinstance(scenario_config, ScenarioConfig):
+            raise TypeError("'scenario_config' must be an instance of " +
+                            "'epyt_flow.simulation.ScenarioConfig' but not of " +
+                            f"'{type(scenario_config)}'")
+        if scenario_config.f_msx_in is not None:
+            raise ValueError("Scenarios with an .msx file are not supported")
+        if not isinstance(observed_data, ScadaData):
+            raise TypeError("'observed_data' must be an instance of " +
+                            "'epyt_flow.simulation.ScadaData' but not of " +
+                            f"'{type(observed_data)}'")
+        if not isinstance(roughness_groups, list) or \
+                any(not isinstance(group, list) for group in roughness_groups):
+            raise TypeError("'roughness_groups' must be an instance of 'list[list[str]]'")
+        if not isinstance(demand_groups, list) or \
+                any(not isinstance(group, list) for group in demand_groups):
+            raise TypeError("'demand_groups' must be an instance of 'list[list[str]]'")
+        if len(roughness_groups) + len(demand_groups) == 0:
+            raise ValueError("At least one group of links or nodes must be given")
+        if not isinstance(n_jobs, int):
+            raise TypeError(f"'n_jobs' must be an instance of 'int' but not of '{type(n_jobs)}'")
+        if not (n_jobs == -1 or n_jobs > 0):
+            raise ValueError("'n_jobs' must be either -1 or a positive integer")
+        if not isinstance(normalize, bool):
+            raise TypeError("'normalize' must be an instance of 'bool' " +
+                            f"but not of '{type(normalize)}'")
+        if not isinstance(warm_start, bool):
+            raise TypeError("'warm_start' must be an instance of 'bool' " +
+                            f"but not of '{type(warm_start)}'")
+
+        self.__n_roughness_groups = len(roughness_groups)
+        self.__n_demand_groups = len(demand_groups)
+        self.__pool = None
+
+        super().__init__(**kwds)
+
+        n_jobs = cpu_count() if n_jobs == -1 else n_jobs
+        try:
+            self.__create_workers(scenario_config, observed_data, roughness_groups,
+                                  demand_groups, n_jobs, normalize, warm_start)
+        except Exception:
+            self.close()
+            raise
+
+    def __create_workers(self, scenario_config: ScenarioConfig, observed_data: ScadaData,
+                         roughness_groups: list[list[str]], demand_groups: list[list[str]],
+                         n_jobs: int, normalize: bool, warm_start: bool) -> None:
+        pressure_sensors = observed_data.sensor_config.pressure_sensors
+        flow_sensors = observed_data.sensor_config.flow_sensors
+        if len(pressure_sensors) + len(flow_sensors) == 0:
+            raise ValueError("'observed_data' does not contain any pressure or flow sensor")
+
+        # Map all IDs to indices & the observed readings to the units of the network
+        with ScenarioSimulator(scenario_config=scenario_config) as sim:
+            sensor_config = sim.sensor_config
+            flow_unit = sim.get_flow_units()
+
+        pressure_sensors_idx = np.array([sensor_config.map_node_id_to_idx(node_id)
+                                         for node_id in pressure_sensors], dtype=int)
+        flow_sensors_idx = np.array([sensor_config.map_link_id_to_idx(link_id)
+                                     for link_id in flow_sensors], dtype=int)
+        roughness_links_idx = np.array([sensor_config.map_link_id_to_idx(link_id)
+                                        for group in roughness_groups for link_id in group],
+                                       dtype=int)
+        roughness_group_idx = np.repeat(np.arange(len(roughness_groups)),
+                                        [len(group) for group in roughness_groups])
+        demand_nodes_idx = np.array([sensor_config.map_node_id_to_idx(node_id)
+                                     for group in demand_groups for node_id in group], dtype=int)
+        demand_group_idx = np.repeat(np.arange(len(demand_groups)),
+                                     [len(group) for group in demand_groups])
+
+        if observed_data.sensor_config.flow_unit != flow_unit:
+            observed_data = observed_data.convert_units(flow_unit=flow_unit)
+        observed_times, observed_values, scales = self.__get_observations(observed_data,
+                                                                          normalize)
+
+        self.__pool = WorkerPool(lambda: _CalibrationWorker(scenario_config, pressure_sensors_idx,
+                                                            flow_sensors_idx, roughness_links_idx,
+                                                            demand_nodes_idx, observed_times,
+                                                            observed_values, scales, warm_start),
+                                 n_jobs)
+
+        # Group of every demand category (nodes can have several demand categories)
+        node_group = dict(zip(demand_nodes_idx, demand_group_idx))
+        self.__roughness_group_idx = roughness_group_idx
+        self.__demand_group_idx = np.array([node_group[node_idx] for node_idx in
+                                            self.__pool.workers[0].demand_nodes_idx], dtype=int)
+
+    def __get_observations(self, observed_data: ScadaData,
+                           normalize: bool) -> tuple[np.ndarray, np.ndarray, np.ndarray]:
+        # Observed readings of all pressure sensors followed by all flow sensors --
+        # ordered by (unique) time points
+        times = np.asarray(observed_data.sensor_readings_time, dtype=np.int64)
+        values = np.concatenate([np.asarray(data, dtype=np.float64).reshape(len(times), -1)
+                                 for data in (observed_data.get_data_pressures(),
+                                              observed_data.get_data_flows())], axis=1)
+        times, rows = np.unique(times, return_index=True)
+        values = values[rows]
+
+        # Scaling factors of the residuals of every sensor
+        scales = np.ones(values.shape[1])
+        if normalize:
+            std = np.nanstd(values, axis=0)
+            scales[std > 0] = 1. / std[std > 0]
+
+        return times, values, scales
+
+    @property
+    def n_parameters(self) -> int:
+        """
+        Gets the number of parameters -- i.e. the length of a candidate parameter vector.
+
+        Returns
+        -------
+        `int`
+            Number of roughness groups plus number of demand groups.
+        """
+        return self.__n_roughness_groups + self.__n_demand_groups
+
+    @property
+    def n_jobs(self) -> int:
+        """
+        Gets the number of copies of the network -- i.e. the number of candidates that are
+        evaluated in parallel.
+
+        Returns
+        -------
+        `int`
+            Number of copies.
+        """
+        return len(self.__pool.workers)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self) -> None:
+        """
+        Unloads all copies of the network.
+        """
+        if self.__pool is not None:
+            self.__pool.close()
+            self.__pool = None
+
+    def __evaluate(self, worker: _CalibrationWorker, candidate: np.ndarray) -> float:
+        sum_squared_residuals, n_residuals = \
+            worker.evaluate(candidate[:self.__n_roughness_groups][self.__roughness_group_idx],
+                            candidate[self.__n_roughness_groups:][self.__demand_group_idx])
+
+        if n_residuals == 0:
+            raise ValueError("The simulation does not cover any time point of 'observed_data'")
+
+        return sum_squared_residuals / n_residuals
+
+    def evaluate(self, candidates: Any) -> np.ndarray:
+        """
+        Evaluates a set of candidate parameter vectors in parallel.
+
+        Parameters
+        ----------
+        candidates : `numpy.ndarray`
+            Candidate parameter vectors -- rows correspond to candidates and columns to
+            parameters (see :attr:`n_parameters`). A single candidate can also be passed as a
+            one-dimensional array.
+
+        Returns
+        -------
+        `numpy.ndarray`
+            Objective (i.e. mean squared residual) of each candidate.
+        """
+        if self.__pool is None:
+            raise RuntimeError("The calibration has already been closed")
+
+        candidates = np.asarray(candidates, dtype=np.float64)
+        if candidates.ndim == 1:
+            candidates = candidates.reshape(1, -1)
+        if candidates.ndim != 2 or candidates.shape[1] != self.n_parameters:
+            raise ValueError(f"'candidates' must have {self.n_parameters} columns")
+        if np.any(candidates <= 0):
+            raise ValueError("All parameters (i.e. multiplicative factors) must be positive")
+
+        return np.array(self.__pool.map(self.__evaluate, candidates))
@@ -0,0 +1,168 @@
+"""
+Module provides functions for synthesizing the demand patterns of many nodes at once --
+all patterns are computed in a single vectorized pass from shared basis matrices, while every
+node gets its own random number generator (derived from a single seed). The synthesized
+patterns can be uploaded to EPANET all at once by
+:func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.set_node_demand_patterns`.
+"""
+import numpy as np
+
+
+def fourier_basis(n_time_steps: int, period: float, n_coefficients: int) -> np.ndarray:
+    """
+    Creates the design matrix of a Fourier series -- i.e. the columns
+    [1, sin(w*k), cos(w*k), sin(2*w*k), cos(2*w*k), ...] with w = 2*pi/period
+    and k = 1, ..., n_time_steps.
+
+    Parameters
+    ----------
+    n_time_steps : `int`
+        Number of time steps (rows).
+    period : `float`
+        Period (in time steps) of the fundamental frequency.
+    n_coefficients : `int`
+        Number of harmonics -- the basis has 2 * n_coefficients + 1 columns.
+
+    Returns
+    -------
+    `numpy.ndarray`
+        Design matrix -- rows correspond to time steps and columns to basis functions.
+    """
+    if not isinstance(n_time_steps, int):
+        raise TypeError("'n_time_steps' must be an instance of 'int' " +
+                        f"but not of '{type(n_time_steps)}'")
+    if n_time_steps <= 0:
+        raise ValueError("'n_time_steps' must be positive")
+    if not isinstance(period, (float, int)):
+        raise TypeError("'period' must be an instance of 'float' " +
+                        f"but not of '{type(period)}'")
+    if period <= 0:
+        raise ValueError("'period' must be positive")
+    if not isinstance(n_coefficients, int):
+        raise TypeError("'n_coefficients' must be an instance of 'int' " +
+                        f"but not of '{type(n_coefficients)}'")
+    if n_coefficients < 0:
+        raise ValueError("'n_coefficients' can not be negative")
+
+    k = np.arange(1, n_time_steps + 1, dtype=np.float64)
+    phase = np.outer(k, np.arange(1, n_coefficients + 1) * (2 * np.pi / period))
+
+    basis = np.empty((n_time_steps, 2 * n_coefficients + 1))
+    basis[:, 0] = 1.
+    basis[:, 1::2] = np.sin(phase)
+    basis[:, 2::2] = np.cos(phase)
+
+    return basis
+
+
+def create_node_rngs(n_nodes: int, seed: int = None) -> list[np.random.Generator]:
+    """
+    Creates an independent random number generator for each node -- the random numbers of a
+    node only depend on the seed and the node's position, but not on the number of nodes.
+
+    Parameters
+    ----------
+    n_nodes : `int`
+        Number of nodes.
+    seed : `int`, optional
+        Seed of all random number generators. If None, fresh entropy is used.
+
+        The default is None.
+
+    Returns
+    -------
+    `list[numpy.random.Generator]`
+        Random number generator of each node.
+    """
+    if not isinstance(n_nodes, int):
+        raise TypeError("'n_nodes' must be an instance of 'int' " +
+                        f"but not of '{type(n_nodes)}'")
+    if n_nodes < 0:
+        raise ValueError("'n_nodes' can not be negative")
+
+    return [np.random.default_rng(s) for s in np.random.SeedSequence(seed).spawn(n_nodes)]
+
+
+def synthesize_leakdb_demands(n_nodes: int, week_coefficients: np.ndarray,
+                              year_coefficients: np.ndarray, n_time_steps: int = 48 * 365,
+                              time_steps_per_day: int = 48, seed: int = None) -> np.ndarray:
+    """
+    Synthesizes demand patterns as in the `LeakDB <https://github.com/KIOS-Research/LeakDB>`_
+    dataset generator -- i.e. the product of a yearly and a weekly Fourier series
+    (whose coefficients are randomly perturbed by up to 10% for every node) and
+    Gaussian noise:
+
+    demand = (yearly + 1) * (weekly * variation + 1) * (noise + 1)
+
+    The Fourier bases are shared by all nodes, and the patterns of all nodes are
+    computed by a single matrix product per component.
+
+    Parameters
+    ----------
+    n_nodes : `int`
+        Number of nodes (patterns).
+    week_coefficients : `numpy.ndarray`
+        Coefficients of the weekly Fourier series (see :func:`fourier_basis`) --
+        i.e. 2 * (number of harmonics) + 1 values.
+    year_coefficients : `numpy.ndarray`
+        Coefficients of the yearly Fourier series (see :func:`fourier_basis`) --
+        i.e. 2 * (number of harmonics) + 1 values.
+    n_time_steps : `int`, optional
+        Length of the patterns.
+
+        The default is one year of 30min time steps.
+    time_steps_per_day : `int`, optional
+        Number of time steps per day -- determines the periods of the weekly and the
+        yearly Fourier series.
+
+        The default is 48 (i.e. 30min time steps).
+    seed : `int`, optional
+        Seed of the random number generators of the nodes (see :func:`create_node_rngs`).
+
+        The default is None.
+
+    Returns
+    -------
+    `numpy.ndarray`
+        Demand patterns -- rows correspond to nodes and columns to time steps.
+    """
+    week_coefficients = np.asarray(week_coefficients, dtype=np.float64).flatten()
+    year_coefficients = np.asarray(year_coefficients, dtype=np.float64).flatten()
+    if len(week_coefficients) % 2 != 1 or len(year_coefficients) % 2 != 1:
+        raise ValueError("The number of Fourier coefficients must be odd")
+    if not isinstance(time_steps_per_day, int):
+        raise TypeError("'time_steps_per_day' must be an instance of 'int' " +
+                        f"but not of '{type(time_steps_per_day)}'")
+    if time_steps_per_day <= 0:
+        raise ValueError("'time_steps_per_day' must be positive")
+
+    h_year = fourier_basis(n_time_steps, time_steps_per_day * 365,
+                           len(year_coefficients) // 2)
+    h_week = fourier_basis(n_time_steps, time_steps_per_day * 7,
+                           len(week_coefficients) // 2)
+
+    # Random numbers of every node -- drawn in the same order as by the LeakDB generator
+    unc_year, unc_week, unc_random = .1, .1, .05
+    a_year = np.empty((n_nodes, len(year_coefficients)))
+    a_week = np.empty((n_nodes, len(week_coefficients)))
+    variation = np.empty((n_nodes, 1))
+    noise = np.empty((n_nodes, n_time_steps))
+    for i, rng in enumerate(create_node_rngs(n_nodes, seed)):
+        a_year[i] = year_coefficients * (1 - unc_year + 2 * unc_year *
+                                         rng.random(len(year_coefficients)))
+        a_week[i] = week_coefficients * (1 - unc_week + 2 * unc_week *
+                                         rng.random(len(week_coefficients)))
+        noise[i] = rng.normal(0, unc_random, n_time_steps)
+        variation[i] = .75 + rng.normal(0, .07)
+
+    # Evaluate all Fourier series at once and combine the components in place
+    demands = a_year @ h_year.T
+    demands += 1.
+    week = a_week @ h_week.T
+    week *= variation
+    week += 1.
+    demands *= week
+    noise += 1.
+    demands *= noise
+
+    return demands
@@ -0,0 +1,220 @@
+"""
+Module provides a model for predicting the memory consumption of scenario simulations
+from the memory that is allocated by EPANET and EPANET-MSX
+(see :func:`~epyt_flow.simulation.native_api.get_memory_usage`).
+"""
+import numpy as np
+from scipy.optimize import nnls
+
+
+# Features of the memory model -- all of them are given in bytes
+MEMORY_MODEL_FEATURES = ["engine", "segments", "msx_segments", "results", "files"]
+
+
+class MemoryModel():
+    """
+    Linear model of the memory consumption (RAM and hard disk) of a scenario simulation.
+
+    The memory consumption is predicted as a weighted sum of the following features
+    (see :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.get_memory_features`):
+
+        - "engine": Memory allocated by EPANET and EPANET-MSX right after opening the solvers --
+          i.e. network, hydraulic solver (incl. the sparse matrix factor), water quality solver,
+          MSX species arrays, and the per-thread ODE solver workspaces.
+          The weight accounts for the overhead of the memory allocator.
+        - "segments": Size of a single EPANET pipe segment for every link --
+          the weight corresponds to the average number of segments per link.
+        - "msx_segments": Size of a single EPANET-MSX pipe segment for every link --
+          the weight corresponds to the average number of segments per link.
+        - "results": Size of all simulation results --
+          the weight corresponds to the number of copies that exist at the same time
+          (e.g. when collecting and concatenating the results of all time steps).
+        - "files": Size of the hydraulics and output files on the hard disk.
+
+    The default weights were derived as follows:
+
+        - "engine": Ratio of the heap growth of the process to the
+          memory reported by the engine after opening the solvers -- 1.15 and 1.18 for
+          synthetic networks with 10^4 and 10^5 junctions.
+        - "segments": Peak number of pipe segments per link in water age simulations
+          of these networks -- 5.6 and 2.9.
+        - "msx_segments": Peak number of EPANET-MSX pipe segments per link in simulations of
+          these networks with a chlorine decay model -- approx. 101.
+        - "results": Not measured but derived from the code: the results of all time steps
+          (1 copy), the sensor readings that are computed from them (up to 1 copy if every
+          node and link is a sensor), and the concatenation of the largest data type
+          (approx. 0.5 copies).
+        - "files": The files are written once, i.e. their size is used as is.
+
+    The default process overhead is the peak resident set size of a Python 3.11 process after
+    importing EPyT-Flow (approx. 170 MB) -- it varies with the Python version and the
+    installed packages.
+
+    Parameters
+    ----------
+    coefficients : `dict[str, float]`, optional
+        Weight of each feature (see `MEMORY_MODEL_FEATURES`) -- missing features are set to
+        their default weight.
+
+        The default is None.
+    process_overhead : `float`, optional
+        Memory (in MB) that is needed by every (worker) process, regardless of the scenario --
+        i.e. the Python interpreter and all loaded modules and libraries.
+
+        The default is 170 MB.
+    """
+    DEFAULT_COEFFICIENTS = {"engine": 1.15, "segments": 4., "msx_segments": 100.,
+                            "results": 2.5, "files": 1.}
+
+    def __init__(self, coefficients: dict[str, float] = None, process_overhead: float = 170.,
+                 **kwds):
+        if coefficients is not None:
+            if not isinstance(coefficients, dict):
+                raise TypeError("'coefficients' must be an instance of 'dict[str, float]' " +
+                                f"but not of '{type(coefficients)}'")
+            if any(feature not in MEMORY_MODEL_FEATURES for feature in coefficients):
+                raise ValueError("Unknown feature in 'coefficients' -- " +
+                                 f"valid features are: {MEMORY_MODEL_FEATURES}")
+            if any(coefficient < 0 for coefficient in coefficients.values()):
+                raise ValueError("All coefficients must be non-negative")
+        if not isinstance(process_overhead, (float, int)):
+            raise TypeError("'process_overhead' must be an instance of 'float' " +
+                            f"but not of '{type(process_overhead)}'")
+        if process_overhead < 0:
+            raise ValueError("'process_overhead' can not be negative")
+
+        self.__coefficients = dict(MemoryModel.DEFAULT_COEFFICIENTS)
+        if coefficients is not None:
+            self.__coefficients.update(coefficients)
+        self.__process_overhead = float(process_overhead)
+
+        super().__init__(**kwds)
+
+    @property
+    def coefficients(self) -> dict[str, float]:
+        """
+        Gets the weight of each feature.
+
+        Returns
+        -------
+        `dict[str, float]`
+            Weight of each feature.
+        """
+        return dict(self.__coefficients)
+
+    @property
+    def process_overhead(self) -> float:
+        """
+        Gets the memory (in MB) that is needed by every (worker) process.
+
+        Returns
+        -------
+        `float`
+            Memory in MB.
+        """
+        return self.__process_overhead
+
+    def predict(self, features: dict[str, float]) -> float:
+        """
+        Predicts the memory consumption of a scenario simulation.
+
+        Parameters
+        ----------
+        features : `dict[str, float]`
+            Features (in bytes) of the scenario -- see
+            :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.get_memory_features`.
+
+        Returns
+        -------
+        `float`
+            Predicted memory consumption in MB (excl. the process overhead).
+        """
+        if not isinstance(features, dict):
+            raise TypeError("'features' must be an instance of 'dict[str, float]' " +
+                            f"but not of '{type(features)}'")
+
+        return sum(self.__coefficients[feature] * float(features.get(feature, 0.))
+                   for feature in MEMORY_MODEL_FEATURES) * .000001
+
+    def calibrate(self, features: list[dict[str, float]], memory_consumption: list[float],
+                  fit_process_overhead: bool = False) -> None:
+        """
+        Fits the (non-negative) weights of the features to measured memory consumptions --
+        e.g. the increase of the peak resident set size when running a scenario simulation
+        plus the size of the written files.
+
+        Parameters
+        ----------
+        features : `list[dict[str, float]]`
+            Features (in bytes) of each measured scenario.
+        memory_consumption : `list[float]`
+            Measured memory consumption (in MB) of each scenario.
+        fit_process_overhead : `bool`, optional
+            If True, the process overhead is fitted as well -- in this case, the measurements
+            must contain the memory of the entire process (e.g. its peak resident set size).
+
+            The default is False.
+        """
+        if not isinstance(features, list) or any(not isinstance(f, dict) for f in features):
+            raise TypeError("'features' must be an instance of 'list[dict[str, float]]'")
+        if not isinstance(memory_consumption, list):
+            raise TypeError("'memory_consumption' must be an instance of 'list[float]' " +
+                            f"but not of '{type(memory_consumption)}'")
+        if len(features) != len(memory_consumption):
+            raise ValueError("'features' and 'memory_consumption' must have the same length")
+        if len(features) == 0:
+            raise ValueError("At least one measurement is needed")
+
+        # Features that are zero in all measurements can not be fitted -- keep their weights
+        active_features = [feature for feature in MEMORY_MODEL_FEATURES
+                           if any(f.get(feature, 0.) != 0 for f in features)]
+
+        A = np.array([[f.get(feature, 0.) * .000001 for feature in active_features]
+                      for f in features]).reshape(len(features), -1)
+        if fit_process_overhead is True:
+            A = np.concatenate((A, np.ones((len(features), 1))), axis=1)
+        b = np.array(memory_consumption, dtype=np.float64)
+
+        weights, _ = nnls(A, b)
+        for feature, weight in zip(active_features, weights):
+            self.__coefficients[feature] = float(weight)
+        if fit_process_overhead is True:
+            self.__process_overhead = float(weights[-1])
+
+
+_memory_model = MemoryModel()
+
+
+def get_memory_model() -> MemoryModel:
+    """
+    Gets the memory model that is used for estimating the memory consumption of
+    scenario simulations -- e.g. by
+    :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.estimate_memory_consumption`
+    and :class:`~epyt_flow.simulation.parallel_simulation.ParallelScenarioSimulation`.
+
+    Returns
+    -------
+    :class:`~epyt_flow.simulation.memory_model.MemoryModel`
+        Memory model.
+    """
+    return _memory_model
+
+
+def set_memory_model(memory_model: MemoryModel) -> None:
+    """
+    Sets the memory model that is used for estimating the memory consumption of
+    scenario simulations -- e.g. a model that was calibrated on this machine.
+
+    Parameters
+    ----------
+    memory_model : :class:`~epyt_flow.simulation.memory_model.MemoryModel`
+        Memory model.
+    """
+    global _memory_model
+
+    if not isinstance(memory_model, MemoryModel):
+        raise TypeError("'memory_model' must be an instance of " +
+                        "'epyt_flow.simulation.memory_model.MemoryModel' but not of " +
+                        f"'{type(memory_model)}'")
+
+    _memory_model = memory_model
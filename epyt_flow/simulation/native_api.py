@@ -0,0 +1,1129 @@
+"""
+Module provides functions for calling extensions of the EPANET and EPANET-MSX libraries
+that are shipped (and compiled) with EPyT-Flow but are not wrapped by EPyT.
+"""
+from typing import Any, Iterator
+from contextlib import contextmanager
+import ctypes
+import warnings
+import numpy as np
+from epyt import epanet
+
+
+def get_native_function(epanet_api: epanet, func_name: str) -> tuple[Any, tuple]:
+    """
+    Gets a function of the EPANET library used by a given EPyT instance.
+
+    Depending on whether the project handle based (thread-safe) API is used or not,
+    either the function 'EN_<func_name>' or the legacy function 'EN<func_name>' is returned.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    func_name : `str`
+        Name of the function without the 'EN_' or 'EN' prefix -- e.g. 'getadjacency'.
+
+    Returns
+    -------
+    `tuple[Any, tuple]`
+        The ctypes function and the leading arguments (i.e. the project handle,
+        if required) that have to be passed to it.
+    """
+    api = epanet_api.api
+    if getattr(api, "_ph", None) is not None:
+        f, args = getattr(api._lib, f"EN_{func_name}", None), (api._ph,)
+    else:
+        f, args = getattr(api._lib, f"EN{func_name}", None), ()
+
+    if f is None:
+        raise RuntimeError(f"The loaded EPANET library does not provide '{func_name}' -- " +
+                           "please make sure that the EPANET library shipped with EPyT-Flow " +
+                           "was compiled successfully")
+
+    return f, args
+
+
+def has_native_function(epanet_api: epanet, func_name: str) -> bool:
+    """
+    Checks if the EPANET library used by a given EPyT instance provides a given function.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    func_name : `str`
+        Name of the function without the 'EN_' or 'EN' prefix.
+
+    Returns
+    -------
+    `bool`
+        True if the function is available, False otherwise.
+    """
+    try:
+        get_native_function(epanet_api, func_name)
+        return True
+    except RuntimeError:
+        return False
+
+
+def call_native_function(epanet_api: epanet, func_name: str, *args) -> int:
+    """
+    Calls a function of the EPANET library used by a given EPyT instance.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    func_name : `str`
+        Name of the function without the 'EN_' or 'EN' prefix.
+    *args
+        Arguments passed to the function (excl. the project handle).
+
+    Returns
+    -------
+    `int`
+        Error code -- warnings (i.e. codes <= 100) are passed through, errors raise an exception.
+    """
+    f, handle = get_native_function(epanet_api, func_name)
+
+    err = f(*handle, *args)
+    if err > 100:
+        raise RuntimeError(f"EPANET function '{func_name}' failed with error code {err}")
+
+    return err
+
+
+def as_pointer(arr: np.ndarray, ctype: Any) -> Any:
+    """
+    Gets a ctypes pointer to the data of a given (contiguous) numpy array.
+
+    Parameters
+    ----------
+    arr : `numpy.ndarray`
+        Array.
+    ctype : `Any`
+        ctypes type of the array elements -- e.g. `ctypes.c_int`.
+
+    Returns
+    -------
+    `Any`
+        ctypes pointer.
+    """
+    if not arr.flags["C_CONTIGUOUS"]:
+        raise ValueError("'arr' must be C-contiguous")
+
+    return arr.ctypes.data_as(ctypes.POINTER(ctype))
+
+
+def get_adjacency(epanet_api: epanet) -> tuple[np.ndarray, np.ndarray, np.ndarray]:
+    """
+    Gets the node adjacency of the network in compressed sparse row (CSR) format,
+    as computed by EPANET.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+
+    Returns
+    -------
+    `tuple[numpy.ndarray, numpy.ndarray, numpy.ndarray]`
+        Row pointers (number of nodes + 1), indices of neighboring nodes, and indices of the
+        connecting links (each 2 * number of links) -- all indices start from 0.
+    """
+    n_nodes = epanet_api.getNodeCount()
+    n_links = epanet_api.getLinkCount()
+
+    row_ptr = np.zeros(n_nodes + 1, dtype=np.intc)
+    col_idx = np.zeros(2 * n_links, dtype=np.intc)
+    link_idx = np.zeros(2 * n_links, dtype=np.intc)
+
+    call_native_function(epanet_api, "getadjacency",
+                         as_pointer(row_ptr, ctypes.c_int), as_pointer(col_idx, ctypes.c_int),
+                         as_pointer(link_idx, ctypes.c_int))
+
+    return row_ptr, col_idx, link_idx
+
+
+def get_leak_signatures(epanet_api: epanet, nodes_idx: np.ndarray, emitter_coeffs: np.ndarray,
+                        sensors_idx: np.ndarray, n_threads: int = 1) -> np.ndarray:
+    """
+    Computes the pressure drops at a set of sensor nodes that are caused by candidate leaks,
+    relative to the current hydraulic solution -- i.e. this function must be called while
+    the hydraulic solver is running (e.g. after each step of a simulation).
+
+    Each candidate leak is modelled as an emitter at its junction. Starting from the current
+    solution, EPANET re-solves the network equations of each candidate (with the status of
+    all links, tank levels, and demands being fixed) -- the candidates are distributed over
+    multiple threads that share the structure of the hydraulic solver's sparse matrix.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    nodes_idx : `numpy.ndarray`
+        Index (starting from 0) of the junction of each candidate leak.
+    emitter_coeffs : `numpy.ndarray`
+        Emitter coefficient of each candidate leak.
+    sensors_idx : `numpy.ndarray`
+        Indices (starting from 0) of the sensor nodes.
+    n_threads : `int`, optional
+        Number of threads.
+
+        The default is 1.
+
+    Returns
+    -------
+    `numpy.ndarray`
+        Pressure drops -- rows correspond to sensor nodes and columns to candidate leaks.
+    """
+    nodes_idx = np.ascontiguousarray(nodes_idx, dtype=np.intc) + 1
+    emitter_coeffs = np.ascontiguousarray(emitter_coeffs, dtype=np.float64)
+    sensors_idx = np.ascontiguousarray(sensors_idx, dtype=np.intc) + 1
+    if nodes_idx.shape != emitter_coeffs.shape:
+        raise ValueError("'nodes_idx' and 'emitter_coeffs' must have the same length")
+
+    pressure_drops = np.zeros((len(sensors_idx), len(nodes_idx)), dtype=np.float64)
+
+    err = call_native_function(epanet_api, "getleaksignatures", ctypes.c_int(len(nodes_idx)),
+                               as_pointer(nodes_idx, ctypes.c_int),
+                               as_pointer(emitter_coeffs, ctypes.c_double),
+                               ctypes.c_int(len(sensors_idx)),
+                               as_pointer(sensors_idx, ctypes.c_int), ctypes.c_int(n_threads),
+                               as_pointer(pressure_drops, ctypes.c_double))
+    if err == 1:
+        warnings.warn("The hydraulics of some candidate leaks did not converge")
+
+    return pressure_drops
+
+
+def get_backward_influence(epanet_api: epanet, sensors_idx: np.ndarray, sample_times: np.ndarray,
+                           bin_size: int, min_weight: float = 1e-3
+                           ) -> tuple[np.ndarray, np.ndarray, np.ndarray, np.ndarray]:
+    """
+    Traces the water that is sampled at a set of sensor nodes backwards through the
+    hydraulics of the last simulation -- i.e. this function must be called after a
+    hydraulic analysis has been run and saved to the hydraulics file
+    (e.g. after running a simulation).
+
+    The sampled water is routed against the flow direction of all stored hydraulic periods
+    in a single backward pass per sample: it is split among the inflowing links of each junction
+    in proportion to their flows, delayed by the time it took to pass each pipe under the
+    (time-varying) flows of the stored hydraulic periods, and completely mixed within tanks --
+    water from reservoirs, negative demands, and the initial water of the network is not
+    traced any further.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    sensors_idx : `numpy.ndarray`
+        Indices (starting from 0) of the sensor nodes.
+    sample_times : `numpy.ndarray`
+        Sample times (seconds since the start of the simulation).
+    bin_size : `int`
+        Length (in seconds) of a time bin -- water that passes a node is aggregated
+        within each time bin.
+    min_weight : `float`, optional
+        Smallest fraction of the sampled water that is reported.
+
+        The default is 1e-3.
+
+    Returns
+    -------
+    `tuple[numpy.ndarray, numpy.ndarray, numpy.ndarray, numpy.ndarray]`
+        Sample (i.e. sensor x number of sample times + sample time), node index (starting from 0),
+        mean time (seconds) at which the sampled water passed the node,
+        and fraction of the sampled water -- of every entry of the influence matrix.
+    """
+    sensors_idx = np.ascontiguousarray(sensors_idx, dtype=np.intc) + 1
+    sample_times = np.ascontiguousarray(sample_times, dtype=np.float64)
+    if len(sensors_idx) == 0 or len(sample_times) == 0:
+        raise ValueError("'sensors_idx' and 'sample_times' must not be empty")
+
+    # Entries are only written up to the capacity -- call again if there are more
+    capacity = 64 * len(sensors_idx) * len(sample_times)
+    count = ctypes.c_int(0)
+    while True:
+        rows = np.zeros(capacity, dtype=np.intc)
+        nodes = np.zeros(capacity, dtype=np.intc)
+        times = np.zeros(capacity, dtype=np.float64)
+        weights = np.zeros(capacity, dtype=np.float64)
+        call_native_function(epanet_api, "getbackwardinfluence", ctypes.c_int(len(sensors_idx)),
+                             as_pointer(sensors_idx, ctypes.c_int),
+                             ctypes.c_int(len(sample_times)),
+                             as_pointer(sample_times, ctypes.c_double),
+                             ctypes.c_long(bin_size), ctypes.c_double(min_weight),
+                             ctypes.c_int(capacity), ctypes.byref(count),
+                             as_pointer(rows, ctypes.c_int), as_pointer(nodes, ctypes.c_int),
+                             as_pointer(times, ctypes.c_double),
+                             as_pointer(weights, ctypes.c_double))
+        if count.value <= capacity:
+            break
+        capacity = count.value
+
+    n = count.value
+    return rows[:n], nodes[:n] - 1, times[:n], weights[:n]
+
+
+@contextmanager
+def network_edit(epanet_api: epanet) -> Iterator[None]:
+    """
+    Context manager that batches all changes of the network's structure
+    (i.e. adding and deleting nodes, links, patterns, and controls) into a single
+    EPANET edit transaction -- e.g. when splitting many pipes for placing leakages.
+
+    Inside the transaction, adding objects does not re-allocate all arrays and renumber
+    all links anymore, and deleted nodes and links are removed all at once when the
+    context is left. Deleted nodes and links keep their indices (and are still counted)
+    until then -- use their IDs instead of their indices within the context.
+
+    Nothing is done if the EPANET library does not support edit transactions or
+    if a transaction is already active.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    """
+    if not has_native_function(epanet_api, "beginedit"):
+        yield
+        return
+
+    editing = ctypes.c_int(0)
+    call_native_function(epanet_api, "getediting", ctypes.byref(editing))
+    if editing.value == 1:
+        yield
+        return
+
+    call_native_function(epanet_api, "beginedit")
+    try:
+        yield
+    finally:
+        call_native_function(epanet_api, "commitedit")
+
+
+def set_demand_patterns(epanet_api: epanet, nodes_idx: np.ndarray, base_demands: np.ndarray,
+                        patterns_id: list[str], patterns: np.ndarray) -> None:
+    """
+    Adds a demand pattern for each of a set of junctions and assigns it (incl. a base demand)
+    to the junction's primary demand category.
+
+    All patterns are uploaded to EPANET at once -- i.e. without re-allocating the pattern
+    array and checking for duplicate IDs for every single pattern.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    nodes_idx : `numpy.ndarray`
+        Indices (starting from 0) of the junctions.
+    base_demands : `numpy.ndarray`
+        Base demand of each junction.
+    patterns_id : `list[str]`
+        ID of each new demand pattern.
+    patterns : `numpy.ndarray`
+        Demand patterns -- rows correspond to junctions and columns to time steps.
+    """
+    nodes_idx = np.asarray(nodes_idx, dtype=int) + 1
+    base_demands = np.asarray(base_demands, dtype=np.float64)
+    patterns = np.ascontiguousarray(patterns, dtype=np.float64)
+    if patterns.ndim != 2:
+        raise ValueError("'patterns' must be a two dimensional array")
+    if not nodes_idx.shape[0] == base_demands.shape[0] == len(patterns_id) == patterns.shape[0]:
+        raise ValueError("'nodes_idx', 'base_demands', 'patterns_id', and 'patterns' " +
+                         "must have the same number of rows")
+    if len(patterns_id) == 0:
+        return
+
+    if has_native_function(epanet_api, "addpatterns"):
+        ids = b"".join(pattern_id.encode() + b"\0" for pattern_id in patterns_id)
+        first_idx = ctypes.c_int(0)
+        call_native_function(epanet_api, "addpatterns", ctypes.c_int(patterns.shape[0]),
+                             ctypes.c_char_p(ids), as_pointer(patterns, ctypes.c_double),
+                             ctypes.c_int(patterns.shape[1]), ctypes.byref(first_idx))
+        patterns_idx = first_idx.value + np.arange(len(patterns_id))
+    else:
+        patterns_idx = [epanet_api.addPattern(pattern_id, pattern)
+                        for pattern_id, pattern in zip(patterns_id, patterns)]
+
+    # The legacy API uses single precision for all real-valued arguments
+    c_real = ctypes.c_double if getattr(epanet_api.api, "_ph", None) is not None \
+        else ctypes.c_float
+    for node_idx, base_demand, pattern_idx in zip(nodes_idx, base_demands, patterns_idx):
+        call_native_function(epanet_api, "setbasedemand", ctypes.c_int(int(node_idx)),
+                             ctypes.c_int(1), c_real(float(base_demand)))
+        call_native_function(epanet_api, "setdemandpattern", ctypes.c_int(int(node_idx)),
+                             ctypes.c_int(1), ctypes.c_int(int(pattern_idx)))
+
+
+# Node & link properties that are used with the bulk getters/setters below
+# (see EN_NodeProperty & EN_LinkProperty), and time parameters (see EN_TimeParameter)
+EN_PRESSURE = 11
+EN_TANKLEVEL = 8
+EN_MINLEVEL = 20
+EN_MAXLEVEL = 21
+EN_ROUGHNESS = 2
+EN_FLOW = 8
+EN_LINKPATTERN = 15
+EN_PATTERNSTEP = 3
+EN_DURATION = 0
+EN_REPORTSTEP = 5
+EN_REPORTSTART = 6
+
+
+def __get_values(epanet_api: epanet, func_name: str, property: int,
+                 items_idx: np.ndarray) -> np.ndarray:
+    items_idx = np.ascontiguousarray(items_idx, dtype=np.intc) + 1
+    values = np.zeros(len(items_idx), dtype=np.float64)
+    if len(items_idx) != 0:
+        call_native_function(epanet_api, func_name, ctypes.c_int(property),
+                             ctypes.c_int(len(items_idx)), as_pointer(items_idx, ctypes.c_int),
+                             as_pointer(values, ctypes.c_double))
+
+    return values
+
+
+def get_node_values(epanet_api: epanet, property: int, nodes_idx: np.ndarray) -> np.ndarray:
+    """
+    Gets a property (e.g. :attr:`EN_PRESSURE`) of a set of nodes by a single call of
+    the EPANET library.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    property : `int`
+        Node property -- see EN_NodeProperty.
+    nodes_idx : `numpy.ndarray`
+        Indices (starting from 0) of the nodes.
+
+    Returns
+    -------
+    `numpy.ndarray`
+        Value of each node.
+    """
+    return __get_values(epanet_api, "getnodevaluelist", property, nodes_idx)
+
+
+def get_link_values(epanet_api: epanet, property: int, links_idx: np.ndarray) -> np.ndarray:
+    """
+    Gets a property (e.g. :attr:`EN_FLOW`) of a set of links by a single call of
+    the EPANET library.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    property : `int`
+        Link property -- see EN_LinkProperty.
+    links_idx : `numpy.ndarray`
+        Indices (starting from 0) of the links.
+
+    Returns
+    -------
+    `numpy.ndarray`
+        Value of each link.
+    """
+    return __get_values(epanet_api, "getlinkvaluelist", property, links_idx)
+
+
+def set_link_values(epanet_api: epanet, property: int, links_idx: np.ndarray,
+                    values: np.ndarray) -> None:
+    """
+    Sets a property (e.g. :attr:`EN_ROUGHNESS`) of a set of links by a single call of
+    the EPANET library.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    property : `int`
+        Link property -- see EN_LinkProperty.
+    links_idx : `numpy.ndarray`
+        Indices (starting from 0) of the links.
+    values : `numpy.ndarray`
+        New value of each link.
+    """
+    links_idx = np.ascontiguousarray(links_idx, dtype=np.intc) + 1
+    values = np.ascontiguousarray(values, dtype=np.float64)
+    if links_idx.shape != values.shape:
+        raise ValueError("'links_idx' and 'values' must have the same shape")
+    if len(links_idx) == 0:
+        return
+
+    call_native_function(epanet_api, "setlinkvaluelist", ctypes.c_int(property),
+                         ctypes.c_int(len(links_idx)), as_pointer(links_idx, ctypes.c_int),
+                         as_pointer(values, ctypes.c_double))
+
+
+def set_base_demands(epanet_api: epanet, nodes_idx: np.ndarray, demands_idx: np.ndarray,
+                     base_demands: np.ndarray) -> None:
+    """
+    Sets the base demand of a set of demand categories by a single call of
+    the EPANET library.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    nodes_idx : `numpy.ndarray`
+        Index (starting from 0) of the node of each demand category.
+    demands_idx : `numpy.ndarray`
+        Index (starting from 0) of each demand category at its node.
+    base_demands : `numpy.ndarray`
+        New base demand of each demand category.
+    """
+    nodes_idx = np.ascontiguousarray(nodes_idx, dtype=np.intc) + 1
+    demands_idx = np.ascontiguousarray(demands_idx, dtype=np.intc) + 1
+    base_demands = np.ascontiguousarray(base_demands, dtype=np.float64)
+    if not nodes_idx.shape == demands_idx.shape == base_demands.shape:
+        raise ValueError("'nodes_idx', 'demands_idx', and 'base_demands' " +
+                         "must have the same shape")
+    if len(nodes_idx) == 0:
+        return
+
+    call_native_function(epanet_api, "setbasedemandlist", ctypes.c_int(len(nodes_idx)),
+                         as_pointer(nodes_idx, ctypes.c_int),
+                         as_pointer(demands_idx, ctypes.c_int),
+                         as_pointer(base_demands, ctypes.c_double))
+
+
+# Simulation phases that are timed by the EPANET library (see EN_ProfilePhase) --
+# nested phases are listed after their parent phase
+EN_PROFILE_PHASES = {"run_hydraulics": 0, "demands": 1, "controls": 2, "hydsolve": 3,
+                     "headloss_coeffs": 4, "matrix_coeffs": 5, "linsolve": 6,
+                     "status_checks": 7, "next_hydraulics": 8, "save_hydraulics": 9,
+                     "time_step": 10, "run_quality": 11, "sort_nodes": 12, "save_output": 13,
+                     "transport": 14, "reactions": 15, "advection": 16, "node_mixing": 17}
+
+# Simulation phases that are timed by the EPANET-MSX library (see MSX_PROF_*)
+MSX_PROFILE_PHASES = {"step": 0, "get_hydraulics": 1, "sort_nodes": 2, "save_output": 3,
+                      "transport": 4, "reactions": 5, "advection": 6, "node_mixing": 7,
+                      "dispersion": 8}
+
+
+def set_profiling(epanet_api: epanet, enabled: bool) -> None:
+    """
+    Enables or disables the timing of the simulation phases inside the EPANET library.
+    Enabling the profiling clears all previously collected timings.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    enabled : `bool`
+        True if the profiling is to be enabled, False otherwise.
+    """
+    call_native_function(epanet_api, "setprofiling", ctypes.c_int(int(enabled)))
+
+
+def get_profile(epanet_api: epanet) -> dict:
+    """
+    Gets the timings of the simulation phases collected by the EPANET library
+    since the profiling was enabled.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+
+    Returns
+    -------
+    `dict`
+        Wall clock time (in seconds) and number of calls for each simulation phase
+        (see `EN_PROFILE_PHASES`) -- i.e. phase name -> {"time": ..., "calls": ...}.
+        The phase "hydsolve" additionally reports the total number of iterations of the
+        hydraulic solver.
+    """
+    f, handle = get_native_function(epanet_api, "getprofile")
+
+    seconds = ctypes.c_double() if len(handle) != 0 else ctypes.c_float()
+    calls = ctypes.c_int()
+    iterations = ctypes.c_int()
+
+    profile = {}
+    for phase_name, phase in EN_PROFILE_PHASES.items():
+        err = f(*handle, ctypes.c_int(phase), ctypes.byref(seconds), ctypes.byref(calls),
+                ctypes.byref(iterations))
+        if err > 100:
+            raise RuntimeError(f"EPANET function 'getprofile' failed with error code {err}")
+
+        profile[phase_name] = {"time": float(seconds.value), "calls": calls.value}
+        if phase_name == "hydsolve":
+            profile[phase_name]["iterations"] = iterations.value
+
+    return profile
+
+
+def get_msx_function(epanet_api: epanet, func_name: str) -> Any:
+    """
+    Gets a function of the EPANET-MSX library used by a given EPyT instance.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance -- an .msx file must have been loaded.
+    func_name : `str`
+        Name of the function without the 'MSX' prefix -- e.g. 'getprofile'.
+
+    Returns
+    -------
+    `Any`
+        The ctypes function.
+    """
+    msx_lib = getattr(getattr(epanet_api, "msx", None), "msx_lib", None)
+    if msx_lib is None:
+        raise RuntimeError("No EPANET-MSX library loaded -- please load an .msx file first")
+
+    f = getattr(msx_lib, f"MSX{func_name}", None)
+    if f is None:
+        raise RuntimeError(f"The loaded EPANET-MSX library does not provide '{func_name}' -- " +
+                           "please make sure that the EPANET-MSX library shipped with " +
+                           "EPyT-Flow was compiled successfully")
+
+    return f
+
+
+def set_msx_profiling(epanet_api: epanet, enabled: bool) -> None:
+    """
+    Enables or disables the timing of the simulation phases inside the EPANET-MSX library.
+    Enabling the profiling clears all previously collected timings.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance -- an .msx file must have been loaded.
+    enabled : `bool`
+        True if the profiling is to be enabled, False otherwise.
+    """
+    err = get_msx_function(epanet_api, "setprofiling")(ctypes.c_int(int(enabled)))
+    if err != 0:
+        raise RuntimeError(f"EPANET-MSX function 'setprofiling' failed with error code {err}")
+
+
+def get_msx_profile(epanet_api: epanet) -> dict:
+    """
+    Gets the timings of the simulation phases collected by the EPANET-MSX library
+    since the profiling was enabled.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance -- an .msx file must have been loaded.
+
+    Returns
+    -------
+    `dict`
+        Wall clock time (in seconds) and number of calls for each simulation phase
+        (see `MSX_PROFILE_PHASES`) -- i.e. phase name -> {"time": ..., "calls": ...}.
+    """
+    f = get_msx_function(epanet_api, "getprofile")
+
+    seconds = ctypes.c_double()
+    calls = ctypes.c_int()
+
+    profile = {}
+    for phase_name, phase in MSX_PROFILE_PHASES.items():
+        err = f(ctypes.c_int(phase), ctypes.byref(seconds), ctypes.byref(calls))
+        if err != 0:
+            raise RuntimeError(f"EPANET-MSX function 'getprofile' failed with error code {err}")
+
+        profile[phase_name] = {"time": seconds.value, "calls": calls.value}
+
+    return profile
+
+
+def set_tracing(epanet_api: epanet, buffer_size: int) -> None:
+    """
+    Enables or disables the recording of a timeline of the simulation phases
+    inside the EPANET library.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    buffer_size : `int`
+        Capacity (in events) of the ring buffer -- 0 disables tracing.
+    """
+    call_native_function(epanet_api, "settracing", ctypes.c_int(buffer_size))
+
+
+def set_msx_tracing(epanet_api: epanet, buffer_size: int) -> None:
+    """
+    Enables or disables the recording of a timeline of the simulation phases
+    inside the EPANET-MSX library.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance -- an .msx file must have been loaded.
+    buffer_size : `int`
+        Capacity (in events) of the ring buffer -- 0 disables tracing.
+    """
+    err = get_msx_function(epanet_api, "settracing")(ctypes.c_int(buffer_size))
+    if err != 0:
+        raise RuntimeError(f"EPANET-MSX function 'settracing' failed with error code {err}")
+
+
+# Fields of the hydraulic step diagnostics (see EN_DiagnosticField) and their data types
+EN_DIAGNOSTICS_FIELDS = {"time": (0, np.int64), "iterations": (1, np.int32),
+                         "relative_error": (2, np.float64), "max_head_error": (3, np.float64),
+                         "max_flow_change": (4, np.float64), "status_changes": (5, np.int32),
+                         "bad_valves": (6, np.int32), "deficient_nodes": (7, np.int32),
+                         "demand_reduction": (8, np.float64), "flags": (9, np.int32)}
+
+# Bits of the "flags" field of the hydraulic step diagnostics (see EN_DiagnosticFlag)
+EN_DIAGFLAG_CONVERGED = 1
+EN_DIAGFLAG_EXTRATRIALS = 2
+EN_DIAGFLAG_DAMPED = 4
+EN_DIAGFLAG_REUSEDORDER = 8
+EN_DIAGFLAG_WARMSTART = 16
+EN_DIAGFLAG_WARMACCEPTED = 32
+
+
+def set_diagnostics(epanet_api: epanet, enabled: bool) -> None:
+    """
+    Enables or disables the recording of per time step convergence diagnostics inside
+    the EPANET library -- both discard all previous records.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    enabled : `bool`
+        True if the diagnostics are to be recorded, False otherwise.
+    """
+    call_native_function(epanet_api, "setdiagnostics", ctypes.c_int(int(enabled)))
+
+
+def get_diagnostics(epanet_api: epanet) -> dict[str, np.ndarray]:
+    """
+    Gets the convergence diagnostics of all hydraulic time steps solved since
+    the hydraulic solver was last initialized.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+
+    Returns
+    -------
+    `dict[str, numpy.ndarray]`
+        One array (one entry per hydraulic time step) for each field in
+        `EN_DIAGNOSTICS_FIELDS` -- i.e. time (seconds), number of iterations,
+        relative error, max. head error (head units), max. flow change (flow units),
+        number of links that changed their status, number of ill-conditioned matrices
+        that were fixed by opening a control valve, number of pressure deficient nodes,
+        demand reduction (%) at those nodes, and the flags (see `EN_DIAGFLAG_*`).
+    """
+    count = ctypes.c_int()
+    call_native_function(epanet_api, "getdiagnosticscount", ctypes.byref(count))
+
+    values = np.zeros(count.value, dtype=np.float64)
+    diagnostics = {}
+    for field_name, (field, dtype) in EN_DIAGNOSTICS_FIELDS.items():
+        call_native_function(epanet_api, "getdiagnostics", ctypes.c_int(field),
+                             ctypes.c_int(count.value), as_pointer(values, ctypes.c_double))
+        diagnostics[field_name] = values.astype(dtype)
+
+    return diagnostics
+
+
+# Categories of the memory allocated by the EPANET library (see EN_MemoryCategory) --
+# "files" refers to the disk space used by the hydraulics and binary output files
+EN_MEMORY_CATEGORIES = {"network": 0, "hydraulics": 1, "sparse": 2, "quality": 3,
+                        "segments": 4, "output": 5, "profiling": 6, "files": 7}
+
+# Categories of the memory allocated by the EPANET-MSX library (see MSX_MEM_*) --
+# "workspace" refers to the ODE solver & dispersion workspaces of all OpenMP threads
+MSX_MEMORY_CATEGORIES = {"network": 0, "quality": 1, "segments": 2, "workspace": 3,
+                         "output": 4, "profiling": 5, "files": 6}
+
+
+def get_memory_usage(epanet_api: epanet) -> dict[str, int]:
+    """
+    Gets the amount of memory that is currently allocated by the EPANET library.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+
+    Returns
+    -------
+    `dict[str, int]`
+        Number of bytes for each category in `EN_MEMORY_CATEGORIES` -- e.g. "sparse" refers to
+        the sparse matrix (incl. its Cholesky factor) of the hydraulic solver and "segments"
+        to the memory pool of the water quality pipe segments.
+    """
+    f, handle = get_native_function(epanet_api, "getmemoryusage")
+
+    n_bytes = ctypes.c_double()
+    memory_usage = {}
+    for category_name, category in EN_MEMORY_CATEGORIES.items():
+        err = f(*handle, ctypes.c_int(category), ctypes.byref(n_bytes))
+        if err > 100:
+            raise RuntimeError(f"EPANET function 'getmemoryusage' failed with error code {err}")
+
+        memory_usage[category_name] = int(n_bytes.value)
+
+    return memory_usage
+
+
+def get_solver_memory(epanet_api: epanet) -> int:
+    """
+    Estimates the amount of memory that the hydraulic and water quality solvers of the
+    EPANET library allocate when they are opened -- the solvers are not opened.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+
+    Returns
+    -------
+    `int`
+        Number of bytes that opening the solvers adds to the memory reported by
+        :func:`get_memory_usage` (excl. the pipe segments) -- 0 if the solvers are open.
+    """
+    f, handle = get_native_function(epanet_api, "getsolvermemory")
+
+    n_bytes = ctypes.c_double()
+    err = f(*handle, ctypes.byref(n_bytes))
+    if err > 100:
+        raise RuntimeError(f"EPANET function 'getsolvermemory' failed with error code {err}")
+
+    return int(n_bytes.value)
+
+
+def get_msx_memory_usage(epanet_api: epanet) -> dict[str, int]:
+    """
+    Gets the amount of memory that is currently allocated by the EPANET-MSX library.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance -- an .msx file must have been loaded.
+
+    Returns
+    -------
+    `dict[str, int]`
+        Number of bytes for each category in `MSX_MEMORY_CATEGORIES`.
+    """
+    f = get_msx_function(epanet_api, "getmemoryusage")
+
+    n_bytes = ctypes.c_double()
+    memory_usage = {}
+    for category_name, category in MSX_MEMORY_CATEGORIES.items():
+        err = f(ctypes.c_int(category), ctypes.byref(n_bytes))
+        if err != 0:
+            raise RuntimeError("EPANET-MSX function 'getmemoryusage' failed with " +
+                               f"error code {err}")
+
+        memory_usage[category_name] = int(n_bytes.value)
+
+    return memory_usage
+
+
+def set_warm_start(epanet_api: epanet, enabled: bool) -> None:
+    """
+    Enables or disables warm starts of re-runs of the hydraulic analysis inside the
+    EPANET library -- i.e. every time step starts from the previous run's solution at
+    the same time, and the structure (node re-ordering & symbolic factorization) of the
+    sparse matrix is re-used as long as the network's structure does not change.
+    Both discard all previously recorded solutions.
+
+    Note that this must not be called while the hydraulic solver is open.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    enabled : `bool`
+        True if re-runs are to be warm started, False otherwise.
+    """
+    call_native_function(epanet_api, "setwarmstart", ctypes.c_int(int(enabled)))
+
+
+def set_warm_start_tolerance(epanet_api: epanet, tolerance: float) -> None:
+    """
+    Sets the tolerance for accepting warm started time steps inside the EPANET library --
+    i.e. a time step that starts from the previous run's solution is accepted after the
+    first trial of the hydraulic solver if that trial changed no link flow by more than
+    the tolerance. This is checked for every time step on its own.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    tolerance : `float`
+        Largest absolute flow change (in the network's flow units) -- 0 for solving every
+        time step to full accuracy.
+    """
+    call_native_function(epanet_api, "setwarmstarttol", ctypes.c_double(tolerance))
+
+
+def get_warm_start_stats(epanet_api: epanet) -> dict:
+    """
+    Gets statistics of the most recent (warm started) run of the hydraulic analysis.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+
+    Returns
+    -------
+    `dict`
+        Number of hydraulic time steps solved ("time_steps"), number of those time steps
+        that started from the previous run's solution ("warm_started"), number of warm
+        started time steps that were accepted after the first trial ("accepted" -- see
+        :func:`set_warm_start_tolerance`), and whether the structure of the sparse matrix
+        was re-used ("reused_structure").
+    """
+    steps, warm_started, accepted, reused = ctypes.c_int(), ctypes.c_int(), ctypes.c_int(), \
+        ctypes.c_int()
+    call_native_function(epanet_api, "getwarmstart", ctypes.byref(steps),
+                         ctypes.byref(warm_started), ctypes.byref(accepted),
+                         ctypes.byref(reused))
+
+    return {"time_steps": steps.value, "warm_started": warm_started.value,
+            "accepted": accepted.value, "reused_structure": bool(reused.value)}
+
+
+def set_observations(epanet_api: epanet, objects: np.ndarray, indices: np.ndarray,
+                     properties: np.ndarray, scales: np.ndarray, times: np.ndarray,
+                     values: np.ndarray) -> None:
+    """
+    Sets observed sensor readings inside the EPANET library -- every subsequent run of the
+    hydraulic analysis sums up the squared (scaled) differences between the simulated and
+    the observed readings at the observed time points (see :func:`get_residual`),
+    so that the sensor readings do not have to be retrieved from EPANET.
+
+    Note that this must not be called while the hydraulic solver is open.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    objects : `numpy.ndarray`
+        Object type (:attr:`EN_NODE` or :attr:`EN_LINK`) of each sensor.
+    indices : `numpy.ndarray`
+        Node or link index (starting from 0) of each sensor.
+    properties : `numpy.ndarray`
+        Measured property (e.g. :attr:`EN_PRESSURE` or :attr:`EN_FLOW`) of each sensor.
+    scales : `numpy.ndarray`
+        Factor the residuals of each sensor are multiplied with.
+    times : `numpy.ndarray`
+        Observed time points (seconds since the start of the simulation, ascending).
+    values : `numpy.ndarray`
+        Observed readings (time points x sensors) -- NaN if missing.
+    """
+    objects = np.ascontiguousarray(objects, dtype=np.intc)
+    indices = np.ascontiguousarray(indices, dtype=np.intc) + 1
+    properties = np.ascontiguousarray(properties, dtype=np.intc)
+    scales = np.ascontiguousarray(scales, dtype=np.float64)
+    times = np.ascontiguousarray(times, dtype=np.float64)
+    values = np.ascontiguousarray(values, dtype=np.float64)
+    if not objects.shape == indices.shape == properties.shape == scales.shape:
+        raise ValueError("'objects', 'indices', 'properties', and 'scales' " +
+                         "must have the same shape")
+    if values.shape != (len(times), len(indices)):
+        raise ValueError(f"'values' must be of shape {(len(times), len(indices))}")
+
+    call_native_function(epanet_api, "setobservations", ctypes.c_int(len(indices)),
+                         as_pointer(objects, ctypes.c_int), as_pointer(indices, ctypes.c_int),
+                         as_pointer(properties, ctypes.c_int),
+                         as_pointer(scales, ctypes.c_double), ctypes.c_int(len(times)),
+                         as_pointer(times, ctypes.c_double), as_pointer(values, ctypes.c_double))
+
+
+def get_residual(epanet_api: epanet) -> tuple[float, int]:
+    """
+    Gets the residuals of the most recent run of the hydraulic analysis with respect to the
+    observed sensor readings (see :func:`set_observations`).
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+
+    Returns
+    -------
+    `tuple[float, int]`
+        Sum of the squared (scaled) residuals and number of residuals.
+    """
+    sum_squared_residuals, n_residuals = ctypes.c_double(), ctypes.c_int()
+    call_native_function(epanet_api, "getresidual", ctypes.byref(sum_squared_residuals),
+                         ctypes.byref(n_residuals))
+
+    return sum_squared_residuals.value, n_residuals.value
+
+
+EN_ROUTE_STEPS = 0
+EN_ROUTE_EVENTS = 1
+
+
+def set_quality_routing(epanet_api: epanet, event_driven: bool) -> None:
+    """
+    Selects how the water quality is transported through the pipes inside the EPANET
+    library -- i.e. either over fixed quality time steps (default) or driven by events,
+    where a node is only updated when the leading water segment of one of its inflow
+    pipes is used up (and tanks every quality time step).
+    Reactive constituents (incl. water age) are always transported over fixed quality
+    time steps.
+
+    Note that this must not be called while the water quality solver is open.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    event_driven : `bool`
+        True if the transport is to be driven by events, False otherwise.
+    """
+    call_native_function(epanet_api, "setqualrouting",
+                         ctypes.c_int(EN_ROUTE_EVENTS if event_driven else EN_ROUTE_STEPS))
+
+
+def get_quality_routing(epanet_api: epanet) -> dict:
+    """
+    Gets the water quality routing method and the number of node updates
+    of the most recent event-driven run.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+
+    Returns
+    -------
+    `dict`
+        Whether the transport is driven by events ("event_driven") and the number
+        of node updates since the water quality solver was initialized ("events").
+    """
+    mode, events = ctypes.c_int(), ctypes.c_int()
+    call_native_function(epanet_api, "getqualrouting", ctypes.byref(mode),
+                         ctypes.byref(events))
+
+    return {"event_driven": mode.value == EN_ROUTE_EVENTS, "events": events.value}
+
+
+def set_full_sort(epanet_api: epanet, full_sort: bool) -> None:
+    """
+    Selects whether the EPANET library re-sorts all nodes (from upstream to downstream)
+    whenever the flow direction of a link changes, or only re-orders the nodes affected by
+    the changed links (default). Both give the same water quality -- the full sort is slower
+    and serves as a reference for checking the incremental update.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    full_sort : `bool`
+        True if all nodes are to be re-sorted, False otherwise.
+    """
+    call_native_function(epanet_api, "setfullsort", ctypes.c_int(int(full_sort)))
+
+
+def set_msx_full_sort(epanet_api: epanet, full_sort: bool) -> None:
+    """
+    Selects whether the EPANET-MSX library re-sorts all nodes whenever the flow direction
+    of a link changes, or only re-orders the nodes affected by the changed links (default).
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance -- an .msx file must have been loaded.
+    full_sort : `bool`
+        True if all nodes are to be re-sorted, False otherwise.
+    """
+    err = get_msx_function(epanet_api, "setfullsort")(ctypes.c_int(int(full_sort)))
+    if err != 0:
+        raise RuntimeError(f"EPANET-MSX function 'setfullsort' failed with error code {err}")
+
+
+# Object types and further node & link properties that are used by batch simulations
+# (see EN_ObjectType, EN_NodeProperty & EN_LinkProperty)
+EN_NODE = 0
+EN_LINK = 1
+EN_EMITTER = 3
+EN_DEMAND = 9
+EN_QUALITY = 12
+EN_TANKVOLUME = 24
+EN_STATUS = 11
+EN_SETTING = 12
+EN_LINKQUAL = 14
+
+
+def run_batch(epanet_api: epanet, params: np.ndarray, event_start: np.ndarray,
+              event_times: np.ndarray, event_targets: np.ndarray, event_values: np.ndarray,
+              sensors: np.ndarray, n_periods: int, n_threads: int
+              ) -> tuple[np.ndarray, np.ndarray]:
+    """
+    Simulates a batch of variants (scenarios) of the network on a pool of threads inside the
+    EPANET library -- each thread loads its own copy of the network (in its current state)
+    and the Python interpreter lock is not held while the batch is simulated.
+
+    Note that this must not be called while the hydraulic or water quality solver is open.
+
+    Parameters
+    ----------
+    epanet_api : `epyt.epanet`
+        EPyT instance.
+    params : `numpy.ndarray`
+        Simulation duration, hydraulic time step, and reporting time step (in seconds) of
+        each scenario -- values <= 0 keep the time parameter of the network.
+    event_start : `numpy.ndarray`
+        Index of the first event of each scenario (number of scenarios + 1 entries).
+    event_times : `numpy.ndarray`
+        Time (in seconds) of each event -- sorted within each scenario.
+    event_targets : `numpy.ndarray`
+        Object type (:attr:`EN_NODE` or :attr:`EN_LINK`), index (starting from 0),
+        and property of each event.
+    event_values : `numpy.ndarray`
+        Property value that is set by each event.
+    sensors : `numpy.ndarray`
+        Object type, index (starting from 0), and property of each sensor.
+    n_periods : `int`
+        Number of reporting periods.
+    n_threads : `int`
+        Number of threads.
+
+    Returns
+    -------
+    `tuple[numpy.ndarray, numpy.ndarray]`
+        Sensor readings of shape (number of scenarios, number of periods, number of sensors) --
+        periods that are not simulated are NaN -- and the error (or warning) code
+        of each scenario.
+    """
+    params = np.ascontiguousarray(params, dtype=ctypes.c_long).reshape(-1, 3)
+    event_start = np.ascontiguousarray(event_start, dtype=np.intc)
+    event_times = np.ascontiguousarray(event_times, dtype=ctypes.c_long)
+    event_targets = np.array(event_targets, dtype=np.intc).reshape(-1, 3)
+    event_values = np.ascontiguousarray(event_values, dtype=np.float64)
+    sensors = np.array(sensors, dtype=np.intc).reshape(-1, 3)
+    n_scenarios = params.shape[0]
+    if event_start.shape != (n_scenarios + 1,):
+        raise ValueError("'event_start' must have one more entry than there are scenarios")
+    if not len(event_times) == len(event_targets) == len(event_values) == event_start[-1]:
+        raise ValueError("'event_times', 'event_targets', and 'event_values' must have " +
+                         "one entry per event")
+    event_targets[:, 1] += 1
+    sensors[:, 1] += 1
+
+    values = np.full((n_scenarios, n_periods, len(sensors)), np.nan, dtype=np.float64)
+    errcodes = np.zeros(n_scenarios, dtype=np.intc)
+
+    call_native_function(epanet_api, "runbatch", ctypes.c_int(n_scenarios),
+                         as_pointer(params, ctypes.c_long), as_pointer(event_start, ctypes.c_int),
+                         as_pointer(event_times, ctypes.c_long),
+                         as_pointer(event_targets, ctypes.c_int),
+                         as_pointer(event_values, ctypes.c_double), ctypes.c_int(len(sensors)),
+                         as_pointer(sensors, ctypes.c_int), ctypes.c_int(n_periods),
+                         ctypes.c_int(n_threads), as_pointer(values, ctypes.c_double),
+                         as_pointer(errcodes, ctypes.c_int))
+
+    return values, errcodes
@@ -3,6 +3,7 @@ Module provides functions for simulating several scenarios in parallel.
 """
 from typing import Callable, Any
 import os
+import time
 import warnings
 from multiprocess import Pool, cpu_count
 import shutil
@@ -11,6 +12,8 @@ import psutil
 from .scenario_config import ScenarioConfig
 from .scada import ScadaData
 from .scenario_simulator import ScenarioSimulator
+from .memory_model import get_memory_model
+from .tracing import get_tracer
 
 
 def callback_save_to_file(folder_out: str = "") -> Callable[[ScadaData, ScenarioConfig, int], None]:
@@ -38,9 +41,28 @@ def callback_save_to_file(folder_out: str = "") -> Callable[[ScadaData, Scenario
 
 
 def _run_scenario_simulation(scenario_config: ScenarioConfig, scenario_idx: int,
-                             callback: Callable[[ScadaData, ScenarioConfig, int], Any]) -> Any:
-    with ScenarioSimulator(scenario_config=scenario_config) as sim:
-        return callback(sim.run_simulation(), scenario_config, scenario_idx)
+                             callback: Callable[[ScadaData, ScenarioConfig, int], Any],
+                             trace_settings: dict = None) -> Any:
+    if trace_settings is None:
+        with ScenarioSimulator(scenario_config=scenario_config) as sim:
+            return callback(sim.run_simulation(), scenario_config, scenario_idx)
+
+    # Record a timeline of this worker -- the start-up of the worker process is reconstructed
+    # from its creation time
+    tracer = get_tracer()
+    tracer.enable(**trace_settings)
+
+    process_age = time.time() - psutil.Process().create_time()
+    tracer.add_event("worker_startup", "python", time.perf_counter() - process_age, process_age)
+
+    try:
+        with tracer.span("simulate_scenario", scenario_idx=scenario_idx):
+            with ScenarioSimulator(scenario_config=scenario_config) as sim:
+                scada_data = sim.run_simulation()
+        with tracer.span("callback", scenario_idx=scenario_idx):
+            return callback(scada_data, scenario_config, scenario_idx)
+    finally:
+        tracer.save(os.path.join(tracer.trace_dir, f"trace_{os.getpid()}_{scenario_idx}.json"))
 
 
 class ParallelScenarioSimulation():
@@ -80,6 +102,19 @@ class ParallelScenarioSimulation():
             instance, and the index of the scenario in 'scenarios' as arguments.
 
             The default is :func:`~epyt_flow.simulation.parallel_simulation.callback_save_to_file`.
+
+        Notes
+        -----
+        The number of scenarios that are simulated in parallel is limited by the available
+        working memory -- every worker process needs the memory of the largest scenario
+        (see :attr:`~epyt_flow.simulation.scenario_config.ScenarioConfig.memory_consumption_estimate`)
+        plus the process overhead of the current memory model
+        (see :func:`~epyt_flow.simulation.memory_model.get_memory_model`).
+
+        If tracing is enabled with a trace folder (see
+        :func:`~epyt_flow.simulation.tracing.Tracer.enable`), each worker writes its timeline
+        to this folder -- the timelines can be combined by calling
+        :func:`~epyt_flow.simulation.tracing.merge_traces`.
         """
         if not isinstance(scenarios, list):
             raise TypeError("'scenarios' must be an instance of 'list[ScenarioConfig]' " +
@@ -101,10 +136,10 @@ class ParallelScenarioSimulation():
             raise TypeError("'callback' mut be a callable " +
                             "'Callable[[ScadaData, ScenarioConfig, int], None]'")
 
-        # Get free memory in MB
-        ram_free_memory = psutil.virtual_memory().free * .000001
+        # Get available memory in MB
+        ram_free_memory = psutil.virtual_memory().available * .000001
         if max_working_memory_consumption is not None:
-            ram_free_memory = max(ram_free_memory, max_working_memory_consumption)
+            ram_free_memory = min(ram_free_memory, max_working_memory_consumption)
 
         harddisk_free_memory = shutil.disk_usage(".").free * .000001
 
@@ -128,10 +163,12 @@ class ParallelScenarioSimulation():
         if n_jobs != -1:
             n_available_cpus = min(n_available_cpus, n_jobs)
 
+        # Every worker process needs memory for the largest scenario plus a fixed overhead
         required_memory_bound = min(ram_free_memory, harddisk_free_memory)
+        memory_per_worker = max_memory_required + get_memory_model().process_overhead
         n_max_parallel_scenarios = n_available_cpus
-        if max_memory_required != 0:
-            n_max_parallel_scenarios = int(required_memory_bound / max_memory_required)
+        if memory_per_worker != 0:
+            n_max_parallel_scenarios = max(1, int(required_memory_bound / memory_per_worker))
 
         n_parallel_scenarios = min(n_available_cpus, n_max_parallel_scenarios)
 
@@ -139,9 +176,17 @@ class ParallelScenarioSimulation():
             n_parallel_scenarios = 1
 
         # Run scenario simulations
+        tracer = get_tracer()
+        trace_settings = None
+        if tracer.enabled is True and tracer.trace_dir is not None:
+            trace_settings = {"trace_dir": tracer.trace_dir,
+                              "native_buffer_size": tracer.native_buffer_size}
+
         scenarios_task = []
         for scenario_idx, scenario in enumerate(scenarios):
-            scenarios_task.append((scenario, scenario_idx, callback))
+            scenarios_task.append((scenario, scenario_idx, callback, trace_settings))
 
-        with Pool(processes=n_parallel_scenarios, maxtasksperchild=1) as pool:
-            return pool.starmap(_run_scenario_simulation, scenarios_task)
+        with tracer.span("parallel_scenario_simulation", n_scenarios=len(scenarios),
+                         n_processes=n_parallel_scenarios):
+            with Pool(processes=n_parallel_scenarios, maxtasksperchild=1) as pool:
+                return pool.starmap(_run_scenario_simulation, scenarios_task)
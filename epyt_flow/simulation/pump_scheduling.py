@@ -0,0 +1,384 @@
+"""
+Module provides a harness for evaluating many candidate pump schedules (e.g. proposed by an
+energy optimizer) in parallel -- i.e. their energy usage, minimum pressures,
+and tank level violations.
+"""
+from typing import Any
+import ctypes
+from multiprocess import cpu_count
+import numpy as np
+from epyt.epanet import ToolkitConstants
+
+from .scenario_config import ScenarioConfig
+from .scenario_simulator import ScenarioSimulator
+from .worker_pool import WorkerPool
+from .native_api import EN_PRESSURE, EN_TANKLEVEL, EN_MINLEVEL, EN_MAXLEVEL, EN_LINKPATTERN, \
+    EN_PATTERNSTEP, get_native_function, call_native_function, has_native_function, \
+    get_node_values, set_link_values, set_warm_start
+
+
+class _ScheduleWorker():
+    """
+    Loaded copy of the network that evaluates one candidate pump schedule at a time.
+    """
+    def __init__(self, scenario_config: ScenarioConfig, pumps_idx: np.ndarray,
+                 junctions_idx: np.ndarray, tanks_idx: np.ndarray, warm_start: bool):
+        self.__sim = ScenarioSimulator(scenario_config=scenario_config)
+        self.__epanet_api = self.__sim.epanet_api
+        self.__pumps_idx = pumps_idx
+        self.__junctions_idx = junctions_idx
+        self.__tanks_idx = tanks_idx
+
+        # Every pump gets its own speed pattern, which is overwritten by each candidate
+        n_patterns = ctypes.c_int()
+        call_native_function(self.__epanet_api, "getcount",
+                             ctypes.c_int(ToolkitConstants.EN_PATCOUNT), ctypes.byref(n_patterns))
+        first_idx = ctypes.c_int()
+        ids = b"".join(f"PumpSchedule{n_patterns.value + i}".encode() + b"\0"
+                       for i in range(len(pumps_idx)))
+        call_native_function(self.__epanet_api, "addpatterns", ctypes.c_int(len(pumps_idx)),
+                             ctypes.c_char_p(ids),
+                             (ctypes.c_double * len(pumps_idx))(*[1.] * len(pumps_idx)),
+                             ctypes.c_int(1), ctypes.byref(first_idx))
+        self.__patterns_idx = first_idx.value + np.arange(len(pumps_idx))
+        set_link_values(self.__epanet_api, EN_LINKPATTERN, pumps_idx,
+                        self.__patterns_idx.astype(np.float64))
+
+        if warm_start and has_native_function(self.__epanet_api, "setwarmstart"):
+            set_warm_start(self.__epanet_api, True)
+
+    def close(self) -> None:
+        self.__sim.close()
+
+    def evaluate(self, schedule: np.ndarray, min_pressure: float, tank_min_levels: np.ndarray,
+                 tank_max_levels: np.ndarray, early_termination: bool
+                 ) -> tuple[float, float, float, float, int]:
+        schedule = np.ascontiguousarray(schedule, dtype=np.float64)
+        for pattern_idx, speeds in zip(self.__patterns_idx, schedule):
+            call_native_function(self.__epanet_api, "setpattern", ctypes.c_int(int(pattern_idx)),
+                                 speeds.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+                                 ctypes.c_int(len(speeds)))
+
+        run_h, handle = get_native_function(self.__epanet_api, "runH")
+        next_h, _ = get_native_function(self.__epanet_api, "nextH")
+        t, tstep = ctypes.c_long(), ctypes.c_long()
+
+        lowest_pressure, tank_violation = np.inf, 0.
+        call_native_function(self.__epanet_api, "openH")
+        try:
+            call_native_function(self.__epanet_api, "initH",
+                                 ctypes.c_int(ToolkitConstants.EN_NOSAVE))
+            while True:
+                err = run_h(*handle, ctypes.byref(t))
+                if err > 100:
+                    raise RuntimeError(f"EPANET function 'runH' failed with error code {err}")
+
+                if len(self.__junctions_idx) != 0:
+                    lowest_pressure = min(lowest_pressure,
+                                          float(get_node_values(self.__epanet_api, EN_PRESSURE,
+                                                                self.__junctions_idx).min()))
+                if len(self.__tanks_idx) != 0:
+                    levels = get_node_values(self.__epanet_api, EN_TANKLEVEL, self.__tanks_idx)
+                    tank_violation = max(tank_violation,
+                                         float(np.max(tank_min_levels - levels, initial=0.)),
+                                         float(np.max(levels - tank_max_levels, initial=0.)))
+
+                # Stop simulating infeasible schedules
+                if early_termination and (lowest_pressure < min_pressure or tank_violation > 0):
+                    break
+
+                err = next_h(*handle, ctypes.byref(tstep))
+                if err > 100:
+                    raise RuntimeError(f"EPANET function 'nextH' failed with error code {err}")
+                if tstep.value <= 0:
+                    break
+
+            # Energy used by all pumps so far
+            energy, cost = 0., 0.
+            kw_hrs, pump_cost = ctypes.c_double(), ctypes.c_double()
+            for pump_idx in self.__pumps_idx:
+                call_native_function(self.__epanet_api, "getpumpenergy",
+                                     ctypes.c_int(int(pump_idx) + 1), ctypes.byref(kw_hrs),
+                                     ctypes.byref(pump_cost))
+                energy += kw_hrs.value
+                cost += pump_cost.value
+        finally:
+            call_native_function(self.__epanet_api, "closeH")
+
+        return energy, cost, lowest_pressure, tank_violation, t.value
+
+
+class PumpScheduleEvaluation():
+    """
+    Class for evaluating candidate pump schedules in parallel -- e.g. for optimizing the
+    energy usage of a network.
+
+    A pump schedule specifies the relative speed of each pump in each period
+    (e.g. hour of a day) -- a speed of zero switches the pump off, and a speed of one
+    corresponds to its nominal speed (i.e. switching it on). The schedule is repeated if the
+    simulation is longer than the schedule. Each candidate schedule is evaluated by a full
+    hydraulic simulation that reports:
+
+        - the energy (in kWh) and the energy cost of all scheduled pumps,
+        - the lowest pressure at any junction,
+        - the largest violation of the tank level bounds, and
+        - whether the schedule is feasible -- i.e. the lowest pressure is not below the required
+          minimum pressure and no tank level bound is violated.
+
+    If early termination is enabled, the simulation of a candidate stops as soon as it
+    becomes infeasible (its energy usage then only covers the simulated part).
+
+    The candidates are evaluated by a pool of loaded (and warm) copies of the network that
+    are created once and re-used for all evaluations (see
+    :class:`~epyt_flow.simulation.worker_pool.WorkerPool`) -- the schedule of each pump is
+    uploaded as its speed pattern by a single call per pump. The copies run in threads, which
+    simulate in parallel since the EPANET library is called without holding the Python
+    interpreter lock.
+
+    Note that only the hydraulics of the network (incl. its EPANET controls and rules) are
+    simulated -- events, control modules, and uncertainties of the scenario are ignored.
+    Controls and rules of the network that change the status of scheduled pumps still apply.
+
+    Parameters
+    ----------
+    scenario_config : :class:`~epyt_flow.simulation.scenario_config.ScenarioConfig`
+        Configuration of the scenario (i.e. network).
+    pumps : `list[str]`, optional
+        IDs of the scheduled pumps. If None, all pumps are scheduled.
+
+        The default is None.
+    period_length : `int`, optional
+        Length (in seconds) of a period of a schedule -- must be a multiple of the pattern
+        time step of the network. If None, the pattern time step is used.
+
+        The default is None.
+    min_pressure : `float`, optional
+        Minimum pressure that is required at all junctions.
+
+        The default is zero.
+    tank_level_bounds : `dict[str, tuple[float, float]]`, optional
+        Lower and upper bound on the water level of tanks -- tanks that are not
+        listed are bounded by their minimum and maximum level.
+
+        The default is None.
+    early_termination : `bool`, optional
+        If True, the simulation of a candidate stops as soon as it becomes infeasible.
+
+        The default is True.
+    n_jobs : `int`, optional
+        Number of copies of the network (i.e. candidates that are evaluated in parallel).
+        If -1, the number of copies is equal to the number of CPUs.
+
+        The default is -1.
+    warm_start : `bool`, optional
+        If True, the hydraulic analysis of each candidate is warm started from the
+        previous candidate.
+
+        The default is True.
+    """
+    def __init__(self, scenario_config: ScenarioConfig, pumps: list[str] = None,
+                 period_length: int = None, min_pressure: float = 0.,
+                 tank_level_bounds: dict[str, tuple[float, float]] = None,
+                 early_termination: bool = True, n_jobs: int = -1, warm_start: bool = True,
+                 **kwds):
+        if not isinstance(scenario_config, ScenarioConfig):
+            raise TypeError("'scenario_config' must be an instance of " +
+                            "'epyt_flow.simulation.ScenarioConfig' but not of " +
+                            f"'{type(scenario_config)}'")
+        if scenario_config.f_msx_in is not None:
+            raise ValueError("Scenarios with an .msx file are not supported")
+        if pumps is not None:
+            if not isinstance(pumps, list):
+                raise TypeError("'pumps' must be an instance of 'list[str]' " +
+                                f"but not of '{type(pumps)}'")
+        if period_length is not None:
+            if not isinstance(period_length, int):
+                raise TypeError("'period_length' must be an instance of 'int' " +
+                                f"but not of '{type(period_length)}'")
+            if period_length <= 0:
+                raise ValueError("'period_length' must be positive")
+        if not isinstance(min_pressure, (float, int)):
+            raise TypeError("'min_pressure' must be an instance of 'float' " +
+                            f"but not of '{type(min_pressure)}'")
+        if tank_level_bounds is not None:
+            if not isinstance(tank_level_bounds, dict):
+                raise TypeError("'tank_level_bounds' must be an instance of " +
+                                "'dict[str, tuple[float, float]]' but not of " +
+                                f"'{type(tank_level_bounds)}'")
+        if not isinstance(early_termination, bool):
+            raise TypeError("'early_termination' must be an instance of 'bool' " +
+                            f"but not of '{type(early_termination)}'")
+        if not isinstance(n_jobs, int):
+            raise TypeError(f"'n_jobs' must be an instance of 'int' but not of '{type(n_jobs)}'")
+        if not (n_jobs == -1 or n_jobs > 0):
+            raise ValueError("'n_jobs' must be either -1 or a positive integer")
+        if not isinstance(warm_start, bool):
+            raise TypeError("'warm_start' must be an instance of 'bool' " +
+                            f"but not of '{type(warm_start)}'")
+
+        self.__min_pressure = float(min_pressure)
+        self.__early_termination = early_termination
+        self.__pool = None
+
+        super().__init__(**kwds)
+
+        n_jobs = cpu_count() if n_jobs == -1 else n_jobs
+        try:
+            self.__create_workers(scenario_config, pumps, period_length,
+                                  tank_level_bounds or {}, n_jobs, warm_start)
+        except Exception:
+            self.close()
+            raise
+
+    def __create_workers(self, scenario_config: ScenarioConfig, pumps: list[str],
+                         period_length: int, tank_level_bounds: dict, n_jobs: int,
+                         warm_start: bool) -> None:
+        # Map all IDs to indices & get the nominal tank levels and pattern time step
+        with ScenarioSimulator(scenario_config=scenario_config) as sim:
+            sensor_config = sim.sensor_config
+            pumps = sensor_config.pumps if pumps is None else pumps
+            tanks = sensor_config.tanks
+            if len(pumps) == 0:
+                raise ValueError("The network does not contain any pump to be scheduled")
+            if any(pump_id not in sensor_config.pumps for pump_id in pumps):
+                raise ValueError("'pumps' must only contain IDs of pumps")
+            if any(tank_id not in tanks for tank_id in tank_level_bounds):
+                raise ValueError("'tank_level_bounds' must only contain IDs of tanks")
+
+            pumps_idx = np.array([sensor_config.map_link_id_to_idx(pump_id)
+                                  for pump_id in pumps], dtype=int)
+            tanks_idx = np.array([sensor_config.map_node_id_to_idx(tank_id)
+                                  for tank_id in tanks], dtype=int)
+
+            n_nodes, n_tanks = ctypes.c_int(), ctypes.c_int()
+            call_native_function(sim.epanet_api, "getcount",
+                                 ctypes.c_int(ToolkitConstants.EN_NODECOUNT),
+                                 ctypes.byref(n_nodes))
+            call_native_function(sim.epanet_api, "getcount",
+                                 ctypes.c_int(ToolkitConstants.EN_TANKCOUNT),
+                                 ctypes.byref(n_tanks))
+            junctions_idx = np.arange(n_nodes.value - n_tanks.value)  # Junctions come first
+
+            self.__tank_min_levels = get_node_values(sim.epanet_api, EN_MINLEVEL, tanks_idx)
+            self.__tank_max_levels = get_node_values(sim.epanet_api, EN_MAXLEVEL, tanks_idx)
+            for i, tank_id in enumerate(tanks):
+                if tank_id in tank_level_bounds:
+                    self.__tank_min_levels[i], self.__tank_max_levels[i] = \
+                        tank_level_bounds[tank_id]
+
+            pattern_step = ctypes.c_long()
+            call_native_function(sim.epanet_api, "gettimeparam", ctypes.c_int(EN_PATTERNSTEP),
+                                 ctypes.byref(pattern_step))
+            pattern_step = pattern_step.value
+
+        if period_length is None:
+            period_length = pattern_step
+        if period_length % pattern_step != 0:
+            raise ValueError("'period_length' must be a multiple of the pattern time step " +
+                             f"({pattern_step}s)")
+        self.__pumps = list(pumps)
+        self.__period_length = period_length
+        self.__pattern_steps_per_period = period_length // pattern_step
+
+        self.__pool = WorkerPool(lambda: _ScheduleWorker(scenario_config, pumps_idx, junctions_idx,
+                                                         tanks_idx, warm_start),
+                                 n_jobs)
+
+    @property
+    def pumps(self) -> list[str]:
+        """
+        Gets the IDs of the scheduled pumps -- i.e. the order of the rows of a schedule.
+
+        Returns
+        -------
+        `list[str]`
+            Pump IDs.
+        """
+        return list(self.__pumps)
+
+    @property
+    def period_length(self) -> int:
+        """
+        Gets the length (in seconds) of a period of a schedule.
+
+        Returns
+        -------
+        `int`
+            Period length.
+        """
+        return self.__period_length
+
+    @property
+    def n_jobs(self) -> int:
+        """
+        Gets the number of copies of the network -- i.e. the number of candidates that are
+        evaluated in parallel.
+
+        Returns
+        -------
+        `int`
+            Number of copies.
+        """
+        return len(self.__pool.workers)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self) -> None:
+        """
+        Unloads all copies of the network.
+        """
+        if self.__pool is not None:
+            self.__pool.close()
+            self.__pool = None
+
+    def __evaluate(self, worker: _ScheduleWorker,
+                   schedule: np.ndarray) -> tuple[float, float, float, float, int]:
+        return worker.evaluate(np.repeat(schedule, self.__pattern_steps_per_period, axis=1),
+                               self.__min_pressure, self.__tank_min_levels,
+                               self.__tank_max_levels, self.__early_termination)
+
+    def evaluate(self, schedules: Any) -> dict:
+        """
+        Evaluates a set of candidate pump schedules in parallel.
+
+        Parameters
+        ----------
+        schedules : `numpy.ndarray`
+            Candidate pump schedules -- i.e. a three dimensional array of the relative speed
+            of each pump (see :attr:`pumps`) in each period, of shape
+            (number of candidates, number of pumps, number of periods).
+            A single candidate can also be passed as a two dimensional array.
+
+        Returns
+        -------
+        `dict`
+            Energy usage in kWh ("energy"), energy cost ("cost"), lowest junction pressure
+            ("min_pressure"), largest tank level violation ("tank_level_violation"),
+            feasibility ("feasible"), and the simulated time in seconds ("simulated_time")
+            of each candidate.
+        """
+        if self.__pool is None:
+            raise RuntimeError("The evaluation has already been closed")
+
+        schedules = np.asarray(schedules, dtype=np.float64)
+        if schedules.ndim == 2:
+            schedules = schedules.reshape(1, *schedules.shape)
+        if schedules.ndim != 3 or schedules.shape[1] != len(self.__pumps) or \
+                schedules.shape[2] == 0:
+            raise ValueError("'schedules' must be of shape (number of candidates, " +
+                             f"{len(self.__pumps)}, number of periods)")
+        if np.any(schedules < 0):
+            raise ValueError("Pump speeds can not be negative")
+
+        results = np.array(self.__pool.map(self.__evaluate, schedules),
+                           dtype=np.float64).reshape(-1, 5)
+        min_pressure, tank_level_violation = results[:, 2], results[:, 3]
+
+        return {"energy": results[:, 0], "cost": results[:, 1], "min_pressure": min_pressure,
+                "tank_level_violation": tank_level_violation,
+                "feasible": (min_pressure >= self.__min_pressure) & (tank_level_violation <= 0),
+                "simulated_time": results[:, 4].astype(int)}
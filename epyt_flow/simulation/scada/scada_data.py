@@ -3,7 +3,7 @@ Module provides a class for storing and processing SCADA data.
 """
 import warnings
 from typing import Callable, Any
-from copy import deepcopy
+from copy import deepcopy, copy
 import numpy as np
 from epyt.epanet import ToolkitConstants
 
@@ -123,6 +123,24 @@ class ScadaData(Serializable):
 
         The default is False.
     """
+    # Raw measurements that are affected by unit conversions -- the unit scale that applies
+    # to them (see convert_units)
+    __RAW_DATA_UNIT_SCALES = {"pressure_data_raw": "pressure", "flow_data_raw": "flow",
+                              "demand_data_raw": "demand",
+                              "node_quality_data_raw": "quality_node",
+                              "link_quality_data_raw": "quality_link",
+                              "tanks_volume_data_raw": "tank_volume",
+                              "bulk_species_node_concentration_raw": "bulk_species",
+                              "bulk_species_link_concentration_raw": "bulk_species",
+                              "surface_species_concentration_raw": "surface_species"}
+    __RAW_DATA_ATTRS = ["pressure_data_raw", "flow_data_raw", "demand_data_raw",
+                        "node_quality_data_raw", "link_quality_data_raw", "pumps_state_data_raw",
+                        "valves_state_data_raw", "tanks_volume_data_raw",
+                        "surface_species_concentration_raw",
+                        "bulk_species_node_concentration_raw",
+                        "bulk_species_link_concentration_raw", "pumps_energy_usage_data_raw",
+                        "pumps_efficiency_data_raw"]
+
     def __init__(self, sensor_config: SensorConfig, sensor_readings_time: np.ndarray,
                  pressure_data_raw: np.ndarray = None, flow_data_raw: np.ndarray = None,
                  demand_data_raw: np.ndarray = None, node_quality_data_raw: np.ndarray = None,
@@ -312,11 +330,11 @@ class ScadaData(Serializable):
         else:
             sensor_config = self.__sensor_config
 
-            node_to_idx = sensor_config.node_id_to_idx
-            link_to_idx = sensor_config.link_id_to_idx
-            pump_to_idx = sensor_config.pump_id_to_idx
-            valve_to_idx = sensor_config.valve_id_to_idx
-            tank_to_idx = sensor_config.tank_id_to_idx
+            node_to_idx = sensor_config.map_node_id_to_idx
+            link_to_idx = sensor_config.map_link_id_to_idx
+            pump_to_idx = sensor_config.map_pump_id_to_idx
+            valve_to_idx = sensor_config.map_valve_id_to_idx
+            tank_to_idx = sensor_config.map_tank_id_to_idx
 
             # EPANET quantities
             def __reduce_data(data: np.ndarray, sensors: list[str],
@@ -349,7 +367,7 @@ class ScadaData(Serializable):
             self.__pumps_energy_usage_data_raw = \
                 __reduce_data(data=pumps_energy_usage_data_raw,
                               item_to_idx=pump_to_idx,
-                              sensors=sensor_config.pump_enegeryconsumption_sensors)
+                              sensors=sensor_config.pump_energyconsumption_sensors)
             self.__pumps_efficiency_data_raw = \
                 __reduce_data(data=pumps_efficiency_data_raw,
                               item_to_idx=pump_to_idx,
@@ -373,30 +391,33 @@ class ScadaData(Serializable):
 
                     return np.concatenate(r, axis=1)
 
-            node_bulk_species_idx = [(sensor_config.bulkspecies_id_to_idx(s),
-                                      [sensor_config.node_id_to_idx(node_id)
+            node_bulk_species_idx = [(sensor_config.map_bulkspecies_id_to_idx(s),
+                                      [sensor_config.map_node_id_to_idx(node_id)
                                        for node_id in sensor_config.bulk_species_node_sensors[s]
                                        ]) for s in sensor_config.bulk_species_node_sensors.keys()]
             self.__bulk_species_node_concentration_raw = \
                 __reduce_msx_data(data=bulk_species_node_concentration_raw,
                                   sensors=node_bulk_species_idx)
 
-            bulk_species_link_idx = [(sensor_config.bulkspecies_id_to_idx(s),
-                                      [sensor_config.link_id_to_idx(link_id)
+            bulk_species_link_idx = [(sensor_config.map_bulkspecies_id_to_idx(s),
+                                      [sensor_config.map_link_id_to_idx(link_id)
                                        for link_id in sensor_config.bulk_species_link_sensors[s]
                                        ]) for s in sensor_config.bulk_species_link_sensors.keys()]
             self.__bulk_species_link_concentration_raw = \
                 __reduce_msx_data(data=bulk_species_link_concentration_raw,
                                   sensors=bulk_species_link_idx)
 
-            surface_species_idx = [(sensor_config.surfacespecies_id_to_idx(s),
-                                    [sensor_config.link_id_to_idx(link_id)
+            surface_species_idx = [(sensor_config.map_surfacespecies_id_to_idx(s),
+                                    [sensor_config.map_link_id_to_idx(link_id)
                                      for link_id in sensor_config.surface_species_sensors[s]
                                      ]) for s in sensor_config.surface_species_sensors.keys()]
             self.__surface_species_concentration_raw = \
                 __reduce_msx_data(data=surface_species_concentration_raw,
                                   sensors=surface_species_idx)
 
+        self.__unit_scales = {}
+        self.__raw_data_shared = False
+
         self.__init()
 
         super().__init__(**kwds)
@@ -404,10 +425,16 @@ class ScadaData(Serializable):
     def convert_units(self, flow_unit: int = None, quality_unit: int = None,
                       bulk_species_mass_unit: list[int] = None,
                       surface_species_mass_unit: list[int] = None,
-                      surface_species_area_unit: int = None) -> Any:
+                      surface_species_area_unit: int = None, lazy: bool = False,
+                      inplace: bool = False) -> Any:
         """
         Changes the units of some measurement units.
 
+        All unit conversions are scalings of the raw measurements -- by default, the scaled
+        raw measurements are copied into a new SCADA data instance. Alternatively, the
+        conversion can be done lazily (i.e. the scaling is only applied to the columns returned
+        by :func:`get_data` and to the raw measurements when they are requested) or in place.
+
         .. note::
 
             Beaware of potential rounding errors.
@@ -490,12 +517,34 @@ class ScadaData(Serializable):
             If None, are units of surface species are not changed.
 
             The default is None.
+        lazy : `bool`, optional
+            If True, the returned SCADA data shares the raw measurements with this instance
+            and the unit conversion is applied on the fly -- i.e. no copy of the raw
+            measurements is created.
+
+            The default is False.
+        inplace : `bool`, optional
+            If True, the raw measurements of this instance are converted in place and this
+            instance is returned -- i.e. no copy of the raw measurements is created.
+            Note that raw measurements which are shared with a lazily converted instance
+            are copied instead.
+
+            The default is False.
 
         Returns
         -------
         :class:`~epyt_flow.simulation.scada.scada_data.ScadaData`
             SCADA data instance with the new units.
         """
+        if not isinstance(lazy, bool):
+            raise TypeError("'lazy' must be an instance of 'bool' " +
+                            f"but not of '{type(lazy)}'")
+        if not isinstance(inplace, bool):
+            raise TypeError("'inplace' must be an instance of 'bool' " +
+                            f"but not of '{type(inplace)}'")
+        if lazy is True and inplace is True:
+            raise ValueError("'lazy' and 'inplace' can not be used at the same time")
+
         if flow_unit is not None:
             if not isinstance(flow_unit, int):
                 raise TypeError("'flow_unit' must be a an instance of 'int' " +
@@ -751,16 +800,8 @@ class ScadaData(Serializable):
                 elif old_unit == ToolkitConstants.EN_GPM:
                     return 5.450992969
 
-        # Convert units
-        pressure_data = self.pressure_data_raw
-        flow_data = self.flow_data_raw
-        demand_data = self.demand_data_raw
-        quality_node_data = self.node_quality_data_raw
-        quality_link_data = self.link_quality_data_raw
-        tanks_volume_data = self.tanks_volume_data_raw
-        surface_species_concentrations = self.surface_species_concentration_raw
-        bulk_species_node_concentrations = self.bulk_species_node_concentration_raw
-        bulk_species_link_concentrations = self.bulk_species_link_concentration_raw
+        # Compute the scaling of each type of raw measurements
+        scales = {}
 
         if flow_unit is not None:
             old_flow_unit = self.__sensor_config.flow_unit
@@ -770,27 +811,21 @@ class ScadaData(Serializable):
             else:
                 # Convert flows and demands
                 convert_factor = __get_flow_convert_factor(flow_unit, old_flow_unit)
-
-                flow_data *= convert_factor
-                demand_data *= convert_factor
+                scales["flow"] = convert_factor
+                scales["demand"] = convert_factor
 
                 if is_flowunit_simetric(flow_unit) != is_flowunit_simetric(old_flow_unit):
                     # Convert tank volume and pressure
-                    convert_factor = None
-                    convert_factor_pressure = None
                     if is_flowunit_simetric(flow_unit) is True and \
                             is_flowunit_simetric(old_flow_unit) is False:
-                        convert_factor_volume = .0283168
-                        convert_factor_pressure = .70325
+                        scales["tank_volume"] = .0283168
+                        scales["pressure"] = .70325
                     else:
-                        convert_factor_volume = 35.3147
-                        convert_factor_pressure = 1.4219702084872
-
-                    pressure_data *= convert_factor_pressure
-                    tanks_volume_data *= convert_factor_volume
+                        scales["tank_volume"] = 35.3147
+                        scales["pressure"] = 1.4219702084872
 
         if quality_unit is not None:
-            old_quality_unit = self.__sensor_config.quality_unit()
+            old_quality_unit = self.__sensor_config.quality_unit
             if quality_unit == old_quality_unit:
                 warnings.warn("'quality_unit' are identical to the current quality units " +
                               "-- nothing to do!", UserWarning)
@@ -798,59 +833,28 @@ class ScadaData(Serializable):
                 # Convert chemical concentration and time (basic quality analysis)
                 if quality_unit != TIME_UNIT_HRS:
                     convert_factor = __get_mass_convert_factor(quality_unit, old_quality_unit)
-
-                    quality_node_data *= convert_factor
-                    quality_link_data *= convert_factor
+                    scales["quality_node"] = convert_factor
+                    scales["quality_link"] = convert_factor
 
         if bulk_species_mass_unit is not None:
-            # Convert bulk species concentrations
-            if self.__frozen_sensor_config is True:
-                for i, species_id, _ in enumerate(self.__sensor_config.bulk_species_node_sensors):
-                    species_idx = self.__sensor_config.bulk_species.index(species_id)
-                    new_mass_unit = bulk_species_mass_unit[species_idx]
-                    old_mass_unit = self.__sensor_config.bulk_species_mass_unit[species_idx]
-
-                    if new_mass_unit != old_mass_unit:
-                        convert_factor = __get_mass_convert_factor(new_mass_unit, old_mass_unit)
-                        bulk_species_node_concentrations[:, i, :] *= convert_factor
-
-                for i, species_id, _ in enumerate(self.__sensor_config.bulk_species_link_sensors):
-                    species_idx = self.__sensor_config.bulk_species.index(species_id)
-                    new_mass_unit = bulk_species_mass_unit[species_idx]
-                    old_mass_unit = self.__sensor_config.bulk_species_mass_unit[species_idx]
-
-                    if new_mass_unit != old_mass_unit:
-                        convert_factor = __get_mass_convert_factor(new_mass_unit, old_mass_unit)
-                        bulk_species_link_concentrations[:, i, :] *= convert_factor
-            else:
-                for i in range(bulk_species_node_concentrations.shape[1]):
-                    if bulk_species_mass_unit[i] != self.__sensor_config.bulk_species_mass_unit[i]:
-                        old_mass_unit = self.__sensor_config.bulk_species_mass_unit[i]
-                        convert_factor = __get_mass_convert_factor(bulk_species_mass_unit[i],
-                                                                   old_mass_unit)
-
-                        bulk_species_node_concentrations[:, i, :] *= convert_factor
-                        bulk_species_link_concentrations[:, i, :] *= convert_factor
+            # Convert bulk species concentrations -- one factor per species
+            old_mass_units = self.__sensor_config.bulk_species_mass_unit
+            species_scales = np.array([1. if new_unit == old_unit else
+                                       __get_mass_convert_factor(new_unit, old_unit)
+                                       for new_unit, old_unit in zip(bulk_species_mass_unit,
+                                                                     old_mass_units)])
+            if np.any(species_scales != 1.):
+                scales["bulk_species"] = species_scales
 
         if surface_species_mass_unit is not None:
-            # Convert surface species concentrations
-            if self.__frozen_sensor_config is True:
-                for i, species_id, _ in enumerate(self.__sensor_config.surface_species_sensors):
-                    species_idx = self.__sensor_config.surface_species.index(species_id)
-                    new_mass_unit = surface_species_mass_unit[species_idx]
-                    old_mass_unit = self.__sensor_config.surface_species_mass_unit[species_idx]
-
-                    if new_mass_unit != old_mass_unit:
-                        convert_factor = __get_mass_convert_factor(new_mass_unit, old_mass_unit)
-                        surface_species_concentrations[:, i, :] *= convert_factor
-            else:
-                for i in range(surface_species_concentrations.shape[1]):
-                    old_mass_unit = self.__sensor_config.surface_species_mass_unit[i]
-                    if surface_species_mass_unit[i] != old_mass_unit:
-                        convert_factor = __get_mass_convert_factor(surface_species_mass_unit[i],
-                                                                   old_mass_unit)
-
-                        surface_species_concentrations[:, i, :] *= convert_factor
+            # Convert surface species concentrations -- one factor per species
+            old_mass_units = self.__sensor_config.surface_species_mass_unit
+            species_scales = np.array([1. if new_unit == old_unit else
+                                       __get_mass_convert_factor(new_unit, old_unit)
+                                       for new_unit, old_unit in zip(surface_species_mass_unit,
+                                                                     old_mass_units)])
+            if np.any(species_scales != 1.):
+                scales["surface_species"] = species_scales
 
         # Create new SCADA data instance
         new_flow_unit = self.__sensor_config.flow_unit
@@ -871,7 +875,7 @@ class ScadaData(Serializable):
 
         new_surface_species_area_unit = self.__sensor_config.surface_species_area_unit
         if surface_species_area_unit is not None:
-            new_surface_species_mass_unit = surface_species_area_unit
+            new_surface_species_area_unit = surface_species_area_unit
 
         sensor_config = SensorConfig(nodes=self.__sensor_config.nodes,
                                      links=self.__sensor_config.links,
@@ -913,24 +917,34 @@ class ScadaData(Serializable):
                                      surface_species_mass_unit=new_surface_species_mass_unit,
                                      surface_species_area_unit=new_surface_species_area_unit)
 
-        return ScadaData(sensor_config=sensor_config,
-                         sensor_readings_time=self.sensor_readings_time,
-                         sensor_reading_events=self.sensor_reading_events,
-                         sensor_noise=self.sensor_noise,
-                         frozen_sensor_config=self.frozen_sensor_config,
-                         pressure_data_raw=pressure_data,
-                         flow_data_raw=flow_data,
-                         demand_data_raw=demand_data,
-                         node_quality_data_raw=quality_node_data,
-                         link_quality_data_raw=quality_link_data,
-                         pumps_state_data_raw=self.pumps_state_data_raw,
-                         valves_state_data_raw=self.valves_state_data_raw,
-                         tanks_volume_data_raw=tanks_volume_data,
-                         pumps_energy_usage_data_raw=self.pumps_energyconsumption_data_raw,
-                         pumps_efficiency_data_raw=self.pumps_efficiency_data_raw,
-                         bulk_species_node_concentration_raw=bulk_species_node_concentrations,
-                         bulk_species_link_concentration_raw=bulk_species_link_concentrations,
-                         surface_species_concentration_raw=surface_species_concentrations)
+        # Scales are relative to the stored raw measurements
+        scales = self.__combine_unit_scales(self.__unit_scales, scales)
+
+        if inplace is True:
+            self.__unit_scales = scales
+            self.__apply_unit_scales()
+            self.__sensor_config = sensor_config
+            self.__init()
+            return self
+
+        scada_data = copy(self)
+        scada_data.__sensor_config = sensor_config
+        scada_data.__sensor_reading_events = list(self.__sensor_reading_events)
+        scada_data.__unit_scales = scales
+        if lazy is True:
+            # Share the raw measurements
+            self.__raw_data_shared = True
+            scada_data.__raw_data_shared = True
+        else:
+            scada_data.__raw_data_shared = False
+            for attr in ScadaData.__RAW_DATA_ATTRS:
+                data = getattr(self, f"_ScadaData__{attr}")
+                if data is not None:
+                    setattr(scada_data, f"_ScadaData__{attr}", data.copy())
+            scada_data.__apply_unit_scales()
+        scada_data.__init()
+
+        return scada_data
 
     @property
     def frozen_sensor_config(self) -> bool:
@@ -1039,7 +1053,7 @@ class ScadaData(Serializable):
         `numpy.ndarray`
             Raw pressure readings.
         """
-        return deepcopy(self.__pressure_data_raw)
+        return self.__get_raw_data("pressure_data_raw")
 
     @property
     def flow_data_raw(self) -> np.ndarray:
@@ -1051,7 +1065,7 @@ class ScadaData(Serializable):
         `numpy.ndarray`
             Raw flow readings.
         """
-        return deepcopy(self.__flow_data_raw)
+        return self.__get_raw_data("flow_data_raw")
 
     @property
     def demand_data_raw(self) -> np.ndarray:
@@ -1063,7 +1077,7 @@ class ScadaData(Serializable):
         `numpy.ndarray`
             Raw demand readings.
         """
-        return deepcopy(self.__demand_data_raw)
+        return self.__get_raw_data("demand_data_raw")
 
     @property
     def node_quality_data_raw(self) -> np.ndarray:
@@ -1075,7 +1089,7 @@ class ScadaData(Serializable):
         `numpy.ndarray`
             Raw node quality readings.
         """
-        return deepcopy(self.__node_quality_data_raw)
+        return self.__get_raw_data("node_quality_data_raw")
 
     @property
     def link_quality_data_raw(self) -> np.ndarray:
@@ -1087,7 +1101,7 @@ class ScadaData(Serializable):
         `numpy.ndarray`
             Raw link quality readings.
         """
-        return deepcopy(self.__link_quality_data_raw)
+        return self.__get_raw_data("link_quality_data_raw")
 
     @property
     def sensor_readings_time(self) -> np.ndarray:
@@ -1135,7 +1149,7 @@ class ScadaData(Serializable):
         `numpy.ndarray`
             Raw tank volume readings.
         """
-        return deepcopy(self.__tanks_volume_data_raw)
+        return self.__get_raw_data("tanks_volume_data_raw")
 
     @property
     def surface_species_concentration_raw(self) -> np.ndarray:
@@ -1147,7 +1161,7 @@ class ScadaData(Serializable):
         `numpy.ndarray`
             Raw species concentrations.
         """
-        return deepcopy(self.__surface_species_concentration_raw)
+        return self.__get_raw_data("surface_species_concentration_raw")
 
     @property
     def bulk_species_node_concentration_raw(self) -> np.ndarray:
@@ -1159,7 +1173,7 @@ class ScadaData(Serializable):
         `numpy.ndarray`
             Raw species concentrations.
         """
-        return deepcopy(self.__bulk_species_node_concentration_raw)
+        return self.__get_raw_data("bulk_species_node_concentration_raw")
 
     @property
     def bulk_species_link_concentration_raw(self) -> np.ndarray:
@@ -1171,7 +1185,7 @@ class ScadaData(Serializable):
         `numpy.ndarray`
             Raw species concentrations.
         """
-        return deepcopy(self.__bulk_species_link_concentration_raw)
+        return self.__get_raw_data("bulk_species_link_concentration_raw")
 
     @property
     def pumps_energyconsumption_data_raw(self) -> np.ndarray:
@@ -1249,23 +1263,104 @@ class ScadaData(Serializable):
 
         self.__sensor_readings = None
 
+    @staticmethod
+    def __combine_unit_scales(scales: dict, other_scales: dict) -> dict:
+        combined = dict(scales)
+        for key, scale in other_scales.items():
+            combined[key] = combined[key] * scale if key in combined else scale
+        return combined
+
+    def __get_raw_data_scale(self, attr: str) -> Any:
+        # Factor (broadcastable to the raw measurements) of a pending unit conversion
+        key = ScadaData.__RAW_DATA_UNIT_SCALES.get(attr, None)
+        if key not in self.__unit_scales:
+            return None
+
+        scale = self.__unit_scales[key]
+        if key not in ["bulk_species", "surface_species"]:
+            return scale
+        if self.__frozen_sensor_config is False:
+            return scale.reshape(1, -1, 1)
+
+        # Reduced species measurements are stored column-wise
+        sensor_config = self.__sensor_config
+        if attr == "bulk_species_node_concentration_raw":
+            sensors, species_to_idx = sensor_config.bulk_species_node_sensors, \
+                sensor_config.map_bulkspecies_id_to_idx
+        elif attr == "bulk_species_link_concentration_raw":
+            sensors, species_to_idx = sensor_config.bulk_species_link_sensors, \
+                sensor_config.map_bulkspecies_id_to_idx
+        else:
+            sensors, species_to_idx = sensor_config.surface_species_sensors, \
+                sensor_config.map_surfacespecies_id_to_idx
+        return np.concatenate([np.full(len(sensors[species_id]), scale[species_to_idx(species_id)])
+                               for species_id in sensors.keys()])
+
+    def __get_raw_data(self, attr: str, copy_data: bool = True) -> np.ndarray:
+        data = getattr(self, f"_ScadaData__{attr}")
+        scale = self.__get_raw_data_scale(attr)
+        if data is None:
+            return None
+        elif scale is not None:
+            return data * scale
+        else:
+            return deepcopy(data) if copy_data is True else data
+
+    def __apply_unit_scales(self) -> None:
+        # Applies all pending unit conversions to the stored raw measurements --
+        # raw measurements that are shared with other instances are not changed but replaced
+        for attr in ScadaData.__RAW_DATA_UNIT_SCALES:
+            data = getattr(self, f"_ScadaData__{attr}")
+            scale = self.__get_raw_data_scale(attr)
+            if data is None or scale is None:
+                continue
+
+            if self.__raw_data_shared is False and np.issubdtype(data.dtype, np.floating):
+                data *= scale
+            else:
+                setattr(self, f"_ScadaData__{attr}", data * scale)
+
+        self.__unit_scales = {}
+
+    def __get_column_scales(self, n_columns: int) -> np.ndarray:
+        # Pending unit conversions of the columns returned by get_data()
+        sensor_config = self.__sensor_config
+        sensors_id_to_idx = sensor_config.sensors_id_to_idx
+
+        scales = np.ones(n_columns)
+        for key in ["pressure", "flow", "demand", "quality_node", "quality_link", "tank_volume"]:
+            if key in self.__unit_scales:
+                scales[list(sensors_id_to_idx[key].values())] = self.__unit_scales[key]
+
+        for sensor_type, key, species_to_idx in \
+                [("bulk_species_node", "bulk_species", sensor_config.map_bulkspecies_id_to_idx),
+                 ("bulk_species_link", "bulk_species", sensor_config.map_bulkspecies_id_to_idx),
+                 ("surface_species", "surface_species",
+                  sensor_config.map_surfacespecies_id_to_idx)]:
+            if key in self.__unit_scales:
+                for species_id, cols in sensors_id_to_idx[sensor_type].items():
+                    scales[list(cols.values())] = \
+                        self.__unit_scales[key][species_to_idx(species_id)]
+
+        return scales
+
     def get_attributes(self) -> dict:
         attr = {"sensor_config": self.__sensor_config,
                 "frozen_sensor_config": self.__frozen_sensor_config,
                 "sensor_noise": self.__sensor_noise,
                 "sensor_reading_events": self.__sensor_reading_events,
-                "pressure_data_raw": self.__pressure_data_raw,
-                "flow_data_raw": self.__flow_data_raw,
-                "demand_data_raw": self.__demand_data_raw,
-                "node_quality_data_raw": self.__node_quality_data_raw,
-                "link_quality_data_raw": self.__link_quality_data_raw,
+                "pressure_data_raw": self.__get_raw_data("pressure_data_raw", False),
+                "flow_data_raw": self.__get_raw_data("flow_data_raw", False),
+                "demand_data_raw": self.__get_raw_data("demand_data_raw", False),
+                "node_quality_data_raw": self.__get_raw_data("node_quality_data_raw", False),
+                "link_quality_data_raw": self.__get_raw_data("link_quality_data_raw", False),
                 "sensor_readings_time": self.__sensor_readings_time,
                 "pumps_state_data_raw": self.__pumps_state_data_raw,
                 "valves_state_data_raw": self.__valves_state_data_raw,
-                "tanks_volume_data_raw": self.__tanks_volume_data_raw,
-                "surface_species_concentration_raw": self.__surface_species_concentration_raw,
-                "bulk_species_node_concentration_raw": self.__bulk_species_node_concentration_raw,
-                "bulk_species_link_concentration_raw": self.__bulk_species_link_concentration_raw,
+                "tanks_volume_data_raw": self.__get_raw_data("tanks_volume_data_raw", False),
+                "surface_species_concentration_raw": self.__get_raw_data("surface_species_concentration_raw", False),
+                "bulk_species_node_concentration_raw": self.__get_raw_data("bulk_species_node_concentration_raw", False),
+                "bulk_species_link_concentration_raw": self.__get_raw_data("bulk_species_link_concentration_raw", False),
                 "pumps_energy_usage_data_raw": self.__pumps_energy_usage_data_raw,
                 "pumps_efficiency_data_raw": self.__pumps_efficiency_data_raw}
 
@@ -1281,20 +1376,20 @@ class ScadaData(Serializable):
                 and self.__sensor_noise == other.sensor_noise \
                 and all(a == b for a, b in
                         zip(self.__sensor_reading_events, other.sensor_reading_events)) \
-                and np.all(self.__pressure_data_raw == other.pressure_data_raw) \
-                and np.all(self.__flow_data_raw == other.flow_data_raw) \
-                and np.all(self.__demand_data_raw == self.demand_data_raw) \
-                and np.all(self.__node_quality_data_raw == other.node_quality_data_raw) \
-                and np.all(self.__link_quality_data_raw == other.link_quality_data_raw) \
+                and np.all(self.__get_raw_data("pressure_data_raw", False) == other.pressure_data_raw) \
+                and np.all(self.__get_raw_data("flow_data_raw", False) == other.flow_data_raw) \
+                and np.all(self.__get_raw_data("demand_data_raw", False) == other.demand_data_raw) \
+                and np.all(self.__get_raw_data("node_quality_data_raw", False) == other.node_quality_data_raw) \
+                and np.all(self.__get_raw_data("link_quality_data_raw", False) == other.link_quality_data_raw) \
                 and np.all(self.__sensor_readings_time == other.sensor_readings_time) \
                 and np.all(self.__pumps_state_data_raw == other.pumps_state_data_raw) \
                 and np.all(self.__valves_state_data_raw == other.valves_state_data_raw) \
-                and np.all(self.__tanks_volume_data_raw == other.tanks_volume_data_raw) \
-                and np.all(self.__surface_species_concentration_raw ==
+                and np.all(self.__get_raw_data("tanks_volume_data_raw", False) == other.tanks_volume_data_raw) \
+                and np.all(self.__get_raw_data("surface_species_concentration_raw", False) ==
                            other.surface_species_concentration_raw) \
-                and np.all(self.__bulk_species_node_concentration_raw ==
+                and np.all(self.__get_raw_data("bulk_species_node_concentration_raw", False) ==
                            other.bulk_species_node_concentration_raw) \
-                and np.all(self.__bulk_species_link_concentration_raw ==
+                and np.all(self.__get_raw_data("bulk_species_link_concentration_raw", False) ==
                            other.bulk_species_link_concentration_raw) \
                 and np.all(self.__pumps_energy_usage_data_raw ==
                            other.pumps_energyconsumption_data_raw) \
@@ -1423,6 +1518,7 @@ class ScadaData(Serializable):
         other : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData`
             Other scada data to be concatenated to this data.
         """
+        self.__apply_unit_scales()
         if not isinstance(other, ScadaData):
             raise TypeError("'other' must be an instance of 'ScadaData' " +
                             f"but not of '{type(other)}'")
@@ -1526,6 +1622,7 @@ class ScadaData(Serializable):
         other : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData`
             Other scada data to be concatenated to this data.
         """
+        self.__apply_unit_scales()
         if not isinstance(other, ScadaData):
             raise TypeError(f"'other' must be an instance of 'ScadaData' but not of {type(other)}")
         if self.__sensor_config != other.sensor_config:
@@ -1662,6 +1759,10 @@ class ScadaData(Serializable):
 
             sensor_readings = np.concatenate(data, axis=1)
 
+        # Apply pending unit conversions to the requested columns only
+        if len(self.__unit_scales) != 0:
+            sensor_readings *= self.__get_column_scales(sensor_readings.shape[1])
+
         # Apply sensor uncertainties
         state_sensors_idx = []   # Pump states and valve states are NOT affected!
         for link_id in self.sensor_config.pump_state_sensors:
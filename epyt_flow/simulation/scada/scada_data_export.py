@@ -3,6 +3,12 @@ Module provides classes for exporting SCADA data stored in
 :class:`~epyt_flow.simulation.scada.scada_data.ScadaData`.
 """
 from abc import abstractmethod
+from typing import Iterator
+from concurrent.futures import ThreadPoolExecutor
+import os
+import json
+import struct
+import zlib
 import numpy as np
 from scipy.io import savemat
 import pandas as pd
@@ -280,3 +286,398 @@ class ScadaDataMatlabExport(ScadaDataExport):
                              "sensor_readings_time": sensor_readings_time,
                              "col_desc": col_desc,
                              "flow_unit": scada_data.sensor_config.flow_unit})
+
+
+class ScadaDataChunkedExport(ScadaDataExport):
+    """
+    Class for exporting SCADA data to a compressed, chunked, and columnar binary file
+    (.epytflow_chunked) -- the data can be written incrementally (e.g. the results of
+    :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.run_simulation_as_generator`)
+    without keeping the whole data set in memory, and can be read back column-wise and
+    chunk-wise by :class:`ScadaDataChunkedReader`.
+
+    The sensor readings are collected in chunks of `chunk_size` time steps. Every column of a
+    chunk is byte-shuffled and compressed (zlib) independently -- the columns of a chunk are
+    compressed in parallel. The file ends with a footer (JSON) containing the column
+    descriptions (see :func:`create_column_desc`) and the location of every compressed column.
+
+    Usage with a running simulation:
+
+    .. code-block:: python
+
+        with ScadaDataChunkedExport(f_out="results.epytflow_chunked") as export:
+            for scada_data in sim.run_simulation_as_generator():
+                export.append(scada_data)
+
+    Parameters
+    ----------
+    f_out : `str`
+        Path to the file to which the SCADA data will be exported.
+    export_raw_data : `bool`, optional
+        If True, the raw measurements (i.e. sensor reading without any noise or faults)
+        are exported instead of the final sensor readings.
+
+        The default is False.
+    chunk_size : `int`, optional
+        Number of time steps per chunk.
+
+        The default is 4096.
+    compression_level : `int`, optional
+        zlib compression level (0 - 9).
+
+        The default is 6.
+    n_threads : `int`, optional
+        Number of threads used for compressing the columns of a chunk.
+        If None, the number of CPUs is used.
+
+        The default is None.
+    """
+    MAGIC = b"EPYTFLOWCHUNKS01"
+
+    def __init__(self, f_out: str, export_raw_data: bool = False, chunk_size: int = 4096,
+                 compression_level: int = 6, n_threads: int = None, **kwds):
+        if not isinstance(chunk_size, int):
+            raise TypeError("'chunk_size' must be an instance of 'int' " +
+                            f"but not of '{type(chunk_size)}'")
+        if chunk_size <= 0:
+            raise ValueError("'chunk_size' must be positive")
+        if not isinstance(compression_level, int):
+            raise TypeError("'compression_level' must be an instance of 'int' " +
+                            f"but not of '{type(compression_level)}'")
+        if not 0 <= compression_level <= 9:
+            raise ValueError("'compression_level' must be in [0, 9]")
+        if n_threads is not None:
+            if not isinstance(n_threads, int):
+                raise TypeError("'n_threads' must be an instance of 'int' " +
+                                f"but not of '{type(n_threads)}'")
+            if n_threads <= 0:
+                raise ValueError("'n_threads' must be positive")
+
+        self.__chunk_size = chunk_size
+        self.__compression_level = compression_level
+        self.__n_threads = n_threads if n_threads is not None else (os.cpu_count() or 1)
+
+        self.__file = None
+        self.__executor = None
+        self.__col_desc = None
+        self.__flow_unit = None
+        self.__dtypes = None
+        self.__chunks = []
+        self.__buffer = []
+        self.__buffer_time = []
+        self.__n_buffered = 0
+
+        super().__init__(f_out=f_out, export_raw_data=export_raw_data, **kwds)
+
+    @property
+    def chunk_size(self) -> int:
+        """
+        Gets the number of time steps per chunk.
+
+        Returns
+        -------
+        `int`
+            Number of time steps per chunk.
+        """
+        return self.__chunk_size
+
+    @property
+    def compression_level(self) -> int:
+        """
+        Gets the zlib compression level.
+
+        Returns
+        -------
+        `int`
+            Compression level.
+        """
+        return self.__compression_level
+
+    @property
+    def n_threads(self) -> int:
+        """
+        Gets the number of threads used for compressing the columns of a chunk.
+
+        Returns
+        -------
+        `int`
+            Number of threads.
+        """
+        return self.__n_threads
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def __compress(self, column: np.ndarray) -> bytes:
+        # Byte-shuffling groups the bytes of equal significance, which compresses much better
+        shuffled = column.view(np.uint8).reshape(-1, column.itemsize).T.tobytes()
+        return zlib.compress(shuffled, self.__compression_level)
+
+    def __flush(self) -> None:
+        if self.__n_buffered == 0:
+            return
+
+        data = np.concatenate(self.__buffer, axis=0)
+        columns = [np.ascontiguousarray(np.concatenate(self.__buffer_time))] + \
+            [np.ascontiguousarray(data[:, i]) for i in range(data.shape[1])]
+        self.__buffer, self.__buffer_time, self.__n_buffered = [], [], 0
+        del data
+
+        # Compress all columns in parallel but write them in order
+        chunk = {"n_rows": len(columns[0]), "columns": []}
+        for compressed in self.__executor.map(self.__compress, columns):
+            chunk["columns"].append([self.__file.tell(), len(compressed)])
+            self.__file.write(compressed)
+        self.__chunks.append(chunk)
+
+    def append(self, scada_data: ScadaData) -> None:
+        """
+        Appends given SCADA data (e.g. the results of a single simulation step) to the file --
+        the file is created when this function is called for the first time.
+        All appended SCADA data must have the same sensor configuration.
+
+        Parameters
+        ----------
+        scada_data : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData`
+            SCADA data to be appended.
+        """
+        if not isinstance(scada_data, ScadaData):
+            raise TypeError("'scada_data' must be an instance of " +
+                            "'epyt_flow.simulation.scada_data.ScadaData' and not of " +
+                            f"'{type(scada_data)}'")
+
+        old_sensor_config = None
+        if self.export_raw_data is True:
+            # Backup old sensor config and set a new one with sensors everywhere
+            old_sensor_config = scada_data.sensor_config
+            scada_data.change_sensor_config(self.create_global_sensor_config(scada_data))
+
+        sensor_readings = scada_data.get_data()
+        sensor_readings_time = np.asarray(scada_data.sensor_readings_time)
+        if self.__file is None:
+            self.__col_desc = self.create_column_desc(scada_data)
+            self.__flow_unit = scada_data.sensor_config.flow_unit
+            self.__dtypes = [sensor_readings_time.dtype.str, sensor_readings.dtype.str]
+            self.__file = open(self.f_out, "wb")
+            self.__file.write(ScadaDataChunkedExport.MAGIC)
+            self.__executor = ThreadPoolExecutor(max_workers=self.__n_threads)
+
+        if self.export_raw_data is True:
+            # Restore old sensor config
+            scada_data.change_sensor_config(old_sensor_config)
+
+        if sensor_readings.shape[1] != len(self.__col_desc):
+            raise ValueError("Number of sensors does not match the previously appended data")
+
+        # Split the data at chunk boundaries
+        start = 0
+        while start < sensor_readings.shape[0]:
+            n = min(self.__chunk_size - self.__n_buffered, sensor_readings.shape[0] - start)
+            self.__buffer.append(sensor_readings[start:start + n].astype(self.__dtypes[1]))
+            self.__buffer_time.append(sensor_readings_time[start:start + n].
+                                      astype(self.__dtypes[0]))
+            self.__n_buffered += n
+            start += n
+
+            if self.__n_buffered == self.__chunk_size:
+                self.__flush()
+
+    def close(self) -> None:
+        """
+        Writes the remaining data and the footer, and closes the file.
+        """
+        if self.__file is None:
+            return
+
+        try:
+            self.__flush()
+
+            footer = json.dumps({"col_desc": self.__col_desc.tolist(),
+                                 "flow_unit": int(self.__flow_unit),
+                                 "dtypes": self.__dtypes,
+                                 "chunks": self.__chunks}).encode()
+            self.__file.write(footer)
+            self.__file.write(struct.pack("<Q", len(footer)))
+            self.__file.write(ScadaDataChunkedExport.MAGIC)
+        finally:
+            self.__file.close()
+            self.__executor.shutdown()
+            self.__file = None
+            self.__executor = None
+            self.__chunks = []
+
+    def export(self, scada_data: ScadaData) -> None:
+        """
+        Exports given SCADA data.
+
+        Parameters
+        ----------
+        scada_data : :class:`~epyt_flow.simulation.scada.scada_data.ScadaData`
+            SCADA data to be exported.
+        """
+        try:
+            self.append(scada_data)
+        finally:
+            self.close()
+
+
+class ScadaDataChunkedReader():
+    """
+    Class for reading SCADA data that was exported by :class:`ScadaDataChunkedExport` --
+    only the requested columns and chunks are read and decompressed.
+
+    Parameters
+    ----------
+    f_in : `str`
+        Path to the file.
+    n_threads : `int`, optional
+        Number of threads used for decompressing the columns of a chunk.
+        If None, the number of CPUs is used.
+
+        The default is None.
+    """
+    def __init__(self, f_in: str, n_threads: int = None, **kwds):
+        self.__f_in = f_in
+        self.__n_threads = n_threads if n_threads is not None else (os.cpu_count() or 1)
+
+        magic = ScadaDataChunkedExport.MAGIC
+        with open(f_in, "rb") as f:
+            if f.read(len(magic)) != magic:
+                raise ValueError(f"'{f_in}' is not a chunked SCADA data file")
+            f.seek(-len(magic) - 8, os.SEEK_END)
+            footer_size = struct.unpack("<Q", f.read(8))[0]
+            if f.read(len(magic)) != magic:
+                raise ValueError(f"'{f_in}' is incomplete -- was the export closed?")
+            f.seek(-len(magic) - 8 - footer_size, os.SEEK_END)
+            footer = json.loads(f.read(footer_size).decode())
+
+        self.__col_desc = np.array(footer["col_desc"], dtype=object)
+        self.__flow_unit = footer["flow_unit"]
+        self.__dtypes = [np.dtype(dtype) for dtype in footer["dtypes"]]
+        self.__chunks = footer["chunks"]
+
+        super().__init__(**kwds)
+
+    @property
+    def col_desc(self) -> np.ndarray:
+        """
+        Gets the column descriptions -- see :func:`ScadaDataExport.create_column_desc`.
+
+        Returns
+        -------
+        `numpy.ndarray`
+            Column descriptions.
+        """
+        return self.__col_desc
+
+    @property
+    def flow_unit(self) -> int:
+        """
+        Gets the flow unit of the exported SCADA data.
+
+        Returns
+        -------
+        `int`
+            Flow unit ID.
+        """
+        return self.__flow_unit
+
+    @property
+    def n_rows(self) -> int:
+        """
+        Gets the number of time steps.
+
+        Returns
+        -------
+        `int`
+            Number of time steps.
+        """
+        return sum(chunk["n_rows"] for chunk in self.__chunks)
+
+    @property
+    def n_chunks(self) -> int:
+        """
+        Gets the number of chunks.
+
+        Returns
+        -------
+        `int`
+            Number of chunks.
+        """
+        return len(self.__chunks)
+
+    @staticmethod
+    def __decompress(data: bytes, dtype: np.dtype, n_rows: int) -> np.ndarray:
+        shuffled = np.frombuffer(zlib.decompress(data), dtype=np.uint8)
+        return shuffled.reshape(dtype.itemsize, n_rows).T.copy().view(dtype).reshape(-1)
+
+    def iter_chunks(self, columns: list[int] = None) -> Iterator[tuple[np.ndarray, np.ndarray]]:
+        """
+        Iterates over all chunks.
+
+        Parameters
+        ----------
+        columns : `list[int]`, optional
+            Indices of the columns (sensor readings) that are read.
+            If None, all columns are read.
+
+            The default is None.
+
+        Returns
+        -------
+        `Iterator[tuple[numpy.ndarray, numpy.ndarray]]`
+            Time steps and sensor readings of every chunk.
+        """
+        if columns is None:
+            columns = list(range(len(self.__col_desc)))
+
+        with open(self.__f_in, "rb") as f, \
+                ThreadPoolExecutor(max_workers=self.__n_threads) as executor:
+            for chunk in self.__chunks:
+                n_rows = chunk["n_rows"]
+                data = []
+                for col in [0] + [c + 1 for c in columns]:
+                    offset, size = chunk["columns"][col]
+                    f.seek(offset)
+                    data.append(f.read(size))
+
+                dtypes = [self.__dtypes[0]] + [self.__dtypes[1]] * len(columns)
+                data = list(executor.map(ScadaDataChunkedReader.__decompress, data, dtypes,
+                                         [n_rows] * len(data)))
+
+                sensor_readings = np.empty((n_rows, len(columns)), dtype=self.__dtypes[1])
+                for i, column in enumerate(data[1:]):
+                    sensor_readings[:, i] = column
+                yield data[0], sensor_readings
+
+    def read(self, columns: list[int] = None) -> tuple[np.ndarray, np.ndarray]:
+        """
+        Reads the time steps and the sensor readings.
+
+        Parameters
+        ----------
+        columns : `list[int]`, optional
+            Indices of the columns (sensor readings) that are read.
+            If None, all columns are read.
+
+            The default is None.
+
+        Returns
+        -------
+        `tuple[numpy.ndarray, numpy.ndarray]`
+            Time steps and sensor readings.
+        """
+        n_columns = len(self.__col_desc) if columns is None else len(columns)
+        sensor_readings_time = np.empty(self.n_rows, dtype=self.__dtypes[0])
+        sensor_readings = np.empty((self.n_rows, n_columns), dtype=self.__dtypes[1])
+
+        t = 0
+        for chunk_time, chunk_data in self.iter_chunks(columns):
+            sensor_readings_time[t:t + len(chunk_time)] = chunk_time
+            sensor_readings[t:t + len(chunk_time)] = chunk_data
+            t += len(chunk_time)
+
+        return sensor_readings_time, sensor_readings
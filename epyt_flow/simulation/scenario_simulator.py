@@ -6,6 +6,7 @@ import os
 import pathlib
 from typing import Generator, Union
 from copy import deepcopy
+from contextlib import AbstractContextManager
 import shutil
 import warnings
 import random
@@ -29,6 +30,13 @@ from .events import SystemEvent, Leakage, ActuatorEvent, SensorFault, SensorRead
     SensorReadingEvent
 from .scada import ScadaData, AdvancedControlModule
 from ..topology import NetworkTopology, UNITS_SIMETRIC, UNITS_USCUSTOM
+from .native_api import has_native_function, get_adjacency, set_profiling, get_profile, \
+    set_msx_profiling, get_msx_profile, set_tracing, set_msx_tracing, set_diagnostics, \
+    get_diagnostics, get_memory_usage, get_solver_memory, get_msx_memory_usage, network_edit, \
+    set_demand_patterns, set_warm_start, set_warm_start_tolerance, get_warm_start_stats, \
+    set_quality_routing
+from .memory_model import get_memory_model
+from .tracing import get_tracer
 from ..utils import get_temp_folder
 
 
@@ -93,6 +101,13 @@ class ScenarioSimulator():
         self.__controls = []
         self.__system_events = []
         self.__sensor_reading_events = []
+        self.__profiling = False
+        self.__profile = None
+        self.__solver_diagnostics = False
+        self.__solver_diagnostics_data = None
+        self.__warm_start = False
+        self.__warm_start_stats = None
+        self.__memory_usage = None
 
         custom_epanet_lib = None
         custom_epanetmsx_lib = None
@@ -110,12 +125,13 @@ class ScenarioSimulator():
             if os.path.isfile(os.path.join(path_to_custom_libs, libepanetmsx_name)):
                 custom_epanetmsx_lib = os.path.join(path_to_custom_libs, libepanetmsx_name)
 
-        self.epanet_api = epanet(self.__f_inp_in, ph=self.__f_msx_in is None,
-                                 customlib=custom_epanet_lib, loadfile=True,
-                                 display_msg=epanet_verbose)
+        with get_tracer().span("load_network", f_inp=self.__f_inp_in):
+            self.epanet_api = epanet(self.__f_inp_in, ph=self.__f_msx_in is None,
+                                     customlib=custom_epanet_lib, loadfile=True,
+                                     display_msg=epanet_verbose)
 
-        if self.__f_msx_in is not None:
-            self.epanet_api.loadMSXFile(self.__f_msx_in, customMSXlib=custom_epanetmsx_lib)
+            if self.__f_msx_in is not None:
+                self.epanet_api.loadMSXFile(self.__f_msx_in, customMSXlib=custom_epanetmsx_lib)
 
         self.__sensor_config = self.__get_empty_sensor_config()
         if scenario_config is not None:
@@ -128,8 +144,9 @@ class ScenarioSimulator():
 
             for control in scenario_config.controls:
                 self.add_control(control)
-            for event in scenario_config.system_events:
-                self.add_system_event(event)
+            with network_edit(self.epanet_api):
+                for event in scenario_config.system_events:
+                    self.add_system_event(event)
             for event in scenario_config.sensor_reading_events:
                 self.add_sensor_reading_event(event)
 
@@ -729,30 +746,127 @@ class ScenarioSimulator():
                               system_events=self.system_events,
                               sensor_reading_events=self.sensor_reading_events)
 
-    def estimate_memory_consumption(self) -> float:
+    def get_memory_usage(self, last_run: bool = False) -> dict:
         """
-        Estimates the memory consumption of the simulation -- i.e. the amount of memory that is
-        needed on the hard disk as well as in RAM.
+        Gets the amount of memory that is allocated by EPANET (and EPANET-MSX).
+
+        Note that this requires the EPANET (and EPANET-MSX) library shipped with EPyT-Flow.
+
+        Parameters
+        ----------
+        last_run : `bool`, optional
+            If True, the memory that was allocated at the end of the most recent simulation run
+            is returned -- i.e. after all pipe segments were created and the hydraulics were
+            written to the hard disk. Otherwise, the currently allocated memory is returned.
+
+            The default is False.
 
         Returns
         -------
-        `float`
-            Estimated memory consumption in MB.
+        `dict`
+            Number of bytes for each category -- i.e. "epanet" (and "epanet_msx" if an .msx file
+            is used) -> category -> bytes.
+            See :data:`~epyt_flow.simulation.native_api.EN_MEMORY_CATEGORIES` and
+            :data:`~epyt_flow.simulation.native_api.MSX_MEMORY_CATEGORIES` for the categories.
+            None if 'last_run' is True and no simulation was run yet.
+        """
+        if last_run is True:
+            return deepcopy(self.__memory_usage)
+
+        memory_usage = {"epanet": get_memory_usage(self.epanet_api)}
+        if self.__f_msx_in is not None:
+            memory_usage["epanet_msx"] = get_msx_memory_usage(self.epanet_api)
+
+        return memory_usage
+
+    def __get_engine_memory(self) -> float:
+        n_nodes = self.epanet_api.getNodeCount()
+        n_links = self.epanet_api.getLinkCount()
+
+        if not has_native_function(self.epanet_api, "getmemoryusage"):
+            # Fixed size ID hash tables + avg. allocations per node & link
+            return 2.2e6 + 300. * (n_nodes + n_links)
+
+        n_bytes = sum(n_bytes for category, n_bytes in get_memory_usage(self.epanet_api).items()
+                      if category != "files")
+        if has_native_function(self.epanet_api, "getsolvermemory"):
+            # Allocations of the solvers (if not opened yet) -- estimated without opening them
+            n_bytes += get_solver_memory(self.epanet_api)
+
+        if self.__f_msx_in is not None:
+            try:
+                n_bytes += sum(n_bytes for category, n_bytes in
+                               get_msx_memory_usage(self.epanet_api).items()
+                               if category != "files")
+            except RuntimeError:
+                pass
+
+        return float(n_bytes)
+
+    def get_memory_features(self) -> dict[str, float]:
+        """
+        Gets the features of this scenario that are used for predicting its memory consumption
+        (see :class:`~epyt_flow.simulation.memory_model.MemoryModel`).
+
+        The memory allocated by the engines is queried from the engines -- the allocations of
+        solvers that are not opened yet are estimated without opening them, i.e. the state of
+        the engines is left unchanged. This requires the EPANET (and EPANET-MSX) library shipped
+        with EPyT-Flow, otherwise it is approximated based on the number of nodes and links.
+
+        Returns
+        -------
+        `dict[str, float]`
+            Features in bytes -- see
+            :data:`~epyt_flow.simulation.memory_model.MEMORY_MODEL_FEATURES`.
         """
         self.__adapt_to_network_changes()
 
-        n_time_steps = int(self.epanet_api.getTimeSimulationDuration() /
-                           self.epanet_api.getTimeReportingStep())
-        n_quantities = self.epanet_api.getNodeCount() * 3 + self.epanet_api.getNodeTankCount() + \
-                       self.epanet_api.getLinkValveCount() + self.epanet_api.getLinkPumpCount() + \
-                       self.epanet_api.getLinkCount() * 2
+        n_nodes = self.epanet_api.getNodeCount()
+        n_links = self.epanet_api.getLinkCount()
+        simulation_duration = self.epanet_api.getTimeSimulationDuration()
+        n_time_steps = int(simulation_duration / self.epanet_api.getTimeReportingStep()) + 1
+        n_hyd_time_steps = int(simulation_duration / self.epanet_api.getTimeHydraulicStep()) + 1
+
+        # Results: pressures, demands, qualities, flows, pump & valve states, tank volumes, etc.
+        n_quantities = n_nodes * 3 + n_links * 2 + self.epanet_api.getLinkPumpCount() * 3 + \
+            self.epanet_api.getLinkValveCount() + self.epanet_api.getNodeTankCount() + 1
 
+        # Hydraulics file: time, demands & heads of all nodes,
+        # flows, status & settings of all links, and time step
+        n_hyd_file_bytes = n_hyd_time_steps * 4 * (2 * n_nodes + 3 * n_links + 2)
+
+        n_segment_bytes = 0
+        if self.epanet_api.getQualityInfo().QualityCode != ToolkitConstants.EN_NONE:
+            n_segment_bytes = n_links * 24     # sizeof(struct Sseg)
+
+        n_msx_segment_bytes = 0
         if self.__f_msx_in is not None:
-            n_quantities += self.epanet_api.getLinkCount() * 2 + self.epanet_api.getNodeCount()
+            n_species = len(self.epanet_api.getMSXSpeciesNameID())
+            n_quantities += n_species * (n_nodes + n_links)
+            n_msx_segment_bytes = n_links * (72 + 2 * 8 * (n_species + 1))
 
-        n_bytes_per_quantity = 64
+        return {"engine": self.__get_engine_memory(),
+                "segments": float(n_segment_bytes),
+                "msx_segments": float(n_msx_segment_bytes),
+                "results": float(n_time_steps * n_quantities * 8),
+                "files": float(n_hyd_file_bytes)}
 
-        return n_time_steps * n_quantities * n_bytes_per_quantity * .000001
+    def estimate_memory_consumption(self) -> float:
+        """
+        Estimates the memory consumption of the simulation -- i.e. the amount of memory that is
+        needed on the hard disk as well as in RAM.
+
+        The estimate is computed by the current memory model
+        (see :func:`~epyt_flow.simulation.memory_model.get_memory_model`) from the features
+        of this scenario (see
+        :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.get_memory_features`).
+
+        Returns
+        -------
+        `float`
+            Estimated memory consumption in MB.
+        """
+        return get_memory_model().predict(self.get_memory_features())
 
     def get_topology(self) -> NetworkTopology:
         """
@@ -824,8 +938,13 @@ class ScenarioSimulator():
             valve_type = links_type[link_idx]
             valves[valve_id] = {"type": valve_type, "end_points": link}
 
+        adjacency = None
+        if has_native_function(self.epanet_api, "getadjacency"):
+            adjacency = get_adjacency(self.epanet_api)
+
         return NetworkTopology(f_inp=self.f_inp_in, nodes=nodes, links=links, pumps=pumps,
-                               valves=valves, units=self.get_units_category())
+                               valves=valves, units=self.get_units_category(),
+                               adjacency=adjacency)
 
     def randomize_demands(self) -> None:
         """
@@ -890,6 +1009,54 @@ class ScenarioSimulator():
         self.epanet_api.setNodeJunctionData(node_idx, self.epanet_api.getNodeElevations(node_idx),
                                             base_demand, demand_pattern_id)
 
+    def set_node_demand_patterns(self, nodes_id: list[str], base_demands: np.ndarray,
+                                 demand_patterns_id: list[str],
+                                 demand_patterns: np.ndarray) -> None:
+        """
+        Sets the demand patterns (incl. base demands) of many nodes at once --
+        see :func:`set_node_demand_pattern`.
+
+        All patterns are uploaded to EPANET in a single call, which is much faster than
+        setting them one by one when generating patterns for all nodes
+        (see :mod:`~epyt_flow.simulation.demand_synthesis`).
+
+        Parameters
+        ----------
+        nodes_id : `list[str]`
+            IDs of the nodes for which the demand patterns are set.
+        base_demands : `numpy.ndarray`
+            Base demand of each node.
+        demand_patterns_id : `list[str]`
+            ID of each new demand pattern.
+        demand_patterns : `numpy.ndarray`
+            Demand patterns -- rows correspond to nodes and columns to time steps.
+            Final demand over time = base_demand * demand_pattern
+        """
+        self.__adapt_to_network_changes()
+
+        if not isinstance(nodes_id, list):
+            raise TypeError("'nodes_id' must be an instance of 'list[str]' " +
+                            f"but not of '{type(nodes_id)}'")
+        node_to_idx = {node_id: idx for idx, node_id in enumerate(self.__sensor_config.nodes)}
+        if any(node_id not in node_to_idx for node_id in nodes_id):
+            raise ValueError("Unknown node in 'nodes_id'")
+        if not isinstance(base_demands, np.ndarray):
+            raise TypeError("'base_demands' must be an instance of 'numpy.ndarray' " +
+                            f"but not of '{type(base_demands)}'")
+        if not isinstance(demand_patterns_id, list) or \
+                any(not isinstance(pattern_id, str) for pattern_id in demand_patterns_id):
+            raise TypeError("'demand_patterns_id' must be an instance of 'list[str]'")
+        if not isinstance(demand_patterns, np.ndarray):
+            raise TypeError("'demand_patterns' must be an instance of 'numpy.ndarray' " +
+                            f"but not of '{type(demand_patterns)}'")
+        if len(demand_patterns.shape) != 2:
+            raise ValueError(f"Inconsistent demand patterns shape '{demand_patterns.shape}' " +
+                             "detected. Expected a two dimensional array!")
+
+        nodes_idx = np.array([node_to_idx[node_id] for node_id in nodes_id], dtype=int)
+        set_demand_patterns(self.epanet_api, nodes_idx, base_demands,
+                            demand_patterns_id, demand_patterns)
+
     def add_control(self, control: AdvancedControlModule) -> None:
         """
         Adds a control module to the scenario simulation.
@@ -963,6 +1130,26 @@ class ScenarioSimulator():
 
         self.__system_events.append(event)
 
+    def edit_network(self) -> AbstractContextManager:
+        """
+        Gets a context manager that batches all changes of the network's structure --
+        e.g. splitting pipes when adding many leakages:
+
+        .. code-block:: python
+
+            with sim.edit_network():
+                for leakage in leakages:
+                    sim.add_leakage(leakage)
+
+        See :func:`~epyt_flow.simulation.native_api.network_edit` for details.
+
+        Returns
+        -------
+        `contextlib.AbstractContextManager`
+            Context manager.
+        """
+        return network_edit(self.epanet_api)
+
     def add_sensor_fault(self, sensor_fault_event: SensorFault) -> None:
         """
         Adds a sensor fault to the scenario simulation.
@@ -1360,6 +1547,12 @@ class ScenarioSimulator():
         reporting_time_step = self.epanet_api.getTimeReportingStep()
         hyd_time_step = self.epanet_api.getTimeHydraulicStep()
 
+        if self.__profiling is True:
+            set_msx_profiling(self.epanet_api, True)
+
+        tracer = get_tracer()
+        native_tracing = self.__start_native_tracing(msx=True)
+
         self.epanet_api.initializeMSXQualityAnalysis(ToolkitConstants.EN_NOSAVE)
 
         bulk_species_idx = self.epanet_api.getMSXSpeciesIndex(self.__sensor_config.bulk_species)
@@ -1461,7 +1654,11 @@ class ScenarioSimulator():
                     break
 
             # Compute current time step
-            total_time, tleft = self.epanet_api.stepMSXQualityAnalysisTimeLeft()
+            with tracer.span("time_step"):
+                total_time, tleft = self.epanet_api.stepMSXQualityAnalysisTimeLeft()
+
+            if native_tracing is True:
+                tracer.collect_native_events(self.epanet_api, msx=True)
 
             if verbose is True:
                 try:
@@ -1496,6 +1693,20 @@ class ScenarioSimulator():
                                         sensor_noise=self.__sensor_noise,
                                         frozen_sensor_config=frozen_sensor_config)
 
+        if native_tracing is True:
+            self.__stop_native_tracing(msx=True)
+
+        try:
+            msx_memory_usage = get_msx_memory_usage(self.epanet_api)
+            self.__memory_usage = dict(self.__memory_usage or {})
+            self.__memory_usage["epanet_msx"] = msx_memory_usage
+        except RuntimeError:
+            pass
+
+        if self.__profiling is True:
+            self.__profile = dict(self.__profile or {})
+            self.__profile["epanet_msx"] = get_msx_profile(self.epanet_api)
+
     def run_basic_quality_simulation(self, hyd_file_in: str, verbose: bool = False,
                                      frozen_sensor_config: bool = False) -> ScadaData:
         """
@@ -1587,6 +1798,12 @@ class ScenarioSimulator():
 
         self.epanet_api.useHydraulicFile(hyd_file_in)
 
+        if self.__profiling is True:
+            set_profiling(self.epanet_api, True)
+
+        tracer = get_tracer()
+        native_tracing = self.__start_native_tracing()
+
         self.epanet_api.openQualityAnalysis()
         self.epanet_api.initializeQualityAnalysis(ToolkitConstants.EN_NOSAVE)
 
@@ -1618,7 +1835,8 @@ class ScenarioSimulator():
                         pass
 
             # Compute current time step
-            t = self.epanet_api.runQualityAnalysis()
+            with tracer.span("time_step", time=total_time + tstep):
+                t = self.epanet_api.runQualityAnalysis()
             total_time = t
 
             # Fetch data
@@ -1641,10 +1859,20 @@ class ScenarioSimulator():
                                     frozen_sensor_config=frozen_sensor_config)
 
             # Next
-            tstep = self.epanet_api.nextQualityAnalysisStep()
+            with tracer.span("next_time_step"):
+                tstep = self.epanet_api.nextQualityAnalysisStep()
+
+            if native_tracing is True:
+                tracer.collect_native_events(self.epanet_api)
 
         self.epanet_api.closeHydraulicAnalysis()
 
+        if native_tracing is True:
+            self.__stop_native_tracing()
+
+        if self.__profiling is True:
+            self.__profile = {"epanet": get_profile(self.epanet_api)}
+
     def run_simulation(self, hyd_export: str = None, verbose: bool = False,
                        frozen_sensor_config: bool = False) -> ScadaData:
         """
@@ -1682,36 +1910,42 @@ class ScenarioSimulator():
         if self.__f_msx_in is not None:
             hyd_export = os.path.join(get_temp_folder(), f"epytflow_MSX_{uuid.uuid4()}.hyd")
 
+        tracer = get_tracer()
+
         # Run hydraulic simulation step-by-step
         gen = self.run_simulation_as_generator
-        for scada_data in gen(hyd_export=hyd_export,
-                              verbose=verbose,
-                              return_as_dict=True,
-                              frozen_sensor_config=frozen_sensor_config):
-            if result is None:
-                result = {}
-                for data_type, data in scada_data.items():
-                    result[data_type] = [data]
-            else:
-                for data_type, data in scada_data.items():
-                    result[data_type].append(data)
+        with tracer.span("run_hydraulic_simulation"):
+            for scada_data in gen(hyd_export=hyd_export,
+                                  verbose=verbose,
+                                  return_as_dict=True,
+                                  frozen_sensor_config=frozen_sensor_config):
+                if result is None:
+                    result = {}
+                    for data_type, data in scada_data.items():
+                        result[data_type] = [data]
+                else:
+                    for data_type, data in scada_data.items():
+                        result[data_type].append(data)
 
-        for data_type in result:
-            result[data_type] = np.concatenate(result[data_type], axis=0)
+        with tracer.span("concatenate_scada_data"):
+            for data_type in result:
+                result[data_type] = np.concatenate(result[data_type], axis=0)
 
-        result = ScadaData(**result,
-                           sensor_config=self.__sensor_config,
-                           sensor_reading_events=self.__sensor_reading_events,
-                           sensor_noise=self.__sensor_noise,
-                           frozen_sensor_config=frozen_sensor_config)
+            result = ScadaData(**result,
+                               sensor_config=self.__sensor_config,
+                               sensor_reading_events=self.__sensor_reading_events,
+                               sensor_noise=self.__sensor_noise,
+                               frozen_sensor_config=frozen_sensor_config)
 
         # If necessary, run advanced quality simulation utilizing the computed hydraulics
         if self.f_msx_in is not None:
             gen = self.run_advanced_quality_simulation
-            result_msx = gen(hyd_file_in=hyd_export,
-                             verbose=verbose,
-                             frozen_sensor_config=frozen_sensor_config)
-            result.join(result_msx)
+            with tracer.span("run_advanced_quality_simulation"):
+                result_msx = gen(hyd_file_in=hyd_export,
+                                 verbose=verbose,
+                                 frozen_sensor_config=frozen_sensor_config)
+            with tracer.span("join_scada_data"):
+                result.join(result_msx)
 
             if hyd_export_old is not None:
                 shutil.copyfile(hyd_export, hyd_export_old)
@@ -1772,6 +2006,15 @@ class ScenarioSimulator():
 
         self.__prepare_simulation()
 
+        if self.__profiling is True:
+            set_profiling(self.epanet_api, True)
+
+        tracer = get_tracer()
+        native_tracing = self.__start_native_tracing()
+
+        if self.__solver_diagnostics is True:
+            set_diagnostics(self.epanet_api, True)
+
         self.epanet_api.openHydraulicAnalysis()
         self.epanet_api.openQualityAnalysis()
         self.epanet_api.initializeHydraulicAnalysis(ToolkitConstants.EN_SAVE)
@@ -1811,12 +2054,14 @@ class ScenarioSimulator():
 
                 # Apply system events in a regular time interval only!
                 if (total_time + tstep) % requested_time_step == 0:
-                    for event in self.__system_events:
-                        event.step(total_time + tstep)
+                    with tracer.span("apply_system_events"):
+                        for event in self.__system_events:
+                            event.step(total_time + tstep)
 
                 # Compute current time step
-                t = self.epanet_api.runHydraulicAnalysis()
-                self.epanet_api.runQualityAnalysis()
+                with tracer.span("time_step", time=total_time + tstep):
+                    t = self.epanet_api.runHydraulicAnalysis()
+                    self.epanet_api.runQualityAnalysis()
                 total_time = t
 
                 # Fetch data
@@ -1835,18 +2080,19 @@ class ScenarioSimulator():
                 link_valve_idx = self.epanet_api.getLinkValveIndex()
                 valves_state_data = self.epanet_api.getLinkStatus(link_valve_idx).reshape(1, -1)
 
+                step_data = {"pressure_data_raw": pressure_data,
+                             "flow_data_raw": flow_data,
+                             "demand_data_raw": demand_data,
+                             "node_quality_data_raw": quality_node_data,
+                             "link_quality_data_raw": quality_link_data,
+                             "pumps_state_data_raw": pumps_state_data,
+                             "valves_state_data_raw": valves_state_data,
+                             "tanks_volume_data_raw": tanks_volume_data,
+                             "pumps_energy_usage_data_raw": pumps_energy_usage_data,
+                             "pumps_efficiency_data_raw": pumps_efficiency_data,
+                             "sensor_readings_time": np.array([total_time])}
                 scada_data = ScadaData(sensor_config=self.__sensor_config,
-                                       pressure_data_raw=pressure_data,
-                                       flow_data_raw=flow_data,
-                                       demand_data_raw=demand_data,
-                                       node_quality_data_raw=quality_node_data,
-                                       link_quality_data_raw=quality_link_data,
-                                       pumps_state_data_raw=pumps_state_data,
-                                       valves_state_data_raw=valves_state_data,
-                                       tanks_volume_data_raw=tanks_volume_data,
-                                       pumps_energy_usage_data_raw=pumps_energy_usage_data,
-                                       pumps_efficiency_data_raw=pumps_efficiency_data,
-                                       sensor_readings_time=np.array([total_time]),
+                                       **step_data,
                                        sensor_reading_events=self.__sensor_reading_events,
                                        sensor_noise=self.__sensor_noise,
                                        frozen_sensor_config=frozen_sensor_config)
@@ -1854,31 +2100,42 @@ class ScenarioSimulator():
                 # Yield results in a regular time interval only!
                 if total_time % reporting_time_step == 0 and total_time >= reporting_time_start:
                     if return_as_dict is True:
-                        yield {"pressure_data_raw": pressure_data,
-                               "flow_data_raw": flow_data,
-                               "demand_data_raw": demand_data,
-                               "node_quality_data_raw": quality_node_data,
-                               "link_quality_data_raw": quality_link_data,
-                               "pumps_state_data_raw": pumps_state_data,
-                               "valves_state_data_raw": valves_state_data,
-                               "tanks_volume_data_raw": tanks_volume_data,
-                               "pumps_energy_usage_data_raw": pumps_energy_usage_data,
-                               "pumps_efficiency_data_raw": pumps_efficiency_data,
-                               "sensor_readings_time": np.array([total_time])}
+                        yield step_data
                     else:
                         yield scada_data
 
                 # Apply control modules
-                for control in self.__controls:
-                    control.step(scada_data)
+                with tracer.span("apply_controls"):
+                    for control in self.__controls:
+                        control.step(scada_data)
 
                 # Next
-                tstep = self.epanet_api.nextHydraulicAnalysisStep()
-                self.epanet_api.nextQualityAnalysisStep()
+                with tracer.span("next_time_step"):
+                    tstep = self.epanet_api.nextHydraulicAnalysisStep()
+                    self.epanet_api.nextQualityAnalysisStep()
+
+                if native_tracing is True:
+                    tracer.collect_native_events(self.epanet_api)
+
+            if has_native_function(self.epanet_api, "getmemoryusage"):
+                self.__memory_usage = {"epanet": get_memory_usage(self.epanet_api)}
 
             self.epanet_api.closeQualityAnalysis()
             self.epanet_api.closeHydraulicAnalysis()
 
+            if native_tracing is True:
+                self.__stop_native_tracing()
+
+            if self.__profiling is True:
+                self.__profile = {"epanet": get_profile(self.epanet_api)}
+
+            if self.__solver_diagnostics is True:
+                self.__solver_diagnostics_data = get_diagnostics(self.epanet_api)
+                set_diagnostics(self.epanet_api, False)
+
+            if self.__warm_start is True:
+                self.__warm_start_stats = get_warm_start_stats(self.epanet_api)
+
             if hyd_export is not None:
                 self.epanet_api.saveHydraulicFile(hyd_export)
         except Exception as ex:
@@ -2110,6 +2367,213 @@ class ScenarioSimulator():
             warnings.warn("You are overriding current quality settings " +
                           f"'{qual_info.QualityType}'")
 
+    def __start_native_tracing(self, msx: bool = False) -> bool:
+        tracer = get_tracer()
+        if tracer.enabled is False or tracer.native_buffer_size == 0 or \
+                not has_native_function(self.epanet_api, "settracing"):
+            return False
+
+        if msx is False:
+            set_tracing(self.epanet_api, tracer.native_buffer_size)
+        else:
+            set_msx_tracing(self.epanet_api, tracer.native_buffer_size)
+
+        return True
+
+    def __stop_native_tracing(self, msx: bool = False) -> None:
+        get_tracer().collect_native_events(self.epanet_api, msx)
+
+        if msx is False:
+            set_tracing(self.epanet_api, 0)
+        else:
+            set_msx_tracing(self.epanet_api, 0)
+
+    def enable_profiling(self) -> None:
+        """
+        Enables the timing of the simulation phases (e.g. solving the hydraulics,
+        transport of species, etc.) inside EPANET and EPANET-MSX.
+        The timings of the most recent simulation run can be retrieved by calling
+        :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.get_profile`.
+
+        Note that this requires the EPANET and EPANET-MSX libraries shipped with EPyT-Flow.
+        """
+        if not has_native_function(self.epanet_api, "setprofiling"):
+            raise RuntimeError("The loaded EPANET library does not support profiling")
+
+        self.__profiling = True
+
+    def disable_profiling(self) -> None:
+        """
+        Disables the timing of the simulation phases.
+        """
+        if self.__profiling is True:
+            set_profiling(self.epanet_api, False)
+            if self.__f_msx_in is not None:
+                set_msx_profiling(self.epanet_api, False)
+
+        self.__profiling = False
+        self.__profile = None
+
+    def get_profile(self) -> dict:
+        """
+        Gets the timings of the simulation phases of the most recent simulation run --
+        profiling must be enabled by calling
+        :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.enable_profiling`.
+
+        Returns
+        -------
+        `dict`
+            Wall clock time (in seconds) and number of calls of each simulation phase --
+            i.e. "epanet" (and "epanet_msx" if an .msx file is used) -> phase name ->
+            {"time": ..., "calls": ...}.
+            See :data:`~epyt_flow.simulation.native_api.EN_PROFILE_PHASES` and
+            :data:`~epyt_flow.simulation.native_api.MSX_PROFILE_PHASES` for the phases.
+            None if profiling is not enabled or no simulation was run yet.
+        """
+        return deepcopy(self.__profile)
+
+    def enable_solver_diagnostics(self) -> None:
+        """
+        Enables the recording of convergence diagnostics (e.g. number of iterations,
+        relative error, status changes, etc.) of every hydraulic time step.
+        The diagnostics of the most recent simulation run can be retrieved by calling
+        :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.get_solver_diagnostics`.
+
+        Note that this requires the EPANET library shipped with EPyT-Flow.
+        """
+        if not has_native_function(self.epanet_api, "setdiagnostics"):
+            raise RuntimeError("The loaded EPANET library does not support solver diagnostics")
+
+        self.__solver_diagnostics = True
+
+    def disable_solver_diagnostics(self) -> None:
+        """
+        Disables the recording of convergence diagnostics.
+        """
+        self.__solver_diagnostics = False
+
+    def get_solver_diagnostics(self) -> dict[str, np.ndarray]:
+        """
+        Gets the convergence diagnostics of every hydraulic time step of the most recent
+        simulation run -- recording must be enabled by calling
+        :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.enable_solver_diagnostics`.
+
+        Returns
+        -------
+        `dict[str, numpy.ndarray]`
+            One array (one entry per hydraulic time step, incl. intermediate steps caused by
+            controls or tanks) for each diagnostics field --
+            see :func:`~epyt_flow.simulation.native_api.get_diagnostics`.
+            None if the recording is not enabled or no simulation was run yet.
+        """
+        if self.__solver_diagnostics_data is None:
+            return None
+
+        return {field: values.copy() for field, values in self.__solver_diagnostics_data.items()}
+
+    def enable_warm_start(self, tolerance: float = None) -> None:
+        """
+        Enables warm starts of subsequent simulation runs -- e.g. in calibration loops where
+        only a few parameters (e.g. roughnesses or valve settings) change between the runs.
+
+        Every hydraulic time step starts from the converged solution of the previous run at
+        the same time instead of the solution of the previous time step, and the node
+        re-ordering & symbolic factorization of the hydraulic solver's sparse matrix are
+        re-used as long as the network's structure (i.e. nodes and links) does not change.
+        Statistics of the most recent run can be retrieved by calling
+        :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.get_warm_start_stats`.
+
+        Note that this requires the EPANET library shipped with EPyT-Flow.
+
+        Parameters
+        ----------
+        tolerance : `float`, optional
+            If not None, a warm started hydraulic time step is accepted after the first trial
+            of the solver if that trial changed no link flow by more than `tolerance`
+            (in the network's flow units) -- i.e. if the previous run's solution already
+            satisfies the equations of this time step. This is checked for every time step on
+            its own, after the demands, controls, and events of that time step were applied,
+            so changes that only take effect later in the simulation are not missed.
+            Otherwise, every time step is solved to the full accuracy.
+
+            The default is None.
+        """
+        if not has_native_function(self.epanet_api, "setwarmstart"):
+            raise RuntimeError("The loaded EPANET library does not support warm starts")
+        if tolerance is not None:
+            if not isinstance(tolerance, (float, int)):
+                raise TypeError("'tolerance' must be an instance of 'float' " +
+                                f"but not of '{type(tolerance)}'")
+            if tolerance < 0:
+                raise ValueError("'tolerance' can not be negative")
+
+        if self.__warm_start is False:
+            set_warm_start(self.epanet_api, True)
+        set_warm_start_tolerance(self.epanet_api, 0. if tolerance is None else float(tolerance))
+        self.__warm_start = True
+
+    def disable_warm_start(self) -> None:
+        """
+        Disables warm starts and discards the recorded results of the previous run.
+        """
+        if self.__warm_start is True:
+            set_warm_start(self.epanet_api, False)
+            set_warm_start_tolerance(self.epanet_api, 0.)
+        self.__warm_start = False
+        self.__warm_start_stats = None
+
+    def get_warm_start_stats(self) -> dict:
+        """
+        Gets statistics of the most recent (warm started) simulation run -- warm starts must be
+        enabled by calling
+        :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.enable_warm_start`.
+
+        Returns
+        -------
+        `dict`
+            Number of hydraulic time steps solved ("time_steps"), number of those time steps
+            that started from the previous run's solution ("warm_started"), number of those
+            time steps that were accepted after the first trial of the solver ("accepted" --
+            see the `tolerance` of
+            :func:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator.enable_warm_start`),
+            and whether the structure of the sparse matrix was re-used ("reused_structure").
+            None if warm starts are not enabled or no simulation was run yet.
+        """
+        return deepcopy(self.__warm_start_stats)
+
+    def enable_event_driven_quality_routing(self) -> None:
+        """
+        Enables event-driven transport of the water quality -- i.e. instead of updating all
+        nodes every quality time step, a node is only updated when the leading water segment
+        of one of its inflow pipes arrives (tanks are still updated every quality time step).
+        For non-reactive constituents, the water is moved to the nodes at the exact arrival
+        times of the segments -- i.e. the results (almost) do not depend on the quality time
+        step, and so does its cost, which speeds up e.g. source tracing analyses.
+
+        Note that the results differ from the ones of transporting the water quality over
+        fixed time steps by the error of the latter: a fixed time step delays or advances a
+        concentration front by up to one quality time step, which can change the
+        concentration at a node shortly before and after the arrival of the front by up to
+        the full height of the front -- the results of fixed time steps approach the
+        event-driven ones as the quality time step decreases.
+
+        Note that reactive constituents (incl. water age) are always transported over fixed
+        quality time steps, and that this requires the EPANET library shipped with EPyT-Flow.
+        """
+        if not has_native_function(self.epanet_api, "setqualrouting"):
+            raise RuntimeError("The loaded EPANET library does not support " +
+                               "event-driven quality routing")
+
+        set_quality_routing(self.epanet_api, True)
+
+    def disable_event_driven_quality_routing(self) -> None:
+        """
+        Disables event-driven transport of the water quality -- i.e. the water quality is
+        transported over fixed quality time steps (default).
+        """
+        if has_native_function(self.epanet_api, "setqualrouting"):
+            set_quality_routing(self.epanet_api, False)
+
     def enable_waterage_analysis(self) -> None:
         """
         Sets water age analysis -- i.e. estimates the water age (in hours) at
@@ -0,0 +1,869 @@
+"""
+Module provides functions for optimizing the placement of sensors -- i.e. for computing
+leak and contamination signatures of all candidate events from a single baseline simulation,
+and for selecting sensor locations that detect as many of these events as possible.
+It also provides the computation of leak signature dictionaries for model-based
+leak localization.
+"""
+import os
+import heapq
+from copy import deepcopy
+from typing import Union
+from concurrent.futures import ThreadPoolExecutor
+import numpy as np
+from scipy.sparse import csc_array, csr_array, diags
+from scipy.sparse.linalg import splu
+from scipy.sparse.csgraph import dijkstra
+
+from .scenario_simulator import ScenarioSimulator
+from .sensor_config import SensorConfig
+from .native_api import get_leak_signatures
+from ..topology import NetworkTopology
+
+
+class SignatureMatrix():
+    """
+    Class for storing the signatures of candidate events (rows) at all potential
+    sensor locations (columns) -- e.g. the pressure drop at every node caused by a leak at
+    a given node.
+
+    Signatures are stored in a compact data type (e.g. float16) and can be memory-mapped,
+    i.e. the matrix can be much larger than the available RAM. If the data type is an unsigned
+    integer type (e.g. uint8), each row is quantized and must be multiplied by its scale.
+
+    Parameters
+    ----------
+    data : `numpy.ndarray` or `numpy.memmap`
+        Signatures of all candidate events.
+    candidates : `list[str]`
+        IDs of the candidate events (e.g. leaky nodes) -- i.e. rows of the matrix.
+    sensor_locations : `list[str]`
+        IDs of the potential sensor locations -- i.e. columns of the matrix.
+    scales : `numpy.ndarray`, optional
+        Scale of each row if the signatures are quantized -- must be None otherwise.
+
+        The default is None.
+    """
+    def __init__(self, data: Union[np.ndarray, np.memmap], candidates: list[str],
+                 sensor_locations: list[str], scales: np.ndarray = None, **kwds):
+        if not isinstance(data, np.ndarray):
+            raise TypeError("'data' must be an instance of 'numpy.ndarray' " +
+                            f"but not of '{type(data)}'")
+        if data.ndim != 2:
+            raise ValueError("'data' must be a 2d array")
+        if not isinstance(candidates, list):
+            raise TypeError("'candidates' must be an instance of 'list[str]' " +
+                            f"but not of '{type(candidates)}'")
+        if not isinstance(sensor_locations, list):
+            raise TypeError("'sensor_locations' must be an instance of 'list[str]' " +
+                            f"but not of '{type(sensor_locations)}'")
+        if data.shape != (len(candidates), len(sensor_locations)):
+            raise ValueError("Shape of 'data' does not match the number of candidates " +
+                             "and sensor locations")
+        if np.issubdtype(data.dtype, np.unsignedinteger):
+            if scales is None or not isinstance(scales, np.ndarray) or \
+                    scales.shape != (data.shape[0],):
+                raise ValueError("Quantized signatures need a scale for every row")
+        elif scales is not None:
+            raise ValueError("'scales' can only be used for quantized signatures")
+
+        self.__data = data
+        self.__candidates = candidates
+        self.__sensor_locations = sensor_locations
+        self.__scales = scales
+
+        super().__init__(**kwds)
+
+    @property
+    def data(self) -> Union[np.ndarray, np.memmap]:
+        """
+        Gets the (possibly quantized) signatures.
+
+        Returns
+        -------
+        `numpy.ndarray` or `numpy.memmap`
+            Signatures.
+        """
+        return self.__data
+
+    @property
+    def candidates(self) -> list[str]:
+        """
+        Gets the IDs of the candidate events.
+
+        Returns
+        -------
+        `list[str]`
+            IDs of the candidate events.
+        """
+        return self.__candidates
+
+    @property
+    def sensor_locations(self) -> list[str]:
+        """
+        Gets the IDs of the potential sensor locations.
+
+        Returns
+        -------
+        `list[str]`
+            IDs of the potential sensor locations.
+        """
+        return self.__sensor_locations
+
+    @property
+    def scales(self) -> np.ndarray:
+        """
+        Gets the scale of each row if the signatures are quantized.
+
+        Returns
+        -------
+        `numpy.ndarray`
+            Scales -- None if the signatures are not quantized.
+        """
+        return self.__scales
+
+    @property
+    def shape(self) -> tuple[int, int]:
+        """
+        Gets the number of candidate events and potential sensor locations.
+
+        Returns
+        -------
+        `tuple[int, int]`
+            Shape of the signature matrix.
+        """
+        return self.__data.shape
+
+    def get_rows(self, start: int, end: int) -> np.ndarray:
+        """
+        Gets (and de-quantizes) the signatures of a range of candidate events.
+
+        Parameters
+        ----------
+        start : `int`
+            Index of the first row.
+        end : `int`
+            Index after the last row.
+
+        Returns
+        -------
+        `numpy.ndarray`
+            Signatures as float32.
+        """
+        rows = np.asarray(self.__data[start:end], dtype=np.float32)
+        if self.__scales is not None:
+            rows *= self.__scales[start:end, None]
+        return rows
+
+    def save(self, f_out: str) -> None:
+        """
+        Saves the candidates, sensor locations, and scales to a .npz file --
+        if the signatures are not memory-mapped, they are stored in this file as well.
+
+        Parameters
+        ----------
+        f_out : `str`
+            Path to the .npz file.
+        """
+        data = {"candidates": np.array(self.__candidates, dtype=str),
+                "sensor_locations": np.array(self.__sensor_locations, dtype=str)}
+        if self.__scales is not None:
+            data["scales"] = self.__scales
+        if isinstance(self.__data, np.memmap):
+            data["f_data"] = np.array(os.path.abspath(self.__data.filename))
+        else:
+            data["data"] = self.__data
+
+        np.savez(f_out, **data)
+
+    @staticmethod
+    def load(f_in: str):
+        """
+        Loads a signature matrix that was saved by
+        :func:`~epyt_flow.simulation.sensor_placement.SignatureMatrix.save` --
+        memory-mapped signatures are memory-mapped (read-only) again.
+
+        Parameters
+        ----------
+        f_in : `str`
+            Path to the .npz file.
+
+        Returns
+        -------
+        :class:`~epyt_flow.simulation.sensor_placement.SignatureMatrix`
+            Signature matrix.
+        """
+        with np.load(f_in) as f:
+            if "f_data" in f:
+                data = np.load(str(f["f_data"]), mmap_mode="r")
+            else:
+                data = f["data"]
+            scales = f["scales"] if "scales" in f else None
+
+            return SignatureMatrix(data, f["candidates"].tolist(),
+                                   f["sensor_locations"].tolist(), scales)
+
+
+def _run_baseline(scenario: ScenarioSimulator) -> dict:
+    """
+    Runs the baseline (i.e. event-free) simulation and collects the hydraulic states of
+    all reporting time steps.
+    """
+    epanet_api = scenario.epanet_api
+
+    heads, flows, velocities, status = [], [], [], []
+    for _ in scenario.run_simulation_as_generator(return_as_dict=True):
+        heads.append(epanet_api.getNodeHydraulicHead().astype(np.float32))
+        flows.append(epanet_api.getLinkFlows().astype(np.float32))
+        velocities.append(epanet_api.getLinkVelocity().astype(np.float32))
+        status.append(epanet_api.getLinkStatus().astype(np.int8))
+
+    return {"heads": np.array(heads), "flows": np.array(flows),
+            "velocities": np.array(velocities), "status": np.array(status)}
+
+
+def _get_links_end_points_index(topology: NetworkTopology) -> tuple[np.ndarray, np.ndarray]:
+    links = topology.get_all_links()
+    a = np.array([topology.get_node_index(link[0]) for _, link in links], dtype=np.int32)
+    b = np.array([topology.get_node_index(link[1]) for _, link in links], dtype=np.int32)
+    return a, b
+
+
+def _get_links_conductance(topology: NetworkTopology, heads: np.ndarray, flows: np.ndarray,
+                           status: np.ndarray, flow_exponent: float) -> np.ndarray:
+    """
+    Linearizes the head loss of all links at a given hydraulic state -- i.e. computes
+    dq/dh = |q| / (n |h_L|) for each link, where n is the flow exponent of the head loss formula.
+
+    Closed links do not conduct, and links that are (almost) without head loss (incl. pumps)
+    are treated as stiff connections.
+    """
+    a, b = _get_links_end_points_index(topology)
+    links = topology.get_all_links()
+    is_pipe = np.array([topology.get_link_info(link_id)["type"] == "PIPE"
+                        for link_id, _ in links])
+
+    head_loss = np.abs(heads[a] - heads[b]).astype(np.float64)
+    flows = np.abs(flows).astype(np.float64)
+    exponent = np.where(is_pipe, flow_exponent, 2.)
+
+    eps = 1e-6
+    conductance = np.zeros(len(links), dtype=np.float64)
+    regular = (head_loss > eps) & (flows > eps)
+    conductance[regular] = flows[regular] / (exponent[regular] * head_loss[regular])
+
+    g_max = 1e3 * (np.median(conductance[regular]) if np.any(regular) else 1.)
+    conductance = np.minimum(conductance, g_max)
+    conductance[(~regular) | (~is_pipe)] = g_max
+    conductance[status == 0] = 0.
+
+    return conductance
+
+
+def _get_junctions_conductance_matrix(topology: NetworkTopology, conductance: np.ndarray,
+                                      junctions_idx: np.ndarray) -> csc_array:
+    """
+    Assembles the (symmetric) conductance matrix of the junctions --
+    nodes with a fixed head (i.e. tanks and reservoirs) are eliminated.
+    """
+    a, b = _get_links_end_points_index(topology)
+    n_nodes = len(topology.get_all_nodes())
+    n_links = len(a)
+
+    incidence = csr_array((np.concatenate((np.ones(n_links), -np.ones(n_links))),
+                           (np.concatenate((np.arange(n_links), np.arange(n_links))),
+                            np.concatenate((a, b)))), shape=(n_links, n_nodes))
+    incidence = incidence[:, junctions_idx]
+
+    L = (incidence.T @ diags(conductance) @ incidence).tocsc()
+
+    # Junctions that are cut off (e.g. by closed links) would make the matrix singular
+    diag = L.diagonal()
+    L = L + diags(np.where(diag > 0, 1e-9 * diag, 1.) + 1e-12 * np.max(diag, initial=1.))
+
+    return csc_array(L)
+
+
+def _open_signature_matrix(f_out: str, dtype: np.dtype, shape: tuple) -> np.ndarray:
+    if f_out is not None:
+        return np.lib.format.open_memmap(f_out, mode="w+", dtype=dtype, shape=shape)
+    else:
+        return np.empty(shape, dtype=dtype)
+
+
+def _write_rows(signatures: np.ndarray, scales: np.ndarray, start: int,
+                rows: np.ndarray) -> None:
+    if scales is not None:
+        max_value = np.iinfo(signatures.dtype).max
+        row_max = np.max(rows, axis=1, initial=0.)
+        scales[start:start + rows.shape[0]] = np.where(row_max > 0, row_max / max_value, 1.)
+        rows = np.rint(rows / scales[start:start + rows.shape[0], None])
+    signatures[start:start + rows.shape[0], :] = rows
+
+
+def compute_leak_signatures(scenario: ScenarioSimulator, candidates: list[str] = None,
+                            sensor_locations: list[str] = None, leak_demand: float = 1.,
+                            time_steps: list[int] = None, dtype: np.dtype = np.float16,
+                            f_out: str = None, block_size: int = 256,
+                            n_jobs: int = None) -> SignatureMatrix:
+    """
+    Computes the leak signatures -- i.e. the (absolute) pressure drop at every potential
+    sensor location that is caused by a leak at each candidate node.
+
+    Instead of simulating every leak, only the baseline scenario is simulated. The hydraulics
+    are linearized around the baseline at each of the given time steps, and the conductance
+    matrix of all junctions is factorized once per time step -- the pressure drops caused
+    by all candidate leaks are then obtained by solving for blocks of leaks at once
+    using this shared factorization. The signature of a leak is its maximum pressure drop over
+    all time steps.
+
+    Note that this first-order approximation does not account for tanks levels changing
+    because of the leak, or for controls that react to it.
+
+    Parameters
+    ----------
+    scenario : :class:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator`
+        Baseline scenario -- i.e. without any leaks.
+    candidates : `list[str]`, optional
+        IDs of the junctions where a leak might occur (rows).
+        If None, all junctions are used.
+
+        The default is None.
+    sensor_locations : `list[str]`, optional
+        IDs of the nodes where a pressure sensor might be placed (columns).
+        If None, all junctions are used.
+
+        The default is None.
+    leak_demand : `float`, optional
+        Outflow of each leak (in the flow units of the scenario).
+
+        The default is 1.
+    time_steps : `list[int]`, optional
+        Indices of the (reporting) time steps at which the hydraulics are linearized.
+        If None, four time steps are evenly spread over the simulation.
+
+        The default is None.
+    dtype : `numpy.dtype`, optional
+        Data type of the signatures -- if an unsigned integer type (e.g. uint8) is used,
+        signatures are quantized row-wise.
+
+        The default is float16.
+    f_out : `str`, optional
+        Path to a .npy file -- if not None, the signatures are written to this file
+        and memory-mapped.
+
+        The default is None.
+    block_size : `int`, optional
+        Number of leaks that are solved for at once.
+
+        The default is 256.
+    n_jobs : `int`, optional
+        Number of threads. If None, the number of CPUs is used.
+
+        The default is None.
+
+    Returns
+    -------
+    :class:`~epyt_flow.simulation.sensor_placement.SignatureMatrix`
+        Leak signatures.
+    """
+    if not isinstance(scenario, ScenarioSimulator):
+        raise TypeError("'scenario' must be an instance of " +
+                        "'epyt_flow.simulation.ScenarioSimulator' but not of " +
+                        f"'{type(scenario)}'")
+    if not isinstance(leak_demand, (float, int)) or leak_demand <= 0:
+        raise ValueError("'leak_demand' must be positive")
+    if not isinstance(block_size, int) or block_size <= 0:
+        raise ValueError("'block_size' must be a positive integer")
+    if n_jobs is not None and (not isinstance(n_jobs, int) or n_jobs <= 0):
+        raise ValueError("'n_jobs' must be a positive integer")
+
+    topology = scenario.get_topology()
+    junctions = topology.get_all_junctions()
+    candidates = junctions if candidates is None else candidates
+    sensor_locations = junctions if sensor_locations is None else sensor_locations
+
+    junctions_idx = np.array([topology.get_node_index(node_id) for node_id in junctions],
+                             dtype=np.int32)
+    junction_pos = {node_id: i for i, node_id in enumerate(junctions)}
+    if any(node_id not in junction_pos for node_id in candidates + sensor_locations):
+        raise ValueError("All candidates and sensor locations must be junctions")
+    candidates_pos = np.array([junction_pos[node_id] for node_id in candidates], dtype=np.int32)
+    sensors_pos = np.array([junction_pos[node_id] for node_id in sensor_locations],
+                           dtype=np.int32)
+
+    # Simulate and linearize the baseline
+    baseline = _run_baseline(scenario)
+    n_steps = baseline["heads"].shape[0]
+    if time_steps is None:
+        time_steps = np.unique(np.linspace(0, n_steps - 1, min(4, n_steps)).astype(int)).tolist()
+    if any(not 0 <= t < n_steps for t in time_steps):
+        raise ValueError(f"Invalid time step -- there are only {n_steps} time steps")
+
+    flow_exponent = 1.852 if scenario.epanet_api.getOptionsHeadLossFormula() == "HW" else 2.
+    factors = []
+    for t in time_steps:
+        conductance = _get_links_conductance(topology, baseline["heads"][t],
+                                             baseline["flows"][t], baseline["status"][t],
+                                             flow_exponent)
+        factors.append(splu(_get_junctions_conductance_matrix(topology, conductance,
+                                                              junctions_idx)))
+
+    # Solve for all leaks
+    signatures = _open_signature_matrix(f_out, dtype, (len(candidates), len(sensor_locations)))
+    scales = np.ones(len(candidates), dtype=np.float32) \
+        if np.issubdtype(np.dtype(dtype), np.unsignedinteger) else None
+
+    def __compute_block(start: int) -> None:
+        leaks_pos = candidates_pos[start:start + block_size]
+        rhs = np.zeros((len(junctions), len(leaks_pos)))
+        rhs[leaks_pos, np.arange(len(leaks_pos))] = leak_demand
+
+        pressure_drop = np.zeros((len(leaks_pos), len(sensor_locations)), dtype=np.float32)
+        for factor in factors:
+            np.maximum(pressure_drop, np.abs(factor.solve(rhs)[sensors_pos, :].T),
+                       out=pressure_drop)
+
+        _write_rows(signatures, scales, start, pressure_drop)
+
+    n_jobs = n_jobs if n_jobs is not None else (os.cpu_count() or 1)
+    blocks = range(0, len(candidates), block_size)
+    if n_jobs == 1 or len(blocks) <= 1:
+        for start in blocks:
+            __compute_block(start)
+    else:
+        with ThreadPoolExecutor(max_workers=n_jobs) as executor:
+            list(executor.map(__compute_block, blocks))
+
+    if isinstance(signatures, np.memmap):
+        signatures.flush()
+
+    return SignatureMatrix(signatures, list(candidates), list(sensor_locations), scales)
+
+
+def compute_leak_signature_dictionary(scenario: ScenarioSimulator, emitter_coeffs: list[float],
+                                      candidates: list[str] = None,
+                                      sensor_locations: list[str] = None,
+                                      dtype: np.dtype = np.float32, f_out: str = None,
+                                      n_threads: int = None) -> Union[np.ndarray, np.memmap]:
+    """
+    Computes the pressure residuals (i.e. pressure drops) at all sensor locations for a leak
+    at every candidate junction, for several leak sizes, and at every (reporting) time step --
+    e.g. as a dictionary for model-based leak localization.
+
+    In contrast to simulating a leakage scenario for every candidate, only the baseline scenario
+    is simulated. At every time step, EPANET re-solves the converged baseline hydraulics for
+    each candidate leak (modelled as an emitter) using warm-started Newton iterations
+    -- see :func:`~epyt_flow.simulation.native_api.get_leak_signatures`.
+
+    Parameters
+    ----------
+    scenario : :class:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator`
+        Baseline scenario -- i.e. without any leaks.
+    emitter_coeffs : `list[float]`
+        Emitter coefficients (i.e. leak sizes) of the candidate leaks.
+    candidates : `list[str]`, optional
+        IDs of the junctions where a leak might occur.
+        If None, all junctions are used.
+
+        The default is None.
+    sensor_locations : `list[str]`, optional
+        IDs of the nodes where a pressure sensor is placed.
+        If None, the pressure sensors of the scenario are used.
+
+        The default is None.
+    dtype : `numpy.dtype`, optional
+        Data type of the signatures.
+
+        The default is float32.
+    f_out : `str`, optional
+        Path to a .npy file -- if not None, the signatures are written to this file
+        and memory-mapped.
+
+        The default is None.
+    n_threads : `int`, optional
+        Number of threads. If None, the number of CPUs is used.
+
+        The default is None.
+
+    Returns
+    -------
+    `numpy.ndarray` or `numpy.memmap`
+        Pressure residuals of shape (sensor locations, candidates x emitter coefficients,
+        time steps) -- the leak at candidate i with emitter coefficient j corresponds to
+        the column i * len(emitter_coeffs) + j.
+    """
+    if not isinstance(scenario, ScenarioSimulator):
+        raise TypeError("'scenario' must be an instance of " +
+                        "'epyt_flow.simulation.ScenarioSimulator' but not of " +
+                        f"'{type(scenario)}'")
+    if not isinstance(emitter_coeffs, list) or len(emitter_coeffs) == 0:
+        raise TypeError("'emitter_coeffs' must be a non-empty instance of 'list[float]'")
+    if any(coeff <= 0 for coeff in emitter_coeffs):
+        raise ValueError("All emitter coefficients must be positive")
+    if n_threads is not None and (not isinstance(n_threads, int) or n_threads <= 0):
+        raise ValueError("'n_threads' must be a positive integer")
+
+    topology = scenario.get_topology()
+    candidates = topology.get_all_junctions() if candidates is None else candidates
+    sensor_locations = scenario.sensor_config.pressure_sensors \
+        if sensor_locations is None else sensor_locations
+    if len(sensor_locations) == 0:
+        raise ValueError("No sensor locations given")
+    if any(topology.get_node_info(node_id)["type"] != "JUNCTION" for node_id in candidates):
+        raise ValueError("All candidates must be junctions")
+
+    nodes_idx = np.repeat([topology.get_node_index(node_id) for node_id in candidates],
+                          len(emitter_coeffs))
+    coeffs = np.tile(np.array(emitter_coeffs, dtype=np.float64), len(candidates))
+    sensors_idx = np.array([topology.get_node_index(node_id) for node_id in sensor_locations])
+    n_threads = n_threads if n_threads is not None else (os.cpu_count() or 1)
+
+    epanet_api = scenario.epanet_api
+    reporting_time_start = epanet_api.getTimeReportingStart()
+    n_time_steps = (scenario.get_simulation_duration() - reporting_time_start) // \
+        epanet_api.getTimeReportingStep() + 1
+
+    signatures = _open_signature_matrix(f_out, dtype, (len(sensor_locations), len(nodes_idx),
+                                                       n_time_steps))
+    t = 0
+    for _ in scenario.run_simulation_as_generator(return_as_dict=True):
+        signatures[:, :, t] = get_leak_signatures(epanet_api, nodes_idx, coeffs, sensors_idx,
+                                                  n_threads)
+        t += 1
+
+    if isinstance(signatures, np.memmap):
+        signatures.flush()
+
+    return signatures[:, :, :t]
+
+
+def compute_contamination_signatures(scenario: ScenarioSimulator, max_travel_time: int,
+                                     candidates: list[str] = None,
+                                     sensor_locations: list[str] = None,
+                                     dtype: np.dtype = np.float16, f_out: str = None,
+                                     block_size: int = 256,
+                                     n_jobs: int = None) -> SignatureMatrix:
+    """
+    Computes the contamination signatures -- i.e. how fast a contamination that is injected
+    at each candidate node reaches every potential sensor location.
+
+    Instead of simulating every contamination event, only the baseline scenario is
+    simulated -- contaminations are then routed along the average flow directions with the
+    average travel time of each link. The signature of a contamination event at a sensor
+    location is 1 - t / max_travel_time, where t is the travel time --
+    i.e. it is zero if the contamination does not reach the sensor location in time.
+
+    Parameters
+    ----------
+    scenario : :class:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator`
+        Baseline scenario -- i.e. without any contamination.
+    max_travel_time : `int`
+        Maximum time (in seconds) until the contamination must be detected.
+    candidates : `list[str]`, optional
+        IDs of the nodes where a contamination might be injected (rows).
+        If None, all nodes are used.
+
+        The default is None.
+    sensor_locations : `list[str]`, optional
+        IDs of the nodes where a quality sensor might be placed (columns).
+        If None, all nodes are used.
+
+        The default is None.
+    dtype : `numpy.dtype`, optional
+        Data type of the signatures -- if an unsigned integer type (e.g. uint8) is used,
+        signatures are quantized row-wise.
+
+        The default is float16.
+    f_out : `str`, optional
+        Path to a .npy file -- if not None, the signatures are written to this file
+        and memory-mapped.
+
+        The default is None.
+    block_size : `int`, optional
+        Number of contamination events that are routed at once.
+
+        The default is 256.
+    n_jobs : `int`, optional
+        Number of threads. If None, the number of CPUs is used.
+
+        The default is None.
+
+    Returns
+    -------
+    :class:`~epyt_flow.simulation.sensor_placement.SignatureMatrix`
+        Contamination signatures.
+    """
+    if not isinstance(scenario, ScenarioSimulator):
+        raise TypeError("'scenario' must be an instance of " +
+                        "'epyt_flow.simulation.ScenarioSimulator' but not of " +
+                        f"'{type(scenario)}'")
+    if not isinstance(max_travel_time, int) or max_travel_time <= 0:
+        raise ValueError("'max_travel_time' must be a positive integer")
+    if not isinstance(block_size, int) or block_size <= 0:
+        raise ValueError("'block_size' must be a positive integer")
+    if n_jobs is not None and (not isinstance(n_jobs, int) or n_jobs <= 0):
+        raise ValueError("'n_jobs' must be a positive integer")
+
+    topology = scenario.get_topology()
+    nodes = topology.get_all_nodes()
+    candidates = nodes if candidates is None else candidates
+    sensor_locations = nodes if sensor_locations is None else sensor_locations
+    candidates_idx = np.array([topology.get_node_index(node_id) for node_id in candidates],
+                              dtype=np.int32)
+    sensors_idx = np.array([topology.get_node_index(node_id) for node_id in sensor_locations],
+                           dtype=np.int32)
+
+    # Directed graph of the average flows weighted by the travel times
+    baseline = _run_baseline(scenario)
+    mean_flows = np.mean(baseline["flows"], axis=0)
+    mean_velocities = np.mean(np.abs(baseline["velocities"]), axis=0)
+
+    a, b = _get_links_end_points_index(topology)
+    links = topology.get_all_links()
+    links_length = np.array([topology.get_link_info(link_id)["length"]
+                             if topology.get_link_info(link_id)["type"] == "PIPE" else 0.
+                             for link_id, _ in links], dtype=np.float64)
+
+    has_flow = (np.abs(mean_flows) > 1e-6) & (mean_velocities > 1e-9)
+    travel_time = np.zeros(len(links), dtype=np.float64)
+    travel_time[has_flow] = links_length[has_flow] / mean_velocities[has_flow]
+    src = np.where(mean_flows >= 0, a, b)[has_flow]
+    dst = np.where(mean_flows >= 0, b, a)[has_flow]
+
+    # Zero weights would be dropped from the sparse matrix
+    n_nodes = len(nodes)
+    graph = csr_array((np.maximum(travel_time[has_flow], 1e-3), (src, dst)),
+                      shape=(n_nodes, n_nodes))
+
+    signatures = _open_signature_matrix(f_out, dtype, (len(candidates), len(sensor_locations)))
+    scales = np.ones(len(candidates), dtype=np.float32) \
+        if np.issubdtype(np.dtype(dtype), np.unsignedinteger) else None
+
+    def __compute_block(start: int) -> None:
+        t = dijkstra(graph, directed=True, indices=candidates_idx[start:start + block_size],
+                     limit=max_travel_time)[:, sensors_idx]
+        rows = np.where(np.isfinite(t), 1. - t / max_travel_time, 0.)
+        _write_rows(signatures, scales, start, np.maximum(rows, 0.).astype(np.float32))
+
+    n_jobs = n_jobs if n_jobs is not None else (os.cpu_count() or 1)
+    blocks = range(0, len(candidates), block_size)
+    if n_jobs == 1 or len(blocks) <= 1:
+        for start in blocks:
+            __compute_block(start)
+    else:
+        with ThreadPoolExecutor(max_workers=n_jobs) as executor:
+            list(executor.map(__compute_block, blocks))
+
+    if isinstance(signatures, np.memmap):
+        signatures.flush()
+
+    return SignatureMatrix(signatures, list(candidates), list(sensor_locations), scales)
+
+
+def greedy_max_coverage(signatures: SignatureMatrix, n_sensors: int,
+                        detection_threshold: float, candidates_weight: np.ndarray = None,
+                        batch_size: int = 64, block_size: int = 4096,
+                        n_jobs: int = None) -> tuple[list[str], list[float], float]:
+    """
+    Selects sensor locations such that the (weighted) number of detected candidate events
+    is maximized -- an event is detected by a sensor if its signature at the sensor location
+    is at least the detection threshold.
+
+    Since the coverage is submodular, the lazy greedy algorithm is used: the marginal gains
+    of the previous iterations are upper bounds of the current ones, and only the sensor
+    locations with the largest upper bounds are re-evaluated. Each iteration needs a single
+    pass over the rows of the signature matrix, which are processed in blocks
+    (in parallel) -- i.e. the signature matrix can be memory-mapped.
+
+    Parameters
+    ----------
+    signatures : :class:`~epyt_flow.simulation.sensor_placement.SignatureMatrix`
+        Signatures of all candidate events.
+    n_sensors : `int`
+        Number of sensors.
+    detection_threshold : `float`
+        Minimum signature that can be detected by a sensor.
+    candidates_weight : `numpy.ndarray`, optional
+        Weight of each candidate event -- e.g. its probability.
+        If None, all events are weighted equally.
+
+        The default is None.
+    batch_size : `int`, optional
+        Number of sensor locations that are re-evaluated in each pass over the signatures.
+
+        The default is 64.
+    block_size : `int`, optional
+        Number of rows that are processed at once.
+
+        The default is 4096.
+    n_jobs : `int`, optional
+        Number of threads. If None, the number of CPUs is used.
+
+        The default is None.
+
+    Returns
+    -------
+    `tuple[list[str], list[float], float]`
+        Selected sensor locations, (weighted) coverage after each selection, and an upper bound
+        on the coverage of the optimal placement -- i.e. the true approximation quality
+        is at least the final coverage divided by this bound.
+    """
+    if not isinstance(signatures, SignatureMatrix):
+        raise TypeError("'signatures' must be an instance of " +
+                        "'epyt_flow.simulation.sensor_placement.SignatureMatrix' " +
+                        f"but not of '{type(signatures)}'")
+    n_candidates, n_locations = signatures.shape
+    if not isinstance(n_sensors, int) or not 0 < n_sensors <= n_locations:
+        raise ValueError("'n_sensors' must be a positive integer not larger than the " +
+                         "number of sensor locations")
+    if not isinstance(detection_threshold, (float, int)) or detection_threshold <= 0:
+        raise ValueError("'detection_threshold' must be positive")
+    if candidates_weight is None:
+        candidates_weight = np.ones(n_candidates)
+    elif not isinstance(candidates_weight, np.ndarray) or \
+            candidates_weight.shape != (n_candidates,) or np.any(candidates_weight < 0):
+        raise ValueError("'candidates_weight' must contain a non-negative weight " +
+                         "for every candidate")
+    if not isinstance(batch_size, int) or batch_size <= 0:
+        raise ValueError("'batch_size' must be a positive integer")
+    if not isinstance(block_size, int) or block_size <= 0:
+        raise ValueError("'block_size' must be a positive integer")
+    if n_jobs is not None and (not isinstance(n_jobs, int) or n_jobs <= 0):
+        raise ValueError("'n_jobs' must be a positive integer")
+
+    n_jobs = n_jobs if n_jobs is not None else (os.cpu_count() or 1)
+    blocks = list(range(0, n_candidates, block_size))
+    uncovered = np.ones(n_candidates, dtype=bool)
+
+    def __evaluate(locations: np.ndarray, new_sensor: int) -> np.ndarray:
+        # Marks the events that are detected by the new sensor as covered and
+        # computes the marginal gains of the given sensor locations
+        def __evaluate_block(start: int) -> np.ndarray:
+            rows = signatures.get_rows(start, start + block_size)
+            block_uncovered = uncovered[start:start + rows.shape[0]]
+            if new_sensor is not None:
+                block_uncovered &= rows[:, new_sensor] < detection_threshold
+            detected = rows[block_uncovered][:, locations] >= detection_threshold
+            return candidates_weight[start:start + rows.shape[0]][block_uncovered] @ detected
+
+        if n_jobs == 1 or len(blocks) <= 1:
+            gains = [__evaluate_block(start) for start in blocks]
+        else:
+            with ThreadPoolExecutor(max_workers=n_jobs) as executor:
+                gains = list(executor.map(__evaluate_block, blocks))
+
+        return np.sum(gains, axis=0)
+
+    # Initial gains are exact -- afterwards, they become upper bounds
+    all_locations = np.arange(n_locations)
+    gains = __evaluate(all_locations, None)
+    heap = [(-gain, int(location), 0) for location, gain in zip(all_locations, gains)]
+    heapq.heapify(heap)
+
+    selected, coverage = [], []
+    total_coverage, itr, new_sensor = 0., 0, None
+    while len(selected) < n_sensors:
+        if heap[0][2] != itr:   # Re-evaluate the stale sensor locations with the largest gains
+            stale = [heapq.heappop(heap) for _ in range(min(batch_size, len(heap)))]
+            locations = np.array([location for _, location, _ in stale])
+            for location, gain in zip(locations, __evaluate(locations, new_sensor)):
+                heapq.heappush(heap, (-gain, int(location), itr))
+            new_sensor = None
+
+            if heap[0][2] != itr:   # Only required if all gains in the batch are smaller
+                continue
+
+        gain, location, _ = heapq.heappop(heap)
+        selected.append(location)
+        total_coverage -= gain
+        coverage.append(float(total_coverage))
+        new_sensor = location
+        itr += 1
+
+    # Data-dependent bound: coverage + largest n_sensors upper bounds of the marginal gains
+    upper_bound = total_coverage + \
+        sum(-gain for gain, _, _ in heapq.nsmallest(n_sensors, heap))
+
+    return [signatures.sensor_locations[i] for i in selected], coverage, float(upper_bound)
+
+
+def place_pressure_sensors(sensor_config: SensorConfig, signatures: SignatureMatrix,
+                           n_sensors: int, detection_threshold: float,
+                           **kwds) -> SensorConfig:
+    """
+    Places pressure sensors such that as many leaks as possible are detected --
+    see :func:`~epyt_flow.simulation.sensor_placement.greedy_max_coverage`.
+
+    Parameters
+    ----------
+    sensor_config : :class:`~epyt_flow.simulation.sensor_config.SensorConfig`
+        Sensor configuration of the scenario -- all other sensors are kept.
+    signatures : :class:`~epyt_flow.simulation.sensor_placement.SignatureMatrix`
+        Leak signatures -- see
+        :func:`~epyt_flow.simulation.sensor_placement.compute_leak_signatures`.
+    n_sensors : `int`
+        Number of pressure sensors.
+    detection_threshold : `float`
+        Minimum pressure drop that can be detected by a sensor.
+    **kwds
+        Additional arguments of
+        :func:`~epyt_flow.simulation.sensor_placement.greedy_max_coverage`.
+
+    Returns
+    -------
+    :class:`~epyt_flow.simulation.sensor_config.SensorConfig`
+        Sensor configuration with the selected pressure sensors.
+    """
+    if not isinstance(sensor_config, SensorConfig):
+        raise TypeError("'sensor_config' must be an instance of " +
+                        "'epyt_flow.simulation.SensorConfig' but not of " +
+                        f"'{type(sensor_config)}'")
+
+    sensors, _, _ = greedy_max_coverage(signatures, n_sensors, detection_threshold, **kwds)
+
+    sensor_config = deepcopy(sensor_config)
+    sensor_config.pressure_sensors = sensors
+    return sensor_config
+
+
+def place_quality_sensors(sensor_config: SensorConfig, signatures: SignatureMatrix,
+                          n_sensors: int, detection_threshold: float = 1e-3,
+                          **kwds) -> SensorConfig:
+    """
+    Places (node) quality sensors such that as many contamination events as possible are
+    detected in time -- see :func:`~epyt_flow.simulation.sensor_placement.greedy_max_coverage`.
+
+    Parameters
+    ----------
+    sensor_config : :class:`~epyt_flow.simulation.sensor_config.SensorConfig`
+        Sensor configuration of the scenario -- all other sensors are kept.
+    signatures : :class:`~epyt_flow.simulation.sensor_placement.SignatureMatrix`
+        Contamination signatures -- see
+        :func:`~epyt_flow.simulation.sensor_placement.compute_contamination_signatures`.
+    n_sensors : `int`
+        Number of quality sensors.
+    detection_threshold : `float`, optional
+        Minimum signature that is considered as detected -- e.g. a threshold of 0.5 requires
+        the contamination to be detected within half of the maximum travel time.
+
+        The default is 1e-3.
+    **kwds
+        Additional arguments of
+        :func:`~epyt_flow.simulation.sensor_placement.greedy_max_coverage`.
+
+    Returns
+    -------
+    :class:`~epyt_flow.simulation.sensor_config.SensorConfig`
+        Sensor configuration with the selected quality sensors.
+    """
+    if not isinstance(sensor_config, SensorConfig):
+        raise TypeError("'sensor_config' must be an instance of " +
+                        "'epyt_flow.simulation.SensorConfig' but not of " +
+                        f"'{type(sensor_config)}'")
+
+    sensors, _, _ = greedy_max_coverage(signatures, n_sensors, detection_threshold, **kwds)
+
+    sensor_config = deepcopy(sensor_config)
+    sensor_config.quality_node_sensors = sensors
+    return sensor_config
@@ -0,0 +1,312 @@
+"""
+Module provides functions for identifying the source of a contamination -- i.e. for computing
+which nodes (and when) influence the water that is sampled at the quality sensors by tracing
+the water backwards through the hydraulics of a single simulation.
+"""
+import numpy as np
+from scipy.sparse import csr_array
+
+from .scenario_simulator import ScenarioSimulator
+from .native_api import get_backward_influence
+
+
+class InfluenceMatrix():
+    """
+    Class for storing the (sparse) influence of all nodes on the water sampled at a set of
+    sensor locations -- i.e. the fraction of the water sampled at a sensor location at a given
+    time that passed a node during a given time bin (sensor locations x sample times x nodes
+    x time bins).
+
+    Parameters
+    ----------
+    sensor_locations : `list[str]`
+        IDs of the sensor locations.
+    sample_times : `numpy.ndarray`
+        Sample times (seconds since the start of the simulation).
+    nodes : `list[str]`
+        IDs of all nodes.
+    bin_size : `int`
+        Length (in seconds) of a time bin.
+    samples : `numpy.ndarray`
+        Sample (i.e. sensor location x number of sample times + sample time) of each entry.
+    nodes_idx : `numpy.ndarray`
+        Node index of each entry.
+    times : `numpy.ndarray`
+        Mean time (seconds) at which the sampled water passed the node -- of each entry.
+    weights : `numpy.ndarray`
+        Fraction of the sampled water -- of each entry.
+    """
+    def __init__(self, sensor_locations: list[str], sample_times: np.ndarray, nodes: list[str],
+                 bin_size: int, samples: np.ndarray, nodes_idx: np.ndarray, times: np.ndarray,
+                 weights: np.ndarray, **kwds):
+        if not isinstance(sensor_locations, list):
+            raise TypeError("'sensor_locations' must be an instance of 'list[str]' " +
+                            f"but not of '{type(sensor_locations)}'")
+        if not isinstance(sample_times, np.ndarray):
+            raise TypeError("'sample_times' must be an instance of 'numpy.ndarray' " +
+                            f"but not of '{type(sample_times)}'")
+        if not isinstance(nodes, list):
+            raise TypeError("'nodes' must be an instance of 'list[str]' " +
+                            f"but not of '{type(nodes)}'")
+        if not isinstance(bin_size, int) or bin_size <= 0:
+            raise ValueError("'bin_size' must be a positive integer")
+        if not len(samples) == len(nodes_idx) == len(times) == len(weights):
+            raise ValueError("'samples', 'nodes_idx', 'times', and 'weights' " +
+                             "must have the same length")
+
+        self.__sensor_locations = sensor_locations
+        self.__sample_times = sample_times
+        self.__nodes = nodes
+        self.__bin_size = bin_size
+        self.__n_bins = int(np.max(sample_times)) // bin_size + 1
+        self.__samples = samples
+        self.__nodes_idx = nodes_idx
+        self.__times = times
+        self.__weights = weights
+        self.__bins = np.minimum((times // bin_size).astype(int), self.__n_bins - 1)
+
+        super().__init__(**kwds)
+
+    @property
+    def sensor_locations(self) -> list[str]:
+        """
+        Returns the IDs of the sensor locations.
+
+        Returns
+        -------
+        `list[str]`
+            IDs of the sensor locations.
+        """
+        return self.__sensor_locations
+
+    @property
+    def sample_times(self) -> np.ndarray:
+        """
+        Returns the sample times.
+
+        Returns
+        -------
+        `numpy.ndarray`
+            Sample times (seconds since the start of the simulation).
+        """
+        return self.__sample_times
+
+    @property
+    def nodes(self) -> list[str]:
+        """
+        Returns the IDs of all nodes.
+
+        Returns
+        -------
+        `list[str]`
+            IDs of all nodes.
+        """
+        return self.__nodes
+
+    @property
+    def bin_size(self) -> int:
+        """
+        Returns the length of a time bin.
+
+        Returns
+        -------
+        `int`
+            Length (in seconds) of a time bin.
+        """
+        return self.__bin_size
+
+    @property
+    def shape(self) -> tuple[int, int, int, int]:
+        """
+        Returns the shape of the influence matrix.
+
+        Returns
+        -------
+        `tuple[int, int, int, int]`
+            Number of sensor locations, sample times, nodes, and time bins.
+        """
+        return len(self.__sensor_locations), len(self.__sample_times), len(self.__nodes), \
+            self.__n_bins
+
+    @property
+    def nnz(self) -> int:
+        """
+        Returns the number of non-zero entries.
+
+        Returns
+        -------
+        `int`
+            Number of non-zero entries.
+        """
+        return len(self.__weights)
+
+    def to_sparse(self) -> csr_array:
+        """
+        Returns the influence matrix as a sparse 2d matrix -- the entry of
+        sensor location s, sample time t, node n, and time bin b is stored in
+        row s x number of sample times + t and column n x number of time bins + b.
+
+        Returns
+        -------
+        `scipy.sparse.csr_array`
+            Influence matrix.
+        """
+        n_sensors, n_times, n_nodes, n_bins = self.shape
+        return csr_array((self.__weights,
+                          (self.__samples, self.__nodes_idx * n_bins + self.__bins)),
+                         shape=(n_sensors * n_times, n_nodes * n_bins))
+
+    def get_upstream_nodes(self, sensor_location: str,
+                           sample_time: int) -> dict[str, tuple[float, float]]:
+        """
+        Returns all nodes that influence the water sampled at a given sensor location
+        and time.
+
+        Parameters
+        ----------
+        sensor_location : `str`
+            ID of the sensor location.
+        sample_time : `int`
+            Sample time (seconds since the start of the simulation).
+
+        Returns
+        -------
+        `dict[str, tuple[float, float]]`
+            Mean travel time (in seconds) from the node to the sensor location, and fraction
+            of the sampled water that passed the node -- of each upstream node.
+        """
+        if sensor_location not in self.__sensor_locations:
+            raise ValueError(f"Unknown sensor location '{sensor_location}'")
+        t = np.flatnonzero(self.__sample_times == sample_time)
+        if len(t) == 0:
+            raise ValueError(f"Unknown sample time '{sample_time}'")
+
+        sample = self.__sensor_locations.index(sensor_location) * len(self.__sample_times) + t[0]
+        mask = self.__samples == sample
+        nodes_idx, weights = self.__nodes_idx[mask], self.__weights[mask]
+        travel_times = sample_time - self.__times[mask]
+
+        n_nodes = len(self.__nodes)
+        total_weight = np.bincount(nodes_idx, weights, minlength=n_nodes)
+        mean_travel_time = np.bincount(nodes_idx, weights * travel_times, minlength=n_nodes)
+
+        return {self.__nodes[i]: (float(mean_travel_time[i] / total_weight[i]),
+                                  float(total_weight[i]))
+                for i in np.flatnonzero(total_weight > 0)}
+
+    def locate_source(self, detections: np.ndarray,
+                      n_candidates: int = 10) -> list[tuple[str, int, float]]:
+        """
+        Ranks all nodes and injection times by their consistency with the observed detections
+        -- i.e. by the total influence on all samples with a detection minus the total
+        influence on all samples without a detection.
+
+        Parameters
+        ----------
+        detections : `numpy.ndarray`
+            Boolean array of shape (sensor locations, sample times) indicating whether the
+            contamination was detected in a sample or not.
+        n_candidates : `int`, optional
+            Number of candidates that are returned.
+
+            The default is 10.
+
+        Returns
+        -------
+        `list[tuple[str, int, float]]`
+            Node ID, start of the injection time bin (seconds), and score of the
+            most likely sources -- sorted by decreasing score.
+        """
+        n_sensors, n_times, _, n_bins = self.shape
+        if not isinstance(detections, np.ndarray) or detections.shape != (n_sensors, n_times):
+            raise ValueError("'detections' must be an array of shape " +
+                             f"{(n_sensors, n_times)}")
+        if not isinstance(n_candidates, int) or n_candidates <= 0:
+            raise ValueError("'n_candidates' must be a positive integer")
+
+        sign = np.where(detections.astype(bool).flatten(), 1., -1.)
+        scores = sign @ self.to_sparse()
+
+        best = np.argsort(-scores, kind="stable")[:n_candidates]
+        return [(self.__nodes[i // n_bins], int(i % n_bins) * self.__bin_size,
+                 float(scores[i])) for i in best]
+
+
+def compute_backward_influence(scenario: ScenarioSimulator, sensor_locations: list[str] = None,
+                               sample_times: list[int] = None, bin_size: int = None,
+                               min_weight: float = 1e-3) -> InfluenceMatrix:
+    """
+    Computes the influence of all nodes on the water that is sampled at a set of sensor
+    locations -- e.g. for identifying the source of a contamination.
+
+    Instead of simulating a contamination at every candidate node, the scenario is simulated
+    only once and the water of every sample is traced backwards through the stored hydraulics
+    -- see :func:`~epyt_flow.simulation.native_api.get_backward_influence`.
+
+    Parameters
+    ----------
+    scenario : :class:`~epyt_flow.simulation.scenario_simulator.ScenarioSimulator`
+        Scenario.
+    sensor_locations : `list[str]`, optional
+        IDs of the nodes where the water is sampled.
+        If None, the (node) quality sensors of the scenario are used.
+
+        The default is None.
+    sample_times : `list[int]`, optional
+        Sample times (seconds since the start of the simulation).
+        If None, all reporting time steps are used.
+
+        The default is None.
+    bin_size : `int`, optional
+        Length (in seconds) of a time bin. If None, the hydraulic time step is used.
+
+        The default is None.
+    min_weight : `float`, optional
+        Smallest fraction of the sampled water that is stored in the influence matrix.
+
+        The default is 1e-3.
+
+    Returns
+    -------
+    :class:`~epyt_flow.simulation.source_identification.InfluenceMatrix`
+        Influence matrix.
+    """
+    if not isinstance(scenario, ScenarioSimulator):
+        raise TypeError("'scenario' must be an instance of " +
+                        "'epyt_flow.simulation.ScenarioSimulator' but not of " +
+                        f"'{type(scenario)}'")
+    if bin_size is not None and (not isinstance(bin_size, int) or bin_size <= 0):
+        raise ValueError("'bin_size' must be a positive integer")
+    if not isinstance(min_weight, (float, int)) or min_weight < 0:
+        raise ValueError("'min_weight' must be non-negative")
+
+    sensor_locations = scenario.sensor_config.quality_node_sensors \
+        if sensor_locations is None else sensor_locations
+    if len(sensor_locations) == 0:
+        raise ValueError("No sensor locations given")
+
+    epanet_api = scenario.epanet_api
+    if sample_times is None:
+        sample_times = range(epanet_api.getTimeReportingStart(),
+                             scenario.get_simulation_duration() + 1,
+                             epanet_api.getTimeReportingStep())
+    sample_times = np.array(sample_times, dtype=np.int64)
+    if len(sample_times) == 0 or np.any(sample_times < 0) or \
+            np.any(sample_times > scenario.get_simulation_duration()):
+        raise ValueError("All sample times must be within the simulation")
+    bin_size = bin_size if bin_size is not None else int(epanet_api.getTimeHydraulicStep())
+
+    topology = scenario.get_topology()
+    nodes = topology.get_all_nodes()
+    sensors_idx = np.array([topology.get_node_index(node_id) for node_id in sensor_locations])
+
+    # The hydraulics of the simulation are saved to the hydraulics file
+    for _ in scenario.run_simulation_as_generator(return_as_dict=True):
+        pass
+
+    samples, nodes_idx, times, weights = get_backward_influence(epanet_api, sensors_idx,
+                                                                sample_times, bin_size,
+                                                                float(min_weight))
+
+    return InfluenceMatrix(list(sensor_locations), sample_times, list(nodes), bin_size,
+                           samples, nodes_idx, times, weights)
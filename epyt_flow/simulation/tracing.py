@@ -0,0 +1,372 @@
+"""
+Module provides a lightweight tracer for recording timelines of simulations in the
+Chrome trace event format -- such traces can be viewed in `chrome://tracing` or
+`Perfetto <https://ui.perfetto.dev>`_.
+
+Spans are recorded from the Python simulation loop and (if supported by the loaded libraries)
+from the simulation phases inside EPANET and EPANET-MSX. Each process writes its own trace file,
+which can be combined into a single timeline by calling
+:func:`~epyt_flow.simulation.tracing.merge_traces`.
+"""
+from typing import Any
+import os
+import json
+import time
+import threading
+import ctypes
+from contextlib import nullcontext
+import numpy as np
+from epyt import epanet
+
+from .native_api import get_native_function, get_msx_function, as_pointer, \
+    EN_PROFILE_PHASES, MSX_PROFILE_PHASES
+
+
+_EN_PHASE_NAMES = {phase: phase_name for phase_name, phase in EN_PROFILE_PHASES.items()}
+_MSX_PHASE_NAMES = {phase: phase_name for phase_name, phase in MSX_PROFILE_PHASES.items()}
+
+_NULL_SPAN = nullcontext()
+
+
+class _Span():
+    __slots__ = ("_tracer", "_name", "_category", "_args", "_start")
+
+    def __init__(self, tracer, name: str, category: str, args: dict):
+        self._tracer = tracer
+        self._name = name
+        self._category = category
+        self._args = args
+        self._start = None
+
+    def __enter__(self):
+        self._start = time.perf_counter()
+        return self
+
+    def __exit__(self, *_):
+        self._tracer.add_event(self._name, self._category, self._start,
+                               time.perf_counter() - self._start, self._args)
+
+
+class Tracer():
+    """
+    Class for recording a timeline of (nested) spans in the Chrome trace event format.
+
+    Time stamps are taken from :func:`time.perf_counter`, which is a system-wide clock on Linux
+    and Windows -- i.e. traces of different processes can be merged into a single timeline.
+
+    Note that there is a single tracer per process, see
+    :func:`~epyt_flow.simulation.tracing.get_tracer`.
+    """
+    def __init__(self):
+        self.__enabled = False
+        self.__trace_dir = None
+        self.__native_buffer_size = 0
+        self.__events = []
+        self.__lock = threading.Lock()
+
+    @property
+    def enabled(self) -> bool:
+        """
+        Checks if tracing is enabled.
+
+        Returns
+        -------
+        `bool`
+            True if tracing is enabled, False otherwise.
+        """
+        return self.__enabled
+
+    @property
+    def trace_dir(self) -> str:
+        """
+        Gets the folder where trace files are stored.
+
+        Returns
+        -------
+        `str`
+            Path to the folder -- None if not set.
+        """
+        return self.__trace_dir
+
+    @property
+    def native_buffer_size(self) -> int:
+        """
+        Gets the capacity (in events) of the ring buffers used inside EPANET and EPANET-MSX.
+
+        Returns
+        -------
+        `int`
+            Capacity of the ring buffers -- 0 if the simulation phases inside EPANET and
+            EPANET-MSX are not traced.
+        """
+        return self.__native_buffer_size
+
+    def enable(self, trace_dir: str = None, native_buffer_size: int = 65536) -> None:
+        """
+        Enables tracing.
+
+        Parameters
+        ----------
+        trace_dir : `str`, optional
+            Path to the folder where trace files are stored by
+            :func:`~epyt_flow.simulation.tracing.Tracer.save` -- this folder is also used by
+            the worker processes of
+            :class:`~epyt_flow.simulation.parallel_simulation.ParallelScenarioSimulation`.
+
+            The default is None.
+        native_buffer_size : `int`, optional
+            Capacity (in events) of the ring buffers recording the simulation phases
+            inside EPANET and EPANET-MSX. Those buffers are drained after every time step --
+            if 0, the simulation phases inside EPANET and EPANET-MSX are not traced.
+
+            The default is 65536.
+        """
+        if trace_dir is not None and not isinstance(trace_dir, str):
+            raise TypeError("'trace_dir' must be an instance of 'str' but not of " +
+                            f"'{type(trace_dir)}'")
+        if not isinstance(native_buffer_size, int):
+            raise TypeError("'native_buffer_size' must be an instance of 'int' but not of " +
+                            f"'{type(native_buffer_size)}'")
+        if native_buffer_size < 0:
+            raise ValueError("'native_buffer_size' can not be negative")
+
+        if trace_dir is not None:
+            os.makedirs(trace_dir, exist_ok=True)
+
+        self.__trace_dir = trace_dir
+        self.__native_buffer_size = native_buffer_size
+        self.__enabled = True
+
+    def disable(self) -> None:
+        """
+        Disables tracing -- already recorded events are kept.
+        """
+        self.__enabled = False
+
+    def clear(self) -> None:
+        """
+        Removes all recorded events.
+        """
+        with self.__lock:
+            self.__events = []
+
+    def span(self, name: str, category: str = "python", **args) -> Any:
+        """
+        Creates a context manager recording a span -- if tracing is disabled, a shared
+        no-op context manager is returned.
+
+        Parameters
+        ----------
+        name : `str`
+            Name of the span.
+        category : `str`, optional
+            Category of the span.
+
+            The default is "python".
+        **args
+            Additional information attached to the span.
+
+        Returns
+        -------
+        `Any`
+            Context manager.
+        """
+        if self.__enabled is False:
+            return _NULL_SPAN
+
+        return _Span(self, name, category, args)
+
+    def add_event(self, name: str, category: str, start: float, duration: float,
+                  args: dict = None) -> None:
+        """
+        Adds a (complete) event to the timeline.
+
+        Parameters
+        ----------
+        name : `str`
+            Name of the event.
+        category : `str`
+            Category of the event.
+        start : `float`
+            Start time (in seconds) w.r.t. :func:`time.perf_counter`.
+        duration : `float`
+            Duration in seconds.
+        args : `dict`, optional
+            Additional information attached to the event.
+
+            The default is None.
+        """
+        event = {"name": name, "cat": category, "ph": "X", "ts": start * 1e6,
+                 "dur": duration * 1e6, "pid": os.getpid(), "tid": threading.get_ident()}
+        if args:
+            event["args"] = args
+
+        with self.__lock:
+            self.__events.append(event)
+
+    def __get_clock_offset(self, read_clock: Any) -> float:
+        t_start = time.perf_counter()
+        t_native = read_clock()
+        t_end = time.perf_counter()
+
+        return .5 * (t_start + t_end) - t_native
+
+    def __add_native_events(self, f_get_trace: Any, handle: tuple, phase_names: dict,
+                            category: str, clock_offset: float) -> None:
+        buffer_size = max(self.__native_buffer_size, 1)
+        phases = np.zeros(buffer_size, dtype=np.intc)
+        starts = np.zeros(buffer_size, dtype=np.float64)
+        durations = np.zeros(buffer_size, dtype=np.float64)
+        count = ctypes.c_int()
+        dropped = ctypes.c_int()
+
+        while True:
+            err = f_get_trace(*handle, ctypes.c_int(buffer_size),
+                              as_pointer(phases, ctypes.c_int), as_pointer(starts, ctypes.c_double),
+                              as_pointer(durations, ctypes.c_double), ctypes.byref(count),
+                              ctypes.byref(dropped))
+            if err > 100:
+                raise RuntimeError(f"Failed to retrieve trace events -- error code {err}")
+
+            for i in range(count.value):
+                self.add_event(phase_names[int(phases[i])], category,
+                               starts[i] + clock_offset, durations[i])
+            if dropped.value > 0:
+                self.add_event("dropped_events", category, time.perf_counter(), 0,
+                               {"count": dropped.value})
+
+            if count.value < buffer_size:
+                break
+
+    def collect_native_events(self, epanet_api: epanet, msx: bool = False) -> None:
+        """
+        Moves all events recorded by EPANET (or EPANET-MSX) to the timeline.
+
+        Parameters
+        ----------
+        epanet_api : `epyt.epanet`
+            EPyT instance.
+        msx : `bool`, optional
+            If True, the events recorded by EPANET-MSX are collected,
+            otherwise the ones recorded by EPANET.
+
+            The default is False.
+        """
+        f_clock, handle = get_native_function(epanet_api, "gettraceclock")
+
+        def read_clock():
+            t = ctypes.c_double()
+            f_clock(*handle, ctypes.byref(t))
+            return t.value
+
+        clock_offset = self.__get_clock_offset(read_clock)
+
+        if msx is False:
+            f_get_trace, _ = get_native_function(epanet_api, "gettrace")
+            self.__add_native_events(f_get_trace, handle, _EN_PHASE_NAMES, "epanet",
+                                     clock_offset)
+        else:
+            f_get_trace = get_msx_function(epanet_api, "gettrace")
+            self.__add_native_events(f_get_trace, (), _MSX_PHASE_NAMES, "epanet-msx",
+                                     clock_offset)
+
+    def get_events(self) -> list[dict]:
+        """
+        Gets all recorded events.
+
+        Returns
+        -------
+        `list[dict]`
+            List of events in the Chrome trace event format.
+        """
+        with self.__lock:
+            return list(self.__events)
+
+    def save(self, f_out: str = None, clear: bool = True) -> str:
+        """
+        Writes all recorded events to a trace file (JSON).
+
+        Parameters
+        ----------
+        f_out : `str`, optional
+            Path to the trace file. If None, the events are stored in the file
+            'trace_<pid>.json' in the folder given by
+            :attr:`~epyt_flow.simulation.tracing.Tracer.trace_dir`.
+
+            The default is None.
+        clear : `bool`, optional
+            If True, all recorded events are removed after they have been written.
+
+            The default is True.
+
+        Returns
+        -------
+        `str`
+            Path to the trace file.
+        """
+        if f_out is None:
+            if self.__trace_dir is None:
+                raise ValueError("'f_out' must be set if no 'trace_dir' is specified")
+            f_out = os.path.join(self.__trace_dir, f"trace_{os.getpid()}.json")
+
+        with self.__lock:
+            events = self.__events
+            if clear is True:
+                self.__events = []
+
+        meta = {"name": "process_name", "ph": "M", "pid": os.getpid(),
+                "args": {"name": f"epyt_flow ({os.getpid()})"}}
+        with open(f_out, "w", encoding="utf-8") as f:
+            json.dump({"traceEvents": [meta] + events, "displayTimeUnit": "ms"}, f)
+
+        return f_out
+
+
+_tracer = Tracer()
+
+
+def get_tracer() -> Tracer:
+    """
+    Gets the tracer of this process.
+
+    Returns
+    -------
+    :class:`~epyt_flow.simulation.tracing.Tracer`
+        Tracer.
+    """
+    return _tracer
+
+
+def merge_traces(files_in: list[str], f_out: str) -> None:
+    """
+    Merges multiple trace files (e.g. one per worker process) into a single timeline.
+
+    Parameters
+    ----------
+    files_in : `list[str]`
+        Paths to the trace files -- if a folder is given, all 'trace_*.json' files
+        in that folder are merged.
+    f_out : `str`
+        Path to the merged trace file.
+    """
+    if not isinstance(files_in, list):
+        raise TypeError("'files_in' must be an instance of 'list[str]' but not of " +
+                        f"'{type(files_in)}'")
+
+    paths = []
+    for path in files_in:
+        if os.path.isdir(path):
+            paths += sorted(os.path.join(path, f) for f in os.listdir(path)
+                            if f.startswith("trace_") and f.endswith(".json"))
+        else:
+            paths.append(path)
+
+    events = []
+    for path in paths:
+        if os.path.abspath(path) == os.path.abspath(f_out):
+            continue
+        with open(path, "r", encoding="utf-8") as f:
+            events += json.load(f)["traceEvents"]
+
+    with open(f_out, "w", encoding="utf-8") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)
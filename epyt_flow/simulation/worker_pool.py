@@ -0,0 +1,120 @@
+"""
+Module provides a pool of loaded copies of a network that evaluate many candidates (e.g. proposed
+by an optimizer) in parallel.
+"""
+from typing import Any, Callable, Iterable
+from queue import Queue
+from concurrent.futures import ThreadPoolExecutor
+
+
+class WorkerPool():
+    """
+    Pool of workers (e.g. loaded copies of a network) that are created once and re-used for
+    all evaluations -- every worker evaluates one candidate at a time.
+
+    The workers run in threads, which simulate in parallel since the EPANET library is
+    called without holding the Python interpreter lock.
+
+    Parameters
+    ----------
+    create_worker : `Callable[[], Any]`
+        Function creating a new worker -- workers must provide a `close()` method.
+    n_workers : `int`
+        Number of workers -- i.e. number of candidates that are evaluated in parallel.
+    """
+    def __init__(self, create_worker: Callable[[], Any], n_workers: int):
+        if not callable(create_worker):
+            raise TypeError("'create_worker' must be callable")
+        if not isinstance(n_workers, int):
+            raise TypeError("'n_workers' must be an instance of 'int' " +
+                            f"but not of '{type(n_workers)}'")
+        if n_workers <= 0:
+            raise ValueError("'n_workers' must be positive")
+
+        self.__workers = []
+        self.__idle_workers = Queue()
+        self.__executor = None
+
+        try:
+            for _ in range(n_workers):
+                worker = create_worker()
+                self.__workers.append(worker)
+                self.__idle_workers.put(worker)
+        except Exception:
+            self.close()
+            raise
+
+        self.__executor = ThreadPoolExecutor(max_workers=n_workers)
+
+    @property
+    def workers(self) -> list[Any]:
+        """
+        Gets all workers of the pool.
+
+        Returns
+        -------
+        `list[Any]`
+            Workers.
+        """
+        return list(self.__workers)
+
+    @property
+    def closed(self) -> bool:
+        """
+        Checks if the pool has been closed.
+
+        Returns
+        -------
+        `bool`
+            True if the pool has been closed, False otherwise.
+        """
+        return self.__executor is None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self) -> None:
+        """
+        Closes all workers.
+        """
+        if self.__executor is not None:
+            self.__executor.shutdown()
+            self.__executor = None
+
+        for worker in self.__workers:
+            worker.close()
+        self.__workers = []
+        self.__idle_workers = Queue()
+
+    def map(self, evaluate: Callable[[Any, Any], Any], candidates: Iterable[Any]) -> list[Any]:
+        """
+        Evaluates a set of candidates in parallel -- every candidate is evaluated by the
+        next idle worker.
+
+        Parameters
+        ----------
+        evaluate : `Callable[[Any, Any], Any]`
+            Function evaluating a given candidate (second argument) by a given worker
+            (first argument).
+        candidates : `Iterable[Any]`
+            Candidates.
+
+        Returns
+        -------
+        `list[Any]`
+            Result of each candidate.
+        """
+        if self.__executor is None:
+            raise RuntimeError("The pool has already been closed")
+
+        def evaluate_candidate(candidate: Any) -> Any:
+            worker = self.__idle_workers.get()
+            try:
+                return evaluate(worker, candidate)
+            finally:
+                self.__idle_workers.put(worker)
+
+        return list(self.__executor.map(evaluate_candidate, candidates))
@@ -3,10 +3,13 @@ Module provides a class for representing the topology of WDN.
 """
 from copy import deepcopy
 import warnings
-from typing import Any
+from typing import Any, Union
+from concurrent.futures import ThreadPoolExecutor
+import os
 import numpy as np
 import networkx as nx
-from scipy.sparse import bsr_array
+from scipy.sparse import bsr_array, csr_array
+from scipy.sparse.csgraph import dijkstra
 from geopandas import GeoDataFrame
 from shapely.geometry import Point, LineString
 
@@ -73,12 +76,20 @@ class NetworkTopology(nx.Graph, JsonSerializable):
 
             - UNITS_USCUSTOM = 0  (US Customary)
             - UNITS_SIMETRIC = 1  (SI Metric)
+    adjacency : `tuple[numpy.ndarray, numpy.ndarray, numpy.ndarray]`, optional
+        Node adjacency in compressed sparse row (CSR) format -- i.e. row pointers,
+        indices of neighboring nodes, and indices of connecting links
+        (see :func:`~epyt_flow.topology.NetworkTopology.get_csr_adjacency`).
+        Usually provided by EPANET, if None, it will be computed when needed.
+
+        The default is None.
     """
     def __init__(self, f_inp: str, nodes: list[tuple[str, dict]],
                  links: list[tuple[str, tuple[str, str], dict]],
                  pumps: dict,
                  valves: dict,
                  units: int = None,
+                 adjacency: tuple[np.ndarray, np.ndarray, np.ndarray] = None,
                  **kwds):
         super().__init__(name=f_inp, **kwds)
 
@@ -88,6 +99,17 @@ class NetworkTopology(nx.Graph, JsonSerializable):
         self.__valves = valves
         self.__units = units
 
+        self.__node_index = {node_id: idx for idx, (node_id, _) in enumerate(nodes)}
+        self.__link_index = {link_id: idx for idx, (link_id, _, _) in enumerate(links)}
+
+        if adjacency is not None:
+            row_ptr, col_idx, link_idx = adjacency
+            if len(row_ptr) != len(nodes) + 1 or len(col_idx) != 2 * len(links) or \
+                    len(link_idx) != 2 * len(links):
+                raise ValueError("'adjacency' does not match the given nodes and links")
+            adjacency = tuple(np.asarray(a, dtype=np.int32) for a in adjacency)
+        self.__adjacency = adjacency
+
         if units is None:
             warnings.warn("Loading a file that was created with an outdated version of EPyT-Flow" +
                           " -- support of such old files will be removed in the next release!",
@@ -305,11 +327,10 @@ class NetworkTopology(nx.Graph, JsonSerializable):
         `dict`
             Information associated with the given node.
         """
-        for node_id_, node_info in self.__nodes:
-            if node_id_ == node_id:
-                return node_info
+        if node_id not in self.__node_index:
+            raise ValueError(f"Unknown node '{node_id}'")
 
-        raise ValueError(f"Unknown node '{node_id}'")
+        return self.__nodes[self.__node_index[node_id]][1]
 
     def get_link_info(self, link_id: str) -> dict:
         """
@@ -327,11 +348,11 @@ class NetworkTopology(nx.Graph, JsonSerializable):
         `dict`
             Information associated with the given link.
         """
-        for link_id_, link_nodes, link_info in self.__links:
-            if link_id_ == link_id:
-                return {"nodes": link_nodes} | link_info
+        if link_id not in self.__link_index:
+            raise ValueError(f"Unknown link '{link_id}'")
 
-        raise ValueError(f"Unknown link '{link_id}'")
+        _, link_nodes, link_info = self.__links[self.__link_index[link_id]]
+        return {"nodes": link_nodes} | link_info
 
     def get_pump_info(self, pump_id: str) -> dict:
         """
@@ -535,6 +556,81 @@ class NetworkTopology(nx.Graph, JsonSerializable):
 
         return gis
 
+    def get_node_index(self, node_id: str) -> int:
+        """
+        Gets the index (starting at 0) of a given node -- i.e. its position in
+        :func:`~epyt_flow.topology.NetworkTopology.get_all_nodes`.
+
+        Parameters
+        ----------
+        node_id : `str`
+            ID of the node.
+
+        Returns
+        -------
+        `int`
+            Index of the node.
+        """
+        if node_id not in self.__node_index:
+            raise ValueError(f"Unknown node '{node_id}'")
+
+        return self.__node_index[node_id]
+
+    def get_link_index(self, link_id: str) -> int:
+        """
+        Gets the index (starting at 0) of a given link -- i.e. its position in
+        :func:`~epyt_flow.topology.NetworkTopology.get_all_links`.
+
+        Parameters
+        ----------
+        link_id : `str`
+            ID of the link.
+
+        Returns
+        -------
+        `int`
+            Index of the link.
+        """
+        if link_id not in self.__link_index:
+            raise ValueError(f"Unknown link '{link_id}'")
+
+        return self.__link_index[link_id]
+
+    def __get_links_end_points_index(self) -> tuple[np.ndarray, np.ndarray]:
+        a = np.fromiter((self.__node_index[link[0]] for _, link, _ in self.__links),
+                        dtype=np.int32, count=len(self.__links))
+        b = np.fromiter((self.__node_index[link[1]] for _, link, _ in self.__links),
+                        dtype=np.int32, count=len(self.__links))
+        return a, b
+
+    def get_csr_adjacency(self) -> tuple[np.ndarray, np.ndarray, np.ndarray]:
+        """
+        Gets the node adjacency in compressed sparse row (CSR) format -- i.e. the neighbors of
+        the i-th node are given by col_idx[row_ptr[i]:row_ptr[i+1]] and the connecting links by
+        link_idx[row_ptr[i]:row_ptr[i+1]].
+
+        Note that each link appears twice, once for each of its end points.
+
+        Returns
+        -------
+        `tuple[numpy.ndarray, numpy.ndarray, numpy.ndarray]`
+            Row pointers, indices of neighboring nodes, and indices of connecting links.
+        """
+        if self.__adjacency is None:
+            a, b = self.__get_links_end_points_index()
+            links_idx = np.arange(len(self.__links), dtype=np.int32)
+
+            src = np.concatenate((a, b))
+            order = np.argsort(src, kind="stable")
+            col_idx = np.concatenate((b, a))[order]
+            link_idx = np.concatenate((links_idx, links_idx))[order]
+            row_ptr = np.zeros(len(self.__nodes) + 1, dtype=np.int32)
+            row_ptr[1:] = np.cumsum(np.bincount(src, minlength=len(self.__nodes)))
+
+            self.__adjacency = (row_ptr, col_idx, link_idx)
+
+        return self.__adjacency
+
     def get_adj_matrix(self) -> bsr_array:
         """
         Gets the adjacency matrix of this graph.
@@ -544,24 +640,12 @@ class NetworkTopology(nx.Graph, JsonSerializable):
         `scipy.bsr_array`
             Adjacency matrix as a sparse array.
         """
-        nodes_id = [node_id for node_id, _ in self.__nodes]
         n_nodes = len(self.__nodes)
+        a, b = self.__get_links_end_points_index()
+        diag = np.arange(n_nodes, dtype=np.int32)
 
-        row = []
-        col = []
-        for _, link_end_points, _ in self.__links:
-            a = nodes_id.index(link_end_points[0])
-            b = nodes_id.index(link_end_points[1])
-
-            row.append(a)
-            col.append(b)
-
-            row.append(b)
-            col.append(a)
-
-        for i in range(n_nodes):
-            row.append(i)
-            col.append(i)
+        row = np.concatenate((a, b, diag))
+        col = np.concatenate((b, a, diag))
 
         return bsr_array((np.ones(len(row)), (row, col)), shape=(n_nodes, n_nodes))
 
@@ -579,7 +663,7 @@ class NetworkTopology(nx.Graph, JsonSerializable):
         `list[str]`
             IDs of neighboring nodes.
         """
-        if node_id not in self.get_all_nodes():
+        if node_id not in self.__node_index:
             raise ValueError(f"Unknown node '{node_id}'")
 
         return list(self.neighbors(node_id))
@@ -598,14 +682,16 @@ class NetworkTopology(nx.Graph, JsonSerializable):
         `list[tuple[str, tuple[str, str]]]`
             Adjacent links -- i.e. (link ID, IDs of node end points).
         """
-        if node_id not in self.get_all_nodes():
+        if node_id not in self.__node_index:
             raise ValueError(f"Unknown node '{node_id}'")
 
-        links = []
+        row_ptr, _, link_idx = self.get_csr_adjacency()
+        node_idx = self.__node_index[node_id]
 
-        for link_id, nodes_id, _ in self.__links:
-            if node_id in nodes_id:
-                links.append((link_id, nodes_id))
+        links = []
+        for idx in sorted(set(link_idx[row_ptr[node_idx]:row_ptr[node_idx + 1]])):
+            link_id, nodes_id, _ = self.__links[idx]
+            links.append((link_id, nodes_id))
 
         return links
 
@@ -626,9 +712,9 @@ class NetworkTopology(nx.Graph, JsonSerializable):
 
             The default is True.
         """
-        if start_node_id not in self.get_all_nodes():
+        if start_node_id not in self.__node_index:
             raise ValueError(f"Unknown node '{start_node_id}'")
-        if end_node_id not in self.get_all_nodes():
+        if end_node_id not in self.__node_index:
             raise ValueError(f"Unknown node '{end_node_id}'")
 
         weight = "length" if use_pipe_length_as_weight is True else None
@@ -672,9 +758,9 @@ class NetworkTopology(nx.Graph, JsonSerializable):
 
             The default is True.
         """
-        if start_node_id not in self.get_all_nodes():
+        if start_node_id not in self.__node_index:
             raise ValueError(f"Unknown node '{start_node_id}'")
-        if end_node_id not in self.get_all_nodes():
+        if end_node_id not in self.__node_index:
             raise ValueError(f"Unknown node '{end_node_id}'")
 
         weight = "length" if use_pipe_length_as_weight is True else None
@@ -685,6 +771,9 @@ class NetworkTopology(nx.Graph, JsonSerializable):
         """
         Computes the shortest path length between all pairs of nodes in this graph.
 
+        Note that for large networks,
+        :func:`~epyt_flow.topology.NetworkTopology.get_distance_matrix` should be used instead.
+
         Parameters
         ----------
         use_pipe_length_as_weight : `bool`, optional
@@ -701,3 +790,142 @@ class NetworkTopology(nx.Graph, JsonSerializable):
         """
         weight = "length" if use_pipe_length_as_weight is True else None
         return dict(nx.shortest_path_length(self, weight=weight))
+
+    def get_csr_graph(self, use_pipe_length_as_weight: bool = True) -> csr_array:
+        """
+        Gets this graph as a weighted (symmetric) sparse matrix in CSR format.
+
+        Parallel links are merged into a single edge with the minimum weight.
+
+        Parameters
+        ----------
+        use_pipe_length_as_weight : `bool`, optional
+            If True, pipe lengths are used for the edge weights -- otherwise,
+            each edge weight is set to one.
+
+            The default is True.
+
+        Returns
+        -------
+        `scipy.sparse.csr_array`
+            Weighted graph as a sparse matrix.
+        """
+        row_ptr, col_idx, link_idx = self.get_csr_adjacency()
+        n_nodes = len(self.__nodes)
+
+        if use_pipe_length_as_weight is True:
+            links_length = np.array([link_info["length"] for _, _, link_info in self.__links],
+                                    dtype=np.float64)
+            weights = links_length[link_idx]
+        else:
+            weights = np.ones(len(link_idx), dtype=np.float64)
+
+        # Merge parallel links
+        rows = np.repeat(np.arange(n_nodes, dtype=np.int64), np.diff(row_ptr))
+        key = rows * n_nodes + col_idx
+        order = np.lexsort((weights, key))
+        key, weights = key[order], weights[order]
+        first = np.ones(len(key), dtype=bool)
+        first[1:] = key[1:] != key[:-1]
+        key, weights = key[first], weights[first]
+
+        new_row_ptr = np.zeros(n_nodes + 1, dtype=np.int32)
+        new_row_ptr[1:] = np.cumsum(np.bincount(key // n_nodes, minlength=n_nodes))
+
+        return csr_array((weights, (key % n_nodes).astype(np.int32), new_row_ptr),
+                         shape=(n_nodes, n_nodes))
+
+    def get_distance_matrix(self, sources: list[str] = None, targets: list[str] = None,
+                            use_pipe_length_as_weight: bool = True,
+                            dtype: np.dtype = np.float32, f_out: str = None,
+                            block_size: int = 256,
+                            n_jobs: int = None) -> Union[np.ndarray, np.memmap]:
+        """
+        Computes the shortest path lengths between (a subset of) all pairs of nodes.
+
+        In contrast to
+        :func:`~epyt_flow.topology.NetworkTopology.get_all_pairs_shortest_path_length`,
+        the result is a dense matrix and the computation is done by compiled Dijkstra
+        (or breadth-first search if no weights are used) kernels that process blocks of source
+        nodes in parallel. For large networks, the result can be written block-wise
+        to a memory-mapped .npy file.
+
+        Parameters
+        ----------
+        sources : `list[str]`, optional
+            IDs of the source nodes (rows) -- e.g. all sensor locations.
+            If None, all nodes are used.
+
+            The default is None.
+        targets : `list[str]`, optional
+            IDs of the target nodes (columns). If None, all nodes are used.
+
+            The default is None.
+        use_pipe_length_as_weight : `bool`, optional
+            If True, pipe lengths are used for the edge weights -- otherwise,
+            each edge weight is set to one.
+
+            The default is True.
+        dtype : `numpy.dtype`, optional
+            Data type of the distance matrix.
+
+            The default is float32.
+        f_out : `str`, optional
+            Path to a .npy file -- if not None, the distance matrix is written to this file
+            and returned as a memory-mapped array.
+
+            The default is None.
+        block_size : `int`, optional
+            Number of source nodes processed at once.
+
+            The default is 256.
+        n_jobs : `int`, optional
+            Number of threads. If None, the number of CPUs is used.
+
+            The default is None.
+
+        Returns
+        -------
+        `numpy.ndarray` or `numpy.memmap`
+            Distance matrix -- unreachable pairs are set to infinity.
+        """
+        if not isinstance(block_size, int) or block_size <= 0:
+            raise ValueError("'block_size' must be a positive integer")
+        if n_jobs is not None and (not isinstance(n_jobs, int) or n_jobs <= 0):
+            raise ValueError("'n_jobs' must be a positive integer")
+
+        sources_idx = np.arange(len(self.__nodes)) if sources is None else \
+            np.array([self.get_node_index(node_id) for node_id in sources], dtype=np.int32)
+        targets_idx = None if targets is None else \
+            np.array([self.get_node_index(node_id) for node_id in targets], dtype=np.int32)
+        n_targets = len(self.__nodes) if targets_idx is None else len(targets_idx)
+
+        graph = self.get_csr_graph(use_pipe_length_as_weight)
+        unweighted = not use_pipe_length_as_weight
+
+        if f_out is not None:
+            dist = np.lib.format.open_memmap(f_out, mode="w+", dtype=dtype,
+                                             shape=(len(sources_idx), n_targets))
+        else:
+            dist = np.empty((len(sources_idx), n_targets), dtype=dtype)
+
+        def __compute_block(start: int) -> None:
+            d = dijkstra(graph, directed=True, unweighted=unweighted,
+                         indices=sources_idx[start:start + block_size])
+            if targets_idx is not None:
+                d = d[:, targets_idx]
+            dist[start:start + block_size, :] = d
+
+        n_jobs = n_jobs if n_jobs is not None else (os.cpu_count() or 1)
+        blocks = range(0, len(sources_idx), block_size)
+        if n_jobs == 1 or len(blocks) <= 1:
+            for start in blocks:
+                __compute_block(start)
+        else:
+            with ThreadPoolExecutor(max_workers=n_jobs) as executor:
+                list(executor.map(__compute_block, blocks))
+
+        if isinstance(dist, np.memmap):
+            dist.flush()
+
+        return dist
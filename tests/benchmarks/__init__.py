@@ -0,0 +1,3 @@
+"""
+End-to-end throughput benchmarks -- see :mod:`tests.benchmarks.run_benchmarks`.
+"""
@@ -0,0 +1,96 @@
+"""
+Compares the latest benchmark results in a history file against the previous ones and
+flags regressions -- usage (from the root of the repository)::
+
+    python -m tests.benchmarks.compare benchmark_history.jsonl --threshold 0.1
+
+Results are only compared if they were obtained for the same workload, network size,
+simulation duration, and machine. The exit code is 1 if a regression was found, 0 otherwise.
+"""
+import sys
+import json
+import argparse
+import numpy as np
+
+
+def load_history(f_in: str) -> list[dict]:
+    """
+    Loads all records from a history file.
+    """
+    with open(f_in, "r", encoding="utf-8") as f:
+        return [json.loads(line) for line in f if line.strip() != ""]
+
+
+def _get_key(record: dict) -> tuple:
+    machine = record.get("machine", {})
+    return (record["workload"], record["n_nodes"], record["n_days"],
+            machine.get("platform"), machine.get("processor"), machine.get("cpu_count"))
+
+
+def compare(history: list[dict], threshold: float = .1, window: int = 5) -> list[dict]:
+    """
+    Compares the latest record of each workload against the median of the
+    (at most 'window') preceding records.
+
+    A regression is flagged if the throughput decreased, or the peak memory consumption
+    increased, by more than 'threshold' (relative change).
+    """
+    if not 0 < threshold:
+        raise ValueError("'threshold' must be positive")
+    if window < 1:
+        raise ValueError("'window' must be positive")
+
+    records = {}
+    for record in history:
+        records.setdefault(_get_key(record), []).append(record)
+
+    results = []
+    for key, workload_records in records.items():
+        workload_records = sorted(workload_records, key=lambda r: r["timestamp"])
+        latest, baseline = workload_records[-1], workload_records[-window-1:-1]
+
+        result = {"workload": key[0], "n_nodes": key[1], "n_days": key[2],
+                  "commit": latest.get("commit"),
+                  "scenarios_per_hour": latest["scenarios_per_hour"],
+                  "peak_rss_mb": latest["peak_rss_mb"],
+                  "throughput_change": None, "memory_change": None, "regression": False}
+        if len(baseline) != 0:
+            baseline_throughput = np.median([r["scenarios_per_hour"] for r in baseline])
+            baseline_memory = np.median([r["peak_rss_mb"] for r in baseline])
+            result["throughput_change"] = \
+                float(latest["scenarios_per_hour"] / baseline_throughput - 1.)
+            result["memory_change"] = float(latest["peak_rss_mb"] / baseline_memory - 1.)
+            result["regression"] = result["throughput_change"] < -threshold or \
+                result["memory_change"] > threshold
+
+        results.append(result)
+
+    return results
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Flags regressions in the benchmark history")
+    parser.add_argument("history", help="History file")
+    parser.add_argument("--threshold", type=float, default=.1,
+                        help="Max. relative change that is not considered a regression")
+    parser.add_argument("--window", type=int, default=5,
+                        help="Number of preceding records the baseline is computed from")
+    args = parser.parse_args()
+
+    results = compare(load_history(args.history), args.threshold, args.window)
+
+    def format_change(change: float) -> str:
+        return "       new" if change is None else f"{100. * change:+9.1f}%"
+
+    for result in results:
+        print(f"{result['workload']:>16} ({result['n_nodes']} nodes, {result['n_days']} days): " +
+              f"{result['scenarios_per_hour']:12.1f} scenarios/h " +
+              f"{format_change(result['throughput_change'])}  " +
+              f"{result['peak_rss_mb']:9.1f} MB {format_change(result['memory_change'])}" +
+              ("  REGRESSION" if result["regression"] else ""))
+
+    sys.exit(1 if any(result["regression"] for result in results) else 0)
+
+
+if __name__ == "__main__":
+    main()
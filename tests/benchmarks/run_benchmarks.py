@@ -0,0 +1,128 @@
+"""
+Runs the end-to-end throughput benchmarks and appends the results to a history file.
+
+Each workload runs in a fresh Python process, which reports the throughput (scenarios per hour)
+and its peak memory consumption (resident set size). Usage (from the root of the repository)::
+
+    python -m tests.benchmarks.run_benchmarks --history benchmark_history.jsonl
+    python -m tests.benchmarks.compare benchmark_history.jsonl
+
+The history file contains one JSON record per line and workload.
+"""
+import os
+import sys
+import json
+import time
+import platform
+import argparse
+import tempfile
+import subprocess
+from datetime import datetime, timezone
+
+from .workloads import WORKLOADS
+
+
+def get_peak_rss() -> tuple[float, float]:
+    """
+    Gets the peak resident set size (in MB) of this process and of its (terminated)
+    child processes.
+    """
+    if sys.platform == "win32":
+        import psutil
+        return psutil.Process().memory_info().peak_wset * 1e-6, 0.
+
+    import resource
+    scale = 1e-6 if sys.platform == "darwin" else 1e-3     # ru_maxrss is given in bytes on MacOS
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss * scale, \
+        resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss * scale
+
+
+def get_commit() -> str:
+    try:
+        return subprocess.run(["git", "rev-parse", "HEAD"], capture_output=True, text=True,
+                              check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def get_machine_info() -> dict:
+    return {"platform": platform.platform(), "processor": platform.processor(),
+            "cpu_count": os.cpu_count(), "python": platform.python_version()}
+
+
+def run_workload(workload_name: str, n_nodes: int, n_days: int, download_dir: str) -> dict:
+    """
+    Runs a single workload in this process.
+    """
+    run = WORKLOADS[workload_name](n_nodes=n_nodes, n_days=n_days, download_dir=download_dir)
+
+    start_time = time.perf_counter()
+    n_scenarios = run()
+    wall_time = time.perf_counter() - start_time
+    peak_rss, peak_rss_children = get_peak_rss()
+
+    return {"workload": workload_name, "n_nodes": n_nodes, "n_days": n_days,
+            "n_scenarios": n_scenarios, "wall_time": wall_time,
+            "scenarios_per_hour": 3600. * n_scenarios / wall_time,
+            "peak_rss_mb": peak_rss, "peak_rss_children_mb": peak_rss_children}
+
+
+def run_benchmarks(workloads: list[str], n_nodes: int, n_days: int, download_dir: str,
+                   f_history: str) -> list[dict]:
+    """
+    Runs all given workloads (each in a fresh process) and appends the results to
+    the history file.
+    """
+    commit = get_commit()
+    machine = get_machine_info()
+
+    results = []
+    for workload_name in workloads:
+        proc = subprocess.run([sys.executable, "-m", "tests.benchmarks.run_benchmarks",
+                               "--single", workload_name, "--n-nodes", str(n_nodes),
+                               "--n-days", str(n_days), "--download-dir", download_dir],
+                              capture_output=True, text=True, check=False)
+        if proc.returncode != 0:
+            print(proc.stderr, file=sys.stderr)
+            raise RuntimeError(f"Workload '{workload_name}' failed")
+
+        result = json.loads(proc.stdout.strip().splitlines()[-1])
+        result.update({"timestamp": datetime.now(timezone.utc).isoformat(), "commit": commit,
+                       "machine": machine})
+        results.append(result)
+        print(f"{workload_name:>16}: {result['scenarios_per_hour']:12.1f} scenarios/h  " +
+              f"{result['peak_rss_mb']:9.1f} MB")
+
+    with open(f_history, "a", encoding="utf-8") as f:
+        for result in results:
+            f.write(json.dumps(result) + "\n")
+
+    return results
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Runs the end-to-end throughput benchmarks")
+    parser.add_argument("--history", default="benchmark_history.jsonl",
+                        help="History file the results are appended to")
+    parser.add_argument("--workloads", nargs="+", default=list(WORKLOADS.keys()),
+                        choices=list(WORKLOADS.keys()))
+    parser.add_argument("--n-nodes", type=int, default=1000,
+                        help="Number of junctions of the synthetic networks")
+    parser.add_argument("--n-days", type=int, default=1, help="Simulation duration in days")
+    parser.add_argument("--download-dir",
+                        default=os.path.join(tempfile.gettempdir(), "epyt_flow-benchmarks"),
+                        help="Folder where the synthetic networks are stored")
+    parser.add_argument("--single", default=None, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    os.makedirs(args.download_dir, exist_ok=True)
+    if args.single is not None:
+        print(json.dumps(run_workload(args.single, args.n_nodes, args.n_days,
+                                      args.download_dir)))
+    else:
+        run_benchmarks(args.workloads, args.n_nodes, args.n_days, args.download_dir,
+                       args.history)
+
+
+if __name__ == "__main__":
+    main()
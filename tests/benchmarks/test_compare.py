@@ -0,0 +1,22 @@
+"""
+Module provides tests to test the regression tracking of the throughput benchmarks.
+"""
+from .compare import compare
+
+
+def test_compare():
+    def create_record(timestamp: str, scenarios_per_hour: float, peak_rss_mb: float) -> dict:
+        return {"workload": "hydraulics_leak", "n_nodes": 1000, "n_days": 1,
+                "timestamp": timestamp, "scenarios_per_hour": scenarios_per_hour,
+                "peak_rss_mb": peak_rss_mb, "machine": {"platform": "linux", "cpu_count": 4}}
+
+    history = [create_record("2024-01-01", 100., 200.), create_record("2024-01-02", 110., 200.)]
+    assert compare(history)[0]["regression"] is False
+    assert compare(history[:1])[0]["throughput_change"] is None
+
+    history.append(create_record("2024-01-03", 80., 200.))
+    assert compare(history)[0]["regression"] is True
+
+    history.append(create_record("2024-01-04", 105., 250.))
+    assert compare(history)[0]["regression"] is True
+    assert compare(history, threshold=.5)[0]["regression"] is False
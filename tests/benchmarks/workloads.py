@@ -0,0 +1,162 @@
+"""
+Module provides the workloads of the end-to-end throughput benchmarks.
+
+All workloads run on synthetic networks (see :mod:`epyt_flow.data.synthetic_networks`) --
+i.e. no network access is required. Each workload prepares everything that should not be
+timed (e.g. generating and loading the networks) and returns a function running the benchmarked
+part, which in turn returns the number of simulated scenarios.
+"""
+from typing import Callable
+import numpy as np
+from epyt.epanet import ToolkitConstants
+
+from epyt_flow.data.synthetic_networks import load_synthetic_network
+from epyt_flow.simulation import ScenarioSimulator, ParallelScenarioSimulation, \
+    AbruptLeakage, SENSOR_TYPE_NODE_PRESSURE
+from epyt_flow.simulation.events import SensorFaultDrift, SensorFaultGaussian
+from epyt_flow.uncertainty import SensorNoise, RelativeGaussianUncertainty
+from epyt_flow.utils import to_seconds
+
+
+WORKLOADS = {}
+
+
+def workload(name: str) -> Callable:
+    def register(f: Callable) -> Callable:
+        WORKLOADS[name] = f
+        return f
+    return register
+
+
+def _set_all_sensors(sim: ScenarioSimulator) -> None:
+    sim.set_pressure_sensors(sim.sensor_config.nodes)
+    sim.set_flow_sensors(sim.sensor_config.links)
+
+
+@workload("hydraulics_leak")
+def run_hydraulics_leak(n_nodes: int, n_days: int, download_dir: str) -> Callable[[], int]:
+    config = load_synthetic_network(n_nodes, simulation_duration=24 * n_days,
+                                    download_dir=download_dir)
+
+    def run() -> int:
+        with ScenarioSimulator(scenario_config=config) as sim:
+            _set_all_sensors(sim)
+            sim.add_leakage(AbruptLeakage(link_id="P1", diameter=.05,
+                                          start_time=to_seconds(hours=2),
+                                          end_time=to_seconds(hours=24 * n_days - 2)))
+            sim.run_simulation().get_data()
+
+        return 1
+
+    return run
+
+
+@workload("pda_emitters")
+def run_pda_emitters(n_nodes: int, n_days: int, download_dir: str) -> Callable[[], int]:
+    config = load_synthetic_network(n_nodes, simulation_duration=24 * n_days,
+                                    download_dir=download_dir)
+
+    # Every leak is modeled by an emitter -- place them at 5% of all pipes
+    rng = np.random.default_rng(42)
+    pipes = [link_id for link_id in config.sensor_config.links if link_id.startswith("P")
+             and link_id[1:].isdigit()]
+    leaky_pipes = rng.choice(pipes, size=max(1, len(pipes) // 20), replace=False)
+    start_times = rng.integers(0, 12, size=len(leaky_pipes)) * 3600
+
+    def run() -> int:
+        with ScenarioSimulator(scenario_config=config) as sim:
+            # Pressure-driven analysis with a required pressure that the leaks actually
+            # undercut -- i.e. demands are reduced at some of the junctions
+            sim.set_general_parameters(demand_model={"type": "PDA", "pressure_min": 0,
+                                                     "pressure_required": 20,
+                                                     "pressure_exponent": .5})
+            _set_all_sensors(sim)
+            for link_id, start_time in zip(leaky_pipes, start_times):
+                sim.add_leakage(AbruptLeakage(link_id=str(link_id), diameter=.01,
+                                              start_time=int(start_time),
+                                              end_time=to_seconds(hours=24 * n_days)))
+            sim.run_simulation().get_data()
+
+        return 1
+
+    return run
+
+
+@workload("basic_quality")
+def run_basic_quality(n_nodes: int, n_days: int, download_dir: str) -> Callable[[], int]:
+    config = load_synthetic_network(n_nodes, simulation_duration=24 * n_days,
+                                    download_dir=download_dir)
+
+    def run() -> int:
+        with ScenarioSimulator(scenario_config=config) as sim:
+            sim.enable_chemical_analysis()
+            sim.add_quality_source(node_id="R0", pattern=np.array([1.]),
+                                   source_type=ToolkitConstants.EN_CONCEN)
+            sim.set_node_quality_sensors(sim.sensor_config.nodes)
+            sim.run_simulation().get_data()
+
+        return 1
+
+    return run
+
+
+@workload("msx")
+def run_msx(n_nodes: int, n_days: int, download_dir: str) -> Callable[[], int]:
+    config = load_synthetic_network(n_nodes, simulation_duration=24 * n_days, include_msx=True,
+                                    download_dir=download_dir)
+
+    def run() -> int:
+        with ScenarioSimulator(scenario_config=config) as sim:
+            sim.set_bulk_species_node_sensors(sensor_info={"CL2": sim.sensor_config.nodes})
+            sim.run_simulation().get_data()
+
+        return 1
+
+    return run
+
+
+def _discard_results(*_) -> None:
+    pass
+
+
+@workload("parallel_batch")
+def run_parallel_batch(n_nodes: int, n_days: int, download_dir: str,
+                       n_scenarios: int = 100) -> Callable[[], int]:
+    scenarios = [load_synthetic_network(n_nodes, simulation_duration=24 * n_days, seed=seed,
+                                        download_dir=download_dir)
+                 for seed in range(n_scenarios)]
+
+    def run() -> int:
+        ParallelScenarioSimulation.run(scenarios, callback=_discard_results)
+        return n_scenarios
+
+    return run
+
+
+@workload("scada_get_data")
+def run_scada_get_data(n_nodes: int, n_days: int, download_dir: str,
+                       n_repeats: int = 20) -> Callable[[], int]:
+    config = load_synthetic_network(n_nodes, simulation_duration=24 * n_days,
+                                    download_dir=download_dir)
+    with ScenarioSimulator(scenario_config=config) as sim:
+        _set_all_sensors(sim)
+        sim.set_sensor_noise(SensorNoise(RelativeGaussianUncertainty(scale=.01)))
+        for node_id in sim.sensor_config.nodes[:10]:
+            sim.add_sensor_fault(SensorFaultDrift(coef=1.1, sensor_id=node_id,
+                                                  sensor_type=SENSOR_TYPE_NODE_PRESSURE,
+                                                  start_time=to_seconds(hours=2),
+                                                  end_time=to_seconds(hours=12)))
+            sim.add_sensor_fault(SensorFaultGaussian(std=1., sensor_id=node_id,
+                                                     sensor_type=SENSOR_TYPE_NODE_PRESSURE,
+                                                     start_time=to_seconds(hours=14),
+                                                     end_time=to_seconds(hours=20)))
+        scada_data = sim.run_simulation()
+
+    # Throughput is given in calls of get_data() per hour
+    def run() -> int:
+        for _ in range(n_repeats):
+            scada_data.get_data()
+
+        return n_repeats
+
+    return run
@@ -1,7 +1,9 @@
 """
 Module provides tests to test the advanced quality analysis.
 """
+import numpy as np
 from epyt_flow.simulation import ScenarioSimulator
+from epyt_flow.simulation.native_api import get_msx_profile, set_msx_full_sort
 from epyt_flow.utils import to_seconds
 
 
@@ -53,3 +55,39 @@ def test_msx_example():
 
         # Show sensor readings over the entire simulation
         assert res.get_data_surface_species_concentration() is not None
+
+
+def test_msx_profiling():
+    with ScenarioSimulator(f_inp_in="net2-cl2.inp", f_msx_in="net2-cl2.msx") as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+        sim.set_bulk_species_node_sensors(sensor_info={"CL2": sim.sensor_config.nodes})
+
+        sim.enable_profiling()
+        sim.run_simulation()
+        assert sim.get_profile()["epanet_msx"]["step"]["calls"] > 0
+
+        # No timings are recorded after the profiling has been disabled
+        sim.disable_profiling()
+        msx_profile = get_msx_profile(sim.epanet_api)
+        sim.run_simulation()
+        assert sim.get_profile() is None
+        assert get_msx_profile(sim.epanet_api) == msx_profile
+
+
+def test_msx_incremental_node_sorting():
+    with ScenarioSimulator(f_inp_in="net2-cl2.inp", f_msx_in="net2-cl2.msx") as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=2))
+        sim.set_bulk_species_node_sensors(sensor_info={"CL2": sim.sensor_config.nodes})
+        sim.set_flow_sensors(sensor_locations=sim.sensor_config.links)
+
+        res = sim.run_simulation()
+
+        # The tank fills and drains -- i.e. some flows change direction
+        flows = res.get_data_flows()
+        assert np.any(np.any(flows > 1e-3, axis=0) & np.any(flows < -1e-3, axis=0))
+
+        # Re-ordering only the affected nodes gives the same quality as sorting all nodes
+        set_msx_full_sort(sim.epanet_api, True)
+        res_full_sort = sim.run_simulation()
+        assert np.allclose(res.get_data_bulk_species_node_concentration(),
+                           res_full_sort.get_data_bulk_species_node_concentration())
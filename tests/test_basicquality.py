@@ -6,6 +6,7 @@ from epyt_flow.simulation import ToolkitConstants
 from epyt_flow.data.networks import load_hanoi, load_net1
 from epyt_flow.simulation import ScenarioSimulator
 from epyt_flow.simulation.sensor_config import SENSOR_TYPE_NODE_QUALITY
+from epyt_flow.simulation.native_api import get_quality_routing, set_full_sort
 
 from .utils import get_temp_folder
 
@@ -68,3 +69,53 @@ def test_chlorine_injection():
 
         res = sim.run_simulation()
         res.get_data()
+
+
+def test_event_driven_routing():
+    network_config = load_hanoi(download_dir=get_temp_folder(),
+                                include_default_sensor_placement=True)
+    with ScenarioSimulator(scenario_config=network_config) as sim:
+        sim.set_sensors(SENSOR_TYPE_NODE_QUALITY, sensor_locations=sim.sensor_config.nodes)
+
+        sim.enable_sourcetracing_analysis("2")
+
+        res = sim.run_simulation()
+
+        sim.enable_event_driven_quality_routing()
+        res_events = sim.run_simulation()
+        assert get_quality_routing(sim.epanet_api)["events"] > 0
+
+        # The segments arrive at their exact times -- i.e. the results do not depend on the
+        # quality time step
+        quality_time_step = sim.get_quality_time_step()
+        sim.set_general_parameters(quality_time_step=sim.get_hydraulic_time_step())
+        res_events_long_step = sim.run_simulation()
+        assert np.allclose(res_events.get_data(), res_events_long_step.get_data(), atol=1e-2)
+
+        # The results of fixed time steps approach the event-driven ones as the quality
+        # time step decreases
+        sim.disable_event_driven_quality_routing()
+        sim.set_general_parameters(quality_time_step=max(quality_time_step // 60, 1))
+        res_short_step = sim.run_simulation()
+        assert np.mean(np.abs(res_short_step.get_data() - res_events.get_data())) < \
+            np.mean(np.abs(res.get_data() - res_events.get_data()))
+
+
+def test_incremental_node_sorting():
+    network_config = load_net1(download_dir=get_temp_folder())
+    with ScenarioSimulator(scenario_config=network_config) as sim:
+        sim.set_node_quality_sensors(sensor_locations=sim.sensor_config.nodes)
+        sim.set_flow_sensors(sensor_locations=sim.sensor_config.links)
+
+        sim.enable_chemical_analysis()
+
+        res = sim.run_simulation()
+
+        # The pump cycles and the tank fills and drains -- i.e. some flows change direction
+        flows = res.get_data_flows()
+        assert np.any(np.any(flows > 1e-3, axis=0) & np.any(flows < -1e-3, axis=0))
+
+        # Re-ordering only the affected nodes gives the same quality as sorting all nodes
+        set_full_sort(sim.epanet_api, True)
+        res_full_sort = sim.run_simulation()
+        assert np.allclose(res.get_data_nodes_quality(), res_full_sort.get_data_nodes_quality())
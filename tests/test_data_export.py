@@ -6,7 +6,7 @@ import numpy as np
 from epyt_flow.data.networks import load_hanoi
 from epyt_flow.simulation import ScenarioSimulator, ScadaData
 from epyt_flow.simulation.scada import ScadaDataNumpyExport, ScadaDataXlsxExport, \
-    ScadaDataMatlabExport
+    ScadaDataMatlabExport, ScadaDataChunkedExport, ScadaDataChunkedReader
 from epyt_flow.utils import to_seconds
 
 from .utils import get_temp_folder
@@ -77,3 +77,42 @@ def test_mat_export():
 
         f_out = os.path.join(get_temp_folder(), "matlab_export.mat")
         ScadaDataMatlabExport(f_out=f_out).export(res)
+
+
+def test_chunked_export():
+    hanoi_network_config = load_hanoi(download_dir=get_temp_folder(),
+                                      include_default_sensor_placement=True)
+    with ScenarioSimulator(scenario_config=hanoi_network_config) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=2))
+
+        res = sim.run_simulation()
+
+        f_out = os.path.join(get_temp_folder(), "chunked_export_raw.epytflow_chunked")
+        export = ScadaDataChunkedExport(f_out=f_out, export_raw_data=True)
+        export.export(res)
+        reader = ScadaDataChunkedReader(f_out)
+        time, data = reader.read()
+
+        # The raw data covers all nodes and links
+        sensor_config = res.sensor_config
+        res.change_sensor_config(export.create_global_sensor_config(res))
+        assert np.all(reader.col_desc == export.create_column_desc(res))
+        assert np.all(data == res.get_data()) and np.all(time == res.sensor_readings_time)
+        res.change_sensor_config(sensor_config)
+
+        f_out = os.path.join(get_temp_folder(), "chunked_export_full.epytflow_chunked")
+        ScadaDataChunkedExport(f_out=f_out).export(res)
+        time, data = ScadaDataChunkedReader(f_out).read()
+        assert np.all(data == res.get_data()) and np.all(time == res.sensor_readings_time)
+
+        f_out = os.path.join(get_temp_folder(), "chunked_export.epytflow_chunked")
+        data_appended = []
+        with ScadaDataChunkedExport(f_out=f_out, chunk_size=10) as export:
+            for scada_data in sim.run_simulation_as_generator():
+                export.append(scada_data)
+                data_appended.append(scada_data.get_data())
+
+        reader = ScadaDataChunkedReader(f_out)
+        _, data = reader.read()
+        assert np.all(data == np.concatenate(data_appended, axis=0))
+        assert np.allclose(reader.read(columns=[1, 0])[1], data[:, [1, 0]])
@@ -1,8 +1,9 @@
 """
 Module provides tests to test the `epty_flow.models` module
 """
+import numpy as np
 from epyt_flow.data.benchmarks import load_leakdb_scada_data
-from epyt_flow.models import SensorInterpolationDetector
+from epyt_flow.models import SensorInterpolationDetector, StreamingEventDetection
 
 from .utils import get_temp_folder
 
@@ -18,3 +19,37 @@ def test_sensor_interpolation_detector():
     detector.fit(data_train)
 
     assert detector.apply(data_test) is not None
+
+
+def test_sensor_interpolation_detector_partial_fit():
+    data = load_leakdb_scada_data(scenarios_id=[4, 1], use_net1=True,
+                                  download_dir=get_temp_folder())
+
+    X_train = data[0].get_data()
+    X_test = data[1].get_data()
+
+    detector = SensorInterpolationDetector()
+    for t in range(0, X_train.shape[0], 1000):
+        detector.partial_fit(X_train[t:t + 1000])
+    assert detector.n_samples == X_train.shape[0]
+
+    assert detector.apply(X_test) is not None
+
+
+def test_streaming_event_detection():
+    data = load_leakdb_scada_data(scenarios_id=[4, 1], use_net1=True,
+                                  download_dir=get_temp_folder())
+
+    X_train = data[0].get_data()
+    X_test = data[1].get_data()
+
+    X_stream = np.concatenate((X_train, X_test), axis=0)
+
+    detector = SensorInterpolationDetector()
+    with StreamingEventDetection(detector, n_training_time_points=X_train.shape[0],
+                                 max_pending=8) as detection:
+        for t in range(0, X_stream.shape[0], 100):
+            detection.push(X_stream[t:t + 100])
+
+    assert detection.suspicious_time_points == \
+        [X_train.shape[0] + t for t in detector.apply(X_test)]
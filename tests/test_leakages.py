@@ -86,3 +86,30 @@ def test_custom_leakage_profile():
 
         res = sim.run_simulation()
         res.get_data()
+
+
+def test_multiple_leakages_network_edit():
+    hanoi_network_config = load_hanoi(download_dir=get_temp_folder(),
+                                      include_default_sensor_placement=True,
+                                      flow_units_id=ToolkitConstants.EN_CMH)
+    with ScenarioSimulator(scenario_config=hanoi_network_config) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=2))
+
+        with sim.edit_network():
+            for link_id in ["12", "13", "20"]:
+                sim.add_leakage(AbruptLeakage(link_id=link_id, diameter=0.1,
+                                              start_time=7200, end_time=100800))
+
+        res = sim.run_simulation()
+        res.get_data()
+
+    # The same edits made outside of a transaction must yield the same results
+    with ScenarioSimulator(scenario_config=hanoi_network_config) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=2))
+
+        for link_id in ["12", "13", "20"]:
+            sim.add_leakage(AbruptLeakage(link_id=link_id, diameter=0.1,
+                                          start_time=7200, end_time=100800))
+
+        res_no_edit = sim.run_simulation()
+        assert np.allclose(res.get_data(), res_no_edit.get_data())
@@ -5,6 +5,8 @@ import pytest
 from epyt_flow.data.networks import load_anytown, load_hanoi, load_kentucky, load_ltown, \
     load_net1, load_net2, load_net3, load_net6, load_richmond, load_ctown, load_dtown, \
     load_balerma, load_bwsn1, load_bwsn2, load_micropolis, load_rural, load_ltown_a
+from epyt_flow.data.synthetic_networks import load_synthetic_network
+from epyt_flow.simulation import ScenarioSimulator
 
 from .utils import get_temp_folder
 
@@ -82,3 +84,18 @@ def test_ltown():
 
 def test_ltown_a():
     assert load_ltown_a(get_temp_folder()) is not None
+
+
+def test_synthetic_networks():
+    for topology in ["tree", "ring", "grid", "hybrid"]:
+        config = load_synthetic_network(150, topology=topology, n_tanks=2, n_pumps=2, n_prvs=1,
+                                        simulation_duration=4, download_dir=get_temp_folder())
+        with ScenarioSimulator(scenario_config=config) as sim:
+            assert len(sim.sensor_config.nodes) == 150 + 1 + 2
+            assert sim.run_simulation() is not None
+
+    config = load_synthetic_network(100, include_msx=True, simulation_duration=2,
+                                    download_dir=get_temp_folder())
+    assert config.f_msx_in is not None
+    with open(config.f_inp_in, "r", encoding="utf-8") as f_in:
+        assert "Demand Model PDA" in f_in.read()
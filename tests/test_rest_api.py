@@ -0,0 +1,148 @@
+"""
+Module provides tests to test the asynchronous simulation jobs of the REST API.
+"""
+import time
+import threading
+from types import SimpleNamespace
+from epyt_flow.data.networks import load_hanoi
+from epyt_flow.rest_api.scenario.handlers import ScenarioManager
+from epyt_flow.rest_api.scenario.simulation_handlers import ScenarioSimulationHandler
+from epyt_flow.rest_api.scada_data.handlers import ScadaDataManager
+from epyt_flow.rest_api.simulation_jobs.handlers import SimulationJobManager, \
+    SimulationJobStreamHandler, JOB_STATUS_FINISHED, JOB_STATUS_CANCELLED
+from epyt_flow.utils import to_seconds
+
+from .utils import get_temp_folder
+
+
+def create_scenario(scenario_mgr: ScenarioManager) -> str:
+    hanoi_network_config = load_hanoi(download_dir=get_temp_folder(),
+                                      include_default_sensor_placement=True)
+    scenario_id = scenario_mgr.create(scenario_config=hanoi_network_config)
+    scenario_mgr.get(scenario_id).set_general_parameters(simulation_duration=to_seconds(days=1))
+
+    return scenario_id
+
+
+def wait_until_ended(job, timeout: float = 60.) -> None:
+    deadline = time.monotonic() + timeout
+    while job.finished_time is None:
+        assert time.monotonic() < deadline
+        time.sleep(.1)
+
+
+def test_simulation_job():
+    scenario_mgr = ScenarioManager()
+    scenario_id = create_scenario(scenario_mgr)
+    job_mgr = SimulationJobManager(n_workers=2)
+    try:
+        job_id = job_mgr.submit(scenario_mgr.get(scenario_id),
+                                scenario_mgr.get_lock(scenario_id), chunk_size=5)
+        job = job_mgr.get(job_id)
+        job.claim_stream()
+        frames = list(job.stream_frames())
+
+        status = job.get_status()
+        assert status["status"] == JOB_STATUS_FINISHED
+        assert status["n_chunks"] == len(frames) > 0
+        assert status["progress"] == 1.
+    finally:
+        job_mgr.close()
+        scenario_mgr.remove(scenario_id)
+
+
+def test_simulation_job_stream_timeout():
+    scenario_mgr = ScenarioManager()
+    scenario_id = create_scenario(scenario_mgr)
+    job_mgr = SimulationJobManager(n_workers=2)
+    try:
+        # Nobody consumes the stream -- the job must give up and release the scenario
+        job_id = job_mgr.submit(scenario_mgr.get(scenario_id),
+                                scenario_mgr.get_lock(scenario_id), chunk_size=1,
+                                max_buffered_chunks=1, stream_timeout=1.)
+        job = job_mgr.get(job_id)
+        wait_until_ended(job)
+
+        status = job.get_status()
+        assert status["status"] == JOB_STATUS_CANCELLED
+        assert status["error"] == "Stream timed out"
+        assert scenario_mgr.get_lock(scenario_id).acquire(timeout=1.) is True
+        scenario_mgr.get_lock(scenario_id).release()
+
+        # The buffered frame is still delivered and the stream ends
+        job.claim_stream()
+        assert len(list(job.stream_frames())) == 1
+    finally:
+        job_mgr.close()
+        scenario_mgr.remove(scenario_id)
+
+
+def test_simulation_job_stream_handler():
+    scenario_mgr = ScenarioManager()
+    scenario_id = create_scenario(scenario_mgr)
+    job_mgr = SimulationJobManager(n_workers=2)
+    try:
+        handler = SimulationJobStreamHandler(job_mgr=job_mgr)
+
+        # Claiming the stream must not wait for the job -- e.g. while it waits for its scenario
+        with scenario_mgr.get_lock(scenario_id):
+            job_id = job_mgr.submit(scenario_mgr.get(scenario_id),
+                                    scenario_mgr.get_lock(scenario_id))
+            resp = SimpleNamespace(status=None, data=None, content_type=None, stream=None)
+            request = threading.Thread(target=handler.on_get, args=(None, resp, job_id))
+            request.start()
+            request.join(timeout=1.)
+            assert request.is_alive() is False
+            assert resp.stream is not None
+
+            # A job can only be streamed once
+            resp_again = SimpleNamespace(status=None, data=None, content_type=None, stream=None)
+            handler.on_get(None, resp_again, job_id)
+            assert resp_again.stream is None and resp_again.data is not None
+
+        assert len(list(resp.stream)) > 0
+        assert job_mgr.get(job_id).get_status()["status"] == JOB_STATUS_FINISHED
+    finally:
+        job_mgr.close()
+        scenario_mgr.remove(scenario_id)
+
+
+def test_simulation_job_removal():
+    scenario_mgr = ScenarioManager()
+    scenario_id = create_scenario(scenario_mgr)
+    job_mgr = SimulationJobManager(n_workers=2, job_ttl=.5)
+    try:
+        job_id = job_mgr.submit(scenario_mgr.get(scenario_id),
+                                scenario_mgr.get_lock(scenario_id))
+        job = job_mgr.get(job_id)
+        wait_until_ended(job)
+        assert job_mgr.validate_uuid(job_id) is True
+
+        time.sleep(2.)
+        assert job_mgr.validate_uuid(job_id) is False
+    finally:
+        job_mgr.close()
+        scenario_mgr.remove(scenario_id)
+
+
+def test_simulation_handler_scenario_lock():
+    scenario_mgr = ScenarioManager()
+    scada_data_mgr = ScadaDataManager()
+    scenario_id = create_scenario(scenario_mgr)
+    try:
+        handler = ScenarioSimulationHandler(scenario_mgr=scenario_mgr,
+                                            scada_data_mgr=scada_data_mgr)
+
+        # The synchronous simulation must wait for e.g. a running simulation job
+        resp = SimpleNamespace(status=None, data=None, content_type=None)
+        with scenario_mgr.get_lock(scenario_id):
+            request = threading.Thread(target=handler.on_get, args=(None, resp, scenario_id))
+            request.start()
+            request.join(timeout=1.)
+            assert request.is_alive() is True
+            assert resp.status is None
+
+        request.join()
+        assert len(scada_data_mgr.get_all_items()) == 1
+    finally:
+        scenario_mgr.remove(scenario_id)
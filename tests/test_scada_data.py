@@ -1,6 +1,7 @@
 """
 Module provides tests to test the :class:`epyt_flow.simulation.scada.ScadaData` class.
 """
+import numpy as np
 from epyt_flow.data.networks import load_hanoi
 from epyt_flow.simulation import ScenarioSimulator
 from epyt_flow.utils import to_seconds
@@ -40,3 +41,23 @@ def test_convert_unit():
 
         res2 = res.convert_units(flow_unit=ToolkitConstants.EN_CFS)
         assert res != res2
+
+
+def test_convert_unit_lazy():
+    hanoi_network_config = load_hanoi(download_dir=get_temp_folder(),
+                                      include_default_sensor_placement=True)
+    with ScenarioSimulator(scenario_config=hanoi_network_config) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=2))
+
+        res = sim.run_simulation()
+
+        res_eager = res.convert_units(flow_unit=ToolkitConstants.EN_CFS)
+        res_lazy = res.convert_units(flow_unit=ToolkitConstants.EN_CFS, lazy=True)
+        assert res_eager == res_lazy
+        assert np.allclose(res_eager.get_data(), res_lazy.get_data())
+
+        flows = res.get_data_flows()
+        res.convert_units(flow_unit=ToolkitConstants.EN_CFS, inplace=True)
+        assert res == res_eager
+        assert np.allclose(res_lazy.convert_units(flow_unit=ToolkitConstants.EN_CMH,
+                                                  lazy=True).get_data_flows(), flows)
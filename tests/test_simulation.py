@@ -3,10 +3,22 @@ Module provides tests to test the
 :class:`~epyt_flow.simulation.ScenarioSimulator` class.
 """
 import os
+import ctypes
+import numpy as np
+from epyt.epanet import ToolkitConstants
+
 from epyt_flow.data.networks import load_hanoi, load_ctown
 from epyt_flow.data.benchmarks import load_leakdb_scenarios
-from epyt_flow.simulation import ScenarioSimulator, ParallelScenarioSimulation, \
-    callback_save_to_file
+from epyt_flow.simulation import ScenarioConfig, ScenarioSimulator, ParallelScenarioSimulation, \
+    callback_save_to_file, get_tracer, merge_traces, MemoryModel, MEMORY_MODEL_FEATURES, \
+    compute_leak_signatures, compute_contamination_signatures, greedy_max_coverage, \
+    place_pressure_sensors, SignatureMatrix, compute_leak_signature_dictionary, \
+    synthesize_leakdb_demands, ModelCalibration, PumpScheduleEvaluation, \
+    compute_backward_influence, BatchSimulation, BatchScenario, AbruptLeakage
+from epyt_flow.simulation import calibration as calibration_module
+from epyt_flow.simulation.native_api import EN_DIAGFLAG_CONVERGED, EN_DIAGFLAG_EXTRATRIALS, \
+    EN_PRESSURE, EN_FLOW, EN_TANKVOLUME, call_native_function, get_node_values, get_link_values, \
+    get_profile as get_native_profile
 from epyt_flow.utils import to_seconds, create_path_if_not_exist
 
 from .utils import get_temp_folder
@@ -64,3 +76,431 @@ def test_export_to_epanet_files_2():
 
     with ScenarioSimulator(f_inp_in="Net3-NH2CL.inp", f_msx_in=f_msx_out) as sim:
         pass
+
+
+def test_profiling():
+    hanoi_network_config = load_hanoi(download_dir=get_temp_folder())
+    with ScenarioSimulator(scenario_config=hanoi_network_config) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+        assert sim.get_profile() is None
+
+        sim.enable_profiling()
+        sim.run_simulation()
+
+        profile = sim.get_profile()["epanet"]
+        assert profile["run_hydraulics"]["calls"] > 0
+        assert profile["hydsolve"]["iterations"] >= profile["hydsolve"]["calls"]
+        assert profile["linsolve"]["time"] <= profile["run_hydraulics"]["time"]
+
+        # No timings are recorded after the profiling has been disabled
+        sim.disable_profiling()
+        native_profile = get_native_profile(sim.epanet_api)
+        sim.run_simulation()
+        assert sim.get_profile() is None
+        assert get_native_profile(sim.epanet_api) == native_profile
+
+
+def test_tracing():
+    trace_dir = os.path.join(get_temp_folder(), "traces")
+    tracer = get_tracer()
+    tracer.enable(trace_dir=trace_dir)
+    try:
+        with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+            sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+            sim.enable_waterage_analysis()
+            sim.run_simulation()
+
+        events_name = set(event["name"] for event in tracer.get_events())
+        assert "load_network" in events_name and "time_step" in events_name
+        assert "hydsolve" in events_name
+        assert all(phase in events_name for phase in ["transport", "advection", "node_mixing"])
+
+        tracer.save()
+        merge_traces([trace_dir], os.path.join(trace_dir, "merged.json"))
+    finally:
+        tracer.disable()
+        tracer.clear()
+
+
+def test_solver_diagnostics():
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+        sim.enable_solver_diagnostics()
+        sim.run_simulation()
+
+        diagnostics = sim.get_solver_diagnostics()
+        n_steps = len(diagnostics["time"])
+        assert n_steps > 0
+        assert all(len(values) == n_steps for values in diagnostics.values())
+        assert all(diagnostics["iterations"] > 0)
+
+        # Hanoi converges within the regular trial limit
+        assert all(diagnostics["flags"] & EN_DIAGFLAG_CONVERGED)
+        assert not any(diagnostics["flags"] & EN_DIAGFLAG_EXTRATRIALS)
+
+
+def test_warm_start():
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+        sim.enable_warm_start()
+        res = sim.run_simulation()
+        assert sim.get_warm_start_stats()["warm_started"] == 0
+
+        roughness = sim.epanet_api.getLinkRoughnessCoeff(1)
+        sim.epanet_api.setLinkRoughnessCoeff(1, .9 * roughness)
+        res_warm = sim.run_simulation()
+        stats = sim.get_warm_start_stats()
+        assert stats["warm_started"] == stats["time_steps"]
+        assert stats["reused_structure"] is True
+
+        sim.disable_warm_start()
+        res_cold = sim.run_simulation()
+        assert np.allclose(res_warm.get_data(), res_cold.get_data(), atol=1e-3)
+        assert res.get_data().shape == res_cold.get_data().shape
+
+
+def test_warm_start_tolerance():
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+        sim.enable_warm_start(tolerance=.1)
+        res = sim.run_simulation()
+
+        # Change the demands of the last hours only -- the earlier time steps agree with
+        # the previous run, but the later ones must not be taken from it
+        for pattern_idx in range(1, sim.epanet_api.getPatternCount() + 1):
+            n_periods = sim.epanet_api.getPatternLengths(pattern_idx)
+            for period in range(int(.8 * n_periods) + 1, n_periods + 1):
+                value = sim.epanet_api.getPatternValue(pattern_idx, period)
+                sim.epanet_api.setPatternValue(pattern_idx, period, 1.2 * value)
+        res_warm = sim.run_simulation()
+        stats = sim.get_warm_start_stats()
+        assert stats["warm_started"] == stats["time_steps"]
+        assert stats["accepted"] <= stats["warm_started"]
+
+        sim.disable_warm_start()
+        res_cold = sim.run_simulation()
+        assert not np.allclose(res.get_data(), res_cold.get_data(), atol=1e-3)
+        assert np.allclose(res_warm.get_data(), res_cold.get_data(), atol=1e-2)
+
+
+def test_model_calibration():
+    config = load_hanoi(get_temp_folder(), include_default_sensor_placement=True)
+    with ScenarioSimulator(scenario_config=config) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+        observed = sim.run_simulation()
+        links, nodes = sim.sensor_config.links, sim.sensor_config.nodes
+
+    with ModelCalibration(config, observed, roughness_groups=[links[:10], links[10:]],
+                          demand_groups=[nodes], n_jobs=2) as calibration:
+        assert calibration.n_parameters == 3
+        objectives = calibration.evaluate([[1., 1., 1.], [.8, 1., 1.2], [1., 1., 1.]])
+        assert objectives.shape == (3,)
+        assert objectives[0] < 1e-4 and objectives[2] < 1e-4
+        assert objectives[1] > objectives[0]
+
+
+def test_model_calibration_in_engine_residuals(monkeypatch):
+    config = load_hanoi(get_temp_folder(), include_default_sensor_placement=True)
+    with ScenarioSimulator(scenario_config=config) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+        observed = sim.run_simulation()
+        links, nodes = sim.sensor_config.links, sim.sensor_config.nodes
+
+    candidates = [[1., 1.], [.8, 1.2], [1.3, .7]]
+    with ModelCalibration(config, observed, roughness_groups=[links], demand_groups=[nodes],
+                          n_jobs=1, warm_start=False) as calibration:
+        objectives = calibration.evaluate(candidates)
+
+    # The residuals computed inside EPANET must match the ones computed in Python
+    has_native_function = calibration_module.has_native_function
+    monkeypatch.setattr(calibration_module, "has_native_function",
+                        lambda epanet_api, function_name: function_name != "setobservations"
+                        and has_native_function(epanet_api, function_name))
+    with ModelCalibration(config, observed, roughness_groups=[links], demand_groups=[nodes],
+                          n_jobs=1, warm_start=False) as calibration:
+        assert np.allclose(calibration.evaluate(candidates), objectives)
+
+
+def test_pump_schedule_evaluation():
+    # Remove the controls & rules of C-Town -- otherwise they switch on pumps that are
+    # scheduled to be off
+    config = load_ctown(get_temp_folder())
+    f_inp_in = os.path.join(get_temp_folder(), "CTOWN_no_controls.inp")
+    with open(config.f_inp_in, "r", encoding="utf-8") as f_in, \
+            open(f_inp_in, "w", encoding="utf-8") as f_out:
+        skip = False
+        for line in f_in:
+            if line.strip().startswith("["):
+                skip = line.strip().upper() in ("[CONTROLS]", "[RULES]")
+                f_out.write(line)
+            elif not skip:
+                f_out.write(line)
+
+    with PumpScheduleEvaluation(ScenarioConfig(f_inp_in=f_inp_in,
+                                               general_params=config.general_params),
+                                n_jobs=2, early_termination=False) as evaluation:
+        n_pumps = len(evaluation.pumps)
+        results = evaluation.evaluate(np.stack([np.ones((n_pumps, 24)),
+                                                np.zeros((n_pumps, 24))]))
+        assert results["energy"][0] > 0 and results["energy"][1] == 0
+        assert np.all(results["min_pressure"] < np.inf)
+        assert results["feasible"].shape == (2,)
+
+
+def test_batch_simulation():
+    config = load_hanoi(get_temp_folder(), include_default_sensor_placement=True)
+    with BatchSimulation(config, n_threads=2) as batch:
+        scenarios = [BatchScenario(simulation_duration=to_seconds(hours=12))]
+        for node_id in ["13", "22"]:
+            scenario = BatchScenario(simulation_duration=to_seconds(hours=12))
+            scenario.add_leakage(node_id, 10., to_seconds(hours=2), to_seconds(hours=8))
+            scenarios.append(scenario)
+
+        readings = batch.run(scenarios)
+        assert readings.shape[0] == 3 and readings.shape[2] == len(batch.sensors)
+        assert not np.any(np.isnan(readings))
+        assert np.all(np.abs(readings[1:] - readings[0]).sum(axis=(1, 2)) > 0)
+
+
+def test_batch_simulation_leakages():
+    config = load_hanoi(get_temp_folder(), include_default_sensor_placement=True,
+                        flow_units_id=ToolkitConstants.EN_CMH)
+    duration = to_seconds(hours=12)
+    with ScenarioSimulator(scenario_config=config) as sim:
+        sim.set_general_parameters(simulation_duration=duration)
+        leakage = AbruptLeakage(link_id=None, node_id="13", area=.001,
+                                start_time=to_seconds(hours=2), end_time=duration)
+        sim.add_leakage(leakage)
+        emitter_coeff = leakage.compute_leak_emitter_coefficient(leakage.area)
+        res = sim.run_simulation()
+        sensors = [("node", node_id, EN_PRESSURE) for node_id in sim.sensor_config.pressure_sensors]
+
+    with BatchSimulation(config, sensors=sensors, n_threads=2) as batch:
+        # A leakage must yield the same readings as the ScenarioSimulator
+        single = BatchScenario(simulation_duration=duration)
+        single.add_leakage("13", emitter_coeff, to_seconds(hours=2))
+
+        # Overlapping leakages of the same node add up
+        overlapping = BatchScenario(simulation_duration=duration)
+        overlapping.add_leakage("13", emitter_coeff / 4, to_seconds(hours=2))
+        overlapping.add_leakage("13", emitter_coeff / 4, to_seconds(hours=2), to_seconds(hours=6))
+        overlapping.add_leakage("13", emitter_coeff / 2, to_seconds(hours=1))
+        overlapping.add_leakage("13", emitter_coeff / 4, to_seconds(hours=6))
+
+        readings = batch.run([single, overlapping])
+        assert readings.shape[1:] == res.get_data_pressures().shape
+        assert np.allclose(readings[0], res.get_data_pressures())
+
+        times = np.array(res.sensor_readings_time)
+        assert np.allclose(readings[1][times >= to_seconds(hours=2)],
+                           readings[0][times >= to_seconds(hours=2)])
+        assert not np.allclose(readings[1][times == to_seconds(hours=1)],
+                               readings[0][times == to_seconds(hours=1)])
+
+
+def test_curve_lookup_tables():
+    # Network with a multi-point pump curve, GPV head loss curve, and tank volume curve
+    f_inp_in = os.path.join(get_temp_folder(), "curves.inp")
+    with open(f_inp_in, "w", encoding="utf-8") as f_out:
+        f_out.write("\n".join(["[JUNCTIONS]", "J1 0 0", "J2 5 10", "J3 5 0", "J4 10 20 P1",
+                               "[RESERVOIRS]", "R1 10",
+                               "[TANKS]", "T1 30 4 1 15 10 0 VC1",
+                               "[PIPES]", "P1 R1 J1 10 300 100 0 Open",
+                               "P2 J2 J3 500 250 100 0 Open", "P3 J4 T1 300 250 100 0 Open",
+                               "[PUMPS]", "PU1 J1 J2 HEAD HC1",
+                               "[VALVES]", "V1 J3 J4 200 GPV GC1 0",
+                               "[CURVES]",
+                               "HC1 0 60", "HC1 20 58", "HC1 40 54", "HC1 60 47", "HC1 80 37",
+                               "HC1 100 24",
+                               "GC1 0 0", "GC1 20 0.5", "GC1 40 1.5", "GC1 60 3", "GC1 80 5",
+                               "GC1 120 10",
+                               "VC1 0 0", "VC1 3 300", "VC1 6 800", "VC1 9 1500", "VC1 12 2400",
+                               "VC1 16 3600",
+                               "[PATTERNS]", "P1 0.5 1.0 1.5 2.0 1.0 0.5",
+                               "[TIMES]", "Duration 24:00", "Hydraulic Timestep 1:00",
+                               "Pattern Timestep 4:00",
+                               "[OPTIONS]", "Units LPS", "[END]"]))
+
+    with ScenarioSimulator(scenario_config=ScenarioConfig(f_inp_in=f_inp_in)) as sim:
+        epanet_api = sim.epanet_api
+        links_idx = np.array([sim.sensor_config.map_link_id_to_idx(link_id)
+                              for link_id in ["PU1", "V1"]])
+        tank_idx = np.array([sim.sensor_config.map_node_id_to_idx("T1")])
+
+        curves = {}
+        for curve_id in ["HC1", "GC1", "VC1"]:
+            curve_idx, n_points = ctypes.c_int(), ctypes.c_int()
+            call_native_function(epanet_api, "getcurveindex", ctypes.c_char_p(curve_id.encode()),
+                                 ctypes.byref(curve_idx))
+            call_native_function(epanet_api, "getcurvelen", curve_idx, ctypes.byref(n_points))
+            x, y = (ctypes.c_double * n_points.value)(), (ctypes.c_double * n_points.value)()
+            call_native_function(epanet_api, "getcurve", curve_idx,
+                                 ctypes.create_string_buffer(64), ctypes.byref(n_points), x, y)
+            curves[curve_id] = (curve_idx, np.array(x), np.array(y))
+
+        def check_curves():
+            # The curves must be evaluated at the current flows and tank levels
+            flows = get_link_values(epanet_api, EN_FLOW, links_idx)
+            head_losses = get_link_values(epanet_api, ToolkitConstants.EN_HEADLOSS, links_idx)
+            assert np.isclose(-head_losses[0], np.interp(flows[0], *curves["HC1"][1:]),
+                              rtol=1e-4)
+            assert np.isclose(head_losses[1], np.interp(flows[1], *curves["GC1"][1:]),
+                              rtol=1e-4)
+
+            level = get_node_values(epanet_api, ToolkitConstants.EN_HEAD, tank_idx) - \
+                get_node_values(epanet_api, ToolkitConstants.EN_ELEVATION, tank_idx)
+            assert np.isclose(get_node_values(epanet_api, EN_TANKVOLUME, tank_idx),
+                              np.interp(level, *curves["VC1"][1:]))
+
+        t, tstep = ctypes.c_long(), ctypes.c_long()
+        call_native_function(epanet_api, "openH")
+        try:
+            call_native_function(epanet_api, "initH", ctypes.c_int(0))
+            while True:
+                call_native_function(epanet_api, "runH", ctypes.byref(t))
+                check_curves()
+
+                # Change all curves while the hydraulic solver is open
+                if t.value == to_seconds(hours=8):
+                    for curve_id, (curve_idx, x, y) in curves.items():
+                        x, y = np.ascontiguousarray(.8 * x), np.ascontiguousarray(1.2 * y)
+                        call_native_function(epanet_api, "setcurve", curve_idx,
+                                             x.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+                                             y.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+                                             ctypes.c_int(len(x)))
+                        curves[curve_id] = (curve_idx, x, y)
+
+                    call_native_function(epanet_api, "runH", ctypes.byref(t))
+                    check_curves()
+
+                call_native_function(epanet_api, "nextH", ctypes.byref(tstep))
+                if tstep.value <= 0:
+                    break
+        finally:
+            call_native_function(epanet_api, "closeH")
+
+
+def test_memory_model():
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+
+        features = sim.get_memory_features()
+        assert all(features[feature] >= 0 for feature in MEMORY_MODEL_FEATURES)
+        assert sim.estimate_memory_consumption() > 0
+
+        sim.run_simulation()
+        memory_usage = sim.get_memory_usage(last_run=True)
+        assert memory_usage["epanet"]["sparse"] > 0
+        assert sim.get_memory_usage()["epanet"]["sparse"] == 0
+
+    memory_model = MemoryModel()
+    memory_model.calibrate([features, {**features, "results": 2 * features["results"]}],
+                           [10., 20.])
+    assert all(coefficient >= 0 for coefficient in memory_model.coefficients.values())
+
+
+def test_sensor_placement():
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+
+        f_out = os.path.join(get_temp_folder(), "leak_signatures.npy")
+        signatures = compute_leak_signatures(sim, f_out=f_out, block_size=8)
+        assert signatures.shape[0] == len(sim.sensor_config.nodes) - 1
+        signatures.save(os.path.join(get_temp_folder(), "leak_signatures.npz"))
+        signatures = SignatureMatrix.load(os.path.join(get_temp_folder(), "leak_signatures.npz"))
+
+        sensor_config = place_pressure_sensors(sim.sensor_config, signatures, n_sensors=3,
+                                               detection_threshold=.01)
+        assert len(sensor_config.pressure_sensors) == 3
+        sim.sensor_config = sensor_config
+        sim.run_simulation()
+
+        signatures = compute_contamination_signatures(sim, max_travel_time=to_seconds(hours=6),
+                                                      dtype=np.uint8)
+        sensors, coverage, upper_bound = greedy_max_coverage(signatures, n_sensors=2,
+                                                             detection_threshold=.5)
+        assert len(sensors) == 2 and coverage[-1] <= upper_bound
+
+
+def test_backward_influence():
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(hours=12))
+
+        sensor_locations = sim.get_topology().get_all_junctions()[-2:]
+        influence = compute_backward_influence(sim, sensor_locations=sensor_locations)
+        assert influence.shape[:2] == (2, len(influence.sample_times))
+
+        upstream = influence.get_upstream_nodes(sensor_locations[0], to_seconds(hours=6))
+        assert upstream[sensor_locations[0]] == (0., 1.)
+
+        detections = np.zeros(influence.shape[:2], dtype=bool)
+        detections[0, -1] = True
+        assert len(influence.locate_source(detections, n_candidates=3)) == 3
+
+
+def test_backward_influence_vs_source_tracing():
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1),
+                                   quality_time_step=30)
+        topology = sim.get_topology()
+        reservoir_id = topology.get_all_reservoirs()[0]
+        junctions = topology.get_all_junctions()
+
+        # Demands (and thus flows & travel times) vary over the day
+        base_demands = np.array([sim.epanet_api.getNodeBaseDemands(
+            sim.epanet_api.getNodeIndex(node_id))[1][0] for node_id in junctions])
+        sim.set_node_demand_patterns(junctions, base_demands,
+                                     [f"demand_{node_id}" for node_id in junctions],
+                                     synthesize_leakdb_demands(len(junctions),
+                                                               np.array([.1, .3, -.2, .05, .1]),
+                                                               np.array([.05, .02, -.01]),
+                                                               n_time_steps=48, seed=0))
+        sample_times = [to_seconds(hours=h) for h in (6, 12, 18, 24)]
+        influence = compute_backward_influence(sim, sensor_locations=junctions,
+                                               sample_times=sample_times, bin_size=300,
+                                               min_weight=0.)
+
+        sim.enable_sourcetracing_analysis(reservoir_id)
+        sim.set_node_quality_sensors(sensor_locations=junctions)
+        res = sim.run_simulation()
+        trace = res.get_data_nodes_quality()
+
+        for t in sample_times:
+            row = np.flatnonzero(res.sensor_readings_time == t)[0]
+            for i, junction in enumerate(junctions):
+                upstream = influence.get_upstream_nodes(junction, t)
+                weight = upstream.get(reservoir_id, (0., 0.))[1]
+                assert abs(100. * weight - trace[row, i]) < 2.
+
+
+def test_leak_signature_dictionary():
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(hours=6))
+
+        candidates = sim.get_topology().get_all_junctions()[:5]
+        f_out = os.path.join(get_temp_folder(), "leak_dictionary.npy")
+        signatures = compute_leak_signature_dictionary(sim, [.5, 1.], candidates=candidates,
+                                                       sensor_locations=candidates[:2],
+                                                       f_out=f_out, n_threads=2)
+        assert signatures.shape[:2] == (2, 10)
+        assert np.all(signatures[:, 1::2, :] >= signatures[:, ::2, :] - 1e-6)
+
+
+def test_demand_synthesis():
+    a_week, a_year = np.array([.1, .3, -.2, .05, .1]), np.array([.05, .02, -.01])
+    patterns = synthesize_leakdb_demands(3, a_week, a_year, n_time_steps=48 * 7, seed=42)
+    assert patterns.shape == (3, 48 * 7)
+    assert np.array_equal(patterns[:2], synthesize_leakdb_demands(2, a_week, a_year,
+                                                                  n_time_steps=48 * 7, seed=42))
+
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        sim.set_general_parameters(simulation_duration=to_seconds(days=1))
+
+        nodes_id = sim.get_topology().get_all_junctions()
+        sim.set_node_demand_patterns(nodes_id, np.ones(len(nodes_id)),
+                                     [f"demand_{node_id}" for node_id in nodes_id],
+                                     synthesize_leakdb_demands(len(nodes_id), a_week, a_year,
+                                                               n_time_steps=48, seed=0))
+        assert sim.epanet_api.getPatternCount() >= len(nodes_id)
+
+        sim.run_simulation().get_data()
@@ -0,0 +1,60 @@
+"""
+Module provides tests to test the :class:`epyt_flow.topology.NetworkTopology` class.
+"""
+import os
+import numpy as np
+from epyt_flow.data.networks import load_net1, load_hanoi
+from epyt_flow.simulation import ScenarioSimulator
+from epyt_flow.topology import NetworkTopology
+
+from .utils import get_temp_folder
+
+
+def test_csr_adjacency():
+    with ScenarioSimulator(scenario_config=load_net1(get_temp_folder())) as sim:
+        graph = sim.get_topology()
+
+        graph_py = NetworkTopology(f_inp=graph.name, nodes=[(node_id, graph.get_node_info(node_id))
+                                                            for node_id in graph.get_all_nodes()],
+                                   links=[(link_id, nodes, graph.get_link_info(link_id))
+                                          for link_id, nodes in graph.get_all_links()],
+                                   pumps=graph.pumps, valves=graph.valves, units=graph.units)
+
+        row_ptr, col_idx, link_idx = graph.get_csr_adjacency()
+        row_ptr_py, col_idx_py, link_idx_py = graph_py.get_csr_adjacency()
+        assert np.all(row_ptr == row_ptr_py)
+        for i in range(len(row_ptr) - 1):
+            assert sorted(zip(col_idx[row_ptr[i]:row_ptr[i+1]],
+                              link_idx[row_ptr[i]:row_ptr[i+1]])) == \
+                sorted(zip(col_idx_py[row_ptr[i]:row_ptr[i+1]],
+                           link_idx_py[row_ptr[i]:row_ptr[i+1]]))
+
+        for node_id in graph.get_all_nodes():
+            assert sorted(graph.get_adjacent_links(node_id)) == \
+                sorted((link_id, nodes) for link_id, nodes in graph.get_all_links()
+                       if node_id in nodes)
+
+
+def test_distance_matrix():
+    with ScenarioSimulator(scenario_config=load_hanoi(get_temp_folder())) as sim:
+        graph = sim.get_topology()
+        nodes_id = graph.get_all_nodes()
+
+        dist = graph.get_distance_matrix(block_size=8, n_jobs=2)
+        assert dist.dtype == np.float32
+        ref = graph.get_all_pairs_shortest_path_length()
+        for i, node_a in enumerate(nodes_id):
+            for j, node_b in enumerate(nodes_id):
+                assert np.isclose(dist[i, j], ref[node_a][node_b], rtol=1e-5)
+
+        sources, targets = nodes_id[:3], nodes_id[5:10]
+        dist_sub = graph.get_distance_matrix(sources=sources, targets=targets,
+                                             use_pipe_length_as_weight=False)
+        for i, node_a in enumerate(sources):
+            for j, node_b in enumerate(targets):
+                assert dist_sub[i, j] == graph.get_shortest_path_length(node_a, node_b, False)
+
+        f_out = os.path.join(get_temp_folder(), "dist.npy")
+        dist_mm = graph.get_distance_matrix(f_out=f_out, block_size=5)
+        assert np.all(np.load(f_out) == dist)
+        assert np.all(dist_mm == dist)